@@ -18,6 +18,7 @@ GR_CHECK_HDR_N_DEF(sys/mman.h HAVE_SYS_MMAN_H)
 GR_CHECK_HDR_N_DEF(sys/ipc.h HAVE_SYS_IPC_H)
 GR_CHECK_HDR_N_DEF(sys/shm.h HAVE_SYS_SHM_H)
 GR_CHECK_HDR_N_DEF(signal.h HAVE_SIGNAL_H)
+GR_CHECK_HDR_N_DEF(linux/mempolicy.h HAVE_LINUX_MEMPOLICY_H)
 
 
 ########################################################################
@@ -83,6 +84,14 @@ CHECK_CXX_SOURCE_COMPILES("
 GR_ADD_COND_DEF(HAVE_SHM_OPEN)
 SET(CMAKE_REQUIRED_LIBRARIES)
 
+########################################################################
+CHECK_CXX_SOURCE_COMPILES("
+    #include <sys/mman.h>
+    int main(){memfd_create(0, MFD_CLOEXEC | MFD_HUGETLB); return 0;}
+    " HAVE_MEMFD_CREATE
+)
+GR_ADD_COND_DEF(HAVE_MEMFD_CREATE)
+
 ########################################################################
 CHECK_CXX_SOURCE_COMPILES("
     #define _GNU_SOURCE
@@ -0,0 +1,58 @@
+#!/usr/bin/env python
+#
+# Copyright 2021 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+"""
+Compare schedulers on long chains (1 pipe, many stages) and wide
+fan-outs (many pipes, 1 stage) using ./synthetic.py.
+"""
+
+import os
+import subprocess
+import sys
+from argparse import ArgumentParser
+
+
+def run_one(scheduler, npipes, nstages, nsamples):
+    synthetic = os.path.join(os.path.dirname(os.path.abspath(__file__)), "synthetic.py")
+    cmd = [sys.executable, synthetic, "-m", "-S", scheduler,
+           "-p", str(npipes), "-s", str(nstages), "-N", str(nsamples)]
+    out = subprocess.check_output(cmd, universal_newlines=True)
+    # npipes nstages nsamples real user sys (user+sys)/real flop flop/real
+    fields = out.split("\n")[-2].split()
+    return float(fields[3]), float(fields[4]) + float(fields[5])
+
+
+def main():
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("-S", "--schedulers", default="TPB,WS",
+                        help="comma separated list of schedulers [default=%(default)s]")
+    parser.add_argument("-n", "--sizes", default="16,64,150",
+                        help="comma separated chain lengths / fan-out widths [default=%(default)s]")
+    parser.add_argument("-N", "--nsamples", type=float, default=2e6,
+                        help="number of samples per run [default=%(default)s]")
+    args = parser.parse_args()
+
+    schedulers = args.schedulers.split(",")
+    sizes = [int(x) for x in args.sizes.split(",")]
+
+    print("%-8s %6s %6s  %s" % ("shape", "pipes", "stages",
+                                "  ".join("%-8s real/cpu [s]" % s for s in schedulers)))
+    for shape in ("chain", "fan-out"):
+        for n in sizes:
+            npipes, nstages = (1, n) if shape == "chain" else (n, 1)
+            # keep the amount of filtering constant across shapes
+            nsamples = int(args.nsamples * 16 / n)
+            results = [run_one(s, npipes, nstages, nsamples) for s in schedulers]
+            print("%-8s %6d %6d  %s" % (shape, npipes, nstages,
+                                        "  ".join("%8.3f/%-12.3f" % r for r in results)))
+
+
+if __name__ == '__main__':
+    main()
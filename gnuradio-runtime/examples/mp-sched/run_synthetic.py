@@ -19,13 +19,15 @@ import tempfile
 from argparse import ArgumentParser
 
 
-def write_shell_script(f, data_filename, description, ncores, gflops, max_pipes_and_stages):
+def write_shell_script(f, data_filename, description, ncores, gflops, max_pipes_and_stages,
+                       scheduler=None):
     """
     f is the file to write the script to
     data_filename is the where the data ends up
     description describes the machine
     ncores is the number of cores (used to size the workload)
     gflops is the estimated GFLOPS per core (used to size the workload)
+    scheduler is passed to synthetic.py as --scheduler, if given
     """
 
     f.write("#!/bin/sh\n")
@@ -41,7 +43,10 @@ def write_shell_script(f, data_filename, description, ncores, gflops, max_pipes_
             nsamples = (est_gflops_avail * desired_time_per_run) / (512.0 * nstages * npipes)
             nsamples = int(nsamples * 1e9)
 
-            cmd = "./synthetic.py -m -s %d -p %d -N %d\n" % (nstages, npipes, nsamples)
+            cmd = "./synthetic.py -m -s %d -p %d -N %d" % (nstages, npipes, nsamples)
+            if scheduler:
+                cmd += " -S %s" % (scheduler,)
+            cmd += "\n"
             f.write(cmd)
             f.write('if test $? -ge 128; then exit 128; fi\n')
 
@@ -68,6 +73,8 @@ plot_flops.py will make pretty graphs from the output data generated by %prog.
             help="estimated GFLOPS per core [default=%(default)s]")
     parser.add_argument("-m", "--max-pipes-and-stages", metavar="MAX", type=int, default=16,
             help="maximum number of pipes and stages to use [default=%(default)s]")
+    parser.add_argument("-S", "--scheduler", default=None,
+            help="scheduler to benchmark, e.g. TPB or WS [default: $GR_SCHEDULER or TPB]")
     parser.add_argument("output_file_name", metavar="FILE", help="output file name")
     args = parser.parse_args()
 
@@ -78,7 +85,8 @@ plot_flops.py will make pretty graphs from the output data generated by %prog.
                        args.description,
                        args.ncores,
                        args.gflops,
-                       args.max_pipes_and_stages)
+                       args.max_pipes_and_stages,
+                       args.scheduler)
 
 if __name__ == '__main__':
     main()
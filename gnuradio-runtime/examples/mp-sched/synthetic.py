@@ -49,6 +49,8 @@ class top(gr.top_block):
                                 (eng_notation.num_to_str(default_nsamples))))
         parser.add_argument("-m", "--machine-readable", action="store_true", default=False,
                           help="enable machine readable output")
+        parser.add_argument("-S", "--scheduler", default=None,
+                          help="scheduler to use, e.g. TPB or WS (default: $GR_SCHEDULER or TPB)")
 
         args = parser.parse_args()
 
@@ -57,6 +59,10 @@ class top(gr.top_block):
         self.nsamples = args.nsamples
         self.machine_readable = args.machine_readable
 
+        # read by the runtime when the first flowgraph starts
+        if args.scheduler:
+            os.environ["GR_SCHEDULER"] = args.scheduler
+
         ntaps = 256
 
         # Something vaguely like floating point ops
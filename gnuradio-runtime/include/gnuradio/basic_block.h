@@ -15,14 +15,18 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/logger.h>
 #include <gnuradio/msg_accepter.h>
+#include <gnuradio/msg_port_queue.h>
 #include <gnuradio/runtime_types.h>
 #include <gnuradio/sptr_magic.h>
 #include <gnuradio/thread/thread.h>
 #include <boost/thread/condition_variable.hpp>
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <gnuradio/rpcregisterhelpers.h>
 
@@ -43,22 +47,27 @@ class GR_RUNTIME_API basic_block : public msg_accepter,
                                    public std::enable_shared_from_this<basic_block>
 {
     typedef std::function<void(pmt::pmt_t)> msg_handler_t;
+    typedef std::function<void(const std::vector<pmt::pmt_t>&)> msg_batch_handler_t;
 
 private:
     typedef std::map<pmt::pmt_t, msg_handler_t, pmt::comparator> d_msg_handlers_t;
     d_msg_handlers_t d_msg_handlers;
 
-    typedef std::deque<pmt::pmt_t> msg_queue_t;
+    typedef std::map<pmt::pmt_t, msg_batch_handler_t, pmt::comparator>
+        d_msg_batch_handlers_t;
+    d_msg_batch_handlers_t d_msg_batch_handlers;
+
+    typedef msg_port_queue msg_queue_t;
     typedef std::map<pmt::pmt_t, msg_queue_t, pmt::comparator> msg_queue_map_t;
     typedef std::map<pmt::pmt_t, msg_queue_t, pmt::comparator>::iterator
         msg_queue_map_itr;
 
-    gr::thread::mutex mutex; //< protects all vars
-
 protected:
     friend class flowgraph;
     friend class flat_flowgraph; // TODO: will be redundant
     friend class tpb_thread_body;
+    friend class tpb_chain_thread_body;
+    friend class scheduler_ws;
 
     enum vcolor { WHITE, GREY, BLACK };
 
@@ -78,6 +87,9 @@ protected:
     gr::logger_ptr d_debug_logger; //! Verbose logger
 
     msg_queue_map_t msg_queue;
+    // set once the block is in a flowgraph that was started; from then
+    // on msg_queue is read without a lock, so no ports may be added
+    std::atomic<bool> d_msg_ports_fixed{ false };
     std::vector<rpcbasic_sptr> d_rpc_vars; // container for all RPC variables
 
     basic_block(void) {} // allows pure virtual interface sub-classes
@@ -124,7 +136,34 @@ protected:
         }
     }
 
-    // Message passing interface
+    /*
+     * Called by the runtime system to dispatch all the messages that
+     * were queued on \p which_port, oldest first. Hands them to the
+     * batch handler if there is one, otherwise calls dispatch_msg for
+     * each of them.
+     */
+    virtual void dispatch_msgs(pmt::pmt_t which_port, const std::vector<pmt::pmt_t>& msgs)
+    {
+        const auto& handler = d_msg_batch_handlers.find(which_port);
+        if (handler != d_msg_batch_handlers.end()) {
+            handler->second(msgs);
+            return;
+        }
+        for (const auto& msg : msgs) {
+            dispatch_msg(which_port, msg);
+        }
+    }
+
+    /*!
+     * \brief Wake up the thread that handles this block's messages,
+     * called whenever one is queued.
+     */
+    virtual void notify_msg_handler();
+
+    // Message passing interface: output port -> list of subscribers.
+    // The dict is never changed in place but replaced, with
+    // std::atomic_store(), so the block's thread can publish (reading
+    // it with std::atomic_load()) while a running flowgraph is rewired.
     pmt::pmt_t d_message_subscribers;
 
     /*!
@@ -186,9 +225,20 @@ public:
     void set_block_alias(std::string name);
 
     // ** Message passing interface **
+
+    /*!
+     * \brief Register an input message port.
+     *
+     * Messages are posted to the port without taking a lock, so all
+     * input ports must be registered before the block is first
+     * started, usually in its constructor. Registering a new one
+     * afterwards throws std::runtime_error.
+     */
     void message_port_register_in(pmt::pmt_t port_id);
     void message_port_register_out(pmt::pmt_t port_id);
     void message_port_pub(pmt::pmt_t port_id, pmt::pmt_t msg);
+    //! Publish \p msgs in order, looking up each subscriber only once
+    void message_port_pub_batch(pmt::pmt_t port_id, const std::vector<pmt::pmt_t>& msgs);
     void message_port_sub(pmt::pmt_t port_id, pmt::pmt_t target);
     void message_port_unsub(pmt::pmt_t port_id, pmt::pmt_t target);
 
@@ -232,15 +282,16 @@ public:
     //! is the queue empty?
     bool empty_p(pmt::pmt_t which_port)
     {
-        if (msg_queue.find(which_port) == msg_queue.end())
+        const auto& queue = msg_queue.find(which_port);
+        if (queue == msg_queue.end())
             throw std::runtime_error("port does not exist!");
-        return msg_queue[which_port].empty();
+        return queue->second.empty();
     }
     bool empty_p()
     {
         bool rv = true;
         for (const auto& i : msg_queue) {
-            rv &= msg_queue[i.first].empty();
+            rv &= i.second.empty();
         }
         return rv;
     }
@@ -262,24 +313,33 @@ public:
     //! How many messages in the queue?
     size_t nmsgs(pmt::pmt_t which_port)
     {
-        if (msg_queue.find(which_port) == msg_queue.end())
+        const auto& queue = msg_queue.find(which_port);
+        if (queue == msg_queue.end())
             throw std::runtime_error("port does not exist!");
-        return msg_queue[which_port].size();
+        return queue->second.size();
     }
 
-    //| Acquires and release the mutex
+    //! Lock-free, see msg_port_queue and message_port_register_in()
     void insert_tail(pmt::pmt_t which_port, pmt::pmt_t msg);
     /*!
      * \returns returns pmt at head of queue or pmt::pmt_t() if empty.
      */
     pmt::pmt_t delete_head_nowait(pmt::pmt_t which_port);
 
-    msg_queue_t::iterator get_iterator(pmt::pmt_t which_port)
+    /*!
+     * \deprecated The messages are no longer kept in a std::deque; use
+     * delete_head_nowait() and nmsgs() instead. The iterator walks the
+     * queue from the oldest message on every access.
+     */
+    [[deprecated("use delete_head_nowait() and nmsgs()")]] msg_queue_t::iterator
+    get_iterator(pmt::pmt_t which_port)
     {
         return msg_queue[which_port].begin();
     }
 
-    void erase_msg(pmt::pmt_t which_port, msg_queue_t::iterator it)
+    //! \deprecated see get_iterator()
+    [[deprecated("use delete_head_nowait()")]] void
+    erase_msg(pmt::pmt_t which_port, msg_queue_t::iterator it)
     {
         msg_queue[which_port].erase(it);
     }
@@ -289,7 +349,7 @@ public:
         if (msg_queue.find(which_port) != msg_queue.end()) {
             return true;
         }
-        if (pmt::dict_has_key(d_message_subscribers, which_port)) {
+        if (pmt::dict_has_key(std::atomic_load(&d_message_subscribers), which_port)) {
             return true;
         }
         return false;
@@ -391,6 +451,38 @@ public:
                 "attempt to set_msg_handler() on bad input message port!");
         }
         d_msg_handlers[which_port] = msg_handler_t(msg_handler);
+        d_msg_batch_handlers.erase(which_port);
+    }
+
+    /*!
+     * \brief Set a callback that gets all the messages that are waiting
+     * on \p which_port at once.
+     *
+     * \p msg_handler can be any kind of function pointer or function
+     * object that has the signature:
+     * <pre>
+     *    void msg_handler(const std::vector<pmt::pmt_t>& msgs);
+     * </pre>
+     *
+     * The messages are in the order they were posted. Handlers that
+     * take a lock or allocate per message can do so once per batch, and
+     * pass their results on with message_port_pub_batch. Messages that
+     * are dispatched one at a time are handed over as a batch of one.
+     * The thread-safety guarantees are the same as for set_msg_handler,
+     * which replaces a batch handler (and vice versa).
+     */
+    template <typename T>
+    void set_msg_handler_batch(pmt::pmt_t which_port, T msg_handler)
+    {
+        if (msg_queue.find(which_port) == msg_queue.end()) {
+            throw std::runtime_error(
+                "attempt to set_msg_handler_batch() on bad input message port!");
+        }
+        msg_batch_handler_t handler(msg_handler);
+        d_msg_batch_handlers[which_port] = handler;
+        d_msg_handlers[which_port] = [handler](pmt::pmt_t msg) {
+            handler(std::vector<pmt::pmt_t>{ msg });
+        };
     }
 
     virtual void set_processor_affinity(const std::vector<int>& mask) = 0;
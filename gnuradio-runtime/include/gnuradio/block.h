@@ -325,8 +325,21 @@ public:
     /*!
      * \brief return a reference to the multiple precision rational
      * representation of the approximate output rate / input rate
+     *
+     * Use set_relative_rate() to change it.
+     */
+    const mpq_class& mp_relative_rate() const { return d_mp_relative_rate; }
+
+    /*!
+     * \brief Move the offsets of \p tags from input to output items
+     *
+     * Each offset becomes offset * mp_relative_rate(), rounded half
+     * up to the nearest item. When the numerator and denominator of
+     * the rate fit in 64 bits this uses 128 bit integer arithmetic
+     * set up by set_relative_rate(), else it falls back to GMP; both
+     * give the same result.
      */
-    mpq_class& mp_relative_rate() { return d_mp_relative_rate; }
+    void rescale_tag_offsets(std::vector<tag_t>& tags) const;
 
     /*
      * The following two methods provide special case info to the
@@ -659,6 +672,12 @@ public:
      */
     float pc_throughput_avg();
 
+    /*!
+     * \brief Gets the bytes of the output buffers resident on each NUMA
+     * node, indexed by node.
+     */
+    std::vector<float> pc_numa_node_bytes();
+
     /*!
      * \brief Resets the performance counters
      */
@@ -763,6 +782,8 @@ private:
     bool d_is_unaligned;
     double d_relative_rate; // approx output_rate / input_rate
     mpq_class d_mp_relative_rate;
+    uint64_t d_rrate_num; // d_mp_relative_rate if it fits in 64 bits,
+    uint64_t d_rrate_den; // else 0 / 0
     block_detail_sptr d_detail; // implementation details
     unsigned d_history;
     unsigned d_attr_delay; // the block's sample delay
@@ -947,6 +968,12 @@ protected:
                                 uint64_t downstream_lcm_nitems,
                                 uint32_t downstream_max_out_mult);
 
+    /*!
+     * \brief Wake up the thread running this block, without looking it up
+     * in the block registry.
+     */
+    void notify_msg_handler() override;
+
     std::vector<long> d_max_output_buffer;
     std::vector<long> d_min_output_buffer;
 
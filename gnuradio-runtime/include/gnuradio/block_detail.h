@@ -180,9 +180,18 @@ public:
 
     /*!
      * \brief Unset core affinity.
+     *
+     * A block placed on a NUMA node stays on the CPUs of that node.
      */
     void unset_processor_affinity();
 
+    /*!
+     * \brief NUMA node the block's thread and output buffers are placed
+     * on, or -1 if they aren't placed ([Scheduler] numa_aware).
+     */
+    int numa_node() const { return d_numa_node; }
+    void set_numa_node(int node) { d_numa_node = node; }
+
     /*!
      * \brief Get the current thread priority
      */
@@ -243,6 +252,9 @@ public:
 
     float pc_work_time_total();
 
+    // Bytes of our output buffers resident on each NUMA node
+    std::vector<float> pc_numa_node_bytes();
+
     tpb_detail d_tpb; // used by thread-per-block scheduler
     int d_produce_or;
 
@@ -261,6 +273,7 @@ private:
     std::vector<buffer_sptr> d_output;
     bool d_done;
     int d_consumed;
+    int d_numa_node;
 
     // Performance counters
     float d_ins_noutput_items;
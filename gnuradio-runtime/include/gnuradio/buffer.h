@@ -15,11 +15,13 @@
 #include <gnuradio/custom_lock.h>
 #include <gnuradio/logger.h>
 #include <gnuradio/runtime_types.h>
+#include <gnuradio/tag_store.h>
 #include <gnuradio/tags.h>
 #include <gnuradio/thread/thread.h>
 #include <gnuradio/transfer_type.h>
 
 #include <boost/weak_ptr.hpp>
+#include <atomic>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -113,7 +115,7 @@ public:
     void update_write_pointer(int nitems);
 
     void set_done(bool done);
-    bool done() const { return d_done; }
+    bool done() const { return d_done.load(std::memory_order_acquire); }
 
     /*!
      * \brief Return the block that writes to this buffer.
@@ -125,7 +127,34 @@ public:
 
     gr::thread::mutex* mutex() { return &d_mutex; }
 
-    uint64_t nitems_written() { return d_abs_write_offset; }
+    /*!
+     * \brief true if the read and write indices of this buffer may be
+     * used without holding mutex().
+     *
+     * The writer publishes its index with release semantics in
+     * update_write_pointer(), and each reader does the same in
+     * buffer_reader::update_read_pointer(), so space_available() and
+     * buffer_reader::items_available() only need acquire loads. Tags
+     * are still protected by mutex().
+     */
+    bool atomic_indices() const { return d_atomic_indices; }
+
+    /*!
+     * \brief Lock the mutex for access to the indices, unless the
+     * buffer uses atomic indices, in which case the returned lock
+     * does not own the mutex.
+     */
+    gr::thread::scoped_lock index_lock()
+    {
+        if (d_atomic_indices)
+            return gr::thread::scoped_lock(d_mutex, boost::defer_lock);
+        return gr::thread::scoped_lock(d_mutex);
+    }
+
+    uint64_t nitems_written()
+    {
+        return d_abs_write_offset.load(std::memory_order_relaxed);
+    }
 
     void reset_nitem_counter()
     {
@@ -152,6 +181,11 @@ public:
      */
     void add_item_tag(const tag_t& tag);
 
+    /*!
+     * \brief  Adds all of \p tags to the buffer, taking the mutex once.
+     */
+    void add_item_tags(const std::vector<tag_t>& tags);
+
     /*!
      * \brief  Removes an existing tag from the buffer.
      *
@@ -173,16 +207,13 @@ public:
      */
     void prune_tags(uint64_t max_time);
 
-    std::multimap<uint64_t, tag_t>::iterator get_tags_begin()
-    {
-        return d_item_tags.begin();
-    }
-    std::multimap<uint64_t, tag_t>::iterator get_tags_end() { return d_item_tags.end(); }
-    std::multimap<uint64_t, tag_t>::iterator get_tags_lower_bound(uint64_t x)
+    tag_store::iterator get_tags_begin() { return d_item_tags.begin(); }
+    tag_store::iterator get_tags_end() { return d_item_tags.end(); }
+    tag_store::iterator get_tags_lower_bound(uint64_t x)
     {
         return d_item_tags.lower_bound(x);
     }
-    std::multimap<uint64_t, tag_t>::iterator get_tags_upper_bound(uint64_t x)
+    tag_store::iterator get_tags_upper_bound(uint64_t x)
     {
         return d_item_tags.upper_bound(x);
     }
@@ -241,6 +272,10 @@ public:
      */
     inline void increment_active()
     {
+        // Only the callbacks of buffers with locked indices care
+        if (d_atomic_indices)
+            return;
+
         gr::thread::scoped_lock lock(d_mutex);
 
         d_cv.wait(lock, [this]() { return d_callback_flag == false; });
@@ -253,6 +288,9 @@ public:
      */
     inline void decrement_active()
     {
+        if (d_atomic_indices)
+            return;
+
         gr::thread::scoped_lock lock(d_mutex);
 
         if (--d_active_pointer_counter == 0)
@@ -313,13 +351,17 @@ protected:
     //
     // The mutex protects d_write_index, d_abs_write_offset, d_done, d_item_tags
     // and the d_read_index's and d_abs_read_offset's in the buffer readers.
-    // Also d_callback_flag and d_active_pointer_counter.
+    // Also d_callback_flag and d_active_pointer_counter. If d_atomic_indices
+    // is set, the indices, offsets and d_done are not protected by the mutex;
+    // see atomic_indices().
     //
     gr::thread::mutex d_mutex;
-    unsigned int d_write_index;  // in items [0,d_bufsize)
-    uint64_t d_abs_write_offset; // num items written since the start
-    bool d_done;
-    std::multimap<uint64_t, tag_t> d_item_tags;
+    bool d_atomic_indices;
+    std::atomic<unsigned int> d_write_index;  // in items [0,d_bufsize)
+    std::atomic<uint64_t> d_abs_write_offset; // num items written since the start
+    std::atomic<bool> d_done;
+    tag_store d_item_tags;
+    std::atomic<bool> d_has_tags; // !d_item_tags.empty(), readable without the mutex
     uint64_t d_last_min_items_read;
     //
     gr::thread::condition_variable d_cv;
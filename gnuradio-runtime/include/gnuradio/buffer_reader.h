@@ -18,6 +18,7 @@
 #include <gnuradio/tags.h>
 #include <gnuradio/thread/thread.h>
 #include <boost/weak_ptr.hpp>
+#include <atomic>
 #include <map>
 #include <memory>
 
@@ -106,7 +107,10 @@ public:
 
     gr::thread::mutex* mutex() { return d_buffer->mutex(); }
 
-    uint64_t nitems_read() const { return d_abs_read_offset; }
+    uint64_t nitems_read() const
+    {
+        return d_abs_read_offset.load(std::memory_order_relaxed);
+    }
 
     void reset_nitem_counter()
     {
@@ -175,11 +179,12 @@ protected:
                                                                int delay);
 
     buffer_sptr d_buffer;
-    unsigned int d_read_index;   // in items [0,d->buffer.d_bufsize) ** see NB
-    uint64_t d_abs_read_offset;  // num items seen since the start   ** see NB
+    std::atomic<unsigned int> d_read_index;  // in items [0,d->buffer.d_bufsize) ** see NB
+    std::atomic<uint64_t> d_abs_read_offset; // num items seen since the start   ** see NB
     std::weak_ptr<block> d_link; // block that reads via this buffer reader
     unsigned d_attr_delay;       // sample delay attribute for tag propagation
-    // ** NB: buffer::d_mutex protects d_read_index and d_abs_read_offset
+    // ** NB: buffer::d_mutex protects d_read_index and d_abs_read_offset,
+    //        unless d_buffer->atomic_indices()
 
     //! constructor is private.  Use gr::buffer::add_reader to create instances
     buffer_reader(buffer_sptr buffer, unsigned int read_index, block_sptr link);
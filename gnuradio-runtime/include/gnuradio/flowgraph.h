@@ -14,6 +14,8 @@
 #include <gnuradio/api.h>
 #include <gnuradio/basic_block.h>
 #include <gnuradio/io_signature.h>
+#include <set>
+#include <utility>
 
 namespace gr {
 
@@ -34,7 +36,7 @@ public:
         d_basic_block = block;
         d_port = port;
     }
-    basic_block_sptr block() const { return d_basic_block; }
+    const basic_block_sptr& block() const { return d_basic_block; }
     int port() const { return d_port; }
     std::string identifier() const
     {
@@ -64,7 +66,7 @@ public:
         d_port = port;
         d_is_hier = is_hier;
     }
-    basic_block_sptr block() const { return d_basic_block; }
+    const basic_block_sptr& block() const { return d_basic_block; }
     pmt::pmt_t port() const { return d_port; }
     bool is_hier() const { return d_is_hier; }
     void set_hier(bool h) { d_is_hier = h; }
@@ -260,6 +262,9 @@ protected:
     edge calc_upstream_edge(basic_block_sptr block, int port);
 
 private:
+    // The connected input ports, so connect() needn't go through all edges
+    std::set<std::pair<const basic_block*, int>> d_used_dsts;
+
     void check_valid_port(gr::io_signature::sptr sig, int port);
     void check_valid_port(const msg_endpoint& e);
     void check_dst_not_used(const endpoint& dst);
@@ -0,0 +1,148 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_RUNTIME_MSG_PORT_QUEUE_H
+#define INCLUDED_GR_RUNTIME_MSG_PORT_QUEUE_H
+
+#include <gnuradio/api.h>
+#include <gnuradio/thread/thread.h>
+#include <pmt/pmt.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace gr {
+
+/*!
+ * \brief Queue of the messages posted to one input message port.
+ * \ingroup internal
+ *
+ * Any number of threads can push() without taking a lock: a message
+ * is linked in with a single atomic exchange (Dmitry Vyukov's node
+ * based multi-producer single-consumer queue). Messages are normally
+ * only taken out by the thread running the block; pop() and drain()
+ * still take a mutex, which is never contended then, so a block that
+ * pulls messages off its own ports from another thread stays safe.
+ * drain() takes it once for a whole batch.
+ */
+class GR_RUNTIME_API msg_port_queue
+{
+public:
+    msg_port_queue();
+    ~msg_port_queue();
+
+    msg_port_queue(const msg_port_queue&) = delete;
+    msg_port_queue& operator=(const msg_port_queue&) = delete;
+
+    /*!
+     * \brief Append \p msg to the queue. Safe to call from any thread.
+     */
+    void push(pmt::pmt_t msg);
+
+    /*!
+     * \brief Remove the oldest message.
+     *
+     * \returns the message, or pmt::pmt_t() if the queue is empty.
+     */
+    pmt::pmt_t pop();
+
+    /*!
+     * \brief Move up to \p max of the oldest messages, in order, to the
+     * end of \p msgs.
+     *
+     * \returns the number of messages moved.
+     */
+    size_t drain(std::vector<pmt::pmt_t>& msgs, size_t max = SIZE_MAX);
+
+    /*!
+     * \brief Number of messages in the queue.
+     *
+     * Messages that are being pushed right now may already be counted
+     * while pop() doesn't see them yet.
+     */
+    size_t size() const { return d_size.load(std::memory_order_acquire); }
+
+    bool empty() const { return size() == 0; }
+
+    /*!
+     * \brief Forward iterator over the queued messages, oldest first.
+     *
+     * Only there for the deprecated basic_block::get_iterator(); every
+     * access walks the queue from the oldest message.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = pmt::pmt_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const pmt::pmt_t*;
+        using reference = pmt::pmt_t;
+
+        iterator(const msg_port_queue* queue, size_t index)
+            : d_queue(queue), d_index(index)
+        {
+        }
+
+        pmt::pmt_t operator*() const { return d_queue->at(d_index); }
+        iterator& operator++()
+        {
+            d_index++;
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator it(*this);
+            d_index++;
+            return it;
+        }
+        bool operator==(const iterator& other) const
+        {
+            return d_queue == other.d_queue && d_index == other.d_index;
+        }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class msg_port_queue;
+        const msg_port_queue* d_queue;
+        size_t d_index;
+    };
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, linked_size()); }
+
+    /*!
+     * \brief The message at \p index, counted from the oldest, or
+     * pmt::pmt_t() if there are fewer messages.
+     */
+    pmt::pmt_t at(size_t index) const;
+
+    /*!
+     * \brief Remove the message \p it points to.
+     */
+    void erase(iterator it);
+
+private:
+    struct node;
+
+    std::atomic<node*> d_head; // most recently pushed, producers link in here
+    node* d_tail;              // already consumed; the oldest message is next
+    std::atomic<size_t> d_size;
+    mutable gr::thread::mutex d_mutex; // protects d_tail
+
+    bool pop_locked(pmt::pmt_t& msg);
+    size_t linked_size() const;
+};
+
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_RUNTIME_MSG_PORT_QUEUE_H */
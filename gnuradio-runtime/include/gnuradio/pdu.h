@@ -17,7 +17,10 @@
 
 namespace gr {
 namespace metadata_keys {
+GR_RUNTIME_API const pmt::pmt_t packet_len();
 GR_RUNTIME_API const pmt::pmt_t pdu_num();
+GR_RUNTIME_API const pmt::pmt_t rx_freq();
+GR_RUNTIME_API const pmt::pmt_t rx_rate();
 GR_RUNTIME_API const pmt::pmt_t rx_time();
 GR_RUNTIME_API const pmt::pmt_t sample_rate();
 GR_RUNTIME_API const pmt::pmt_t sys_time();
@@ -0,0 +1,90 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_RUNTIME_TAG_STORE_H
+#define INCLUDED_GR_RUNTIME_TAG_STORE_H
+
+#include <gnuradio/api.h>
+#include <gnuradio/tags.h>
+#include <algorithm>
+#include <vector>
+
+namespace gr {
+
+/*!
+ * \brief The stream tags of a buffer, sorted by offset.
+ * \ingroup internal
+ *
+ * Tags are kept in one vector. Blocks almost always add tags in
+ * offset order, so adding one is usually an append; a tag that is
+ * older than the newest one is inserted in place. Tags with the same
+ * offset stay in the order they were added. Pruning only moves the
+ * start of the live range forward; the pruned tags are dropped once
+ * they make up half of the vector, so both are amortized O(1).
+ *
+ * Not thread safe; the buffer's mutex protects it.
+ */
+class GR_RUNTIME_API tag_store
+{
+public:
+    typedef std::vector<tag_t>::iterator iterator;
+
+    tag_store() : d_first(0) {}
+
+    iterator begin() { return d_tags.begin() + d_first; }
+    iterator end() { return d_tags.end(); }
+
+    bool empty() const { return d_first == d_tags.size(); }
+    size_t size() const { return d_tags.size() - d_first; }
+
+    //! First tag with an offset of at least \p offset
+    iterator lower_bound(uint64_t offset)
+    {
+        return std::lower_bound(begin(), end(), offset, [](const tag_t& t, uint64_t x) {
+            return t.offset < x;
+        });
+    }
+
+    //! First tag with an offset greater than \p offset
+    iterator upper_bound(uint64_t offset)
+    {
+        return std::upper_bound(begin(), end(), offset, [](uint64_t x, const tag_t& t) {
+            return x < t.offset;
+        });
+    }
+
+    void add(const tag_t& tag)
+    {
+        if (empty() || d_tags.back().offset <= tag.offset)
+            d_tags.push_back(tag);
+        else
+            d_tags.insert(upper_bound(tag.offset), tag);
+    }
+
+    //! Add all of \p tags, e.g. the tags propagated from one work call
+    void add(const std::vector<tag_t>& tags);
+
+    //! Remove all tags with an offset less than \p offset
+    void prune(uint64_t offset);
+
+    void clear()
+    {
+        d_tags.clear();
+        d_first = 0;
+    }
+
+private:
+    std::vector<tag_t> d_tags; // [d_first, end) are live
+    size_t d_first;
+};
+
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_RUNTIME_TAG_STORE_H */
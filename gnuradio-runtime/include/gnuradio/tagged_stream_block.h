@@ -30,6 +30,17 @@ private:
     gr_vector_int
         d_n_input_items_reqd; //!< How many input items do I need to process the next PDU?
 
+    // Scratch space of general_work(), kept to save allocations
+    std::vector<std::vector<tag_t>> d_packet_tags; //!< Tags on the first item of a PDU
+    std::vector<std::vector<tag_t>> d_window_tags; //!< Tags on all input items
+    std::vector<size_t> d_window_pos;              //!< Next tag to look at, per input
+    gr_vector_const_void_star d_packet_inputs;     //!< Start of the PDU, per input
+    gr_vector_void_star d_packet_outputs;          //!< End of the output so far
+    gr_vector_int d_nconsumed;                     //!< Items consumed in this call
+
+    //! Collect the tags on the first item of the next PDU in d_packet_tags
+    void get_packet_tags(unsigned which_input, bool from_window);
+
 protected:
     std::string d_length_tag_key_str;
     tagged_stream_block(void) {} // allows pure virtual interface sub-classes
@@ -97,6 +108,11 @@ public:
      * - If not, inform the scheduler and do nothing
      * - Calls work() with the exact number of items per PDU
      * - Updates the tags using update_length_tags()
+     *
+     * If the block propagates its tags itself (TPP_DONT or TPP_CUSTOM)
+     * or has no outputs, this repeats for as many PDUs as there are
+     * complete on the inputs and fit on the outputs, and produces each
+     * one as soon as it's done. work() is called once per PDU either way.
      */
     int general_work(int noutput_items,
                      gr_vector_int& ninput_items,
@@ -72,6 +72,10 @@ struct GR_RUNTIME_API tag_t {
         return (*this);
     }
 
+    //! Moves keep marked_delete, so containers of tags can move them around
+    tag_t(tag_t&& rhs) = default;
+    tag_t& operator=(tag_t&& rhs) = default;
+
     ~tag_t() {}
 };
 
@@ -117,6 +117,16 @@ public:
      */
     std::string msg_edge_list();
 
+    /*!
+     * Returns a string that lists the size of the output buffers of
+     * the blocks in the flattened flowgraph, as "alias:port nitems".
+     * With the [Scheduler] adaptive_buffers preference set, these are
+     * the sizes picked by the last reconfiguration; pass them to
+     * set_min_output_buffer() or set_max_output_buffer() to use them
+     * from the start.
+     */
+    std::string buffer_size_list();
+
     /*!
      * Displays flattened flowgraph edges and block connectivity
      */
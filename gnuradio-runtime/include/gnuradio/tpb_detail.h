@@ -14,7 +14,9 @@
 #include <gnuradio/api.h>
 #include <gnuradio/thread/thread.h>
 #include <pmt/pmt.h>
+#include <atomic>
 #include <deque>
+#include <functional>
 
 namespace gr {
 
@@ -22,16 +24,25 @@ class block_detail;
 
 /*!
  * \brief used by thread-per-block scheduler
+ *
+ * By default the changed flags are set, cleared and waited for under
+ * the mutex. With a [Scheduler] tpb_max_spin_us preference above 0 they
+ * form an eventcount instead: notifiers set a flag and only take the
+ * mutex to signal the condition variable if the block's thread
+ * announced that it is about to sleep. Before sleeping, the thread
+ * spins on the flag for up to the current spin budget, which adapts to
+ * how long recent waits took and is capped by the preference.
  */
 struct GR_RUNTIME_API tpb_detail {
-    gr::thread::mutex mutex; //< protects all vars
-    bool input_changed;
+    gr::thread::mutex mutex; //< protects the condition variables and wakeup
+    std::atomic<bool> input_changed;
     gr::thread::condition_variable input_cond;
-    bool output_changed;
+    std::atomic<bool> output_changed;
     gr::thread::condition_variable output_cond;
+    std::function<void()> wakeup; //< optional, called on every notification
 
 public:
-    tpb_detail() : input_changed(false), output_changed(false) {}
+    tpb_detail();
 
     //! Called by us to tell all our upstream blocks that their output
     //! may have changed.
@@ -45,39 +56,59 @@ public:
     void notify_neighbors(block_detail* d);
 
     //! Called by pmt msg posters
-    void notify_msg()
-    {
-        gr::thread::scoped_lock guard(mutex);
-        input_changed = true;
-        input_cond.notify_one();
-        output_changed = true;
-        output_cond.notify_one();
-    }
+    void notify_msg();
+
+    //! Called by schedulers that don't dedicate a thread to the block
+    //! and need to hear about every notification; pass an empty
+    //! function to remove it again.
+    void set_wakeup(std::function<void()> f);
 
     //! Called by us
     void clear_changed()
     {
-        gr::thread::scoped_lock guard(mutex);
-        input_changed = false;
-        output_changed = false;
+        if (!d_eventcount) {
+            gr::thread::scoped_lock guard(mutex);
+            input_changed.store(false, std::memory_order_relaxed);
+            output_changed.store(false, std::memory_order_relaxed);
+            return;
+        }
+        input_changed.store(false, std::memory_order_relaxed);
+        output_changed.store(false, std::memory_order_relaxed);
+        // Order the stores before our next look at the buffers, so a
+        // notification for data we don't see yet isn't wiped out.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
     }
 
-private:
-    //! Used by notify_downstream
-    void set_input_changed()
+    //! Called by us when blocked on input; gives up after \p timeout_ms
+    //! milliseconds even if nobody notified us.
+    void wait_input(long timeout_ms)
     {
-        gr::thread::scoped_lock guard(mutex);
-        input_changed = true;
-        input_cond.notify_one();
+        wait_changed(input_changed, input_cond, timeout_ms);
     }
 
+    //! Called by us when blocked on output
+    void wait_output() { wait_changed(output_changed, output_cond, 0); }
+
+private:
+    std::atomic<int> d_nsleepers; // threads waiting on input_cond or output_cond
+    std::atomic<bool> d_has_wakeup;
+    int64_t d_spin_ns;     // current spin budget, only used by our thread
+    int64_t d_max_spin_ns; // upper bound of d_spin_ns
+    bool d_eventcount;     // lock-free flags, only worth it when spinning
+
+    void set_changed(std::atomic<bool>& changed, gr::thread::condition_variable& cond);
+    void wait_changed(std::atomic<bool>& changed,
+                      gr::thread::condition_variable& cond,
+                      long timeout_ms);
+    void sleep_changed(std::atomic<bool>& changed,
+                       gr::thread::condition_variable& cond,
+                       long timeout_ms);
+
+    //! Used by notify_downstream
+    void set_input_changed() { set_changed(input_changed, input_cond); }
+
     //! Used by notify_upstream
-    void set_output_changed()
-    {
-        gr::thread::scoped_lock guard(mutex);
-        output_changed = true;
-        output_cond.notify_one();
-    }
+    void set_output_changed() { set_changed(output_changed, output_cond); }
 };
 
 } /* namespace gr */
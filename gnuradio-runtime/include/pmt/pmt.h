@@ -40,42 +40,81 @@ namespace pmt {
 
 /*!
  * \brief base class of all pmt types
+ *
+ * Every pmt carries a tag saying what it is, so the accessors below
+ * can check and dispatch on it with a compare or a switch instead
+ * of a virtual call or a dynamic_cast.
  */
 class PMT_API pmt_base
 {
 
 public:
-    pmt_base(){};
+    enum type_tag : uint8_t {
+        OTHER = 0, // not one of ours
+        BOOL,
+        SYMBOL,
+        INTEGER,
+        UINT64,
+        REAL,
+        COMPLEX,
+        NIL,
+        PAIR,
+        DICT, // a pair as well
+        HASH_DICT, // from make_hash_dict(); not a pair
+        VECTOR,
+        TUPLE,
+        ANY,
+        // the uniform vectors, in one range
+        U8VECTOR,
+        S8VECTOR,
+        U16VECTOR,
+        S16VECTOR,
+        U32VECTOR,
+        S32VECTOR,
+        U64VECTOR,
+        S64VECTOR,
+        F32VECTOR,
+        F64VECTOR,
+        C32VECTOR,
+        C64VECTOR,
+    };
+
+    pmt_base(type_tag type = OTHER) : d_type(type){};
     pmt_base(const pmt_base&) = delete;
     virtual ~pmt_base();
 
-    virtual bool is_bool() const { return false; }
-    virtual bool is_symbol() const { return false; }
-    virtual bool is_number() const { return false; }
-    virtual bool is_integer() const { return false; }
-    virtual bool is_uint64() const { return false; }
-    virtual bool is_real() const { return false; }
-    virtual bool is_complex() const { return false; }
-    virtual bool is_null() const { return false; }
-    virtual bool is_pair() const { return false; }
-    virtual bool is_tuple() const { return false; }
-    virtual bool is_vector() const { return false; }
-    virtual bool is_dict() const { return false; }
-    virtual bool is_any() const { return false; }
-
-    virtual bool is_uniform_vector() const { return false; }
-    virtual bool is_u8vector() const { return false; }
-    virtual bool is_s8vector() const { return false; }
-    virtual bool is_u16vector() const { return false; }
-    virtual bool is_s16vector() const { return false; }
-    virtual bool is_u32vector() const { return false; }
-    virtual bool is_s32vector() const { return false; }
-    virtual bool is_u64vector() const { return false; }
-    virtual bool is_s64vector() const { return false; }
-    virtual bool is_f32vector() const { return false; }
-    virtual bool is_f64vector() const { return false; }
-    virtual bool is_c32vector() const { return false; }
-    virtual bool is_c64vector() const { return false; }
+    type_tag type() const { return d_type; }
+
+    bool is_bool() const { return d_type == BOOL; }
+    bool is_symbol() const { return d_type == SYMBOL; }
+    bool is_number() const { return d_type >= INTEGER && d_type <= COMPLEX; }
+    bool is_integer() const { return d_type == INTEGER; }
+    bool is_uint64() const { return d_type == UINT64; }
+    bool is_real() const { return d_type == REAL; }
+    bool is_complex() const { return d_type == COMPLEX; }
+    bool is_null() const { return d_type == NIL; }
+    bool is_pair() const { return d_type == PAIR || d_type == DICT; }
+    bool is_tuple() const { return d_type == TUPLE; }
+    bool is_vector() const { return d_type == VECTOR; }
+    bool is_dict() const { return d_type == DICT || d_type == HASH_DICT; }
+    bool is_any() const { return d_type == ANY; }
+
+    bool is_uniform_vector() const { return d_type >= U8VECTOR; }
+    bool is_u8vector() const { return d_type == U8VECTOR; }
+    bool is_s8vector() const { return d_type == S8VECTOR; }
+    bool is_u16vector() const { return d_type == U16VECTOR; }
+    bool is_s16vector() const { return d_type == S16VECTOR; }
+    bool is_u32vector() const { return d_type == U32VECTOR; }
+    bool is_s32vector() const { return d_type == S32VECTOR; }
+    bool is_u64vector() const { return d_type == U64VECTOR; }
+    bool is_s64vector() const { return d_type == S64VECTOR; }
+    bool is_f32vector() const { return d_type == F32VECTOR; }
+    bool is_f64vector() const { return d_type == F64VECTOR; }
+    bool is_c32vector() const { return d_type == C32VECTOR; }
+    bool is_c64vector() const { return d_type == C64VECTOR; }
+
+private:
+    const type_tag d_type;
 };
 
 /*!
@@ -86,25 +125,25 @@ typedef std::shared_ptr<pmt_base> pmt_t;
 class PMT_API exception : public std::logic_error
 {
 public:
-    exception(const std::string& msg, pmt_t obj);
+    exception(const std::string& msg, const pmt_t& obj);
 };
 
 class PMT_API wrong_type : public std::invalid_argument
 {
 public:
-    wrong_type(const std::string& msg, pmt_t obj);
+    wrong_type(const std::string& msg, const pmt_t& obj);
 };
 
 class PMT_API out_of_range : public exception
 {
 public:
-    out_of_range(const std::string& msg, pmt_t obj);
+    out_of_range(const std::string& msg, const pmt_t& obj);
 };
 
 class PMT_API notimplemented : public exception
 {
 public:
-    notimplemented(const std::string& msg, pmt_t obj);
+    notimplemented(const std::string& msg, const pmt_t& obj);
 };
 
 
@@ -114,10 +153,10 @@ public:
  * ------------------------------------------------------------------------
  */
 
-PMT_API pmt_t get_PMT_NIL();
-PMT_API pmt_t get_PMT_T();
-PMT_API pmt_t get_PMT_F();
-PMT_API pmt_t get_PMT_EOF();
+PMT_API const pmt_t& get_PMT_NIL();
+PMT_API const pmt_t& get_PMT_T();
+PMT_API const pmt_t& get_PMT_F();
+PMT_API const pmt_t& get_PMT_EOF();
 
 #define PMT_NIL get_PMT_NIL()
 #define PMT_T get_PMT_T()
@@ -135,20 +174,20 @@ PMT_API pmt_t get_PMT_EOF();
  */
 
 //! Return true if obj is \#t or \#f, else return false.
-PMT_API bool is_bool(pmt_t obj);
+PMT_API bool is_bool(const pmt_t& obj);
 
 //! Return false if obj is \#f, else return true.
-PMT_API bool is_true(pmt_t obj);
+PMT_API bool is_true(const pmt_t& obj);
 
 //! Return true if obj is \#f, else return true.
-PMT_API bool is_false(pmt_t obj);
+PMT_API bool is_false(const pmt_t& obj);
 
 //! Return \#f is val is false, else return \#t.
 PMT_API pmt_t from_bool(bool val);
 
 //! Return true if val is pmt::True, return false when val is pmt::PMT_F,
 // else raise wrong_type exception.
-PMT_API bool to_bool(pmt_t val);
+PMT_API bool to_bool(const pmt_t& val);
 
 /*
  * ------------------------------------------------------------------------
@@ -159,11 +198,16 @@ PMT_API bool to_bool(pmt_t val);
 //! Return true if obj is a symbol, else false.
 PMT_API bool is_symbol(const pmt_t& obj);
 
-//! Return the symbol whose name is \p s.
-PMT_API pmt_t string_to_symbol(const std::string& s);
+/*!
+ * \brief Return the symbol whose name is \p s.
+ *
+ * Symbols are never freed, so the reference stays valid.  Lookups of
+ * symbols that already exist take no lock.
+ */
+PMT_API const pmt_t& string_to_symbol(const std::string& s);
 
 //! Alias for pmt_string_to_symbol
-PMT_API pmt_t intern(const std::string& s);
+PMT_API const pmt_t& intern(const std::string& s);
 
 
 /*!
@@ -179,7 +223,7 @@ PMT_API const std::string symbol_to_string(const pmt_t& sym);
  */
 
 //! Return true if obj is any kind of number, else false.
-PMT_API bool is_number(pmt_t obj);
+PMT_API bool is_number(const pmt_t& obj);
 
 /*
  * ------------------------------------------------------------------------
@@ -188,7 +232,7 @@ PMT_API bool is_number(pmt_t obj);
  */
 
 //! Return true if \p x is an integer number, else false
-PMT_API bool is_integer(pmt_t x);
+PMT_API bool is_integer(const pmt_t& x);
 
 //! Return the pmt value that represents the integer \p x.
 PMT_API pmt_t from_long(long x);
@@ -200,7 +244,7 @@ PMT_API pmt_t from_long(long x);
  * return that integer.  Else raise an exception, either wrong_type
  * when x is not an exact integer, or out_of_range when it doesn't fit.
  */
-PMT_API long to_long(pmt_t x);
+PMT_API long to_long(const pmt_t& x);
 
 /*
  * ------------------------------------------------------------------------
@@ -209,7 +253,7 @@ PMT_API long to_long(pmt_t x);
  */
 
 //! Return true if \p x is an uint64 number, else false
-PMT_API bool is_uint64(pmt_t x);
+PMT_API bool is_uint64(const pmt_t& x);
 
 //! Return the pmt value that represents the uint64 \p x.
 PMT_API pmt_t from_uint64(uint64_t x);
@@ -221,7 +265,7 @@ PMT_API pmt_t from_uint64(uint64_t x);
  * return that uint64.  Else raise an exception, either wrong_type
  * when x is not an exact uint64, or out_of_range when it doesn't fit.
  */
-PMT_API uint64_t to_uint64(pmt_t x);
+PMT_API uint64_t to_uint64(const pmt_t& x);
 
 /*
  * ------------------------------------------------------------------------
@@ -232,7 +276,7 @@ PMT_API uint64_t to_uint64(pmt_t x);
 /*
  * \brief Return true if \p obj is a real number, else false.
  */
-PMT_API bool is_real(pmt_t obj);
+PMT_API bool is_real(const pmt_t& obj);
 
 //! Return the pmt value that represents double \p x.
 PMT_API pmt_t from_double(double x);
@@ -245,7 +289,7 @@ PMT_API pmt_t from_float(float x);
  * as a double.  The argument \p val must be a real or integer, otherwise
  * a wrong_type exception is raised.
  */
-PMT_API double to_double(pmt_t x);
+PMT_API double to_double(const pmt_t& x);
 
 /*!
  * \brief Convert pmt to float if possible.
@@ -254,7 +298,7 @@ PMT_API double to_double(pmt_t x);
  * the value as a double in any case. Use this when strict typing
  * is required.
  */
-PMT_API float to_float(pmt_t x);
+PMT_API float to_float(const pmt_t& x);
 
 /*
  * ------------------------------------------------------------------------
@@ -265,7 +309,7 @@ PMT_API float to_float(pmt_t x);
 /*!
  * \brief return true if \p obj is a complex number, false otherwise.
  */
-PMT_API bool is_complex(pmt_t obj);
+PMT_API bool is_complex(const pmt_t& obj);
 
 //! Return a complex number constructed of the given real and imaginary parts.
 PMT_API pmt_t make_rectangular(double re, double im);
@@ -286,7 +330,7 @@ PMT_API pmt_t pmt_from_complex(const std::complex<double>& z);
  * If \p z is complex, real or integer, return the closest complex<double>.
  * Otherwise, raise the wrong_type exception.
  */
-PMT_API std::complex<double> to_complex(pmt_t z);
+PMT_API std::complex<double> to_complex(const pmt_t& z);
 
 /*
  * ------------------------------------------------------------------------
@@ -310,17 +354,17 @@ PMT_API pmt_t car(const pmt_t& pair);
 PMT_API pmt_t cdr(const pmt_t& pair);
 
 //! Stores \p value in the car field of \p pair.
-PMT_API void set_car(pmt_t pair, pmt_t value);
+PMT_API void set_car(const pmt_t& pair, const pmt_t& value);
 
 //! Stores \p value in the cdr field of \p pair.
-PMT_API void set_cdr(pmt_t pair, pmt_t value);
+PMT_API void set_cdr(const pmt_t& pair, const pmt_t& value);
 
-PMT_API pmt_t caar(pmt_t pair);
-PMT_API pmt_t cadr(pmt_t pair);
-PMT_API pmt_t cdar(pmt_t pair);
-PMT_API pmt_t cddr(pmt_t pair);
-PMT_API pmt_t caddr(pmt_t pair);
-PMT_API pmt_t cadddr(pmt_t pair);
+PMT_API pmt_t caar(const pmt_t& pair);
+PMT_API pmt_t cadr(const pmt_t& pair);
+PMT_API pmt_t cdar(const pmt_t& pair);
+PMT_API pmt_t cddr(const pmt_t& pair);
+PMT_API pmt_t caddr(const pmt_t& pair);
+PMT_API pmt_t cadddr(const pmt_t& pair);
 
 /*
  * ------------------------------------------------------------------------
@@ -333,7 +377,7 @@ PMT_API pmt_t cadddr(pmt_t pair);
  */
 
 //! Return true if \p x is a tuple, otherwise false.
-PMT_API bool is_tuple(pmt_t x);
+PMT_API bool is_tuple(const pmt_t& x);
 
 PMT_API pmt_t make_tuple();
 PMT_API pmt_t make_tuple(const pmt_t& e0);
@@ -406,22 +450,22 @@ PMT_API pmt_t tuple_ref(const pmt_t& tuple, size_t k);
  */
 
 //! Return true if \p x is a vector, otherwise false.
-PMT_API bool is_vector(pmt_t x);
+PMT_API bool is_vector(const pmt_t& x);
 
 //! Make a vector of length \p k, with initial values set to \p fill
-PMT_API pmt_t make_vector(size_t k, pmt_t fill);
+PMT_API pmt_t make_vector(size_t k, const pmt_t& fill);
 
 /*!
  * Return the contents of position \p k of \p vector.
  * \p k must be a valid index of \p vector.
  */
-PMT_API pmt_t vector_ref(pmt_t vector, size_t k);
+PMT_API pmt_t vector_ref(const pmt_t& vector, size_t k);
 
 //! Store \p obj in position \p k.
-PMT_API void vector_set(pmt_t vector, size_t k, pmt_t obj);
+PMT_API void vector_set(const pmt_t& vector, size_t k, const pmt_t& obj);
 
 //! Store \p fill in every position of \p vector
-PMT_API void vector_fill(pmt_t vector, pmt_t fill);
+PMT_API void vector_fill(const pmt_t& vector, const pmt_t& fill);
 
 /*
  * ------------------------------------------------------------------------
@@ -432,7 +476,7 @@ PMT_API void vector_fill(pmt_t vector, pmt_t fill);
  */
 
 //! Return true if \p x is a blob, otherwise false.
-PMT_API bool is_blob(pmt_t x);
+PMT_API bool is_blob(const pmt_t& x);
 
 /*!
  * \brief Make a blob given a pointer and length in bytes
@@ -445,10 +489,10 @@ PMT_API bool is_blob(pmt_t x);
 PMT_API pmt_t make_blob(const void* buf, size_t len);
 
 //! Return a pointer to the blob's data
-PMT_API const void* blob_data(pmt_t blob);
+PMT_API const void* blob_data(const pmt_t& blob);
 
 //! Return the blob's length in bytes
-PMT_API size_t blob_length(pmt_t blob);
+PMT_API size_t blob_length(const pmt_t& blob);
 
 /*!
  * <pre>
@@ -478,23 +522,23 @@ PMT_API size_t blob_length(pmt_t blob);
  */
 
 //! true if \p x is any kind of uniform numeric vector
-PMT_API bool is_uniform_vector(pmt_t x);
-
-PMT_API bool is_u8vector(pmt_t x);
-PMT_API bool is_s8vector(pmt_t x);
-PMT_API bool is_u16vector(pmt_t x);
-PMT_API bool is_s16vector(pmt_t x);
-PMT_API bool is_u32vector(pmt_t x);
-PMT_API bool is_s32vector(pmt_t x);
-PMT_API bool is_u64vector(pmt_t x);
-PMT_API bool is_s64vector(pmt_t x);
-PMT_API bool is_f32vector(pmt_t x);
-PMT_API bool is_f64vector(pmt_t x);
-PMT_API bool is_c32vector(pmt_t x);
-PMT_API bool is_c64vector(pmt_t x);
+PMT_API bool is_uniform_vector(const pmt_t& x);
+
+PMT_API bool is_u8vector(const pmt_t& x);
+PMT_API bool is_s8vector(const pmt_t& x);
+PMT_API bool is_u16vector(const pmt_t& x);
+PMT_API bool is_s16vector(const pmt_t& x);
+PMT_API bool is_u32vector(const pmt_t& x);
+PMT_API bool is_s32vector(const pmt_t& x);
+PMT_API bool is_u64vector(const pmt_t& x);
+PMT_API bool is_s64vector(const pmt_t& x);
+PMT_API bool is_f32vector(const pmt_t& x);
+PMT_API bool is_f64vector(const pmt_t& x);
+PMT_API bool is_c32vector(const pmt_t& x);
+PMT_API bool is_c64vector(const pmt_t& x);
 
 //! item size in bytes if \p x is any kind of uniform numeric vector
-PMT_API size_t uniform_vector_itemsize(pmt_t x);
+PMT_API size_t uniform_vector_itemsize(const pmt_t& x);
 
 PMT_API pmt_t make_u8vector(size_t k, uint8_t fill);
 PMT_API pmt_t make_s8vector(size_t k, int8_t fill);
@@ -534,89 +578,84 @@ PMT_API pmt_t init_c32vector(size_t k, const std::vector<std::complex<float>>& d
 PMT_API pmt_t init_c64vector(size_t k, const std::complex<double>* data);
 PMT_API pmt_t init_c64vector(size_t k, const std::vector<std::complex<double>>& data);
 
-PMT_API uint8_t u8vector_ref(pmt_t v, size_t k);
-PMT_API int8_t s8vector_ref(pmt_t v, size_t k);
-PMT_API uint16_t u16vector_ref(pmt_t v, size_t k);
-PMT_API int16_t s16vector_ref(pmt_t v, size_t k);
-PMT_API uint32_t u32vector_ref(pmt_t v, size_t k);
-PMT_API int32_t s32vector_ref(pmt_t v, size_t k);
-PMT_API uint64_t u64vector_ref(pmt_t v, size_t k);
-PMT_API int64_t s64vector_ref(pmt_t v, size_t k);
-PMT_API float f32vector_ref(pmt_t v, size_t k);
-PMT_API double f64vector_ref(pmt_t v, size_t k);
-PMT_API std::complex<float> c32vector_ref(pmt_t v, size_t k);
-PMT_API std::complex<double> c64vector_ref(pmt_t v, size_t k);
-
-PMT_API void u8vector_set(pmt_t v, size_t k, uint8_t x); //< v[k] = x
-PMT_API void s8vector_set(pmt_t v, size_t k, int8_t x);
-PMT_API void u16vector_set(pmt_t v, size_t k, uint16_t x);
-PMT_API void s16vector_set(pmt_t v, size_t k, int16_t x);
-PMT_API void u32vector_set(pmt_t v, size_t k, uint32_t x);
-PMT_API void s32vector_set(pmt_t v, size_t k, int32_t x);
-PMT_API void u64vector_set(pmt_t v, size_t k, uint64_t x);
-PMT_API void s64vector_set(pmt_t v, size_t k, int64_t x);
-PMT_API void f32vector_set(pmt_t v, size_t k, float x);
-PMT_API void f64vector_set(pmt_t v, size_t k, double x);
-PMT_API void c32vector_set(pmt_t v, size_t k, std::complex<float> x);
-PMT_API void c64vector_set(pmt_t v, size_t k, std::complex<double> x);
+PMT_API uint8_t u8vector_ref(const pmt_t& v, size_t k);
+PMT_API int8_t s8vector_ref(const pmt_t& v, size_t k);
+PMT_API uint16_t u16vector_ref(const pmt_t& v, size_t k);
+PMT_API int16_t s16vector_ref(const pmt_t& v, size_t k);
+PMT_API uint32_t u32vector_ref(const pmt_t& v, size_t k);
+PMT_API int32_t s32vector_ref(const pmt_t& v, size_t k);
+PMT_API uint64_t u64vector_ref(const pmt_t& v, size_t k);
+PMT_API int64_t s64vector_ref(const pmt_t& v, size_t k);
+PMT_API float f32vector_ref(const pmt_t& v, size_t k);
+PMT_API double f64vector_ref(const pmt_t& v, size_t k);
+PMT_API std::complex<float> c32vector_ref(const pmt_t& v, size_t k);
+PMT_API std::complex<double> c64vector_ref(const pmt_t& v, size_t k);
+
+PMT_API void u8vector_set(const pmt_t& v, size_t k, uint8_t x); //< v[k] = x
+PMT_API void s8vector_set(const pmt_t& v, size_t k, int8_t x);
+PMT_API void u16vector_set(const pmt_t& v, size_t k, uint16_t x);
+PMT_API void s16vector_set(const pmt_t& v, size_t k, int16_t x);
+PMT_API void u32vector_set(const pmt_t& v, size_t k, uint32_t x);
+PMT_API void s32vector_set(const pmt_t& v, size_t k, int32_t x);
+PMT_API void u64vector_set(const pmt_t& v, size_t k, uint64_t x);
+PMT_API void s64vector_set(const pmt_t& v, size_t k, int64_t x);
+PMT_API void f32vector_set(const pmt_t& v, size_t k, float x);
+PMT_API void f64vector_set(const pmt_t& v, size_t k, double x);
+PMT_API void c32vector_set(const pmt_t& v, size_t k, std::complex<float> x);
+PMT_API void c64vector_set(const pmt_t& v, size_t k, std::complex<double> x);
 
 // Return const pointers to the elements
 
 PMT_API const void*
-uniform_vector_elements(pmt_t v, size_t& len); //< works with any; len is in bytes
-
-PMT_API const uint8_t* u8vector_elements(pmt_t v, size_t& len);   //< len is in elements
-PMT_API const int8_t* s8vector_elements(pmt_t v, size_t& len);    //< len is in elements
-PMT_API const uint16_t* u16vector_elements(pmt_t v, size_t& len); //< len is in elements
-PMT_API const int16_t* s16vector_elements(pmt_t v, size_t& len);  //< len is in elements
-PMT_API const uint32_t* u32vector_elements(pmt_t v, size_t& len); //< len is in elements
-PMT_API const int32_t* s32vector_elements(pmt_t v, size_t& len);  //< len is in elements
-PMT_API const uint64_t* u64vector_elements(pmt_t v, size_t& len); //< len is in elements
-PMT_API const int64_t* s64vector_elements(pmt_t v, size_t& len);  //< len is in elements
-PMT_API const float* f32vector_elements(pmt_t v, size_t& len);    //< len is in elements
-PMT_API const double* f64vector_elements(pmt_t v, size_t& len);   //< len is in elements
-PMT_API const std::complex<float>* c32vector_elements(pmt_t v,
-                                                      size_t& len); //< len is in elements
-PMT_API const std::complex<double>*
-c64vector_elements(pmt_t v, size_t& len); //< len is in elements
+uniform_vector_elements(const pmt_t& v, size_t& len); //< works with any; len is in bytes
+
+// len is in elements
+PMT_API const uint8_t* u8vector_elements(const pmt_t& v, size_t& len);
+PMT_API const int8_t* s8vector_elements(const pmt_t& v, size_t& len);
+PMT_API const uint16_t* u16vector_elements(const pmt_t& v, size_t& len);
+PMT_API const int16_t* s16vector_elements(const pmt_t& v, size_t& len);
+PMT_API const uint32_t* u32vector_elements(const pmt_t& v, size_t& len);
+PMT_API const int32_t* s32vector_elements(const pmt_t& v, size_t& len);
+PMT_API const uint64_t* u64vector_elements(const pmt_t& v, size_t& len);
+PMT_API const int64_t* s64vector_elements(const pmt_t& v, size_t& len);
+PMT_API const float* f32vector_elements(const pmt_t& v, size_t& len);
+PMT_API const double* f64vector_elements(const pmt_t& v, size_t& len);
+PMT_API const std::complex<float>* c32vector_elements(const pmt_t& v, size_t& len);
+PMT_API const std::complex<double>* c64vector_elements(const pmt_t& v, size_t& len);
 
 // len is in elements
-PMT_API const std::vector<uint8_t> u8vector_elements(pmt_t v);
-PMT_API const std::vector<int8_t> s8vector_elements(pmt_t v);
-PMT_API const std::vector<uint16_t> u16vector_elements(pmt_t v);
-PMT_API const std::vector<int16_t> s16vector_elements(pmt_t v);
-PMT_API const std::vector<uint32_t> u32vector_elements(pmt_t v);
-PMT_API const std::vector<int32_t> s32vector_elements(pmt_t v);
-PMT_API const std::vector<uint64_t> u64vector_elements(pmt_t v);
-PMT_API const std::vector<int64_t> s64vector_elements(pmt_t v);
-PMT_API const std::vector<float> f32vector_elements(pmt_t v);
-PMT_API const std::vector<double> f64vector_elements(pmt_t v);
-PMT_API const std::vector<std::complex<float>> c32vector_elements(pmt_t v);
-PMT_API const std::vector<std::complex<double>> c64vector_elements(pmt_t v);
+PMT_API const std::vector<uint8_t> u8vector_elements(const pmt_t& v);
+PMT_API const std::vector<int8_t> s8vector_elements(const pmt_t& v);
+PMT_API const std::vector<uint16_t> u16vector_elements(const pmt_t& v);
+PMT_API const std::vector<int16_t> s16vector_elements(const pmt_t& v);
+PMT_API const std::vector<uint32_t> u32vector_elements(const pmt_t& v);
+PMT_API const std::vector<int32_t> s32vector_elements(const pmt_t& v);
+PMT_API const std::vector<uint64_t> u64vector_elements(const pmt_t& v);
+PMT_API const std::vector<int64_t> s64vector_elements(const pmt_t& v);
+PMT_API const std::vector<float> f32vector_elements(const pmt_t& v);
+PMT_API const std::vector<double> f64vector_elements(const pmt_t& v);
+PMT_API const std::vector<std::complex<float>> c32vector_elements(const pmt_t& v);
+PMT_API const std::vector<std::complex<double>> c64vector_elements(const pmt_t& v);
 
 // Return non-const pointers to the elements
 
 PMT_API void*
-uniform_vector_writable_elements(pmt_t v,
+uniform_vector_writable_elements(const pmt_t& v,
                                  size_t& len); //< works with any; len is in bytes
 
-PMT_API uint8_t* u8vector_writable_elements(pmt_t v, size_t& len); //< len is in elements
-PMT_API int8_t* s8vector_writable_elements(pmt_t v, size_t& len);  //< len is in elements
-PMT_API uint16_t* u16vector_writable_elements(pmt_t v,
-                                              size_t& len);         //< len is in elements
-PMT_API int16_t* s16vector_writable_elements(pmt_t v, size_t& len); //< len is in elements
-PMT_API uint32_t* u32vector_writable_elements(pmt_t v,
-                                              size_t& len);         //< len is in elements
-PMT_API int32_t* s32vector_writable_elements(pmt_t v, size_t& len); //< len is in elements
-PMT_API uint64_t* u64vector_writable_elements(pmt_t v,
-                                              size_t& len);         //< len is in elements
-PMT_API int64_t* s64vector_writable_elements(pmt_t v, size_t& len); //< len is in elements
-PMT_API float* f32vector_writable_elements(pmt_t v, size_t& len);   //< len is in elements
-PMT_API double* f64vector_writable_elements(pmt_t v, size_t& len);  //< len is in elements
-PMT_API std::complex<float>*
-c32vector_writable_elements(pmt_t v, size_t& len); //< len is in elements
-PMT_API std::complex<double>*
-c64vector_writable_elements(pmt_t v, size_t& len); //< len is in elements
+// len is in elements
+PMT_API uint8_t* u8vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API int8_t* s8vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API uint16_t* u16vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API int16_t* s16vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API uint32_t* u32vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API int32_t* s32vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API uint64_t* u64vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API int64_t* s64vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API float* f32vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API double* f64vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API std::complex<float>* c32vector_writable_elements(const pmt_t& v, size_t& len);
+PMT_API std::complex<double>* c64vector_writable_elements(const pmt_t& v, size_t& len);
 
 /*
  * ------------------------------------------------------------------------
@@ -625,6 +664,14 @@ c64vector_writable_elements(pmt_t v, size_t& len); //< len is in elements
  * This is a functional data structure that is persistent.  Updating a
  * functional data structure does not destroy the existing version, but
  * rather creates a new version that coexists with the old.
+ *
+ * Dictionaries made by make_dict are a-lists: lists of (key . value)
+ * pairs, most recently added first, however many entries they have.
+ * make_hash_dict makes one that is kept in a hash array mapped trie
+ * instead, which shares all but the changed path with the versions
+ * before it, for dictionaries of many entries.  A dictionary of that
+ * kind is not a pair; dict_items and friends list its entries in the
+ * order an a-list would have had them.
  * ------------------------------------------------------------------------
  */
 
@@ -638,6 +685,14 @@ PMT_API pmt_t dcons(const pmt_t& x, const pmt_t& y);
 //! Make an empty dictionary
 PMT_API pmt_t make_dict();
 
+/*!
+ * Make an empty dictionary kept in a hash trie.  Looking up and adding
+ * entries doesn't walk the whole dictionary, so this is the one to use
+ * for dictionaries of more than a few entries.  It is not a pair, walk it
+ * with dict_items().
+ */
+PMT_API pmt_t make_hash_dict();
+
 //! Return a new dictionary with \p key associated with \p value.
 PMT_API pmt_t dict_add(const pmt_t& dict, const pmt_t& key, const pmt_t& value);
 
@@ -651,16 +706,16 @@ PMT_API bool dict_has_key(const pmt_t& dict, const pmt_t& key);
 PMT_API pmt_t dict_ref(const pmt_t& dict, const pmt_t& key, const pmt_t& not_found);
 
 //! Return list of (key . value) pairs
-PMT_API pmt_t dict_items(pmt_t dict);
+PMT_API pmt_t dict_items(const pmt_t& dict);
 
 //! Return list of keys
-PMT_API pmt_t dict_keys(pmt_t dict);
+PMT_API pmt_t dict_keys(const pmt_t& dict);
 
 //! Return a new dictionary \p dict1 with k=>v pairs from \p dict2 added.
 PMT_API pmt_t dict_update(const pmt_t& dict1, const pmt_t& dict2);
 
 //! Return list of values
-PMT_API pmt_t dict_values(pmt_t dict);
+PMT_API pmt_t dict_values(const pmt_t& dict);
 
 /*
  * ------------------------------------------------------------------------
@@ -672,16 +727,16 @@ PMT_API pmt_t dict_values(pmt_t dict);
  */
 
 //! Return true if \p obj is an any
-PMT_API bool is_any(pmt_t obj);
+PMT_API bool is_any(const pmt_t& obj);
 
 //! make an any
 PMT_API pmt_t make_any(const boost::any& any);
 
 //! Return underlying boost::any
-PMT_API boost::any any_ref(pmt_t obj);
+PMT_API boost::any any_ref(const pmt_t& obj);
 
 //! Store \p any in \p obj
-PMT_API void any_set(pmt_t obj, const boost::any& any);
+PMT_API void any_set(const pmt_t& obj, const boost::any& any);
 
 
 /*
@@ -751,7 +806,7 @@ PMT_API size_t length(const pmt_t& v);
  * in \p alist has \p obj as its car then \#f is returned.
  * Uses pmt::eq to compare \p obj with car fields of the pairs in \p alist.
  */
-PMT_API pmt_t assq(pmt_t obj, pmt_t alist);
+PMT_API pmt_t assq(const pmt_t& obj, const pmt_t& alist);
 
 /*!
  * \brief Find the first pair in \p alist whose car field is \p obj
@@ -761,7 +816,7 @@ PMT_API pmt_t assq(pmt_t obj, pmt_t alist);
  * in \p alist has \p obj as its car then \#f is returned.
  * Uses pmt::eqv to compare \p obj with car fields of the pairs in \p alist.
  */
-PMT_API pmt_t assv(pmt_t obj, pmt_t alist);
+PMT_API pmt_t assv(const pmt_t& obj, const pmt_t& alist);
 
 /*!
  * \brief Find the first pair in \p alist whose car field is \p obj
@@ -771,7 +826,7 @@ PMT_API pmt_t assv(pmt_t obj, pmt_t alist);
  * in \p alist has \p obj as its car then \#f is returned.
  * Uses pmt::equal to compare \p obj with car fields of the pairs in \p alist.
  */
-PMT_API pmt_t assoc(pmt_t obj, pmt_t alist);
+PMT_API pmt_t assoc(const pmt_t& obj, const pmt_t& alist);
 
 /*!
  * \brief Apply \p proc element-wise to the elements of list and returns
@@ -780,64 +835,67 @@ PMT_API pmt_t assoc(pmt_t obj, pmt_t alist);
  * \p list must be a list.  The dynamic order in which \p proc is
  * applied to the elements of \p list is unspecified.
  */
-PMT_API pmt_t map(pmt_t proc(const pmt_t&), pmt_t list);
+PMT_API pmt_t map(pmt_t proc(const pmt_t&), const pmt_t& list);
 
 /*!
  * \brief reverse \p list.
  *
  * \p list must be a proper list.
  */
-PMT_API pmt_t reverse(pmt_t list);
+PMT_API pmt_t reverse(const pmt_t& list);
 
 /*!
  * \brief destructively reverse \p list.
  *
  * \p list must be a proper list.
  */
-PMT_API pmt_t reverse_x(pmt_t list);
+PMT_API pmt_t reverse_x(const pmt_t& list);
 
 /*!
  * \brief (acons x y a) == (cons (cons x y) a)
  */
-inline static pmt_t acons(pmt_t x, pmt_t y, pmt_t a) { return dcons(cons(x, y), a); }
+inline static pmt_t acons(const pmt_t& x, const pmt_t& y, const pmt_t& a)
+{
+    return dcons(cons(x, y), a);
+}
 
 /*!
  * \brief locates \p nth element of \n list where the car is the 'zeroth' element.
  */
-PMT_API pmt_t nth(size_t n, pmt_t list);
+PMT_API pmt_t nth(size_t n, const pmt_t& list);
 
 /*!
  * \brief returns the tail of \p list that would be obtained by calling
  * cdr \p n times in succession.
  */
-PMT_API pmt_t nthcdr(size_t n, pmt_t list);
+PMT_API pmt_t nthcdr(size_t n, const pmt_t& list);
 
 /*!
  * \brief Return the first sublist of \p list whose car is \p obj.
  * If \p obj does not occur in \p list, then \#f is returned.
  * pmt::memq use pmt::eq to compare \p obj with the elements of \p list.
  */
-PMT_API pmt_t memq(pmt_t obj, pmt_t list);
+PMT_API pmt_t memq(const pmt_t& obj, const pmt_t& list);
 
 /*!
  * \brief Return the first sublist of \p list whose car is \p obj.
  * If \p obj does not occur in \p list, then \#f is returned.
  * pmt::memv use pmt::eqv to compare \p obj with the elements of \p list.
  */
-PMT_API pmt_t memv(pmt_t obj, pmt_t list);
+PMT_API pmt_t memv(const pmt_t& obj, const pmt_t& list);
 
 /*!
  * \brief Return the first sublist of \p list whose car is \p obj.
  * If \p obj does not occur in \p list, then \#f is returned.
  * pmt::member use pmt::equal to compare \p obj with the elements of \p list.
  */
-PMT_API pmt_t member(pmt_t obj, pmt_t list);
+PMT_API pmt_t member(const pmt_t& obj, const pmt_t& list);
 
 /*!
  * \brief Return true if every element of \p list1 appears in \p list2, and false
  * otherwise. Comparisons are done with pmt::eqv.
  */
-PMT_API bool subsetp(pmt_t list1, pmt_t list2);
+PMT_API bool subsetp(const pmt_t& list1, const pmt_t& list2);
 
 /*!
  * \brief Return a list of length 1 containing \p x1
@@ -879,17 +937,17 @@ PMT_API pmt_t list6(const pmt_t& x1,
 /*!
  * \brief Return \p list with \p item added to it.
  */
-PMT_API pmt_t list_add(pmt_t list, const pmt_t& item);
+PMT_API pmt_t list_add(const pmt_t& list, const pmt_t& item);
 
 /*!
  * \brief Return \p list with \p item removed from it.
  */
-PMT_API pmt_t list_rm(pmt_t list, const pmt_t& item);
+PMT_API pmt_t list_rm(const pmt_t& list, const pmt_t& item);
 
 /*!
  * \brief Return bool of \p list contains \p item
  */
-PMT_API bool list_has(pmt_t list, const pmt_t& item);
+PMT_API bool list_has(const pmt_t& list, const pmt_t& item);
 
 
 /*
@@ -899,7 +957,7 @@ PMT_API bool list_has(pmt_t list, const pmt_t& item);
  */
 
 //! return true if obj is the EOF object, otherwise return false.
-PMT_API bool is_eof_object(pmt_t obj);
+PMT_API bool is_eof_object(const pmt_t& obj);
 
 /*!
  * read converts external representations of pmt objects into the
@@ -921,21 +979,21 @@ PMT_API pmt_t read(std::istream& port);
 /*!
  * Write a written representation of \p obj to the given \p port.
  */
-PMT_API void write(pmt_t obj, std::ostream& port);
+PMT_API void write(const pmt_t& obj, std::ostream& port);
 
 /*!
  * Return a string representation of \p obj.
  * This is the same output as would be generated by pmt::write.
  */
-PMT_API std::string write_string(pmt_t obj);
+PMT_API std::string write_string(const pmt_t& obj);
 
 
-PMT_API std::ostream& operator<<(std::ostream& os, pmt_t obj);
+PMT_API std::ostream& operator<<(std::ostream& os, const pmt_t& obj);
 
 /*!
  * \brief Write pmt string representation to stdout.
  */
-PMT_API void print(pmt_t v);
+PMT_API void print(const pmt_t& v);
 
 
 /*
@@ -946,20 +1004,41 @@ PMT_API void print(pmt_t v);
 /*!
  * \brief Write portable byte-serial representation of \p obj to \p sink
  */
-PMT_API bool serialize(pmt_t obj, std::streambuf& sink);
+PMT_API bool serialize(const pmt_t& obj, std::streambuf& sink);
 
 /*!
  * \brief Create obj from portable byte-serial representation
  */
 PMT_API pmt_t deserialize(std::streambuf& source);
 
+/*!
+ * \brief Number of bytes serialize() writes for \p obj
+ */
+PMT_API size_t serialized_size(const pmt_t& obj);
+
+/*!
+ * \brief Write the bytes serialize() would to the \p len bytes at \p buf
+ *
+ * Returns the number of bytes written; throws pmt::out_of_range if
+ * \p len is less than serialized_size(obj).
+ */
+PMT_API size_t serialize_to_buffer(const pmt_t& obj, void* buf, size_t len);
+
+/*!
+ * \brief Create the obj at the start of the \p len bytes at \p buf
+ *
+ * Sets \p used to the number of bytes it took up.  Returns PMT_EOF if
+ * \p len is 0, and throws on malformed or truncated input.
+ */
+PMT_API pmt_t deserialize_from_buffer(const void* buf, size_t len, size_t& used);
+
 
 PMT_API void dump_sizeof(); // debugging
 
 /*!
  * \brief Provide a simple string generating interface to pmt's serialize function
  */
-PMT_API std::string serialize_str(pmt_t obj);
+PMT_API std::string serialize_str(const pmt_t& obj);
 
 /*!
  * \brief Provide a simple string generating interface to pmt's deserialize function
@@ -21,10 +21,10 @@
 namespace pmt {
 
 //! Make pmt symbol
-static inline pmt_t mp(const std::string& s) { return string_to_symbol(s); }
+static inline const pmt_t& mp(const std::string& s) { return string_to_symbol(s); }
 
 //! Make pmt symbol
-static inline pmt_t mp(const char* s) { return string_to_symbol(s); }
+static inline const pmt_t& mp(const char* s) { return string_to_symbol(s); }
 
 //! Make pmt long
 static inline pmt_t mp(long x) { return from_long(x); }
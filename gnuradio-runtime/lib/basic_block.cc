@@ -73,7 +73,12 @@ void basic_block::message_port_register_in(pmt::pmt_t port_id)
     if (!pmt::is_symbol(port_id)) {
         throw std::runtime_error("message_port_register_in: bad port id");
     }
-    msg_queue[port_id] = msg_queue_t();
+    if (msg_queue.count(port_id))
+        return;
+    if (d_msg_ports_fixed)
+        throw std::runtime_error(
+            "message_port_register_in: can't add ports once the block was started");
+    msg_queue.try_emplace(port_id);
 }
 
 pmt::pmt_t basic_block::message_ports_in()
@@ -93,31 +98,39 @@ void basic_block::message_port_register_out(pmt::pmt_t port_id)
     if (!pmt::is_symbol(port_id)) {
         throw std::runtime_error("message_port_register_out: bad port id");
     }
-    if (pmt::dict_has_key(d_message_subscribers, port_id)) {
+    pmt::pmt_t subscribers = std::atomic_load(&d_message_subscribers);
+    if (pmt::dict_has_key(subscribers, port_id)) {
         throw std::runtime_error("message_port_register_out: port already in use");
     }
-    d_message_subscribers = pmt::dict_add(d_message_subscribers, port_id, pmt::PMT_NIL);
+    std::atomic_store(&d_message_subscribers,
+                      pmt::dict_add(subscribers, port_id, pmt::PMT_NIL));
 }
 
 pmt::pmt_t basic_block::message_ports_out()
 {
-    size_t len = pmt::length(d_message_subscribers);
+    pmt::pmt_t subscribers = std::atomic_load(&d_message_subscribers);
+    size_t len = pmt::length(subscribers);
     pmt::pmt_t port_names = pmt::make_vector(len, pmt::PMT_NIL);
-    pmt::pmt_t keys = pmt::dict_keys(d_message_subscribers);
+    pmt::pmt_t keys = pmt::dict_keys(subscribers);
     for (size_t i = 0; i < len; i++) {
         pmt::vector_set(port_names, i, pmt::nth(i, keys));
     }
     return port_names;
 }
 
-//  - publish a message on a message port
-void basic_block::message_port_pub(pmt::pmt_t port_id, pmt::pmt_t msg)
+// Posts msgs, in order, to every block subscribed to port_id
+static void post_to_subscribers(pmt::pmt_t subscribers,
+                                pmt::pmt_t port_id,
+                                const pmt::pmt_t* msgs,
+                                size_t nmsgs)
 {
-    if (!pmt::dict_has_key(d_message_subscribers, port_id)) {
+    if (!pmt::dict_has_key(subscribers, port_id)) {
         throw std::runtime_error("port does not exist");
     }
+    if (nmsgs == 0)
+        return;
 
-    pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers, port_id, pmt::PMT_NIL);
+    pmt::pmt_t currlist = pmt::dict_ref(subscribers, port_id, pmt::PMT_NIL);
     // iterate through subscribers on port
     while (pmt::is_pair(currlist)) {
         pmt::pmt_t target = pmt::car(currlist);
@@ -127,31 +140,48 @@ void basic_block::message_port_pub(pmt::pmt_t port_id, pmt::pmt_t msg)
 
         currlist = pmt::cdr(currlist);
         basic_block_sptr blk = global_block_registry.block_lookup(block);
-        // blk->post(msg);
-        blk->post(port, msg);
+        for (size_t i = 0; i < nmsgs; i++) {
+            blk->post(port, msgs[i]);
+        }
     }
 }
 
+//  - publish a message on a message port
+void basic_block::message_port_pub(pmt::pmt_t port_id, pmt::pmt_t msg)
+{
+    post_to_subscribers(std::atomic_load(&d_message_subscribers), port_id, &msg, 1);
+}
+
+void basic_block::message_port_pub_batch(pmt::pmt_t port_id,
+                                         const std::vector<pmt::pmt_t>& msgs)
+{
+    post_to_subscribers(
+        std::atomic_load(&d_message_subscribers), port_id, msgs.data(), msgs.size());
+}
+
 //  - subscribe to a message port
 void basic_block::message_port_sub(pmt::pmt_t port_id, pmt::pmt_t target)
 {
-    if (!pmt::dict_has_key(d_message_subscribers, port_id)) {
+    pmt::pmt_t subscribers = std::atomic_load(&d_message_subscribers);
+    if (!pmt::dict_has_key(subscribers, port_id)) {
         std::stringstream ss;
         ss << "Port does not exist: \"" << pmt::write_string(port_id)
            << "\" on block: " << pmt::write_string(target) << std::endl;
         throw std::runtime_error(ss.str());
     }
-    pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers, port_id, pmt::PMT_NIL);
+    pmt::pmt_t currlist = pmt::dict_ref(subscribers, port_id, pmt::PMT_NIL);
 
     // ignore re-adds of the same target
     if (!pmt::list_has(currlist, target))
-        d_message_subscribers = pmt::dict_add(
-            d_message_subscribers, port_id, pmt::list_add(currlist, target));
+        std::atomic_store(
+            &d_message_subscribers,
+            pmt::dict_add(subscribers, port_id, pmt::list_add(currlist, target)));
 }
 
 void basic_block::message_port_unsub(pmt::pmt_t port_id, pmt::pmt_t target)
 {
-    if (!pmt::dict_has_key(d_message_subscribers, port_id)) {
+    pmt::pmt_t subscribers = std::atomic_load(&d_message_subscribers);
+    if (!pmt::dict_has_key(subscribers, port_id)) {
         std::stringstream ss;
         ss << "Port does not exist: \"" << pmt::write_string(port_id)
            << "\" on block: " << pmt::write_string(target) << std::endl;
@@ -159,9 +189,10 @@ void basic_block::message_port_unsub(pmt::pmt_t port_id, pmt::pmt_t target)
     }
 
     // ignore unsubs of unknown targets
-    pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers, port_id, pmt::PMT_NIL);
-    d_message_subscribers =
-        pmt::dict_add(d_message_subscribers, port_id, pmt::list_rm(currlist, target));
+    pmt::pmt_t currlist = pmt::dict_ref(subscribers, port_id, pmt::PMT_NIL);
+    std::atomic_store(
+        &d_message_subscribers,
+        pmt::dict_add(subscribers, port_id, pmt::list_rm(currlist, target)));
 }
 
 void basic_block::_post(pmt::pmt_t which_port, pmt::pmt_t msg)
@@ -171,7 +202,8 @@ void basic_block::_post(pmt::pmt_t which_port, pmt::pmt_t msg)
 
 void basic_block::insert_tail(pmt::pmt_t which_port, pmt::pmt_t msg)
 {
-    gr::thread::scoped_lock guard(mutex);
+    // No ports are added once the block was started (see
+    // message_port_register_in), so the map is searched without a lock.
     const auto& queue = msg_queue.find(which_port);
     if (queue == msg_queue.end()) {
         GR_LOG_ERROR(d_logger,
@@ -180,29 +212,29 @@ void basic_block::insert_tail(pmt::pmt_t which_port, pmt::pmt_t msg)
         throw std::runtime_error("attempted to insert_tail on invalid queue!");
     }
 
-    queue->second.push_back(msg);
+    queue->second.push(msg);
 
     // wake up thread if BLKD_IN or BLKD_OUT
-    global_block_registry.notify_blk(d_symbol_name);
+    notify_msg_handler();
 }
 
 pmt::pmt_t basic_block::delete_head_nowait(pmt::pmt_t which_port)
 {
-    gr::thread::scoped_lock guard(mutex);
-
-    if (empty_p(which_port)) {
-        return pmt::pmt_t();
-    }
+    const auto& queue = msg_queue.find(which_port);
+    if (queue == msg_queue.end())
+        throw std::runtime_error("port does not exist!");
 
-    pmt::pmt_t m(msg_queue[which_port].front());
-    msg_queue[which_port].pop_front();
+    return queue->second.pop();
+}
 
-    return m;
+void basic_block::notify_msg_handler()
+{
+    global_block_registry.notify_blk(d_symbol_name);
 }
 
 pmt::pmt_t basic_block::message_subscribers(pmt::pmt_t port)
 {
-    return pmt::dict_ref(d_message_subscribers, port, pmt::PMT_NIL);
+    return pmt::dict_ref(std::atomic_load(&d_message_subscribers), port, pmt::PMT_NIL);
 }
 
 
@@ -40,6 +40,8 @@ block::block(const std::string& name,
       d_is_unaligned(false),
       d_relative_rate(1.0),
       d_mp_relative_rate(1.0),
+      d_rrate_num(1),
+      d_rrate_den(1),
       d_history(1),
       d_attr_delay(0),
       d_fixed_rate(false),
@@ -131,6 +133,20 @@ void block::set_unaligned(int na)
 
 void block::set_is_unaligned(bool u) { d_is_unaligned = u; }
 
+// The numerator and denominator of \p q if both fit in 64 bits and
+// there are 128 bit integers to multiply offsets by them, else 0 / 0
+static void u64_ratio(const mpq_class& q, uint64_t& num, uint64_t& den)
+{
+    num = den = 0;
+#ifdef __SIZEOF_INT128__
+    if (mpz_sizeinbase(q.get_num_mpz_t(), 2) <= 64 &&
+        mpz_sizeinbase(q.get_den_mpz_t(), 2) <= 64) {
+        mpz_export(&num, nullptr, 1, sizeof(num), 0, 0, q.get_num_mpz_t());
+        mpz_export(&den, nullptr, 1, sizeof(den), 0, 0, q.get_den_mpz_t());
+    }
+#endif
+}
+
 void block::set_relative_rate(double relative_rate)
 {
     if (relative_rate <= 0.0)
@@ -139,6 +155,7 @@ void block::set_relative_rate(double relative_rate)
 
     d_relative_rate = relative_rate;
     d_mp_relative_rate = mpq_class(relative_rate);
+    u64_ratio(d_mp_relative_rate, d_rrate_num, d_rrate_den);
 }
 
 void block::set_inverse_relative_rate(double inverse_relative_rate)
@@ -168,6 +185,32 @@ void block::set_relative_rate(uint64_t interpolation, uint64_t decimation)
     d_mp_relative_rate = mpq_class(interp, decim);
     d_mp_relative_rate.canonicalize();
     d_relative_rate = d_mp_relative_rate.get_d();
+    u64_ratio(d_mp_relative_rate, d_rrate_num, d_rrate_den);
+}
+
+void block::rescale_tag_offsets(std::vector<tag_t>& tags) const
+{
+#ifdef __SIZEOF_INT128__
+    if (d_rrate_den != 0) {
+        // floor(offset * num / den + 1/2) without overflow: the
+        // product has at most 128 bits and the remainder decides the
+        // rounding. Like mpz_class::get_ui(), keep the low 64 bits.
+        for (auto& t : tags) {
+            unsigned __int128 x = (unsigned __int128)t.offset * d_rrate_num;
+            unsigned __int128 r = x % d_rrate_den;
+            t.offset = (uint64_t)(x / d_rrate_den + (2 * r >= d_rrate_den));
+        }
+        return;
+    }
+#endif
+
+    static const mpq_class one_half(1, 2);
+    mpz_class offset;
+    for (auto& t : tags) {
+        mpz_import(offset.get_mpz_t(), 1, 1, sizeof(t.offset), 0, 0, &t.offset);
+        offset = offset * d_mp_relative_rate + one_half;
+        t.offset = offset.get_ui();
+    }
 }
 
 void block::consume(int which_input, int how_many_items)
@@ -740,6 +783,15 @@ float block::pc_throughput_avg()
     }
 }
 
+std::vector<float> block::pc_numa_node_bytes()
+{
+    if (d_detail) {
+        return d_detail->pc_numa_node_bytes();
+    } else {
+        return std::vector<float>(1, 0);
+    }
+}
+
 void block::reset_perf_counters()
 {
     if (d_detail) {
@@ -748,6 +800,14 @@ void block::reset_perf_counters()
 }
 
 
+void block::notify_msg_handler()
+{
+    // Not having a detail just means the block hasn't been started yet
+    block_detail_sptr detail = d_detail;
+    if (detail)
+        detail->d_tpb.notify_msg();
+}
+
 void block::system_handler(pmt::pmt_t msg)
 {
     // std::cout << "system_handler " << msg << "\n";
@@ -772,15 +832,16 @@ std::string block::log_level()
 
 void block::notify_msg_neighbors()
 {
-    size_t len = pmt::length(d_message_subscribers);
+    pmt::pmt_t subscribers = std::atomic_load(&d_message_subscribers);
+    size_t len = pmt::length(subscribers);
     pmt::pmt_t port_names = pmt::make_vector(len, pmt::PMT_NIL);
-    pmt::pmt_t keys = pmt::dict_keys(d_message_subscribers);
+    pmt::pmt_t keys = pmt::dict_keys(subscribers);
     for (size_t i = 0; i < len; i++) {
         // for each output port
         pmt::pmt_t oport = pmt::nth(i, keys);
 
         // for each subscriber on this port
-        pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers, oport, pmt::PMT_NIL);
+        pmt::pmt_t currlist = pmt::dict_ref(subscribers, oport, pmt::PMT_NIL);
 
         // iterate through subscribers on port
         while (pmt::is_pair(currlist)) {
@@ -1019,6 +1080,18 @@ void block::setup_pc_rpc()
         "Var. of how full output buffers are",
         RPC_PRIVLVL_MIN,
         DISPTIME | DISPOPTSTRIP));
+
+    d_rpc_vars.emplace_back(new rpcbasic_register_get<block, std::vector<float>>(
+        alias(),
+        "numa node bytes",
+        &block::pc_numa_node_bytes,
+        pmt::make_f32vector(0, 0),
+        pmt::make_f32vector(0, 1e9),
+        pmt::make_f32vector(0, 0),
+        "bytes",
+        "Output buffer bytes on each NUMA node",
+        RPC_PRIVLVL_MIN,
+        DISPTIME | DISPOPTSTRIP));
 #endif /* defined(GR_CTRLPORT) && defined(GR_PERFORMANCE_COUNTERS) */
 }
 
@@ -12,6 +12,7 @@
 #include "config.h"
 #endif
 
+#include "numa.h"
 #include <gnuradio/block_detail.h>
 #include <gnuradio/buffer.h>
 #include <gnuradio/buffer_reader.h>
@@ -30,6 +31,7 @@ block_detail::block_detail(unsigned int ninputs, unsigned int noutputs)
       d_input(ninputs),
       d_output(noutputs),
       d_done(false),
+      d_numa_node(-1),
       d_ins_noutput_items(0),
       d_avg_noutput_items(0),
       d_var_noutput_items(0),
@@ -46,6 +48,7 @@ block_detail::block_detail(unsigned int ninputs, unsigned int noutputs)
       d_ins_work_time(0),
       d_avg_work_time(0),
       d_var_work_time(0),
+      d_total_work_time(0),
       d_avg_throughput(0),
       d_pc_counter(0)
 {
@@ -232,7 +235,10 @@ void block_detail::set_processor_affinity(const std::vector<int>& mask)
 void block_detail::unset_processor_affinity()
 {
     if (threaded) {
-        gr::thread::thread_unbind(thread);
+        if (d_numa_node >= 0)
+            gr::thread::thread_bind_to_processor(thread, numa::node_cpus(d_numa_node));
+        else
+            gr::thread::thread_unbind(thread);
     }
 }
 
@@ -277,7 +283,7 @@ void block_detail::stop_perf_counters(int noutput_items, int nproduced)
         d_pc_start_time = (float)gr::high_res_timer_now();
         for (size_t i = 0; i < d_input.size(); i++) {
             buffer_reader_sptr in_buf = d_input[i];
-            gr::thread::scoped_lock guard(*in_buf->mutex());
+            gr::thread::scoped_lock guard = in_buf->buffer()->index_lock();
             float pfull = static_cast<float>(in_buf->items_available()) /
                           static_cast<float>(in_buf->max_possible_items_available());
             d_ins_input_buffers_full[i] = pfull;
@@ -286,7 +292,7 @@ void block_detail::stop_perf_counters(int noutput_items, int nproduced)
         }
         for (size_t i = 0; i < d_output.size(); i++) {
             buffer_sptr out_buf = d_output[i];
-            gr::thread::scoped_lock guard(*out_buf->mutex());
+            gr::thread::scoped_lock guard = out_buf->index_lock();
             float pfull = 1.0f - static_cast<float>(out_buf->space_available()) /
                                      static_cast<float>(out_buf->bufsize());
             d_ins_output_buffers_full[i] = pfull;
@@ -317,7 +323,7 @@ void block_detail::stop_perf_counters(int noutput_items, int nproduced)
 
         for (size_t i = 0; i < d_input.size(); i++) {
             buffer_reader_sptr in_buf = d_input[i];
-            gr::thread::scoped_lock guard(*in_buf->mutex());
+            gr::thread::scoped_lock guard = in_buf->buffer()->index_lock();
             float pfull = static_cast<float>(in_buf->items_available()) /
                           static_cast<float>(in_buf->max_possible_items_available());
 
@@ -329,7 +335,7 @@ void block_detail::stop_perf_counters(int noutput_items, int nproduced)
 
         for (size_t i = 0; i < d_output.size(); i++) {
             buffer_sptr out_buf = d_output[i];
-            gr::thread::scoped_lock guard(*out_buf->mutex());
+            gr::thread::scoped_lock guard = out_buf->index_lock();
             float pfull = 1.0f - static_cast<float>(out_buf->space_available()) /
                                      static_cast<float>(out_buf->bufsize());
 
@@ -344,7 +350,11 @@ void block_detail::stop_perf_counters(int noutput_items, int nproduced)
     d_pc_counter++;
 }
 
-void block_detail::reset_perf_counters() { d_pc_counter = 0; }
+void block_detail::reset_perf_counters()
+{
+    d_pc_counter = 0;
+    d_total_work_time = 0;
+}
 
 float block_detail::pc_noutput_items() { return d_ins_noutput_items; }
 
@@ -454,4 +464,19 @@ float block_detail::pc_work_time_var() { return d_var_work_time / (d_pc_counter
 float block_detail::pc_work_time_total() { return d_total_work_time; }
 
 float block_detail::pc_throughput_avg() { return d_avg_throughput; }
+
+std::vector<float> block_detail::pc_numa_node_bytes()
+{
+    std::vector<float> bytes(numa::num_nodes(), 0);
+    for (const auto& buf : d_output) {
+        // Other buffer types aren't page aligned or not in host memory
+        if (!buf || buf->get_mapping_type() != buffer_mapping_type::double_mapped)
+            continue;
+        size_t len = buf->bufsize() * buf->get_sizeof_item();
+        std::vector<size_t> b = numa::bytes_per_node(buf->base(), len, buf->base() + len);
+        for (size_t n = 0; n < b.size() && n < bytes.size(); n++)
+            bytes[n] += b[n];
+    }
+    return bytes;
+}
 } /* namespace gr */
@@ -16,6 +16,7 @@
 #include <gnuradio/block_detail.h>
 #include <gnuradio/custom_lock.h>
 #include <gnuradio/prefs.h>
+#include "scheduler_trace.h"
 #include <block_executor.h>
 #include <limits>
 #include <sstream>
@@ -70,7 +71,7 @@ static int min_available_space(block* m,
         min_noutput_items = 1;
     for (int i = output_idx; i < d->noutputs(); i++) {
         buffer_sptr out_buf = d->output(i);
-        gr::thread::scoped_lock guard(*out_buf->mutex());
+        gr::thread::scoped_lock guard = out_buf->index_lock();
         int space_avail = out_buf->space_available();
         int avail_n = round_down(space_avail, output_multiple);
         // If not strictly output multiple size aligned, potentially use all
@@ -108,17 +109,28 @@ static int min_available_space(block* m,
     return min_space;
 }
 
+// Move the offsets of \p tags from input to output items
+static void rescale_tags(std::vector<tag_t>& tags, const block* m)
+{
+    double rrate = m->relative_rate();
+
+    if (rrate == 1.0) {
+        return;
+    } else if (m->update_rate()) {
+        for (auto& t : tags)
+            t.offset = std::llround((double)t.offset * rrate);
+    } else {
+        m->rescale_tag_offsets(tags);
+    }
+}
+
 static bool propagate_tags(block::tag_propagation_policy_t policy,
+                           const block* m,
                            block_detail* d,
                            const std::vector<uint64_t>& start_nitems_read,
-                           double rrate,
-                           mpq_class& mp_rrate,
-                           bool use_fp_rrate,
                            std::vector<tag_t>& rtags,
                            long block_id)
 {
-    static const mpq_class one_half(1, 2);
-
     // Move tags downstream
     // if a sink, we don't need to move downstream
     if (d->sink_p()) {
@@ -131,8 +143,6 @@ static bool propagate_tags(block::tag_propagation_policy_t policy,
         return true;
     case block::TPP_ALL_TO_ALL: {
         // every tag on every input propagates to everyone downstream
-        std::vector<buffer_sptr> out_buf;
-
         for (int i = 0; i < d->ninputs(); i++) {
             d->get_tags_in_range(
                 rtags, i, start_nitems_read[i], d->nitems_read(i), block_id);
@@ -141,42 +151,9 @@ static bool propagate_tags(block::tag_propagation_policy_t policy,
                 continue;
             }
 
-            if (out_buf.empty()) {
-                out_buf.reserve(d->noutputs());
-                for (int o = 0; o < d->noutputs(); o++)
-                    out_buf.push_back(d->output(o));
-            }
-
-            std::vector<tag_t>::iterator t;
-            if (rrate == 1.0) {
-                for (t = rtags.begin(); t != rtags.end(); t++) {
-                    for (int o = 0; o < d->noutputs(); o++)
-                        out_buf[o]->add_item_tag(*t);
-                }
-            } else if (use_fp_rrate) {
-                for (t = rtags.begin(); t != rtags.end(); t++) {
-                    tag_t new_tag = *t;
-                    new_tag.offset = std::llround((double)new_tag.offset * rrate);
-                    for (int o = 0; o < d->noutputs(); o++)
-                        out_buf[o]->add_item_tag(new_tag);
-                }
-            } else {
-                mpz_class offset;
-                for (t = rtags.begin(); t != rtags.end(); t++) {
-                    tag_t new_tag = *t;
-                    mpz_import(offset.get_mpz_t(),
-                               1,
-                               1,
-                               sizeof(new_tag.offset),
-                               0,
-                               0,
-                               &new_tag.offset);
-                    offset = offset * mp_rrate + one_half;
-                    new_tag.offset = offset.get_ui();
-                    for (int o = 0; o < d->noutputs(); o++)
-                        out_buf[o]->add_item_tag(new_tag);
-                }
-            }
+            rescale_tags(rtags, m);
+            for (int o = 0; o < d->noutputs(); o++)
+                d->output(o)->add_item_tags(rtags);
         }
     } break;
     case block::TPP_ONE_TO_ONE:
@@ -184,8 +161,6 @@ static bool propagate_tags(block::tag_propagation_policy_t policy,
         // this requires d->ninputs() == d->noutputs; this is checked when this
         // type of tag-propagation system is selected in block_detail
         if (d->ninputs() == d->noutputs()) {
-            buffer_sptr out_buf;
-
             for (int i = 0; i < d->ninputs(); i++) {
                 d->get_tags_in_range(
                     rtags, i, start_nitems_read[i], d->nitems_read(i), block_id);
@@ -194,35 +169,8 @@ static bool propagate_tags(block::tag_propagation_policy_t policy,
                     continue;
                 }
 
-                out_buf = d->output(i);
-
-                std::vector<tag_t>::iterator t;
-                if (rrate == 1.0) {
-                    for (t = rtags.begin(); t != rtags.end(); t++) {
-                        out_buf->add_item_tag(*t);
-                    }
-                } else if (use_fp_rrate) {
-                    for (t = rtags.begin(); t != rtags.end(); t++) {
-                        tag_t new_tag = *t;
-                        new_tag.offset = std::llround((double)new_tag.offset * rrate);
-                        out_buf->add_item_tag(new_tag);
-                    }
-                } else {
-                    mpz_class offset;
-                    for (t = rtags.begin(); t != rtags.end(); t++) {
-                        tag_t new_tag = *t;
-                        mpz_import(offset.get_mpz_t(),
-                                   1,
-                                   1,
-                                   sizeof(new_tag.offset),
-                                   0,
-                                   0,
-                                   &new_tag.offset);
-                        offset = offset * mp_rrate + one_half;
-                        new_tag.offset = offset.get_ui();
-                        out_buf->add_item_tag(new_tag);
-                    }
-                }
+                rescale_tags(rtags, m);
+                d->output(i)->add_item_tags(rtags);
             }
         } else {
             std::ostringstream msg;
@@ -245,9 +193,15 @@ block_executor::block_executor(block_sptr block, int max_noutput_items)
 
 #ifdef GR_PERFORMANCE_COUNTERS
     prefs* prefs = prefs::singleton();
-    d_use_pc = prefs->get_bool("PerfCounters", "on", false);
+    // Adaptive buffer sizing goes by the buffer occupancy counters
+    d_use_pc = prefs->get_bool("PerfCounters", "on", false) ||
+               prefs->get_bool("Scheduler", "adaptive_buffers", false);
 #endif /* GR_PERFORMANCE_COUNTERS */
 
+    if (trace::enabled())
+        trace::register_block(d_block->unique_id(), d_block->alias());
+
+    trace::scope span(trace::event_type::START, d_block->unique_id());
     d_block->start(); // enable any drivers, etc.
 }
 
@@ -337,11 +291,13 @@ block_executor::state block_executor::run_one_iteration()
         max_items_avail = 0;
         for (int i = 0; i < d->ninputs(); i++) {
             {
-                // Acquire the mutex and grab local copies of items_available and done.
+                // Grab local copies of done and items_available. Read done first:
+                // with atomic indices there is no mutex to hold the writer off, and
+                // done only covers the items that were written before it was set.
                 buffer_reader_sptr in_buf = d->input(i);
-                gr::thread::scoped_lock guard(*in_buf->mutex());
-                d_ninput_items[i] = in_buf->items_available();
+                gr::thread::scoped_lock guard = in_buf->buffer()->index_lock();
                 d_input_done[i] = in_buf->done();
+                d_ninput_items[i] = in_buf->items_available();
             }
 
             LOG(std::ostringstream msg;
@@ -415,11 +371,13 @@ block_executor::state block_executor::run_one_iteration()
         max_items_avail = 0;
         for (int i = 0; i < d->ninputs(); i++) {
             {
-                // Acquire the mutex and grab local copies of items_available and done.
+                // Grab local copies of done and items_available. Read done first:
+                // with atomic indices there is no mutex to hold the writer off, and
+                // done only covers the items that were written before it was set.
                 buffer_reader_sptr in_buf = d->input(i);
-                gr::thread::scoped_lock guard(*in_buf->mutex());
-                d_ninput_items[i] = in_buf->items_available();
+                gr::thread::scoped_lock guard = in_buf->buffer()->index_lock();
                 d_input_done[i] = in_buf->done();
+                d_ninput_items[i] = in_buf->items_available();
             }
             max_items_avail = std::max(max_items_avail, d_ninput_items[i]);
         }
@@ -618,10 +576,22 @@ block_executor::state block_executor::run_one_iteration()
             d->start_perf_counters();
 #endif /* GR_PERFORMANCE_COUNTERS */
 
+        int64_t trace_start = trace::enabled() ? trace::now() : 0;
+
         // Do the actual work of the block
         int n =
             m->general_work(noutput_items, d_ninput_items, d_input_items, d_output_items);
 
+        if (trace_start) {
+            trace::record({ trace_start,
+                            trace::now(),
+                            m->unique_id(),
+                            -1,
+                            noutput_items,
+                            n,
+                            trace::event_type::WORK });
+        }
+
 #ifdef GR_PERFORMANCE_COUNTERS
         if (d_use_pc)
             d->stop_perf_counters(noutput_items, n);
@@ -642,11 +612,9 @@ block_executor::state block_executor::run_one_iteration()
 
         // Now propagate the tags based on the new relative rate
         if (!propagate_tags(m->tag_propagation_policy(),
+                            m,
                             d,
                             d_start_nitems_read,
-                            m->relative_rate(),
-                            m->mp_relative_rate(),
-                            m->update_rate(),
                             d_returned_tags,
                             m->unique_id())) {
             d->post_work_cleanup();
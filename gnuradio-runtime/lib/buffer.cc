@@ -71,9 +71,11 @@ buffer::buffer(buffer_mapping_type buf_type,
       d_has_history(false),
       d_sizeof_item(sizeof_item),
       d_link(link),
+      d_atomic_indices(false),
       d_write_index(0),
       d_abs_write_offset(0),
       d_done(false),
+      d_has_tags(false),
       d_last_min_items_read(0),
       d_callback_flag(false),
       d_active_pointer_counter(0),
@@ -128,14 +130,18 @@ const void* buffer::_read_pointer(unsigned int read_index)
 
 void buffer::update_write_pointer(int nitems)
 {
-    gr::thread::scoped_lock guard(*mutex());
+    gr::thread::scoped_lock guard = index_lock();
 
 #ifdef BUFFER_DEBUG
     unsigned orig_wr_idx = d_write_index;
 #endif
 
-    d_write_index = index_add(d_write_index, nitems);
-    d_abs_write_offset += nitems;
+    // Only the writer modifies these. Publish the index last, so a
+    // reader that sees it also sees the items (and tags) behind it.
+    d_abs_write_offset.store(d_abs_write_offset.load(std::memory_order_relaxed) + nitems,
+                             std::memory_order_relaxed);
+    d_write_index.store(index_add(d_write_index.load(std::memory_order_relaxed), nitems),
+                        std::memory_order_release);
 
 #ifdef BUFFER_DEBUG
     std::ostringstream msg;
@@ -148,7 +154,7 @@ void buffer::update_write_pointer(int nitems)
 void buffer::set_done(bool done)
 {
     gr::thread::scoped_lock guard(*mutex());
-    d_done = done;
+    d_done.store(done, std::memory_order_release);
 }
 
 void buffer::drop_reader(buffer_reader* reader)
@@ -165,18 +171,28 @@ void buffer::drop_reader(buffer_reader* reader)
 void buffer::add_item_tag(const tag_t& tag)
 {
     gr::thread::scoped_lock guard(*mutex());
-    d_item_tags.insert(std::pair<uint64_t, tag_t>(tag.offset, tag));
+    d_item_tags.add(tag);
+    d_has_tags.store(true, std::memory_order_release);
+}
+
+void buffer::add_item_tags(const std::vector<tag_t>& tags)
+{
+    if (tags.empty())
+        return;
+
+    gr::thread::scoped_lock guard(*mutex());
+    d_item_tags.add(tags);
+    d_has_tags.store(true, std::memory_order_release);
 }
 
 void buffer::remove_item_tag(const tag_t& tag, long id)
 {
     gr::thread::scoped_lock guard(*mutex());
-    for (std::multimap<uint64_t, tag_t>::iterator it =
-             d_item_tags.lower_bound(tag.offset);
-         it != d_item_tags.upper_bound(tag.offset);
+    for (auto it = d_item_tags.lower_bound(tag.offset);
+         it != d_item_tags.end() && it->offset == tag.offset;
          ++it) {
-        if ((*it).second == tag) {
-            (*it).second.marked_deleted.push_back(id);
+        if (*it == tag) {
+            it->marked_deleted.push_back(id);
         }
     }
 }
@@ -193,31 +209,11 @@ void buffer::prune_tags(uint64_t max_time)
            gr::thread::scoped_lock guard(*mutex());
      */
 
-    /*
-      http://www.cplusplus.com/reference/map/multimap/erase/
-      "Iterators, pointers and references referring to elements removed
-      by the function are invalidated. All other iterators, pointers
-      and references keep their validity."
-
-      Store the iterator to be deleted in tmp; increment itr to the
-      next valid iterator, then erase tmp, which now becomes invalid.
-     */
-
-    uint64_t item_time;
-    std::multimap<uint64_t, tag_t>::iterator itr(d_item_tags.begin()), tmp;
-    while (itr != d_item_tags.end()) {
-        item_time = (*itr).second.offset;
-        if (item_time + d_max_reader_delay + bufsize() < max_time) {
-            tmp = itr;
-            itr++;
-            d_item_tags.erase(tmp);
-        } else {
-            // d_item_tags is a map sorted by offset, so when the if
-            // condition above fails, all future tags in the map must also
-            // fail. So just break here.
-            break;
-        }
-    }
+    // Tags older than what the slowest reader can still ask for
+    uint64_t keep = static_cast<uint64_t>(d_max_reader_delay) + bufsize();
+    if (max_time > keep)
+        d_item_tags.prune(max_time - keep);
+    d_has_tags.store(!d_item_tags.empty(), std::memory_order_release);
 }
 
 void buffer::on_lock(gr::thread::scoped_lock& lock)
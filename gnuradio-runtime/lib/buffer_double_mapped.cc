@@ -12,11 +12,13 @@
 #include "config.h"
 #endif
 #include "vmcircbuf.h"
+#include "vmcircbuf_mmap_hugetlb.h"
 #include <gnuradio/block.h>
 #include <gnuradio/buffer_double_mapped.h>
 #include <gnuradio/buffer_reader.h>
 #include <gnuradio/integer_math.h>
 #include <gnuradio/math.h>
+#include <gnuradio/prefs.h>
 #include <assert.h>
 #include <algorithm>
 #include <iostream>
@@ -52,6 +54,10 @@ buffer_double_mapped::buffer_double_mapped(int nitems,
              link)
 {
     gr::configure_default_loggers(d_logger, d_debug_logger, "buffer_double_mapped");
+
+    // One writer, readers that never move each other's indices, and no
+    // callbacks: nothing here needs the mutex besides the tags.
+    d_atomic_indices = true;
     if (!allocate_buffer(nitems))
         throw std::bad_alloc();
 
@@ -111,6 +117,30 @@ bool buffer_double_mapped::allocate_buffer(int nitems)
         GR_LOG_WARN(d_logger, msg.c_str());
     }
 
+    // Buffers of a huge page or more go into huge pages if asked to: a
+    // block streaming through a multi-MB buffer then needs a handful of
+    // TLB entries instead of hundreds. Round up to whole huge pages, and
+    // quietly use normal pages if there aren't enough huge ones.
+    if (prefs::singleton()->get_bool("DEFAULT", "hugepage_buffers", false)) {
+        gr::vmcircbuf_factory* f = gr::vmcircbuf_mmap_hugetlb_factory::singleton();
+        int hugepage = f->granularity();
+        if ((long)nitems * d_sizeof_item >= (size_t)hugepage) {
+            int huge_min_nitems = minimum_buffer_items(d_sizeof_item, hugepage);
+            int huge_nitems =
+                (nitems + huge_min_nitems - 1) / huge_min_nitems * huge_min_nitems;
+            d_vmcircbuf.reset(f->make(huge_nitems * d_sizeof_item));
+            if (d_vmcircbuf) {
+                d_bufsize = huge_nitems;
+                d_base = (char*)d_vmcircbuf->pointer_to_first_copy();
+                return true;
+            }
+            GR_LOG_DEBUG(d_debug_logger,
+                         boost::format("no huge pages for %d KB buffer, using "
+                                       "normal pages") %
+                             (huge_nitems * d_sizeof_item / 1024));
+        }
+    }
+
     d_bufsize = nitems;
     d_vmcircbuf.reset(gr::vmcircbuf_sysconfig::make(d_bufsize * d_sizeof_item));
     if (d_vmcircbuf == 0) {
@@ -141,7 +171,14 @@ int buffer_double_mapped::space_available()
         }
 
         if (min_items_read != d_last_min_items_read) {
-            prune_tags(d_last_min_items_read);
+            // Only we add tags, so there is nothing to prune if there
+            // are none; otherwise take the mutex the caller didn't.
+            if (d_has_tags.load(std::memory_order_relaxed)) {
+                gr::thread::scoped_lock guard(*mutex(), boost::defer_lock);
+                if (d_atomic_indices)
+                    guard.lock();
+                prune_tags(d_last_min_items_read);
+            }
             d_last_min_items_read = min_items_read;
         }
 
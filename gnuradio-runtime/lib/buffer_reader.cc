@@ -48,6 +48,9 @@ buffer_add_reader(buffer_sptr buf, int nzero_preload, block_sptr link, int delay
         r->d_read_index = buf->d_write_index - nzero_preload;
     }
 
+    // A reader added to a buffer that is in use counts from where the
+    // writer is, like the readers that are already there
+    r->d_abs_read_offset = buf->nitems_written();
     buf->d_readers.push_back(r.get());
 
 #ifdef BUFFER_DEBUG
@@ -95,7 +98,10 @@ unsigned buffer_reader::sample_delay() const { return d_attr_delay; }
 
 int buffer_reader::items_available() const
 {
-    int available = d_buffer->index_sub(d_buffer->d_write_index, d_read_index);
+    // Acquire both indices: the writer calls this from space_available()
+    int available =
+        d_buffer->index_sub(d_buffer->d_write_index.load(std::memory_order_acquire),
+                            d_read_index.load(std::memory_order_acquire));
 
 #ifdef BUFFER_DEBUG
     std::ostringstream msg;
@@ -118,14 +124,19 @@ const void* buffer_reader::read_pointer()
 
 void buffer_reader::update_read_pointer(int nitems)
 {
-    gr::thread::scoped_lock guard(*mutex());
+    gr::thread::scoped_lock guard = d_buffer->index_lock();
 
 #ifdef BUFFER_DEBUG
     unsigned orig_rd_idx = d_read_index;
 #endif
 
-    d_read_index = d_buffer->index_add(d_read_index, nitems);
-    d_abs_read_offset += nitems;
+    // Publish the index last; once the writer sees it, it may reuse the
+    // space we just read from.
+    d_abs_read_offset.store(d_abs_read_offset.load(std::memory_order_relaxed) + nitems,
+                            std::memory_order_relaxed);
+    d_read_index.store(
+        d_buffer->index_add(d_read_index.load(std::memory_order_relaxed), nitems),
+        std::memory_order_release);
 
 #ifdef BUFFER_DEBUG
     std::ostringstream msg;
@@ -141,6 +152,13 @@ void buffer_reader::get_tags_in_range(std::vector<tag_t>& v,
                                       uint64_t abs_end,
                                       long id)
 {
+    v.clear();
+
+    // Tags are added before the items they belong to are published, so
+    // if the buffer holds no tags now there are none in our range.
+    if (!d_buffer->d_has_tags.load(std::memory_order_acquire))
+        return;
+
     gr::thread::scoped_lock guard(*mutex());
 
     uint64_t lower_bound = abs_start - d_attr_delay;
@@ -152,28 +170,22 @@ void buffer_reader::get_tags_in_range(std::vector<tag_t>& v,
     if (upper_bound > abs_end)
         upper_bound = 0;
 
-    v.clear();
-    std::multimap<uint64_t, tag_t>::iterator itr =
-        d_buffer->get_tags_lower_bound(lower_bound);
-    std::multimap<uint64_t, tag_t>::iterator itr_end =
-        d_buffer->get_tags_upper_bound(upper_bound);
+    tag_store::iterator itr = d_buffer->get_tags_lower_bound(lower_bound);
+    tag_store::iterator itr_end = d_buffer->get_tags_upper_bound(upper_bound);
+    v.reserve(itr_end - itr);
 
     uint64_t item_time;
-    while (itr != itr_end) {
-        item_time = (*itr).second.offset + d_attr_delay;
+    for (; itr != itr_end; itr++) {
+        item_time = itr->offset + d_attr_delay;
         if ((item_time >= abs_start) && (item_time < abs_end)) {
-            std::vector<long>::iterator id_itr;
-            id_itr = std::find(
-                itr->second.marked_deleted.begin(), itr->second.marked_deleted.end(), id);
             // If id is not in the vector of marked blocks
-            if (id_itr == itr->second.marked_deleted.end()) {
-                tag_t t = (*itr).second;
-                t.offset += d_attr_delay;
-                v.push_back(t);
-                v.back().marked_deleted.clear();
+            if (itr->marked_deleted.empty() ||
+                std::find(itr->marked_deleted.begin(), itr->marked_deleted.end(), id) ==
+                    itr->marked_deleted.end()) {
+                v.push_back(*itr); // doesn't copy marked_deleted
+                v.back().offset += d_attr_delay;
             }
         }
-        itr++;
     }
 }
 
@@ -343,8 +343,8 @@ bool buffer_single_mapped::input_blocked_callback_logic(int items_required,
             if (idx == min_reader_index) {
                 d_readers[idx]->d_read_index = 0;
             } else {
-                d_readers[idx]->d_read_index += items_avail;
-                d_readers[idx]->d_read_index %= d_bufsize;
+                d_readers[idx]->d_read_index =
+                    (d_readers[idx]->d_read_index + items_avail) % d_bufsize;
             }
         }
 
@@ -13,6 +13,9 @@
 #endif
 
 #include "flat_flowgraph.h"
+#include "numa.h"
+#include "scheduler_trace.h"
+#include "vmcircbuf.h"
 #include <gnuradio/block_detail.h>
 #include <gnuradio/buffer.h>
 #include <gnuradio/buffer_double_mapped.h>
@@ -21,8 +24,10 @@
 #include <gnuradio/integer_math.h>
 #include <gnuradio/logger.h>
 #include <gnuradio/prefs.h>
+#include <gnuradio/sync_block.h>
 #include <volk/volk.h>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <iostream>
 #include <map>
 
@@ -35,6 +40,19 @@ namespace gr {
 static const unsigned int s_fixed_buffer_size =
     prefs::singleton()->get_long("DEFAULT", "buffer_size", GR_FIXED_BUFFER_SIZE);
 
+// Adaptive buffers grow up to 1Mbyte, when they're more than 3/4 full
+// on average, and shrink when they're less than 1/4 full
+#define GR_ADAPTIVE_BUFFER_MAX_SIZE (1L << 20)
+#define GR_ADAPTIVE_BUFFER_GROW 0.75f
+#define GR_ADAPTIVE_BUFFER_SHRINK 0.25f
+
+// The smallest number of items a double mapped buffer can hold
+static long min_buffer_nitems(size_t item_size)
+{
+    long granularity = gr::vmcircbuf_sysconfig::granularity();
+    return granularity / GR_GCD((long)item_size, granularity);
+}
+
 flat_flowgraph_sptr make_flat_flowgraph()
 {
     return flat_flowgraph_sptr(new flat_flowgraph());
@@ -51,14 +69,21 @@ void flat_flowgraph::setup_connections()
 {
     basic_block_vector_t blocks = calc_used_blocks();
 
+    calc_fused_chains(blocks);
+    calc_numa_nodes();
+
     // Assign block details to blocks
     for (basic_block_viter_t p = blocks.begin(); p != blocks.end(); p++) {
+        if (trace::enabled())
+            trace::register_block((*p)->unique_id(), (*p)->alias());
+        trace::scope span(trace::event_type::ALLOCATE, (*p)->unique_id());
         allocate_block_detail(*p);
     }
 
     // Connect inputs to outputs for each block
     for (basic_block_viter_t p = blocks.begin(); p != blocks.end(); p++) {
         connect_block_inputs(*p);
+        (*p)->d_msg_ports_fixed = true;
 
         block_sptr block = cast_to_block_sptr(*p);
         block->set_unaligned(0);
@@ -76,7 +101,8 @@ void flat_flowgraph::setup_connections()
     }
 }
 
-void flat_flowgraph::allocate_block_detail(basic_block_sptr block)
+void flat_flowgraph::allocate_block_detail(basic_block_sptr block,
+                                           const std::vector<long>& nitems)
 {
     int ninputs = calc_used_ports(block, true).size();
     int noutputs = calc_used_ports(block, false).size();
@@ -175,12 +201,325 @@ void flat_flowgraph::allocate_block_detail(basic_block_sptr block)
         downstream_max_out_mult[i] = max_out_multiple;
     }
 
+    // Sizes picked by adaptive buffers are the block's limits for this
+    // allocation only, so the ones it had stay as they were.
+    // allocate_buffer() caps its default size at max_output_buffer, and
+    // only goes beyond it up to min_output_buffer if there's no max.
+    std::vector<long> saved_max, saved_min;
+    for (size_t i = 0; i < nitems.size(); i++) {
+        saved_max.push_back(grblock->max_output_buffer(i));
+        saved_min.push_back(grblock->min_output_buffer(i));
+        if (nitems[i] <= 0)
+            continue;
+        long item_size = grblock->output_signature()->sizeof_stream_item(i);
+        if (nitems[i] <= 2 * (long)s_fixed_buffer_size / item_size) {
+            grblock->set_max_output_buffer(i, nitems[i]);
+        } else {
+            grblock->set_max_output_buffer(i, -1);
+            grblock->set_min_output_buffer(i, nitems[i]);
+        }
+    }
+
     // Allocate the block detail and necessary buffers
     grblock->allocate_detail(ninputs,
                              noutputs,
                              downstream_max_nitems,
                              downstream_lcm_nitems,
                              downstream_max_out_mult);
+
+    for (size_t i = 0; i < saved_max.size(); i++) {
+        grblock->set_max_output_buffer(i, saved_max[i]);
+        grblock->set_min_output_buffer(i, saved_min[i]);
+    }
+
+    // Keep the output buffers on the NUMA node of the thread writing them.
+    // The pages aren't touched yet, so they're allocated there right away.
+    auto node = d_numa_nodes.find(block);
+    if (node != d_numa_nodes.end()) {
+        block_detail_sptr detail = grblock->detail();
+        detail->set_numa_node(node->second);
+        for (int i = 0; i < detail->noutputs(); i++) {
+            buffer_sptr buf = detail->output(i);
+            if (buf->get_mapping_type() != buffer_mapping_type::double_mapped)
+                continue;
+            if (!numa::bind_memory(const_cast<char*>(buf->base()),
+                                   buf->bufsize() * buf->get_sizeof_item(),
+                                   node->second))
+                GR_LOG_WARN(d_logger,
+                            boost::format("could not bind output %d of %s to NUMA "
+                                          "node %d") %
+                                i % grblock->identifier() % node->second);
+        }
+    }
+}
+
+// The NUMA node a block has to stay on, -1 if it's free to go anywhere
+static int fixed_numa_node(basic_block_sptr block)
+{
+    block_sptr grblock = cast_to_block_sptr(block);
+    if (!grblock->processor_affinity().empty())
+        return numa::node_of_cpu(grblock->processor_affinity()[0]);
+    if (grblock->detail())
+        return grblock->detail()->numa_node();
+    return -1;
+}
+
+void flat_flowgraph::calc_numa_nodes()
+{
+    d_numa_nodes.clear();
+
+    int nnodes = numa::num_nodes();
+    if (nnodes < 2 || !prefs::singleton()->get_bool("Scheduler", "numa_aware", false))
+        return;
+
+    // Connected blocks go where most of the blocks with an affinity (or
+    // that were placed before a reconfiguration) are. Graphs without
+    // any go to the node with the fewest blocks so far.
+    std::vector<size_t> nblocks(nnodes, 0);
+    for (const auto& graph : partition()) {
+        std::vector<size_t> votes(nnodes, 0);
+        for (const auto& b : graph) {
+            int n = fixed_numa_node(b);
+            if (n >= 0)
+                votes[n]++;
+        }
+
+        int node;
+        auto most = std::max_element(votes.begin(), votes.end());
+        if (*most > 0)
+            node = most - votes.begin();
+        else
+            node = std::min_element(nblocks.begin(), nblocks.end()) - nblocks.begin();
+
+        for (const auto& b : graph) {
+            int n = fixed_numa_node(b);
+            d_numa_nodes[b] = (n >= 0) ? n : node;
+            nblocks[d_numa_nodes[b]]++;
+
+            GR_LOG_DEBUG(d_debug_logger,
+                         boost::format("placing %s on NUMA node %d") % b->identifier() %
+                             d_numa_nodes[b]);
+        }
+    }
+}
+
+// The fewest items allocate_buffer() allows for an output of block,
+// read by the downstream blocks
+static long smallest_output_buffer(block_sptr block,
+                                   const basic_block_vector_t& downstream)
+{
+    long nitems = 2 * block->output_multiple();
+    for (const auto& d : downstream) {
+        block_sptr dgrblock = cast_to_block_sptr(d);
+        double decimation = (1.0 / dgrblock->relative_rate());
+        double needed = decimation * dgrblock->output_multiple() +
+                        (dgrblock->history() - 1);
+        nitems = std::max(nitems, static_cast<long>(2 * needed));
+    }
+    return nitems;
+}
+
+// Whether block, or a block connected to one of its streams, is running
+static bool next_to_running(const edge_vector_t& edges,
+                            basic_block_sptr block,
+                            const std::set<basic_block_sptr>& running)
+{
+    if (running.count(block))
+        return true;
+    for (const auto& e : edges) {
+        if ((e.src().block() == block && running.count(e.dst().block())) ||
+            (e.dst().block() == block && running.count(e.src().block())))
+            return true;
+    }
+    return false;
+}
+
+long flat_flowgraph::adaptive_buffer_nitems(
+    long old_nitems, float full, long granularity, long min_nitems, long max_nitems)
+{
+    long nitems = old_nitems;
+    if (full > GR_ADAPTIVE_BUFFER_GROW) {
+        max_nitems = max_nitems / granularity * granularity;
+        nitems = std::max(old_nitems, std::min(2 * old_nitems, max_nitems));
+    } else if (full < GR_ADAPTIVE_BUFFER_SHRINK) {
+        nitems = std::max(old_nitems / 2, min_nitems);
+        nitems = (nitems + granularity - 1) / granularity * granularity;
+        nitems = std::min(nitems, old_nitems);
+    }
+    return nitems;
+}
+
+void flat_flowgraph::resize_output_buffers(flat_flowgraph_sptr old_ffg,
+                                           const std::set<basic_block_sptr>& running)
+{
+    prefs* p = prefs::singleton();
+    if (!p->get_bool("Scheduler", "adaptive_buffers", false))
+        return;
+    long max_size = p->get_long(
+        "Scheduler", "adaptive_buffers_max_size", GR_ADAPTIVE_BUFFER_MAX_SIZE);
+
+    // block -> the new size of each output, 0 where it stays
+    std::map<basic_block_sptr, std::vector<long>> resized;
+
+    for (const auto& b : d_blocks) {
+        block_sptr grblock = cast_to_block_sptr(b);
+        block_detail_sptr detail = grblock->detail();
+
+        // Only blocks that ran since the last (re)start and kept their outputs
+        if (!detail || !old_ffg->has_block_p(b) ||
+            detail->pc_work_time_total() <= 0 ||
+            static_cast<int>(calc_used_ports(b, false).size()) != detail->noutputs())
+            continue;
+
+        // A new detail means new readers on the buffers upstream and
+        // for the blocks downstream, so none of them may be running.
+        if (next_to_running(d_edges, b, running))
+            continue;
+
+        // The new buffers start out empty, and their readers start with
+        // zeros for their history, so only replace the buffers if all
+        // their items were read, by readers without history.
+        bool drained = true;
+        for (int i = 0; i < detail->noutputs(); i++) {
+            buffer_sptr buf = detail->output(i);
+            for (size_t r = 0; r < buf->nreaders(); r++) {
+                buffer_reader* reader = buf->reader(r);
+                if (reader->items_available() > 0 || reader->link()->history() > 1)
+                    drained = false;
+            }
+        }
+        if (!drained)
+            continue;
+
+        std::vector<long> new_nitems(detail->noutputs(), 0);
+        bool changed = false;
+        for (int i = 0; i < detail->noutputs(); i++) {
+            buffer_sptr buf = detail->output(i);
+            if (buf->get_mapping_type() != buffer_mapping_type::double_mapped)
+                continue;
+
+            // How full the writer left the buffer on average, or the
+            // fullest any reader left it
+            float full = detail->pc_output_buffers_full_avg(i);
+            for (size_t r = 0; r < buf->nreaders(); r++) {
+                block_detail_sptr rdetail = buf->reader(r)->link()->detail();
+                if (!rdetail || rdetail->pc_work_time_total() <= 0)
+                    continue;
+                for (int j = 0; j < rdetail->ninputs(); j++) {
+                    if (rdetail->input(j).get() == buf->reader(r))
+                        full = std::max(full, rdetail->pc_input_buffers_full_avg(j));
+                }
+            }
+
+            long item_size = buf->get_sizeof_item();
+            long old_nitems = buf->bufsize();
+            long nitems = adaptive_buffer_nitems(
+                old_nitems,
+                full,
+                min_buffer_nitems(item_size),
+                smallest_output_buffer(grblock, calc_downstream_blocks(b, i)),
+                max_size / item_size);
+            if (nitems == old_nitems)
+                continue;
+
+            GR_LOG_INFO(d_logger,
+                        boost::format("%s output %d was %.0f%% full, resizing its "
+                                      "buffer from %d to %d items") %
+                            grblock->alias() % i % (100 * full) % old_nitems % nitems);
+            new_nitems[i] = nitems;
+            changed = true;
+        }
+
+        if (changed)
+            resized[b] = new_nitems;
+    }
+
+    // Only now that all blocks are measured, start measuring afresh.
+    // The resized blocks keep their input readers; the readers of
+    // their old output buffers are replaced as the blocks downstream
+    // are connected.
+    for (const auto& b : d_blocks) {
+        block_sptr grblock = cast_to_block_sptr(b);
+        auto r = resized.find(b);
+        if (r != resized.end()) {
+            block_detail_sptr old_detail = grblock->detail();
+            grblock->set_detail(block_detail_sptr());
+            allocate_block_detail(b, r->second);
+
+            block_detail_sptr detail = grblock->detail();
+            for (int j = 0; j < std::min(detail->ninputs(), old_detail->ninputs()); j++)
+                detail->set_input(j, old_detail->input(j));
+        } else if (grblock->detail() && !running.count(b)) {
+            grblock->detail()->reset_perf_counters();
+        }
+    }
+}
+
+bool flat_flowgraph::is_fusable(basic_block_sptr block)
+{
+    block_sptr grblock = cast_to_block_sptr(block);
+    if (!grblock || !std::dynamic_pointer_cast<sync_block>(grblock))
+        return false;
+
+    // Blocks that asked for a thread of their own, custom buffers and
+    // anything that isn't 1:1 with exactly one input and one output
+    // run on their own.
+    std::vector<int> inputs = calc_used_ports(block, true);
+    std::vector<int> outputs = calc_used_ports(block, false);
+    return inputs.size() == 1 && inputs[0] == 0 && outputs.size() == 1 &&
+           outputs[0] == 0 && grblock->relative_rate() == 1.0 &&
+           grblock->processor_affinity().empty() && grblock->thread_priority() <= 0 &&
+           grblock->input_signature()->stream_buffer_type(0) ==
+               buffer_double_mapped::type &&
+           grblock->output_signature()->stream_buffer_type(0) ==
+               buffer_double_mapped::type;
+}
+
+void flat_flowgraph::calc_fused_chains(basic_block_vector_t& blocks)
+{
+    d_fused_chains.clear();
+    d_fused_chains_found = true;
+
+    if (!prefs::singleton()->get_bool("Scheduler", "tpb_fuse_chains", false))
+        return;
+
+    // Link each fusable block to its downstream neighbor if that is the
+    // only reader of its output and fusable as well.
+    std::map<basic_block_sptr, basic_block_sptr> fused_next;
+    std::map<basic_block_sptr, bool> has_prev;
+    for (const auto& b : blocks) {
+        if (!is_fusable(b))
+            continue;
+        basic_block_vector_t next = calc_downstream_blocks(b, 0);
+        if (next.size() == 1 && is_fusable(next[0])) {
+            fused_next[b] = next[0];
+            has_prev[next[0]] = true;
+        }
+    }
+
+    // Every linked block without a linked predecessor starts a chain
+    for (const auto& b : topological_sort(blocks)) {
+        if (fused_next.count(b) == 0 || has_prev.count(b))
+            continue;
+
+        block_vector_t chain;
+        basic_block_sptr p = b;
+        while (true) {
+            chain.push_back(cast_to_block_sptr(p));
+            auto next = fused_next.find(p);
+            if (next == fused_next.end())
+                break;
+            p = next->second;
+        }
+
+        std::ostringstream msg;
+        msg << "fusing chain of " << chain.size() << " blocks:";
+        for (const auto& c : chain)
+            msg << " " << c->identifier();
+        GR_LOG_DEBUG(d_debug_logger, msg.str());
+
+        d_fused_chains.push_back(chain);
+    }
 }
 
 void flat_flowgraph::connect_block_inputs(basic_block_sptr block)
@@ -274,8 +613,15 @@ void flat_flowgraph::connect_block_inputs(basic_block_sptr block)
     }
 }
 
-void flat_flowgraph::merge_connections(flat_flowgraph_sptr old_ffg)
+void flat_flowgraph::merge_connections(flat_flowgraph_sptr old_ffg,
+                                       const std::set<basic_block_sptr>& running)
 {
+    // calc_changed_blocks() found them already when reconfiguring a
+    // running flowgraph
+    if (!d_fused_chains_found)
+        calc_fused_chains(d_blocks);
+    calc_numa_nodes();
+
     // Allocate block details if needed.  Only new blocks that aren't pruned out
     // by flattening will need one; existing blocks still in the new flowgraph will
     // already have one.
@@ -286,6 +632,7 @@ void flat_flowgraph::merge_connections(flat_flowgraph_sptr old_ffg)
             GR_LOG_DEBUG(d_debug_logger,
                          "merge: allocating new detail for block " + block->identifier());
             allocate_block_detail(block);
+            block->d_msg_ports_fixed = true;
         } else {
             GR_LOG_DEBUG(d_debug_logger,
                          "merge: reusing original detail for block " +
@@ -317,10 +664,18 @@ void flat_flowgraph::merge_connections(flat_flowgraph_sptr old_ffg)
         }
     }
 
+    // Give the blocks whose output buffers were too full or too empty
+    // new ones.
+    resize_output_buffers(old_ffg, running);
+
     // Now connect inputs to outputs, reusing old buffer readers if they exist
     for (basic_block_viter_t p = d_blocks.begin(); p != d_blocks.end(); p++) {
         block_sptr block = cast_to_block_sptr(*p);
 
+        // Its connections didn't change, and its thread is using them
+        if (running.count(*p))
+            continue;
+
         GR_LOG_DEBUG(d_debug_logger, "merge: merging " + block->identifier() + "...");
 
         if (old_ffg->has_block_p(*p)) {
@@ -379,12 +734,75 @@ void flat_flowgraph::merge_connections(flat_flowgraph_sptr old_ffg)
 
         // Now deal with the fact that the block details might have
         // changed numbers of inputs and outputs vs. in the old
-        // flowgraph.
-        block->detail()->reset_nitem_counters();
-        block->detail()->clear_tags();
+        // flowgraph. Next to running blocks, the item counters go on
+        // instead, so their tags stay where they are; new readers
+        // start counting where the writer is.
+        if (running.empty()) {
+            block->detail()->reset_nitem_counters();
+            block->detail()->clear_tags();
+        }
     }
 }
 
+// Insert both ends of the (stream or message) edges of from that
+// aren't in to
+template <class E>
+static void insert_gone_edges(const std::vector<E>& from,
+                              const std::vector<E>& to,
+                              std::set<basic_block_sptr>& blocks)
+{
+    for (const auto& e : from) {
+        auto same = [&e](const E& x) { return x.src() == e.src() && x.dst() == e.dst(); };
+        if (std::find_if(to.begin(), to.end(), same) == to.end()) {
+            blocks.insert(e.src().block());
+            blocks.insert(e.dst().block());
+        }
+    }
+}
+
+std::set<basic_block_sptr>
+flat_flowgraph::calc_changed_blocks(flat_flowgraph_sptr old_ffg)
+{
+    std::set<basic_block_sptr> changed;
+
+    for (const auto& b : d_blocks) {
+        if (!old_ffg->has_block_p(b))
+            changed.insert(b);
+    }
+    for (const auto& b : old_ffg->d_blocks) {
+        if (!has_block_p(b))
+            changed.insert(b);
+    }
+
+    insert_gone_edges(old_ffg->d_edges, d_edges, changed);
+    insert_gone_edges(d_edges, old_ffg->d_edges, changed);
+    insert_gone_edges(old_ffg->d_msg_edges, d_msg_edges, changed);
+    insert_gone_edges(d_msg_edges, old_ffg->d_msg_edges, changed);
+
+    // A fused chain runs in one thread, so it stops as a whole. Going
+    // by the old and the new chains leaves the blocks that keep
+    // running in the same chains as before.
+    calc_fused_chains(d_blocks);
+    bool grown = true;
+    while (grown) {
+        grown = false;
+        for (const auto* chains : { &old_ffg->d_fused_chains, &d_fused_chains }) {
+            for (const auto& chain : *chains) {
+                auto in_changed = [&changed](const block_sptr& b) {
+                    return changed.count(b) > 0;
+                };
+                if (std::any_of(chain.begin(), chain.end(), in_changed) &&
+                    !std::all_of(chain.begin(), chain.end(), in_changed)) {
+                    changed.insert(chain.begin(), chain.end());
+                    grown = true;
+                }
+            }
+        }
+    }
+
+    return changed;
+}
+
 void flat_flowgraph::setup_buffer_alignment(block_sptr block)
 {
     const int alignment = volk_get_alignment();
@@ -429,6 +847,23 @@ std::string flat_flowgraph::msg_edge_list()
     return s.str();
 }
 
+std::string flat_flowgraph::buffer_size_list()
+{
+    std::stringstream s;
+    for (basic_block_viter_t p = d_blocks.begin(); p != d_blocks.end(); p++) {
+        block_sptr block = cast_to_block_sptr(*p);
+        block_detail_sptr detail = block->detail();
+        if (!detail)
+            continue;
+        for (int i = 0; i < detail->noutputs(); i++) {
+            buffer_sptr buffer = detail->output(i);
+            s << block->alias() << ":" << i << " " << buffer->bufsize() << " items ("
+              << buffer->bufsize() * buffer->get_sizeof_item() << " bytes)" << std::endl;
+        }
+    }
+    return s.str();
+}
+
 void flat_flowgraph::dump()
 {
     for (edge_viter_t e = d_edges.begin(); e != d_edges.end(); e++)
@@ -15,6 +15,9 @@
 #include <gnuradio/block.h>
 #include <gnuradio/flowgraph.h>
 #include <gnuradio/logger.h>
+#include <map>
+#include <set>
+#include <vector>
 
 namespace gr {
 
@@ -38,8 +41,32 @@ public:
     // Wire list of gr::block together in new flat_flowgraph
     void setup_connections();
 
-    // Merge applicable connections from existing flat flowgraph
-    void merge_connections(flat_flowgraph_sptr sfg);
+    // Merge applicable connections from existing flat flowgraph. The
+    // blocks in running keep running meanwhile and are left alone.
+    void merge_connections(flat_flowgraph_sptr sfg,
+                           const std::set<basic_block_sptr>& running = {});
+
+    /*!
+     * The blocks that have to be stopped to turn \p old_ffg into this
+     * flowgraph: blocks that were added or removed, both ends of every
+     * stream or message edge that was added or removed, and the blocks
+     * fused into one thread with any of those, before or after. The
+     * chains found here are kept for merge_connections().
+     */
+    std::set<basic_block_sptr> calc_changed_blocks(flat_flowgraph_sptr old_ffg);
+
+    /*!
+     * The size adaptive buffers give an output buffer of \p old_nitems
+     * items that was \p full (0 to 1) on average: twice as big, up to
+     * \p max_nitems, if it was more than 3/4 full, half as big, down
+     * to \p min_nitems, if it was less than 1/4 full, and otherwise the
+     * same. Sizes are multiples of \p granularity items.
+     */
+    static long adaptive_buffer_nitems(long old_nitems,
+                                       float full,
+                                       long granularity,
+                                       long min_nitems,
+                                       long max_nitems);
 
     // Return a string list of edges
     std::string edge_list();
@@ -47,6 +74,9 @@ public:
     // Return a string list of msg edges
     std::string msg_edge_list();
 
+    // Return a string list of the size of every output buffer
+    std::string buffer_size_list();
+
     void dump();
 
     /*!
@@ -75,12 +105,52 @@ public:
      */
     void enable_pc_rpc();
 
+    /*!
+     * Chains of two or more blocks that the thread-per-block scheduler
+     * runs in a single thread, each in topological order. Only found if
+     * the [Scheduler] tpb_fuse_chains preference is set; valid after
+     * setup_connections() or merge_connections().
+     */
+    const std::vector<block_vector_t>& fused_chains() const { return d_fused_chains; }
+
 private:
     flat_flowgraph();
 
-    void allocate_block_detail(basic_block_sptr block);
+    /*!
+     * Give \p block a new block_detail with output buffers; those with
+     * a nonzero entry in \p nitems get that many items.
+     */
+    void allocate_block_detail(basic_block_sptr block,
+                               const std::vector<long>& nitems = {});
     void connect_block_inputs(basic_block_sptr block);
 
+    /*!
+     * Find the chains of 1:1 sync blocks, each with a single input and
+     * output and no fan-out between them, and fill d_fused_chains.
+     */
+    void calc_fused_chains(basic_block_vector_t& blocks);
+    bool is_fusable(basic_block_sptr block);
+
+    /*!
+     * Pick the NUMA node of every block for d_numa_nodes, if the
+     * [Scheduler] numa_aware preference is set and there's more than
+     * one node.
+     */
+    void calc_numa_nodes();
+
+    /*!
+     * Grow the output buffers of blocks of \p old_ffg that were mostly
+     * full since the last (re)start, and shrink the ones that were
+     * mostly empty, if the [Scheduler] adaptive_buffers preference is
+     * set. The blocks get a new block_detail with the readers of the
+     * old one. Blocks next to one in \p running, and those with unread
+     * items in their output buffers, keep their buffers. The limits
+     * set with set_max_output_buffer() and set_min_output_buffer()
+     * are left alone.
+     */
+    void resize_output_buffers(flat_flowgraph_sptr old_ffg,
+                               const std::set<basic_block_sptr>& running);
+
     /* When reusing a flowgraph's blocks, this call makes sure all of
      * the buffer's are aligned at the machine's alignment boundary
      * and tells the blocks that they are aligned.
@@ -92,6 +162,10 @@ private:
 
     gr::logger_ptr d_logger;
     gr::logger_ptr d_debug_logger;
+
+    std::vector<block_vector_t> d_fused_chains;
+    bool d_fused_chains_found = false;
+    std::map<basic_block_sptr, int> d_numa_nodes;
 };
 
 } /* namespace gr */
@@ -14,6 +14,7 @@
 
 #include <gnuradio/flowgraph.h>
 #include <iterator>
+#include <map>
 #include <sstream>
 #include <stdexcept>
 
@@ -52,6 +53,7 @@ void flowgraph::connect(const endpoint& src, const endpoint& dst)
 
     // Alles klar, Herr Kommissar
     d_edges.push_back(edge(src, dst));
+    d_used_dsts.emplace(dst.block().get(), dst.port());
 }
 
 void flowgraph::disconnect(const endpoint& src, const endpoint& dst)
@@ -59,6 +61,7 @@ void flowgraph::disconnect(const endpoint& src, const endpoint& dst)
     for (edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++) {
         if (src == p->src() && dst == p->dst()) {
             d_edges.erase(p);
+            d_used_dsts.erase(std::make_pair(dst.block().get(), dst.port()));
             return;
         }
     }
@@ -72,6 +75,13 @@ void flowgraph::validate()
 {
     d_blocks = calc_used_blocks();
 
+    // The used input and output ports of all blocks, in one pass
+    std::map<basic_block_sptr, std::pair<std::vector<int>, std::vector<int>>> ports;
+    for (edge_viter_t e = d_edges.begin(); e != d_edges.end(); e++) {
+        ports[e->dst().block()].first.push_back(e->dst().port());
+        ports[e->src().block()].second.push_back(e->src().port());
+    }
+
     for (basic_block_viter_t p = d_blocks.begin(); p != d_blocks.end(); p++) {
         std::vector<int> used_ports;
         int ninputs, noutputs;
@@ -79,11 +89,11 @@ void flowgraph::validate()
         if (FLOWGRAPH_DEBUG)
             std::cout << "Validating block: " << (*p) << std::endl;
 
-        used_ports = calc_used_ports(*p, true); // inputs
+        used_ports = unique_vector<int>(ports[*p].first); // inputs
         ninputs = used_ports.size();
         check_contiguity(*p, used_ports, true); // inputs
 
-        used_ports = calc_used_ports(*p, false); // outputs
+        used_ports = unique_vector<int>(ports[*p].second); // outputs
         noutputs = used_ports.size();
         check_contiguity(*p, used_ports, false); // outputs
 
@@ -101,6 +111,7 @@ void flowgraph::clear()
     // Boost shared pointers will deallocate as needed
     d_blocks.clear();
     d_edges.clear();
+    d_used_dsts.clear();
 }
 
 void flowgraph::check_valid_port(gr::io_signature::sptr sig, int port)
@@ -143,6 +154,9 @@ void flowgraph::check_valid_port(const msg_endpoint& e)
 void flowgraph::check_dst_not_used(const endpoint& dst)
 {
     // A destination is in use if it is already on the edge list
+    if (!d_used_dsts.count(std::make_pair(dst.block().get(), dst.port())))
+        return;
+
     for (edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++)
         if (p->dst() == dst) {
             std::stringstream msg;
@@ -262,9 +276,10 @@ void flowgraph::check_contiguity(basic_block_sptr block,
 basic_block_vector_t flowgraph::calc_downstream_blocks(basic_block_sptr block, int port)
 {
     basic_block_vector_t tmp;
+    endpoint src(block, port);
 
     for (edge_viter_t p = d_edges.begin(); p != d_edges.end(); p++)
-        if (p->src() == endpoint(block, port))
+        if (p->src() == src)
             tmp.push_back(p->dst().block());
 
     return unique_vector<basic_block_sptr>(tmp);
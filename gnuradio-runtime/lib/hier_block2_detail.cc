@@ -16,6 +16,8 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/prefs.h>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <stdexcept>
 
@@ -26,9 +28,14 @@ namespace gr {
 
 constexpr bool HIER_BLOCK2_DETAIL_DEBUG = false;
 
+// The last stamp any hierarchical block took when it changed
+static std::atomic<uint64_t> s_last_change(0);
+
 hier_block2_detail::hier_block2_detail(hier_block2* owner)
-    : d_owner(owner), d_parent_detail(0), d_fg(make_flowgraph())
+    : d_owner(owner), d_parent_detail(0), d_fg(make_flowgraph()), d_flat_stamp(0)
 {
+    changed();
+
     int min_inputs = owner->input_signature()->min_streams();
     int max_inputs = owner->input_signature()->max_streams();
     int min_outputs = owner->output_signature()->min_streams();
@@ -55,9 +62,33 @@ hier_block2_detail::~hier_block2_detail()
     d_owner = 0; // Don't use delete, we didn't allocate
 }
 
+// Drop what the last flatten_aux() worked out here and in the blocks
+// around me, so that disconnected blocks aren't kept alive by it
+void hier_block2_detail::changed()
+{
+    d_changed = ++s_last_change;
+    for (hier_block2_detail* d = this; d; d = d->d_parent_detail) {
+        d->d_flat_stamp = 0;
+        d->d_flat_edges.clear();
+        d->d_flat_blocks.clear();
+        d->d_flat_children.clear();
+    }
+}
+
+// The newest stamp of this block and the hierarchical blocks in it,
+// as far as they're known from the last flatten_aux()
+uint64_t hier_block2_detail::subtree_stamp() const
+{
+    uint64_t stamp = d_changed;
+    for (const hier_block2_detail* child : d_flat_children)
+        stamp = std::max(stamp, child->subtree_stamp());
+    return stamp;
+}
+
 void hier_block2_detail::connect(basic_block_sptr block)
 {
     std::stringstream msg;
+    changed();
 
     // Check if duplicate
     if (std::find(d_blocks.begin(), d_blocks.end(), block) != d_blocks.end()) {
@@ -90,6 +121,7 @@ void hier_block2_detail::connect(basic_block_sptr src,
                                  int dst_port)
 {
     std::stringstream msg;
+    changed();
 
     if (HIER_BLOCK2_DETAIL_DEBUG)
         std::cout << "connecting: " << endpoint(src, src_port) << " -> "
@@ -151,6 +183,7 @@ void hier_block2_detail::msg_connect(basic_block_sptr src,
 {
     if (HIER_BLOCK2_DETAIL_DEBUG)
         std::cout << "connecting message port..." << std::endl;
+    changed();
 
     // add block uniquely to list to internal blocks
     if (std::find(d_blocks.begin(), d_blocks.end(), dst) == d_blocks.end()) {
@@ -202,6 +235,7 @@ void hier_block2_detail::msg_disconnect(basic_block_sptr src,
 {
     if (HIER_BLOCK2_DETAIL_DEBUG)
         std::cout << "disconnecting message port..." << std::endl;
+    changed();
 
     // remove edge for this message connection
     bool hier_in = false, hier_out = false;
@@ -250,6 +284,8 @@ void hier_block2_detail::msg_disconnect(basic_block_sptr src,
 
 void hier_block2_detail::disconnect(basic_block_sptr block)
 {
+    changed();
+
     // Check on singleton list
     for (basic_block_viter_t p = d_blocks.begin(); p != d_blocks.end(); p++) {
         if (*p == block) {
@@ -299,6 +335,7 @@ void hier_block2_detail::disconnect(basic_block_sptr src,
     if (HIER_BLOCK2_DETAIL_DEBUG)
         std::cout << "disconnecting: " << endpoint(src, src_port) << " -> "
                   << endpoint(dst, dst_port) << std::endl;
+    changed();
 
     if (src.get() == dst.get())
         throw std::invalid_argument(
@@ -331,6 +368,8 @@ void hier_block2_detail::disconnect(basic_block_sptr src,
 
 void hier_block2_detail::refresh_io_signature()
 {
+    changed();
+
     int min_inputs = d_owner->input_signature()->min_streams();
     int max_inputs = d_owner->input_signature()->max_streams();
     int min_outputs = d_owner->output_signature()->min_streams();
@@ -502,6 +541,7 @@ endpoint_vector_t hier_block2_detail::resolve_port(int port, bool is_input)
 
 void hier_block2_detail::disconnect_all()
 {
+    changed();
     d_fg->clear();
     d_blocks.clear();
 
@@ -514,7 +554,6 @@ void hier_block2_detail::disconnect_all()
 endpoint_vector_t hier_block2_detail::resolve_endpoint(const endpoint& endp,
                                                        bool is_input) const
 {
-    std::stringstream msg;
     endpoint_vector_t result;
 
     // Check if endpoint is a leaf node
@@ -535,6 +574,7 @@ endpoint_vector_t hier_block2_detail::resolve_endpoint(const endpoint& endp,
         return hier_block2->d_detail->resolve_port(endp.port(), is_input);
     }
 
+    std::stringstream msg;
     msg << "unable to resolve" << (is_input ? " input " : " output ") << "endpoint "
         << endp;
     throw std::runtime_error(msg.str());
@@ -688,23 +728,33 @@ void hier_block2_detail::flatten_aux(flat_flowgraph_sptr sfg) const
     if (HIER_BLOCK2_DETAIL_DEBUG)
         std::cout << "Flattening stream connections: " << std::endl;
 
-    for (p = edges.begin(); p != edges.end(); p++) {
-        if (HIER_BLOCK2_DETAIL_DEBUG)
-            std::cout << "Flattening edge " << (*p) << std::endl;
+    // Nothing in here changed since last time: skip resolving the edges
+    // and collecting the blocks
+    bool cached = (d_flat_stamp != 0 && subtree_stamp() == d_flat_stamp);
+    if (!cached) {
+        d_flat_stamp = 0;
+        d_flat_edges.clear();
+        for (p = edges.begin(); p != edges.end(); p++) {
+            if (HIER_BLOCK2_DETAIL_DEBUG)
+                std::cout << "Flattening edge " << (*p) << std::endl;
 
-        endpoint_vector_t src_endps = resolve_endpoint(p->src(), false);
-        endpoint_vector_t dst_endps = resolve_endpoint(p->dst(), true);
+            endpoint_vector_t src_endps = resolve_endpoint(p->src(), false);
+            endpoint_vector_t dst_endps = resolve_endpoint(p->dst(), true);
 
-        endpoint_viter_t s, d;
-        for (s = src_endps.begin(); s != src_endps.end(); s++) {
-            for (d = dst_endps.begin(); d != dst_endps.end(); d++) {
-                if (HIER_BLOCK2_DETAIL_DEBUG)
-                    std::cout << (*s) << "->" << (*d) << std::endl;
-                sfg->connect(*s, *d);
+            endpoint_viter_t s, d;
+            for (s = src_endps.begin(); s != src_endps.end(); s++) {
+                for (d = dst_endps.begin(); d != dst_endps.end(); d++) {
+                    if (HIER_BLOCK2_DETAIL_DEBUG)
+                        std::cout << (*s) << "->" << (*d) << std::endl;
+                    d_flat_edges.push_back(edge(*s, *d));
+                }
             }
         }
     }
 
+    for (const auto& e : d_flat_edges)
+        sfg->connect(e.src(), e.dst());
+
     // loop through flattening hierarchical connections
     if (HIER_BLOCK2_DETAIL_DEBUG)
         std::cout << "Flattening msg connections: " << std::endl;
@@ -763,35 +813,53 @@ void hier_block2_detail::flatten_aux(flat_flowgraph_sptr sfg) const
 
     // Construct unique list of blocks used either in edges, inputs,
     // outputs, or by themselves.  I still hate STL.
-    basic_block_vector_t blocks; // unique list of used blocks
-    basic_block_vector_t tmp = d_fg->calc_used_blocks();
-
-    // First add the list of singleton blocks
     std::vector<basic_block_sptr>::const_iterator b; // Because flatten_aux is const
-    for (b = d_blocks.begin(); b != d_blocks.end(); b++) {
-        tmp.push_back(*b);
-    }
+    if (!cached) {
+        basic_block_vector_t tmp = d_fg->calc_used_blocks();
 
-    // Now add the list of connected input blocks
-    std::stringstream msg;
-    for (unsigned int i = 0; i < d_inputs.size(); i++) {
-        if (d_inputs[i].empty()) {
-            msg << "In hierarchical block " << d_owner->name() << ", input " << i
-                << " is not connected internally";
-            throw std::runtime_error(msg.str());
+        // First add the list of singleton blocks
+        for (b = d_blocks.begin(); b != d_blocks.end(); b++) {
+            tmp.push_back(*b);
+        }
+
+        // Now add the list of connected input blocks
+        std::stringstream msg;
+        for (unsigned int i = 0; i < d_inputs.size(); i++) {
+            if (d_inputs[i].empty()) {
+                msg << "In hierarchical block " << d_owner->name() << ", input " << i
+                    << " is not connected internally";
+                throw std::runtime_error(msg.str());
+            }
+
+            for (unsigned int j = 0; j < d_inputs[i].size(); j++)
+                tmp.push_back(d_inputs[i][j].block());
         }
 
-        for (unsigned int j = 0; j < d_inputs[i].size(); j++)
-            tmp.push_back(d_inputs[i][j].block());
+        for (unsigned int i = 0; i < d_outputs.size(); i++) {
+            if (!d_outputs[i].block()) {
+                msg << "In hierarchical block " << d_owner->name() << ", output " << i
+                    << " is not connected internally";
+                throw std::runtime_error(msg.str());
+            }
+            tmp.push_back(d_outputs[i].block());
+        }
+        sort(tmp.begin(), tmp.end());
+
+        d_flat_blocks.clear();
+        std::insert_iterator<basic_block_vector_t> inserter(d_flat_blocks,
+                                                            d_flat_blocks.begin());
+        unique_copy(tmp.begin(), tmp.end(), inserter);
+
+        d_flat_children.clear();
+        for (b = d_flat_blocks.begin(); b != d_flat_blocks.end(); b++) {
+            hier_block2_sptr hier_block2(cast_to_hier_block2_sptr(*b));
+            if (hier_block2 && (hier_block2.get() != d_owner))
+                d_flat_children.push_back(hier_block2->d_detail.get());
+        }
     }
 
     for (unsigned int i = 0; i < d_outputs.size(); i++) {
         basic_block_sptr blk = d_outputs[i].block();
-        if (!blk) {
-            msg << "In hierarchical block " << d_owner->name() << ", output " << i
-                << " is not connected internally";
-            throw std::runtime_error(msg.str());
-        }
         // Set the buffers of only the blocks connected to the hier output
         if (!set_all_min_buff) {
             min_buff = d_owner->min_output_buffer(i);
@@ -841,22 +909,14 @@ void hier_block2_detail::flatten_aux(flat_flowgraph_sptr sfg) const
                 }
             }
         }
-        tmp.push_back(blk);
     }
-    sort(tmp.begin(), tmp.end());
-
-    std::insert_iterator<basic_block_vector_t> inserter(blocks, blocks.begin());
-    unique_copy(tmp.begin(), tmp.end(), inserter);
 
     // Recurse hierarchical children
-    for (basic_block_viter_t p = blocks.begin(); p != blocks.end(); p++) {
-        hier_block2_sptr hier_block2(cast_to_hier_block2_sptr(*p));
-        if (hier_block2 && (hier_block2.get() != d_owner)) {
-            if (HIER_BLOCK2_DETAIL_DEBUG)
-                std::cout << "flatten_aux: recursing into hierarchical block "
-                          << hier_block2->alias() << std::endl;
-            hier_block2->d_detail->flatten_aux(sfg);
-        }
+    for (const hier_block2_detail* child : d_flat_children) {
+        if (HIER_BLOCK2_DETAIL_DEBUG)
+            std::cout << "flatten_aux: recursing into hierarchical block "
+                      << child->d_owner->alias() << std::endl;
+        child->flatten_aux(sfg);
     }
 
     // prune any remaining hier connections
@@ -874,13 +934,16 @@ void hier_block2_detail::flatten_aux(flat_flowgraph_sptr sfg) const
 
     // if ctrlport is enabled, call setup RPC for all blocks in the flowgraph
     if (ctrlport_on) {
-        for (b = blocks.begin(); b != blocks.end(); b++) {
+        for (b = d_flat_blocks.begin(); b != d_flat_blocks.end(); b++) {
             if (!(*b)->is_rpc_set()) {
                 (*b)->setup_rpc();
                 (*b)->rpc_set();
             }
         }
     }
+
+    // The children have been through this, so their stamps are known
+    d_flat_stamp = subtree_stamp();
 }
 
 void hier_block2_detail::lock()
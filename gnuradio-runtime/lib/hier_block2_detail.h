@@ -15,6 +15,8 @@
 #include <gnuradio/hier_block2.h>
 #include <flat_flowgraph.h>
 #include <boost/core/noncopyable.hpp>
+#include <cstdint>
+#include <vector>
 
 namespace gr {
 
@@ -65,6 +67,20 @@ private:
     endpoint_vector_t d_outputs; // Single internal endpoint per external output
     basic_block_vector_t d_blocks;
 
+    // What flatten_aux() worked out last time: my edges resolved to
+    // edges between primitive blocks, and the blocks I use. Reused as
+    // long as neither this block nor one inside it changes, which the
+    // stamps tell: every change to a block takes the next stamp. A
+    // change also empties the cache of the block and its parents.
+    uint64_t d_changed; // stamp of my last change
+    mutable uint64_t d_flat_stamp;
+    mutable edge_vector_t d_flat_edges;
+    mutable basic_block_vector_t d_flat_blocks;
+    mutable std::vector<const hier_block2_detail*> d_flat_children;
+
+    void changed();
+    uint64_t subtree_stamp() const;
+
     void refresh_io_signature();
     void connect_input(int my_port, int port, basic_block_sptr block);
     void connect_output(int my_port, int port, basic_block_sptr block);
@@ -0,0 +1,140 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/msg_port_queue.h>
+#include <utility>
+
+namespace gr {
+
+struct msg_port_queue::node {
+    std::atomic<node*> next;
+    pmt::pmt_t msg;
+
+    node() : next(nullptr) {}
+    explicit node(pmt::pmt_t m) : next(nullptr), msg(std::move(m)) {}
+};
+
+msg_port_queue::msg_port_queue() : d_head(new node()), d_size(0)
+{
+    d_tail = d_head.load(std::memory_order_relaxed);
+}
+
+msg_port_queue::~msg_port_queue()
+{
+    node* n = d_tail;
+    while (n) {
+        node* next = n->next.load(std::memory_order_relaxed);
+        delete n;
+        n = next;
+    }
+}
+
+void msg_port_queue::push(pmt::pmt_t msg)
+{
+    node* n = new node(std::move(msg));
+
+    // Count it first, so size() never goes below what pop() can see
+    d_size.fetch_add(1, std::memory_order_release);
+
+    // Until the second store the consumer stops at prev, and only sees
+    // the message once it's completely linked in.
+    node* prev = d_head.exchange(n, std::memory_order_acq_rel);
+    prev->next.store(n, std::memory_order_release);
+}
+
+bool msg_port_queue::pop_locked(pmt::pmt_t& msg)
+{
+    node* tail = d_tail;
+    node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr)
+        return false;
+
+    // next becomes the consumed node, so hand out its message
+    msg = std::move(next->msg);
+    d_tail = next;
+    delete tail;
+    d_size.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+pmt::pmt_t msg_port_queue::pop()
+{
+    pmt::pmt_t msg;
+    if (empty())
+        return msg;
+
+    gr::thread::scoped_lock guard(d_mutex);
+    pop_locked(msg);
+    return msg;
+}
+
+size_t msg_port_queue::drain(std::vector<pmt::pmt_t>& msgs, size_t max)
+{
+    if (empty())
+        return 0;
+
+    gr::thread::scoped_lock guard(d_mutex);
+    size_t n = 0;
+    pmt::pmt_t msg;
+    while (n < max && pop_locked(msg)) {
+        msgs.push_back(std::move(msg));
+        n++;
+    }
+    return n;
+}
+
+size_t msg_port_queue::linked_size() const
+{
+    gr::thread::scoped_lock guard(d_mutex);
+    size_t n = 0;
+    for (node* i = d_tail->next.load(std::memory_order_acquire); i;
+         i = i->next.load(std::memory_order_acquire))
+        n++;
+    return n;
+}
+
+pmt::pmt_t msg_port_queue::at(size_t index) const
+{
+    gr::thread::scoped_lock guard(d_mutex);
+    node* n = d_tail->next.load(std::memory_order_acquire);
+    for (; n && index > 0; index--)
+        n = n->next.load(std::memory_order_acquire);
+    return n ? n->msg : pmt::pmt_t();
+}
+
+void msg_port_queue::erase(iterator it)
+{
+    gr::thread::scoped_lock guard(d_mutex);
+    node* oldest = d_tail->next.load(std::memory_order_acquire);
+    node* n = oldest;
+    for (size_t i = 0; n && i < it.d_index; i++)
+        n = n->next.load(std::memory_order_acquire);
+    if (!n)
+        return;
+
+    // Producers may be linking in behind the newest node, so the links
+    // stay as they are: the messages before the erased one move one node
+    // on, and the oldest node is consumed.
+    pmt::pmt_t msg = oldest->msg;
+    n = oldest;
+    for (size_t i = 0; i < it.d_index; i++) {
+        n = n->next.load(std::memory_order_acquire);
+        std::swap(msg, n->msg);
+    }
+
+    pmt::pmt_t dropped;
+    pop_locked(dropped);
+}
+
+} /* namespace gr */
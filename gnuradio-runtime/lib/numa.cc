@@ -0,0 +1,175 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "numa.h"
+#include "pagesize.h"
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__) && defined(HAVE_LINUX_MEMPOLICY_H)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define GR_HAVE_NUMA
+#endif
+
+namespace gr {
+namespace numa {
+
+#ifdef GR_HAVE_NUMA
+
+static const char* s_node_path = "/sys/devices/system/node/node%d/cpulist";
+
+// Parse a sysfs CPU list such as "0-3,8-11"
+static std::vector<int> parse_cpulist(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        int first, last;
+        char dash;
+        std::stringstream rs(range);
+        if (!(rs >> first))
+            continue;
+        last = first;
+        if (rs >> dash >> last && dash != '-')
+            continue;
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+static std::vector<std::vector<int>> read_nodes()
+{
+    std::vector<std::vector<int>> nodes;
+    while (true) {
+        std::ifstream f(boost::str(boost::format(s_node_path) % nodes.size()));
+        std::string list;
+        if (!f || !std::getline(f, list))
+            break;
+        nodes.push_back(parse_cpulist(list));
+    }
+    if (nodes.empty())
+        nodes.resize(1);
+    return nodes;
+}
+
+// The topology doesn't change while we're running
+static const std::vector<std::vector<int>>& nodes()
+{
+    static const std::vector<std::vector<int>> s_nodes = read_nodes();
+    return s_nodes;
+}
+
+int num_nodes() { return nodes().size(); }
+
+int node_of_cpu(int cpu)
+{
+    for (size_t n = 0; n < nodes().size(); n++) {
+        for (int c : nodes()[n]) {
+            if (c == cpu)
+                return n;
+        }
+    }
+    return 0;
+}
+
+std::vector<int> node_cpus(int node)
+{
+    if (node < 0 || node >= num_nodes())
+        return std::vector<int>();
+    return nodes()[node];
+}
+
+bool bind_memory(void* addr, size_t len, int node)
+{
+    if (node < 0 || node >= num_nodes() || num_nodes() < 2)
+        return false;
+
+    const size_t bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] = 1UL << (node % bits);
+
+    return syscall(SYS_mbind,
+                   addr,
+                   len,
+                   MPOL_PREFERRED,
+                   mask.data(),
+                   mask.size() * bits,
+                   MPOL_MF_MOVE) == 0;
+}
+
+// Node of every page starting at addr, negative for pages not mapped there
+static std::vector<int> page_nodes(uintptr_t addr, size_t npages)
+{
+    // With no target nodes, move_pages() only reports where pages are
+    std::vector<void*> pages(npages);
+    std::vector<int> status(npages, -1);
+    for (size_t i = 0; i < npages; i++)
+        pages[i] = reinterpret_cast<void*>(addr + i * gr::pagesize());
+    if (syscall(SYS_move_pages, 0, npages, pages.data(), nullptr, status.data(), 0) != 0)
+        std::fill(status.begin(), status.end(), -1);
+    return status;
+}
+
+std::vector<size_t> bytes_per_node(const void* addr, size_t len, const void* alias)
+{
+    std::vector<size_t> bytes(num_nodes(), 0);
+    size_t page = gr::pagesize();
+    uintptr_t first = reinterpret_cast<uintptr_t>(addr) & ~(page - 1);
+    size_t npages = (reinterpret_cast<uintptr_t>(addr) + len - first + page - 1) / page;
+
+    std::vector<int> status = page_nodes(first, npages);
+    if (alias) {
+        uintptr_t offset = reinterpret_cast<uintptr_t>(addr) - first;
+        std::vector<int> alias_status =
+            page_nodes(reinterpret_cast<uintptr_t>(alias) - offset, npages);
+        for (size_t i = 0; i < npages; i++) {
+            if (status[i] < 0)
+                status[i] = alias_status[i];
+        }
+    }
+
+    for (int s : status) {
+        if (s >= 0 && s < num_nodes())
+            bytes[s] += page;
+    }
+    return bytes;
+}
+
+#else
+
+int num_nodes() { return 1; }
+
+int node_of_cpu(int cpu) { return 0; }
+
+std::vector<int> node_cpus(int node) { return std::vector<int>(); }
+
+bool bind_memory(void* addr, size_t len, int node) { return false; }
+
+std::vector<size_t> bytes_per_node(const void* addr, size_t len, const void* alias)
+{
+    return std::vector<size_t>(1, 0);
+}
+
+#endif /* GR_HAVE_NUMA */
+
+} /* namespace numa */
+} /* namespace gr */
@@ -0,0 +1,63 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_RUNTIME_NUMA_H
+#define INCLUDED_GR_RUNTIME_NUMA_H
+
+#include <gnuradio/api.h>
+#include <cstddef>
+#include <vector>
+
+namespace gr {
+namespace numa {
+
+/*!
+ * \brief Minimal NUMA support for buffer and thread placement.
+ * \ingroup internal
+ *
+ * Talks to the kernel directly (sysfs and the mbind/move_pages system
+ * calls), so no libnuma is needed. On systems without NUMA support
+ * there is a single node 0 and the calls below do nothing.
+ */
+
+//! Number of NUMA nodes with CPUs; 1 if NUMA isn't supported.
+GR_RUNTIME_API int num_nodes();
+
+//! NUMA node CPU \p cpu belongs to, 0 if unknown.
+GR_RUNTIME_API int node_of_cpu(int cpu);
+
+//! The CPUs of NUMA node \p node; empty if unknown.
+GR_RUNTIME_API std::vector<int> node_cpus(int node);
+
+/*!
+ * \brief Bind the pages of [\p addr, \p addr + \p len) to NUMA node \p node.
+ *
+ * \p addr must be page aligned. Pages touched later are allocated on
+ * \p node (falling back to other nodes if it runs out of memory);
+ * pages already present are moved where possible.
+ *
+ * \returns true if the policy was set
+ */
+GR_RUNTIME_API bool bind_memory(void* addr, size_t len, int node);
+
+/*!
+ * \brief How many bytes of [\p addr, \p addr + \p len) are resident on
+ * each NUMA node, indexed by node.
+ *
+ * Only pages mapped at \p addr or, if given, at \p alias (the second
+ * copy of a doubly mapped buffer) are counted.
+ */
+GR_RUNTIME_API std::vector<size_t>
+bytes_per_node(const void* addr, size_t len, const void* alias = nullptr);
+
+} /* namespace numa */
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_RUNTIME_NUMA_H */
@@ -17,11 +17,26 @@
 namespace gr {
 namespace metadata_keys {
 
+const pmt::pmt_t packet_len()
+{
+    static const pmt::pmt_t val = pmt::mp("packet_len");
+    return val;
+}
 const pmt::pmt_t pdu_num()
 {
     static const pmt::pmt_t val = pmt::mp("pdu_num");
     return val;
 }
+const pmt::pmt_t rx_freq()
+{
+    static const pmt::pmt_t val = pmt::mp("rx_freq");
+    return val;
+}
+const pmt::pmt_t rx_rate()
+{
+    static const pmt::pmt_t val = pmt::mp("rx_rate");
+    return val;
+}
 const pmt::pmt_t rx_time()
 {
     static const pmt::pmt_t val = pmt::mp("rx_time");
@@ -16,8 +16,11 @@
 #include <gnuradio/messages/msg_accepter.h>
 #include <pmt/pmt.h>
 #include <pmt/pmt_pool.h>
+#include <atomic>
 #include <cstdio>
 #include <cstring>
+#include <deque>
+#include <memory>
 #include <vector>
 
 namespace pmt {
@@ -31,78 +34,91 @@ pmt_base::~pmt_base()
 //                         Exceptions
 ////////////////////////////////////////////////////////////////////////////
 
-exception::exception(const std::string& msg, pmt_t obj)
+exception::exception(const std::string& msg, const pmt_t& obj)
     : logic_error(msg + ": " + write_string(obj))
 {
 }
 
-wrong_type::wrong_type(const std::string& msg, pmt_t obj)
+wrong_type::wrong_type(const std::string& msg, const pmt_t& obj)
     : invalid_argument(msg + ": wrong_type " + write_string(obj))
 {
 }
 
-out_of_range::out_of_range(const std::string& msg, pmt_t obj)
+out_of_range::out_of_range(const std::string& msg, const pmt_t& obj)
     : exception(msg + ": out of range ", obj)
 {
 }
 
-notimplemented::notimplemented(const std::string& msg, pmt_t obj)
+notimplemented::notimplemented(const std::string& msg, const pmt_t& obj)
     : exception(msg + ": notimplemented ", obj)
 {
 }
 
 ////////////////////////////////////////////////////////////////////////////
-//                          Dynamic Casts
+//                               Casts
 ////////////////////////////////////////////////////////////////////////////
 
-static pmt_symbol* _symbol(pmt_t x) { return dynamic_cast<pmt_symbol*>(x.get()); }
+// Only valid once the type tag says x is one
 
-static pmt_integer* _integer(pmt_t x) { return dynamic_cast<pmt_integer*>(x.get()); }
+static pmt_symbol* _symbol(const pmt_t& x) { return static_cast<pmt_symbol*>(x.get()); }
 
-static pmt_uint64* _uint64(pmt_t x) { return dynamic_cast<pmt_uint64*>(x.get()); }
+static pmt_integer* _integer(const pmt_t& x)
+{
+    return static_cast<pmt_integer*>(x.get());
+}
 
-static pmt_real* _real(pmt_t x) { return dynamic_cast<pmt_real*>(x.get()); }
+static pmt_uint64* _uint64(const pmt_t& x) { return static_cast<pmt_uint64*>(x.get()); }
 
-static pmt_complex* _complex(pmt_t x) { return dynamic_cast<pmt_complex*>(x.get()); }
+static pmt_real* _real(const pmt_t& x) { return static_cast<pmt_real*>(x.get()); }
 
-static pmt_pair* _pair(pmt_t x) { return dynamic_cast<pmt_pair*>(x.get()); }
+static pmt_complex* _complex(const pmt_t& x)
+{
+    return static_cast<pmt_complex*>(x.get());
+}
 
-static pmt_vector* _vector(pmt_t x) { return dynamic_cast<pmt_vector*>(x.get()); }
+static pmt_pair* _pair(const pmt_t& x) { return static_cast<pmt_pair*>(x.get()); }
 
-static pmt_tuple* _tuple(pmt_t x) { return dynamic_cast<pmt_tuple*>(x.get()); }
+static pmt_vector* _vector(const pmt_t& x) { return static_cast<pmt_vector*>(x.get()); }
 
-static pmt_uniform_vector* _uniform_vector(pmt_t x)
+static pmt_tuple* _tuple(const pmt_t& x) { return static_cast<pmt_tuple*>(x.get()); }
+
+static pmt_uniform_vector* _uniform_vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_uniform_vector*>(x.get());
+    return static_cast<pmt_uniform_vector*>(x.get());
 }
 
-static pmt_any* _any(pmt_t x) { return dynamic_cast<pmt_any*>(x.get()); }
+static pmt_any* _any(const pmt_t& x) { return static_cast<pmt_any*>(x.get()); }
+
+static pmt_hash_dict* _hash_dict(const pmt_t& x)
+{
+    return static_cast<pmt_hash_dict*>(x.get());
+}
 
 ////////////////////////////////////////////////////////////////////////////
 //                           Globals
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_null::pmt_null() {}
+pmt_null::pmt_null() : pmt_base(NIL) {}
 
-pmt_t get_PMT_NIL()
+const pmt_t& get_PMT_NIL()
 {
     static pmt_t _NIL = pmt_t(new pmt_null());
     return _NIL;
 }
 
-pmt_t get_PMT_T()
+const pmt_t& get_PMT_T()
 {
     static const pmt_t _T = pmt_t(new pmt_bool());
     return _T;
 }
 
-pmt_t get_PMT_F()
+const pmt_t& get_PMT_F()
 {
     static const pmt_t _F = pmt_t(new pmt_bool());
     return _F;
 }
 
-pmt_t get_PMT_EOF()
+const pmt_t& get_PMT_EOF()
 {
     static const pmt_t _EOF = cons(get_PMT_NIL(), get_PMT_NIL());
     return _EOF;
@@ -112,17 +128,17 @@ pmt_t get_PMT_EOF()
 //                           Booleans
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_bool::pmt_bool() {}
+pmt_bool::pmt_bool() : pmt_base(BOOL) {}
 
-bool is_true(pmt_t obj) { return obj != PMT_F; }
+bool is_true(const pmt_t& obj) { return obj != PMT_F; }
 
-bool is_false(pmt_t obj) { return obj == PMT_F; }
+bool is_false(const pmt_t& obj) { return obj == PMT_F; }
 
-bool is_bool(pmt_t obj) { return obj->is_bool(); }
+bool is_bool(const pmt_t& obj) { return obj->is_bool(); }
 
 pmt_t from_bool(bool val) { return val ? PMT_T : PMT_F; }
 
-bool to_bool(pmt_t val)
+bool to_bool(const pmt_t& val)
 {
     if (val == PMT_T)
         return true;
@@ -135,52 +151,136 @@ bool to_bool(pmt_t val)
 //                             Symbols
 ////////////////////////////////////////////////////////////////////////////
 
-static const unsigned int get_symbol_hash_table_size()
+namespace {
+
+// A symbol in the table; symbols live as long as the process does
+struct symbol_entry {
+    size_t hash;
+    pmt_t sym;
+
+    const std::string& name() const
+    {
+        return static_cast<pmt_symbol*>(sym.get())->name();
+    }
+};
+
+/*
+ * Open addressing with linear probing, kept at most half full.  A slot
+ * goes from empty to an entry once and never changes after that, so
+ * lookups take no lock.  Inserts are serialized; one that would fill
+ * the table more than half publishes a copy twice the size instead.
+ * Lookups still running on the old table may miss symbols added since
+ * and retry under the lock, so old tables are kept, never freed.
+ */
+struct symbol_table {
+    const size_t mask;
+    std::unique_ptr<std::atomic<const symbol_entry*>[]> slots;
+
+    explicit symbol_table(size_t size)
+        : mask(size - 1), slots(new std::atomic<const symbol_entry*>[size])
+    {
+        for (size_t i = 0; i < size; i++)
+            slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    size_t size() const { return mask + 1; }
+
+    const symbol_entry* find(const std::string& name, size_t hash) const
+    {
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const symbol_entry* e = slots[i].load(std::memory_order_acquire);
+            if (!e)
+                return nullptr;
+            if (e->hash == hash && e->name() == name)
+                return e;
+        }
+    }
+
+    void add(const symbol_entry* e)
+    {
+        size_t i = e->hash & mask;
+        while (slots[i].load(std::memory_order_relaxed))
+            i = (i + 1) & mask;
+        slots[i].store(e, std::memory_order_release);
+    }
+};
+
+struct symbol_tables {
+    static constexpr size_t INITIAL_SIZE = 8192;
+
+    std::atomic<const symbol_table*> current;
+    boost::mutex mutex; // serializes inserts
+    std::deque<symbol_entry> entries;
+    std::vector<std::unique_ptr<symbol_table>> tables;
+
+    symbol_tables()
+    {
+        tables.emplace_back(new symbol_table(INITIAL_SIZE));
+        current.store(tables.back().get(), std::memory_order_release);
+    }
+};
+
+// Function static, so symbols can be interned during static initialization
+symbol_tables& get_symbol_tables()
 {
-    static const unsigned int SYMBOL_HASH_TABLE_SIZE = 8192;
-    return SYMBOL_HASH_TABLE_SIZE;
+    static symbol_tables s_symbol_tables;
+    return s_symbol_tables;
 }
 
-static std::vector<pmt_t>* get_symbol_hash_table()
+const symbol_entry* insert_symbol(const std::string& name, size_t hash)
 {
-    static std::vector<pmt_t> s_symbol_hash_table(get_symbol_hash_table_size());
-    return &s_symbol_hash_table;
+    symbol_tables& t = get_symbol_tables();
+    boost::mutex::scoped_lock lock(t.mutex);
+
+    // Another thread may have added it since we looked
+    symbol_table* table = t.tables.back().get();
+    if (const symbol_entry* e = table->find(name, hash))
+        return e;
+
+    if (2 * (t.entries.size() + 1) > table->size()) {
+        t.tables.emplace_back(new symbol_table(2 * table->size()));
+        table = t.tables.back().get();
+        for (const symbol_entry& e : t.entries)
+            table->add(&e);
+        t.current.store(table, std::memory_order_release);
+    }
+
+    t.entries.push_back({ hash, pmt_t(new pmt_symbol(name)) });
+    table->add(&t.entries.back());
+    return &t.entries.back();
 }
 
-pmt_symbol::pmt_symbol(const std::string& name) : d_name(name) {}
+// Per thread cache of the symbols looked up last, by hash
+constexpr size_t SYMBOL_CACHE_SIZE = 64;
+thread_local const symbol_entry* t_symbol_cache[SYMBOL_CACHE_SIZE];
+
+} // namespace
+
+pmt_symbol::pmt_symbol(const std::string& name) : pmt_base(SYMBOL), d_name(name) {}
 
 
 bool is_symbol(const pmt_t& obj) { return obj->is_symbol(); }
 
-pmt_t string_to_symbol(const std::string& name)
+const pmt_t& string_to_symbol(const std::string& name)
 {
-    unsigned hash = std::hash<std::string>()(name) % get_symbol_hash_table_size();
+    size_t hash = std::hash<std::string>()(name);
 
-    // Does a symbol with this name already exist?
-    for (pmt_t sym = (*get_symbol_hash_table())[hash]; sym; sym = _symbol(sym)->next()) {
-        if (name == _symbol(sym)->name())
-            return sym; // Yes.  Return it
-    }
+    const symbol_entry*& cached = t_symbol_cache[hash % SYMBOL_CACHE_SIZE];
+    if (cached && cached->hash == hash && cached->name() == name)
+        return cached->sym;
 
-    // Lock the table on insert for thread safety:
-    static boost::mutex thread_safety;
-    boost::mutex::scoped_lock lock(thread_safety);
-    // Re-do the search in case another thread inserted this symbol into the table
-    // before we got the lock
-    for (pmt_t sym = (*get_symbol_hash_table())[hash]; sym; sym = _symbol(sym)->next()) {
-        if (name == _symbol(sym)->name())
-            return sym; // Yes.  Return it
-    }
+    const symbol_table* table =
+        get_symbol_tables().current.load(std::memory_order_acquire);
+    const symbol_entry* e = table->find(name, hash);
+    if (!e)
+        e = insert_symbol(name, hash);
 
-    // Nope.  Make a new one.
-    pmt_t sym = pmt_t(new pmt_symbol(name));
-    _symbol(sym)->set_next((*get_symbol_hash_table())[hash]);
-    (*get_symbol_hash_table())[hash] = sym;
-    return sym;
+    cached = e;
+    return e->sym;
 }
 
 // alias...
-pmt_t intern(const std::string& name) { return string_to_symbol(name); }
+const pmt_t& intern(const std::string& name) { return string_to_symbol(name); }
 
 const std::string symbol_to_string(const pmt_t& sym)
 {
@@ -195,24 +295,23 @@ const std::string symbol_to_string(const pmt_t& sym)
 //                             Number
 ////////////////////////////////////////////////////////////////////////////
 
-bool is_number(pmt_t x) { return x->is_number(); }
+bool is_number(const pmt_t& x) { return x->is_number(); }
 
 ////////////////////////////////////////////////////////////////////////////
 //                             Integer
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_integer::pmt_integer(long value) : d_value(value) {}
+pmt_integer::pmt_integer(long value) : pmt_base(INTEGER), d_value(value) {}
 
-bool is_integer(pmt_t x) { return x->is_integer(); }
+bool is_integer(const pmt_t& x) { return x->is_integer(); }
 
 
 pmt_t from_long(long x) { return pmt_t(new pmt_integer(x)); }
 
-long to_long(pmt_t x)
+long to_long(const pmt_t& x)
 {
-    pmt_integer* i = dynamic_cast<pmt_integer*>(x.get());
-    if (i)
-        return i->value();
+    if (x->is_integer())
+        return _integer(x)->value();
 
     throw wrong_type("pmt_to_long", x);
 }
@@ -221,21 +320,24 @@ long to_long(pmt_t x)
 //                             Uint64
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_uint64::pmt_uint64(uint64_t value) : d_value(value) {}
+pmt_uint64::pmt_uint64(uint64_t value) : pmt_base(UINT64), d_value(value) {}
 
-bool is_uint64(pmt_t x) { return x->is_uint64(); }
+bool is_uint64(const pmt_t& x) { return x->is_uint64(); }
 
 
 pmt_t from_uint64(uint64_t x) { return pmt_t(new pmt_uint64(x)); }
 
-uint64_t to_uint64(pmt_t x)
+uint64_t to_uint64(const pmt_t& x)
 {
-    if (x->is_uint64())
+    switch (x->type()) {
+    case pmt_base::UINT64:
         return _uint64(x)->value();
-    if (x->is_integer()) {
-        long tmp = _integer(x)->value();
-        if (tmp >= 0)
-            return (uint64_t)tmp;
+    case pmt_base::INTEGER:
+        if (_integer(x)->value() >= 0)
+            return (uint64_t)_integer(x)->value();
+        break;
+    default:
+        break;
     }
 
     throw wrong_type("pmt_to_uint64", x);
@@ -245,33 +347,38 @@ uint64_t to_uint64(pmt_t x)
 //                              Real
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_real::pmt_real(double value) : d_value(value) {}
+pmt_real::pmt_real(double value) : pmt_base(REAL), d_value(value) {}
 
-bool is_real(pmt_t x) { return x->is_real(); }
+bool is_real(const pmt_t& x) { return x->is_real(); }
 
 pmt_t from_double(double x) { return pmt_t(new pmt_real(x)); }
 
 pmt_t from_float(float x) { return pmt_t(new pmt_real(x)); }
 
-double to_double(pmt_t x)
+double to_double(const pmt_t& x)
 {
-    if (x->is_real())
+    switch (x->type()) {
+    case pmt_base::REAL:
         return _real(x)->value();
-    if (x->is_integer())
+    case pmt_base::INTEGER:
         return _integer(x)->value();
-
-    throw wrong_type("pmt_to_double", x);
+    default:
+        throw wrong_type("pmt_to_double", x);
+    }
 }
 
-float to_float(pmt_t x) { return float(to_double(x)); }
+float to_float(const pmt_t& x) { return float(to_double(x)); }
 
 ////////////////////////////////////////////////////////////////////////////
 //                              Complex
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_complex::pmt_complex(std::complex<double> value) : d_value(value) {}
+pmt_complex::pmt_complex(std::complex<double> value)
+    : pmt_base(COMPLEX), d_value(value)
+{
+}
 
-bool is_complex(pmt_t x) { return x->is_complex(); }
+bool is_complex(const pmt_t& x) { return x->is_complex(); }
 
 pmt_t make_rectangular(double re, double im) { return from_complex(re, im); }
 
@@ -289,25 +396,30 @@ pmt_t pmt_from_complex(const std::complex<double>& z)
 
 pmt_t from_complex(const std::complex<double>& z) { return pmt_t(new pmt_complex(z)); }
 
-std::complex<double> to_complex(pmt_t x)
+std::complex<double> to_complex(const pmt_t& x)
 {
-    if (x->is_complex())
+    switch (x->type()) {
+    case pmt_base::COMPLEX:
         return _complex(x)->value();
-    if (x->is_real())
+    case pmt_base::REAL:
         return _real(x)->value();
-    if (x->is_integer())
+    case pmt_base::INTEGER:
         return _integer(x)->value();
-
-    throw wrong_type("pmt_to_complex", x);
+    default:
+        throw wrong_type("pmt_to_complex", x);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////
 //                              Pairs
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_pair::pmt_pair(const pmt_t& car, const pmt_t& cdr) : d_car(car), d_cdr(cdr) {}
+pmt_pair::pmt_pair(const pmt_t& car, const pmt_t& cdr, type_tag type)
+    : pmt_base(type), d_car(car), d_cdr(cdr)
+{
+}
 
-bool is_null(const pmt_t& x) { return x == PMT_NIL; }
+bool is_null(const pmt_t& x) { return x->is_null(); }
 
 bool is_pair(const pmt_t& obj) { return obj->is_pair(); }
 
@@ -315,23 +427,21 @@ pmt_t cons(const pmt_t& x, const pmt_t& y) { return pmt_t(new pmt_pair(x, y)); }
 
 pmt_t car(const pmt_t& pair)
 {
-    pmt_pair* p = dynamic_cast<pmt_pair*>(pair.get());
-    if (p)
-        return p->car();
+    if (pair->is_pair())
+        return _pair(pair)->d_car;
 
     throw wrong_type("pmt_car", pair);
 }
 
 pmt_t cdr(const pmt_t& pair)
 {
-    pmt_pair* p = dynamic_cast<pmt_pair*>(pair.get());
-    if (p)
-        return p->cdr();
+    if (pair->is_pair())
+        return _pair(pair)->d_cdr;
 
     throw wrong_type("pmt_cdr", pair);
 }
 
-void set_car(pmt_t pair, pmt_t obj)
+void set_car(const pmt_t& pair, const pmt_t& obj)
 {
     if (pair->is_pair())
         _pair(pair)->set_car(obj);
@@ -339,7 +449,7 @@ void set_car(pmt_t pair, pmt_t obj)
         throw wrong_type("pmt_set_car", pair);
 }
 
-void set_cdr(pmt_t pair, pmt_t obj)
+void set_cdr(const pmt_t& pair, const pmt_t& obj)
 {
     if (pair->is_pair())
         _pair(pair)->set_cdr(obj);
@@ -351,7 +461,7 @@ void set_cdr(pmt_t pair, pmt_t obj)
 //                             Vectors
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_vector::pmt_vector(size_t len, pmt_t fill) : d_v(len)
+pmt_vector::pmt_vector(size_t len, const pmt_t& fill) : pmt_base(VECTOR), d_v(len)
 {
     for (size_t i = 0; i < len; i++)
         d_v[i] = fill;
@@ -364,38 +474,38 @@ pmt_t pmt_vector::ref(size_t k) const
     return d_v[k];
 }
 
-void pmt_vector::set(size_t k, pmt_t obj)
+void pmt_vector::set(size_t k, const pmt_t& obj)
 {
     if (k >= length())
         throw out_of_range("pmt_vector_set", from_long(k));
     d_v[k] = obj;
 }
 
-void pmt_vector::fill(pmt_t obj)
+void pmt_vector::fill(const pmt_t& obj)
 {
     for (size_t i = 0; i < length(); i++)
         d_v[i] = obj;
 }
 
-bool is_vector(pmt_t obj) { return obj->is_vector(); }
+bool is_vector(const pmt_t& obj) { return obj->is_vector(); }
 
-pmt_t make_vector(size_t k, pmt_t fill) { return pmt_t(new pmt_vector(k, fill)); }
+pmt_t make_vector(size_t k, const pmt_t& fill) { return pmt_t(new pmt_vector(k, fill)); }
 
-pmt_t vector_ref(pmt_t vector, size_t k)
+pmt_t vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_vector())
         throw wrong_type("pmt_vector_ref", vector);
     return _vector(vector)->ref(k);
 }
 
-void vector_set(pmt_t vector, size_t k, pmt_t obj)
+void vector_set(const pmt_t& vector, size_t k, const pmt_t& obj)
 {
     if (!vector->is_vector())
         throw wrong_type("pmt_vector_set", vector);
     _vector(vector)->set(k, obj);
 }
 
-void vector_fill(pmt_t vector, pmt_t obj)
+void vector_fill(const pmt_t& vector, const pmt_t& obj)
 {
     if (!vector->is_vector())
         throw wrong_type("pmt_vector_set", vector);
@@ -406,7 +516,7 @@ void vector_fill(pmt_t vector, pmt_t obj)
 //                             Tuples
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_tuple::pmt_tuple(size_t len) : d_v(len) {}
+pmt_tuple::pmt_tuple(size_t len) : pmt_base(TUPLE), d_v(len) {}
 
 pmt_t pmt_tuple::ref(size_t k) const
 {
@@ -415,7 +525,7 @@ pmt_t pmt_tuple::ref(size_t k) const
     return d_v[k];
 }
 
-bool is_tuple(pmt_t obj) { return obj->is_tuple(); }
+bool is_tuple(const pmt_t& obj) { return obj->is_tuple(); }
 
 pmt_t tuple_ref(const pmt_t& tuple, size_t k)
 {
@@ -595,8 +705,8 @@ pmt_t to_tuple(const pmt_t& x)
         return r;
     }
 
-    if (x->is_pair()) {
-        pmt_t y = x;
+    if (x->is_pair() || x->type() == pmt_base::HASH_DICT) {
+        pmt_t y = x->is_pair() ? x : dict_items(x);
         for (size_t i = 0; i < len; i++) {
             t->_set(i, car(y));
             y = cdr(y);
@@ -612,23 +722,23 @@ pmt_t to_tuple(const pmt_t& x)
 //                       Uniform Numeric Vectors
 ////////////////////////////////////////////////////////////////////////////
 
-bool is_uniform_vector(pmt_t x) { return x->is_uniform_vector(); }
+bool is_uniform_vector(const pmt_t& x) { return x->is_uniform_vector(); }
 
-size_t uniform_vector_itemsize(pmt_t vector)
+size_t uniform_vector_itemsize(const pmt_t& vector)
 {
     if (!vector->is_uniform_vector())
         throw wrong_type("pmt_uniform_vector_itemsize", vector);
     return _uniform_vector(vector)->itemsize();
 }
 
-const void* uniform_vector_elements(pmt_t vector, size_t& len)
+const void* uniform_vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_uniform_vector())
         throw wrong_type("pmt_uniform_vector_elements", vector);
     return _uniform_vector(vector)->uniform_elements(len);
 }
 
-void* uniform_vector_writable_elements(pmt_t vector, size_t& len)
+void* uniform_vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_uniform_vector())
         throw wrong_type("pmt_uniform_vector_writable_elements", vector);
@@ -641,19 +751,43 @@ void* uniform_vector_writable_elements(pmt_t vector, size_t& len)
 ////////////////////////////////////////////////////////////////////////////
 
 /*
- * This is an a-list implementation.
- *
- * When we need better performance for large dictionaries, consider implementing
- * persistent Red-Black trees as described in "Purely Functional Data Structures",
- * Chris Okasaki, 1998, section 3.3.
+ * make_dict() makes an a-list.  make_hash_dict() makes a pmt_hash_dict,
+ * a hash trie (see pmt_hash_dict.cc), which lists its entries in the
+ * same order an a-list would have.
  */
 
-pmt_dict::pmt_dict(const pmt_t& car, const pmt_t& cdr) : pmt_pair::pmt_pair(car, cdr) {}
+/*
+ * The (key . value) pair in alist whose key matches obj, or nullptr.
+ * Walks the list by reference, without copying (and so counting
+ * references to) any of its elements.
+ */
+template <typename Match>
+static const pmt_t* find_pair(const pmt_t& obj, const pmt_t& alist, Match match)
+{
+    for (const pmt_t* l = &alist; (*l)->is_pair(); l = &_pair(*l)->d_cdr) {
+        const pmt_t& p = _pair(*l)->d_car;
+        if (!p->is_pair()) // malformed alist
+            return nullptr;
+
+        if (match(obj, _pair(p)->d_car))
+            return &p;
+    }
+    return nullptr;
+}
+
+static const pmt_t* find_assv(const pmt_t& obj, const pmt_t& alist)
+{
+    return find_pair(obj, alist, eqv);
+}
+
+pmt_dict::pmt_dict(const pmt_t& car, const pmt_t& cdr) : pmt_pair(car, cdr, DICT) {}
 
 bool is_dict(const pmt_t& obj) { return is_null(obj) || obj->is_dict(); }
 
 pmt_t make_dict() { return PMT_NIL; }
 
+pmt_t make_hash_dict() { return pmt_t(new pmt_hash_dict(nullptr, 0, 0)); }
+
 pmt_t dcons(const pmt_t& x, const pmt_t& y)
 {
     // require arguments to be a PMT pair and PMT dictionary respectively
@@ -662,18 +796,18 @@ pmt_t dcons(const pmt_t& x, const pmt_t& y)
     if (!is_dict(y))
         throw wrong_type("pmt_dcons: not a dict", y);
 
+    if (y->type() == pmt_base::HASH_DICT) // no list to put x in front of
+        return _hash_dict(y)->add(_pair(x)->d_car, _pair(x)->d_cdr);
+
     return pmt_t(new pmt_dict(x, y));
 }
 
 pmt_t dict_add(const pmt_t& dict, const pmt_t& key, const pmt_t& value)
 {
-    if (is_null(dict))
-        return acons(key, value, PMT_NIL);
+    if (dict->type() == pmt_base::HASH_DICT)
+        return _hash_dict(dict)->add(key, value);
 
-    if (dict_has_key(dict, key))
-        return acons(key, value, dict_delete(dict, key));
-
-    return acons(key, value, dict);
+    return acons(key, value, dict_delete(dict, key));
 }
 
 pmt_t dict_update(const pmt_t& dict1, const pmt_t& dict2)
@@ -690,71 +824,102 @@ pmt_t dict_update(const pmt_t& dict1, const pmt_t& dict2)
 
 pmt_t dict_delete(const pmt_t& dict, const pmt_t& key)
 {
-    if (is_null(dict))
-        return dict;
+    if (dict->type() == pmt_base::HASH_DICT) {
+        pmt_t d = _hash_dict(dict)->remove(key);
+        return d ? d : dict;
+    }
 
-    if (eqv(caar(dict), key))
-        return cdr(dict);
+    // Copy the entries in front of key, share the ones after it
+    std::vector<const pmt_t*> before;
+    const pmt_t* l = &dict;
+    for (; (*l)->is_pair(); l = &_pair(*l)->d_cdr) {
+        const pmt_t& entry = _pair(*l)->d_car;
+        if (!entry->is_pair())
+            throw wrong_type("pmt_car", entry);
+        if (eqv(_pair(entry)->d_car, key))
+            break;
+        before.push_back(&entry);
+    }
+
+    if (!(*l)->is_pair()) {
+        if (!(*l)->is_null())
+            throw wrong_type("pmt_car", *l);
+        return dict; // not in there
+    }
 
-    return dcons(car(dict), dict_delete(cdr(dict), key));
+    pmt_t d = _pair(*l)->d_cdr;
+    for (auto e = before.rbegin(); e != before.rend(); e++)
+        d = dcons(**e, d);
+    return d;
 }
 
 pmt_t dict_ref(const pmt_t& dict, const pmt_t& key, const pmt_t& not_found)
 {
-    pmt_t p = assv(key, dict); // look for (key . value) pair
-    if (is_pair(p))
-        return cdr(p);
+    if (dict->type() == pmt_base::HASH_DICT) {
+        const pmt_t* v = _hash_dict(dict)->ref(key);
+        return v ? *v : not_found;
+    }
+
+    const pmt_t* p = find_assv(key, dict); // look for (key . value) pair
+    if (p)
+        return _pair(*p)->d_cdr;
     else
         return not_found;
 }
 
 bool dict_has_key(const pmt_t& dict, const pmt_t& key)
 {
-    return is_pair(assv(key, dict));
+    if (dict->type() == pmt_base::HASH_DICT)
+        return _hash_dict(dict)->ref(key) != nullptr;
+
+    return find_assv(key, dict) != nullptr;
 }
 
-pmt_t dict_items(pmt_t dict)
+pmt_t dict_items(const pmt_t& dict)
 {
     if (!is_dict(dict))
         throw wrong_type("pmt_dict_values", dict);
 
+    if (dict->type() == pmt_base::HASH_DICT)
+        return _hash_dict(dict)->items();
+
     return dict; // equivalent to dict in the a-list case
 }
 
-pmt_t dict_keys(pmt_t dict)
+pmt_t dict_keys(const pmt_t& dict)
 {
     if (!is_dict(dict))
         throw wrong_type("pmt_dict_keys", dict);
 
-    return map(car, dict);
+    return map(car, dict_items(dict));
 }
 
-pmt_t dict_values(pmt_t dict)
+pmt_t dict_values(const pmt_t& dict)
 {
     if (!is_dict(dict))
         throw wrong_type("pmt_dict_keys", dict);
 
-    return map(cdr, dict);
+    return map(cdr, dict_items(dict));
 }
 
 ////////////////////////////////////////////////////////////////////////////
 //                                 Any
 ////////////////////////////////////////////////////////////////////////////
 
-pmt_any::pmt_any(const boost::any& any) : d_any(any) {}
+pmt_any::pmt_any(const boost::any& any) : pmt_base(ANY), d_any(any) {}
 
-bool is_any(pmt_t obj) { return obj->is_any(); }
+bool is_any(const pmt_t& obj) { return obj->is_any(); }
 
 pmt_t make_any(const boost::any& any) { return pmt_t(new pmt_any(any)); }
 
-boost::any any_ref(pmt_t obj)
+boost::any any_ref(const pmt_t& obj)
 {
     if (!obj->is_any())
         throw wrong_type("pmt_any_ref", obj);
     return _any(obj)->ref();
 }
 
-void any_set(pmt_t obj, const boost::any& any)
+void any_set(const pmt_t& obj, const boost::any& any)
 {
     if (!obj->is_any())
         throw wrong_type("pmt_any_set", obj);
@@ -792,20 +957,20 @@ gr::messages::msg_accepter_sptr msg_accepter_ref(const pmt_t& obj)
 //             Binary Large Object -- currently a u8vector
 ////////////////////////////////////////////////////////////////////////////
 
-bool is_blob(pmt_t x) { return is_u8vector(x); }
+bool is_blob(const pmt_t& x) { return is_u8vector(x); }
 
 pmt_t make_blob(const void* buf, size_t len_in_bytes)
 {
     return init_u8vector(len_in_bytes, (const uint8_t*)buf);
 }
 
-const void* blob_data(pmt_t blob)
+const void* blob_data(const pmt_t& blob)
 {
     size_t len;
     return uniform_vector_elements(blob, len);
 }
 
-size_t blob_length(pmt_t blob)
+size_t blob_length(const pmt_t& blob)
 {
     size_t len;
     uniform_vector_elements(blob, len);
@@ -819,7 +984,8 @@ size_t blob_length(pmt_t blob)
 
 bool is_pdu(const pmt_t& obj)
 {
-    return is_pair(obj) && is_dict(car(obj)) && is_uniform_vector(cdr(obj));
+    return obj->is_pair() && is_dict(_pair(obj)->d_car) &&
+           _pair(obj)->d_cdr->is_uniform_vector();
 }
 
 bool eq(const pmt_t& x, const pmt_t& y) { return x == y; }
@@ -829,19 +995,21 @@ bool eqv(const pmt_t& x, const pmt_t& y)
     if (x == y)
         return true;
 
-    if (x->is_integer() && y->is_integer())
-        return _integer(x)->value() == _integer(y)->value();
+    if (x->type() != y->type())
+        return false;
 
-    if (x->is_uint64() && y->is_uint64())
+    switch (x->type()) {
+    case pmt_base::INTEGER:
+        return _integer(x)->value() == _integer(y)->value();
+    case pmt_base::UINT64:
         return _uint64(x)->value() == _uint64(y)->value();
-
-    if (x->is_real() && y->is_real())
+    case pmt_base::REAL:
         return _real(x)->value() == _real(y)->value();
-
-    if (x->is_complex() && y->is_complex())
+    case pmt_base::COMPLEX:
         return _complex(x)->value() == _complex(y)->value();
-
-    return false;
+    default:
+        return false;
+    }
 }
 
 bool equal(const pmt_t& x, const pmt_t& y)
@@ -850,7 +1018,13 @@ bool equal(const pmt_t& x, const pmt_t& y)
         return true;
 
     if (x->is_pair() && y->is_pair())
-        return equal(car(x), car(y)) && equal(cdr(x), cdr(y));
+        return equal(_pair(x)->d_car, _pair(y)->d_car) &&
+               equal(_pair(x)->d_cdr, _pair(y)->d_cdr);
+
+    // As a-lists, in case only one of them is
+    if ((x->type() == pmt_base::HASH_DICT && y->is_dict()) ||
+        (y->type() == pmt_base::HASH_DICT && x->is_dict()))
+        return equal(dict_items(x), dict_items(y));
 
     if (x->is_vector() && y->is_vector()) {
         pmt_vector* xv = _vector(x);
@@ -900,97 +1074,69 @@ bool equal(const pmt_t& x, const pmt_t& y)
 
 size_t length(const pmt_t& x)
 {
-    if (x->is_vector())
-        return _vector(x)->length();
-
     if (x->is_uniform_vector())
         return _uniform_vector(x)->length();
 
-    if (x->is_tuple())
+    switch (x->type()) {
+    case pmt_base::VECTOR:
+        return _vector(x)->length();
+    case pmt_base::TUPLE:
         return _tuple(x)->length();
-
-    if (x->is_null())
+    case pmt_base::NIL:
         return 0;
-
-    // also returns correct result for dictionaries
-    if (x->is_pair()) {
+    case pmt_base::HASH_DICT:
+        return _hash_dict(x)->length();
+    case pmt_base::PAIR:
+    case pmt_base::DICT: {
         size_t length = 1;
-        pmt_t it = cdr(x);
-        while (is_pair(it)) {
+        const pmt_t* it = &_pair(x)->d_cdr;
+        while ((*it)->is_pair()) {
             length++;
-            it = cdr(it);
+            it = &_pair(*it)->d_cdr;
         }
-        if (is_null(it))
+        if ((*it)->is_null())
             return length;
 
         // not a proper list
         throw wrong_type("pmt_length", x);
     }
-
-    throw wrong_type("pmt_length", x);
+    default:
+        throw wrong_type("pmt_length", x);
+    }
 }
 
-pmt_t assq(pmt_t obj, pmt_t alist)
+pmt_t assq(const pmt_t& obj, const pmt_t& alist)
 {
-    while (is_pair(alist)) {
-        pmt_t p = car(alist);
-        if (!is_pair(p)) // malformed alist
-            return PMT_F;
-
-        if (eq(obj, car(p)))
-            return p;
-
-        alist = cdr(alist);
-    }
-    return PMT_F;
+    const pmt_t* p = find_pair(obj, alist, eq);
+    return p ? *p : PMT_F;
 }
 
-pmt_t assv(pmt_t obj, pmt_t alist)
+pmt_t assv(const pmt_t& obj, const pmt_t& alist)
 {
-    while (is_pair(alist)) {
-        pmt_t p = car(alist);
-        if (!is_pair(p)) // malformed alist
-            return PMT_F;
-
-        if (eqv(obj, car(p)))
-            return p;
-
-        alist = cdr(alist);
-    }
-    return PMT_F;
+    const pmt_t* p = find_pair(obj, alist, eqv);
+    return p ? *p : PMT_F;
 }
 
 
-pmt_t assoc(pmt_t obj, pmt_t alist)
+pmt_t assoc(const pmt_t& obj, const pmt_t& alist)
 {
-    while (is_pair(alist)) {
-        pmt_t p = car(alist);
-        if (!is_pair(p)) // malformed alist
-            return PMT_F;
-
-        if (equal(obj, car(p)))
-            return p;
-
-        alist = cdr(alist);
-    }
-    return PMT_F;
+    const pmt_t* p = find_pair(obj, alist, equal);
+    return p ? *p : PMT_F;
 }
 
-pmt_t map(pmt_t proc(const pmt_t&), pmt_t list)
+pmt_t map(pmt_t proc(const pmt_t&), const pmt_t& list)
 {
     pmt_t r = PMT_NIL;
 
-    while (is_pair(list)) {
-        r = cons(proc(car(list)), r);
-        list = cdr(list);
-    }
+    for (const pmt_t* l = &list; (*l)->is_pair(); l = &_pair(*l)->d_cdr)
+        r = cons(proc(_pair(*l)->d_car), r);
 
     return reverse_x(r);
 }
 
-pmt_t reverse(pmt_t listx)
+pmt_t reverse(const pmt_t& listx)
 {
-    pmt_t list = listx;
+    pmt_t list = listx->type() == pmt_base::HASH_DICT ? dict_items(listx) : listx;
     pmt_t r = PMT_NIL;
 
     if (is_dict(listx)) {
@@ -1010,13 +1156,13 @@ pmt_t reverse(pmt_t listx)
         throw wrong_type("pmt_reverse", listx);
 }
 
-pmt_t reverse_x(pmt_t list)
+pmt_t reverse_x(const pmt_t& list)
 {
     // FIXME do it destructively
     return reverse(list);
 }
 
-pmt_t nth(size_t n, pmt_t list)
+pmt_t nth(size_t n, const pmt_t& list)
 {
     pmt_t t = nthcdr(n, list);
     if (is_pair(t))
@@ -1025,62 +1171,58 @@ pmt_t nth(size_t n, pmt_t list)
         return PMT_NIL;
 }
 
-pmt_t nthcdr(size_t n, pmt_t list)
+pmt_t nthcdr(size_t n, const pmt_t& list)
 {
     if (!(is_pair(list) || is_null(list)))
         throw wrong_type("pmt_nthcdr", list);
 
+    const pmt_t* l = &list;
     while (n > 0) {
-        if (is_pair(list)) {
-            list = cdr(list);
+        if ((*l)->is_pair()) {
+            l = &_pair(*l)->d_cdr;
             n--;
             continue;
         }
-        if (is_null(list))
+        if ((*l)->is_null())
             return PMT_NIL;
         else
-            throw wrong_type("pmt_nthcdr: not a LIST", list);
+            throw wrong_type("pmt_nthcdr: not a LIST", *l);
     }
-    return list;
+    return *l;
 }
 
-pmt_t memq(pmt_t obj, pmt_t list)
+pmt_t memq(const pmt_t& obj, const pmt_t& list)
 {
-    while (is_pair(list)) {
-        if (eq(obj, car(list)))
-            return list;
-        list = cdr(list);
+    for (const pmt_t* l = &list; (*l)->is_pair(); l = &_pair(*l)->d_cdr) {
+        if (eq(obj, _pair(*l)->d_car))
+            return *l;
     }
     return PMT_F;
 }
 
-pmt_t memv(pmt_t obj, pmt_t list)
+pmt_t memv(const pmt_t& obj, const pmt_t& list)
 {
-    while (is_pair(list)) {
-        if (eqv(obj, car(list)))
-            return list;
-        list = cdr(list);
+    for (const pmt_t* l = &list; (*l)->is_pair(); l = &_pair(*l)->d_cdr) {
+        if (eqv(obj, _pair(*l)->d_car))
+            return *l;
     }
     return PMT_F;
 }
 
-pmt_t member(pmt_t obj, pmt_t list)
+pmt_t member(const pmt_t& obj, const pmt_t& list)
 {
-    while (is_pair(list)) {
-        if (equal(obj, car(list)))
-            return list;
-        list = cdr(list);
+    for (const pmt_t* l = &list; (*l)->is_pair(); l = &_pair(*l)->d_cdr) {
+        if (equal(obj, _pair(*l)->d_car))
+            return *l;
     }
     return PMT_F;
 }
 
-bool subsetp(pmt_t list1, pmt_t list2)
+bool subsetp(const pmt_t& list1, const pmt_t& list2)
 {
-    while (is_pair(list1)) {
-        pmt_t p = car(list1);
-        if (is_false(memv(p, list2)))
+    for (const pmt_t* l = &list1; (*l)->is_pair(); l = &_pair(*l)->d_cdr) {
+        if (is_false(memv(_pair(*l)->d_car, list2)))
             return false;
-        list1 = cdr(list1);
     }
     return true;
 }
@@ -1115,12 +1257,12 @@ pmt_t list6(const pmt_t& x1,
     return cons(x1, cons(x2, cons(x3, cons(x4, cons(x5, cons(x6, PMT_NIL))))));
 }
 
-pmt_t list_add(pmt_t list, const pmt_t& item)
+pmt_t list_add(const pmt_t& list, const pmt_t& item)
 {
     return reverse(cons(item, reverse(list)));
 }
 
-pmt_t list_rm(pmt_t list, const pmt_t& item)
+pmt_t list_rm(const pmt_t& list, const pmt_t& item)
 {
     if (is_pair(list)) {
         pmt_t left = car(list);
@@ -1135,7 +1277,7 @@ pmt_t list_rm(pmt_t list, const pmt_t& item)
     }
 }
 
-bool list_has(pmt_t list, const pmt_t& item)
+bool list_has(const pmt_t& list, const pmt_t& item)
 {
     if (is_pair(list)) {
         pmt_t left = car(list);
@@ -1150,19 +1292,19 @@ bool list_has(pmt_t list, const pmt_t& item)
     }
 }
 
-pmt_t caar(pmt_t pair) { return (car(car(pair))); }
+pmt_t caar(const pmt_t& pair) { return (car(car(pair))); }
 
-pmt_t cadr(pmt_t pair) { return car(cdr(pair)); }
+pmt_t cadr(const pmt_t& pair) { return car(cdr(pair)); }
 
-pmt_t cdar(pmt_t pair) { return cdr(car(pair)); }
+pmt_t cdar(const pmt_t& pair) { return cdr(car(pair)); }
 
-pmt_t cddr(pmt_t pair) { return cdr(cdr(pair)); }
+pmt_t cddr(const pmt_t& pair) { return cdr(cdr(pair)); }
 
-pmt_t caddr(pmt_t pair) { return car(cdr(cdr(pair))); }
+pmt_t caddr(const pmt_t& pair) { return car(cdr(cdr(pair))); }
 
-pmt_t cadddr(pmt_t pair) { return car(cdr(cdr(cdr(pair)))); }
+pmt_t cadddr(const pmt_t& pair) { return car(cdr(cdr(cdr(pair)))); }
 
-bool is_eof_object(pmt_t obj) { return eq(obj, PMT_EOF); }
+bool is_eof_object(const pmt_t& obj) { return eq(obj, PMT_EOF); }
 
 void dump_sizeof()
 {
@@ -0,0 +1,266 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "pmt_int.h"
+#include <pmt/pmt.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace pmt {
+
+static const unsigned BITS = 5;  // of the hash per level
+static const unsigned LEVELS = 13; // deeper than that, all 64 bits match
+
+static inline unsigned popcount(uint32_t x)
+{
+    x = x - ((x >> 1) & 0x55555555);
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+    return (((x + (x >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+}
+
+// Spreads the bits, so that keys that differ in a few bits differ in all levels
+static inline uint64_t mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint64_t double_bits(double x)
+{
+    if (x == 0) // +0.0 and -0.0 are eqv
+        return 0;
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+/*
+ * Keys that are eqv must hash the same.  Numbers are eqv by value;
+ * anything else, symbols included (they're interned), only to itself,
+ * so its address will do.
+ */
+static uint64_t hash_key(const pmt_t& key)
+{
+    switch (key->type()) {
+    case pmt_base::INTEGER:
+        return mix(static_cast<pmt_integer*>(key.get())->value());
+    case pmt_base::UINT64:
+        return mix(static_cast<pmt_uint64*>(key.get())->value());
+    case pmt_base::REAL:
+        return mix(double_bits(static_cast<pmt_real*>(key.get())->value()));
+    case pmt_base::COMPLEX: {
+        std::complex<double> z = static_cast<pmt_complex*>(key.get())->value();
+        return mix(double_bits(z.real()) ^ mix(double_bits(z.imag())));
+    }
+    default:
+        return mix(reinterpret_cast<uintptr_t>(key.get()));
+    }
+}
+
+static inline bool matches(const pmt_hash_dict_entry& e, uint64_t hash, const pmt_t& key)
+{
+    return e.hash == hash && eqv(e.key, key);
+}
+
+/*
+ * Below LEVELS, a node is a plain list of the entries whose hashes
+ * collide in all bits; its bitmap isn't used.
+ */
+
+static const pmt_hash_dict_entry*
+find(const pmt_hash_dict_node* n, uint64_t hash, const pmt_t& key)
+{
+    for (unsigned level = 0; n; level++) {
+        if (level == LEVELS) {
+            for (const pmt_hash_dict_slot& s : n->slots)
+                if (matches(s.entry, hash, key))
+                    return &s.entry;
+            return nullptr;
+        }
+
+        uint32_t bit = 1u << ((hash >> (level * BITS)) & 31);
+        if (!(n->bitmap & bit))
+            return nullptr;
+
+        const pmt_hash_dict_slot& s = n->slots[popcount(n->bitmap & (bit - 1))];
+        if (!s.child)
+            return matches(s.entry, hash, key) ? &s.entry : nullptr;
+        n = s.child.get();
+    }
+    return nullptr;
+}
+
+// A copy of n (or a new node, if there is none) with e in it
+static pmt_hash_dict_node_sptr insert(const pmt_hash_dict_node* n,
+                                      unsigned level,
+                                      const pmt_hash_dict_entry& e,
+                                      bool& replaced)
+{
+    auto r = n ? std::make_shared<pmt_hash_dict_node>(*n)
+               : std::make_shared<pmt_hash_dict_node>();
+
+    if (level == LEVELS) {
+        for (pmt_hash_dict_slot& s : r->slots)
+            if (matches(s.entry, e.hash, e.key)) {
+                s.entry = e;
+                replaced = true;
+                return r;
+            }
+        r->slots.push_back(pmt_hash_dict_slot{ nullptr, e });
+        return r;
+    }
+
+    uint32_t bit = 1u << ((e.hash >> (level * BITS)) & 31);
+    size_t pos = popcount(r->bitmap & (bit - 1));
+    if (!(r->bitmap & bit)) {
+        r->slots.insert(r->slots.begin() + pos, pmt_hash_dict_slot{ nullptr, e });
+        r->bitmap |= bit;
+        return r;
+    }
+
+    pmt_hash_dict_slot& s = r->slots[pos];
+    if (s.child) {
+        s.child = insert(s.child.get(), level + 1, e, replaced);
+    } else if (matches(s.entry, e.hash, e.key)) {
+        s.entry = e;
+        replaced = true;
+    } else { // two entries for the slot: move both down a level
+        bool unused = false;
+        s.child = insert(insert(nullptr, level + 1, s.entry, unused).get(),
+                         level + 1,
+                         e,
+                         replaced);
+        s.entry = pmt_hash_dict_entry();
+    }
+    return r;
+}
+
+/*
+ * n without key: n itself if key isn't in it, or nullptr if nothing
+ * is left.
+ */
+static pmt_hash_dict_node_sptr remove(const pmt_hash_dict_node_sptr& n,
+                                      unsigned level,
+                                      uint64_t hash,
+                                      const pmt_t& key)
+{
+    if (level == LEVELS) {
+        for (size_t i = 0; i < n->slots.size(); i++)
+            if (matches(n->slots[i].entry, hash, key)) {
+                if (n->slots.size() == 1)
+                    return nullptr;
+                auto r = std::make_shared<pmt_hash_dict_node>(*n);
+                r->slots.erase(r->slots.begin() + i);
+                return r;
+            }
+        return n;
+    }
+
+    uint32_t bit = 1u << ((hash >> (level * BITS)) & 31);
+    if (!(n->bitmap & bit))
+        return n;
+
+    size_t pos = popcount(n->bitmap & (bit - 1));
+    const pmt_hash_dict_slot& s = n->slots[pos];
+    pmt_hash_dict_node_sptr child;
+    if (s.child) {
+        child = remove(s.child, level + 1, hash, key);
+        if (child == s.child)
+            return n;
+    } else if (!matches(s.entry, hash, key))
+        return n;
+
+    if (!child && n->slots.size() == 1)
+        return nullptr;
+
+    auto r = std::make_shared<pmt_hash_dict_node>(*n);
+    if (!child) {
+        r->slots.erase(r->slots.begin() + pos);
+        r->bitmap &= ~bit;
+    } else if (child->slots.size() == 1 && !child->slots[0].child) {
+        r->slots[pos] = child->slots[0]; // a lone entry moves back up
+    } else {
+        r->slots[pos].child = child;
+    }
+    return r;
+}
+
+static void collect(const pmt_hash_dict_node* n,
+                    std::vector<const pmt_hash_dict_entry*>& entries)
+{
+    for (const pmt_hash_dict_slot& s : n->slots) {
+        if (s.child)
+            collect(s.child.get(), entries);
+        else
+            entries.push_back(&s.entry);
+    }
+}
+
+pmt_hash_dict::pmt_hash_dict(const pmt_hash_dict_node_sptr& root,
+                             size_t size,
+                             uint64_t next_seq)
+    : pmt_base(HASH_DICT), d_root(root), d_size(size), d_next_seq(next_seq)
+{
+}
+
+const pmt_t* pmt_hash_dict::ref(const pmt_t& key) const
+{
+    const pmt_hash_dict_entry* e = find(d_root.get(), hash_key(key), key);
+    return e ? &e->value : nullptr;
+}
+
+pmt_t pmt_hash_dict::add(const pmt_t& key, const pmt_t& value) const
+{
+    bool replaced = false;
+    pmt_hash_dict_entry e{ hash_key(key), d_next_seq, key, value };
+    pmt_hash_dict_node_sptr root = insert(d_root.get(), 0, e, replaced);
+    return pmt_t(new pmt_hash_dict(root, replaced ? d_size : d_size + 1, d_next_seq + 1));
+}
+
+pmt_t pmt_hash_dict::remove(const pmt_t& key) const
+{
+    if (!d_root)
+        return pmt_t();
+
+    pmt_hash_dict_node_sptr root = pmt::remove(d_root, 0, hash_key(key), key);
+    if (root == d_root)
+        return pmt_t(); // not in there
+    return pmt_t(new pmt_hash_dict(root, d_size - 1, d_next_seq));
+}
+
+pmt_t pmt_hash_dict::items() const
+{
+    std::vector<const pmt_hash_dict_entry*> entries;
+    entries.reserve(d_size);
+    if (d_root)
+        collect(d_root.get(), entries);
+    std::sort(entries.begin(),
+              entries.end(),
+              [](const pmt_hash_dict_entry* a, const pmt_hash_dict_entry* b) {
+                  return a->seq < b->seq;
+              });
+
+    // Most recent first
+    pmt_t alist = PMT_NIL;
+    for (const pmt_hash_dict_entry* e : entries)
+        alist = dcons(cons(e->key, e->value), alist);
+    return alist;
+}
+
+} /* namespace pmt */
@@ -27,25 +27,18 @@ class pmt_bool : public pmt_base
 public:
     pmt_bool();
     //~pmt_bool(){}
-
-    bool is_bool() const override { return true; }
 };
 
 
 class pmt_symbol : public pmt_base
 {
     std::string d_name;
-    pmt_t d_next;
 
 public:
     pmt_symbol(const std::string& name);
     //~pmt_symbol(){}
 
-    bool is_symbol() const override { return true; }
-    const std::string name() { return d_name; }
-
-    pmt_t next() { return d_next; } // symbol table link
-    void set_next(pmt_t next) { d_next = next; }
+    const std::string& name() const { return d_name; }
 };
 
 class pmt_integer : public pmt_base
@@ -56,8 +49,6 @@ public:
     pmt_integer(long value);
     //~pmt_integer(){}
 
-    bool is_number() const override { return true; }
-    bool is_integer() const override { return true; }
     long value() const { return d_value; }
 };
 
@@ -69,8 +60,6 @@ public:
     pmt_uint64(uint64_t value);
     //~pmt_uint64(){}
 
-    bool is_number() const override { return true; }
-    bool is_uint64() const override { return true; }
     uint64_t value() const { return d_value; }
 };
 
@@ -82,8 +71,6 @@ public:
     pmt_real(double value);
     //~pmt_real(){}
 
-    bool is_number() const override { return true; }
-    bool is_real() const override { return true; }
     double value() const { return d_value; }
 };
 
@@ -95,8 +82,6 @@ public:
     pmt_complex(std::complex<double> value);
     //~pmt_complex(){}
 
-    bool is_number() const override { return true; }
-    bool is_complex() const override { return true; }
     std::complex<double> value() const { return d_value; }
 };
 
@@ -105,8 +90,6 @@ class pmt_null : public pmt_base
 public:
     pmt_null();
     //~pmt_null(){}
-
-    bool is_null() const override { return true; }
 };
 
 class pmt_pair : public pmt_base
@@ -115,15 +98,14 @@ public:
     pmt_t d_car;
     pmt_t d_cdr;
 
-    pmt_pair(const pmt_t& car, const pmt_t& cdr);
+    pmt_pair(const pmt_t& car, const pmt_t& cdr, type_tag type = PAIR);
     //~pmt_pair(){};
 
-    bool is_pair() const override { return true; }
     pmt_t car() const { return d_car; }
     pmt_t cdr() const { return d_cdr; }
 
-    void set_car(pmt_t car) { d_car = car; }
-    void set_cdr(pmt_t cdr) { d_cdr = cdr; }
+    void set_car(const pmt_t& car) { d_car = car; }
+    void set_cdr(const pmt_t& cdr) { d_cdr = cdr; }
 };
 
 class pmt_dict : public pmt_pair
@@ -131,8 +113,50 @@ class pmt_dict : public pmt_pair
 public:
     pmt_dict(const pmt_t& car, const pmt_t& cdr);
     //~pmt_dict(){};
+};
+
+/*
+ * A dict made by make_hash_dict(): a persistent hash array mapped trie
+ * of its entries, each level indexed by the next 5 bits of the hash of
+ * the key.  Nodes are never changed once built; adding or deleting an
+ * entry copies the path to it and shares everything else.
+ */
+struct pmt_hash_dict_entry {
+    uint64_t hash;
+    uint64_t seq; // when it was added, to list the entries in a-list order
+    pmt_t key;
+    pmt_t value;
+};
 
-    bool is_dict() const override { return true; }
+struct pmt_hash_dict_node;
+typedef std::shared_ptr<const pmt_hash_dict_node> pmt_hash_dict_node_sptr;
+
+// Either an entry, or (if child is set) the entries whose hashes share this slot
+struct pmt_hash_dict_slot {
+    pmt_hash_dict_node_sptr child;
+    pmt_hash_dict_entry entry;
+};
+
+struct pmt_hash_dict_node {
+    uint32_t bitmap = 0; // which of the 32 slots are used
+    std::vector<pmt_hash_dict_slot> slots; // the used ones, in order
+};
+
+class pmt_hash_dict : public pmt_base
+{
+    pmt_hash_dict_node_sptr d_root;
+    size_t d_size;
+    uint64_t d_next_seq;
+
+public:
+    pmt_hash_dict(const pmt_hash_dict_node_sptr& root, size_t size, uint64_t next_seq);
+    //~pmt_hash_dict(){};
+
+    const pmt_t* ref(const pmt_t& key) const; // nullptr if not in there
+    pmt_t add(const pmt_t& key, const pmt_t& value) const;
+    pmt_t remove(const pmt_t& key) const;
+    pmt_t items() const; // as an a-list
+    size_t length() const { return d_size; }
 };
 
 class pmt_vector : public pmt_base
@@ -140,16 +164,15 @@ class pmt_vector : public pmt_base
     std::vector<pmt_t> d_v;
 
 public:
-    pmt_vector(size_t len, pmt_t fill);
+    pmt_vector(size_t len, const pmt_t& fill);
     //~pmt_vector();
 
-    bool is_vector() const override { return true; }
     pmt_t ref(size_t k) const;
-    void set(size_t k, pmt_t obj);
-    void fill(pmt_t fill);
+    void set(size_t k, const pmt_t& obj);
+    void fill(const pmt_t& fill);
     size_t length() const { return d_v.size(); }
 
-    pmt_t _ref(size_t k) const { return d_v[k]; }
+    const pmt_t& _ref(size_t k) const { return d_v[k]; }
 };
 
 class pmt_tuple : public pmt_base
@@ -160,12 +183,11 @@ public:
     pmt_tuple(size_t len);
     //~pmt_tuple();
 
-    bool is_tuple() const override { return true; }
     pmt_t ref(size_t k) const;
     size_t length() const { return d_v.size(); }
 
-    pmt_t _ref(size_t k) const { return d_v[k]; }
-    void _set(size_t k, pmt_t v) { d_v[k] = v; }
+    const pmt_t& _ref(size_t k) const { return d_v[k]; }
+    void _set(size_t k, const pmt_t& v) { d_v[k] = v; }
 };
 
 class pmt_any : public pmt_base
@@ -176,7 +198,6 @@ public:
     pmt_any(const boost::any& any);
     //~pmt_any();
 
-    bool is_any() const override { return true; }
     const boost::any& ref() const { return d_any; }
     void set(const boost::any& any) { d_any = any; }
 };
@@ -185,7 +206,7 @@ public:
 class pmt_uniform_vector : public pmt_base
 {
 public:
-    bool is_uniform_vector() const override { return true; }
+    pmt_uniform_vector(type_tag type) : pmt_base(type) {}
     virtual const void* uniform_elements(size_t& len) = 0;
     virtual void* uniform_writable_elements(size_t& len) = 0;
     virtual size_t length() const = 0;
@@ -20,25 +20,25 @@
 
 namespace pmt {
 
-static void write_list_tail(pmt_t obj, std::ostream& port)
+static void write_list_tail(const pmt_t& obj, std::ostream& port)
 {
-    write(car(obj), port); // write the car
-    obj = cdr(obj);        // step to cdr
+    write(car(obj), port);  // write the car
+    pmt_t tail = cdr(obj); // step to cdr
 
-    if (is_null(obj)) // ()
+    if (is_null(tail)) // ()
         port << ")";
 
-    else if (is_pair(obj)) { // normal list
+    else if (is_pair(tail)) { // normal list
         port << " ";
-        write_list_tail(obj, port);
+        write_list_tail(tail, port);
     } else { // dotted pair
         port << " . ";
-        write(obj, port);
+        write(tail, port);
         port << ")";
     }
 }
 
-void write(pmt_t obj, std::ostream& port)
+void write(const pmt_t& obj, std::ostream& port)
 {
     if (is_bool(obj)) {
         if (is_true(obj))
@@ -82,10 +82,8 @@ void write(pmt_t obj, std::ostream& port)
                 port << " " << vector_ref(obj, i);
         }
         port << ")";
-    } else if (is_dict(obj)) {
-        // FIXME
-        // port << "#<dict " << obj << ">";
-        port << "#<dict>";
+    } else if (is_dict(obj)) { // a hash dict; written as the a-list it stands for
+        write(dict_items(obj), port);
     } else if (is_uniform_vector(obj)) {
         port << "#[";
         size_t len = length(obj);
@@ -104,13 +102,13 @@ void write(pmt_t obj, std::ostream& port)
     }
 }
 
-std::ostream& operator<<(std::ostream& os, pmt_t obj)
+std::ostream& operator<<(std::ostream& os, const pmt_t& obj)
 {
     write(obj, os);
     return os;
 }
 
-std::string write_string(pmt_t obj)
+std::string write_string(const pmt_t& obj)
 {
     std::ostringstream s;
     s << obj;
@@ -122,7 +120,7 @@ pmt_t read(std::istream& port)
     throw notimplemented("notimplemented: pmt::read", PMT_NIL);
 }
 
-void serialize(pmt_t obj, std::ostream& sink)
+void serialize(const pmt_t& obj, std::ostream& sink)
 {
     throw notimplemented("notimplemented: pmt::serialize", obj);
 }
@@ -138,4 +136,4 @@ pmt_t deserialize(std::istream& source)
 } /* namespace pmt */
 
 
-void pmt::print(pmt_t v) { std::cout << write_string(v) << std::endl; }
+void pmt::print(const pmt_t& v) { std::cout << write_string(v) << std::endl; }
@@ -16,6 +16,7 @@
 #include "pmt_int.h"
 #include <pmt/pmt.h>
 #include <boost/endian/conversion.hpp>
+#include <cstring>
 #include <limits>
 #include <vector>
 
@@ -24,85 +25,216 @@ namespace pmt {
 static pmt_t parse_pair(std::streambuf& sb, uint8_t type);
 
 // ----------------------------------------------------------------
-// output primitives
+// output to a contiguous buffer
 // ----------------------------------------------------------------
 
-static bool serialize_untagged_u8(uint8_t i, std::streambuf& sb)
-{
-    return sb.sputc((i >> 0) & 0xff) != std::streambuf::traits_type::eof();
-}
-
-// always writes big-endian
-static bool serialize_untagged_u16(uint16_t i, std::streambuf& sb)
+/*
+ * Everything is big-endian on the wire.  Uniform vectors go out as
+ * arrays of 8, 16, 32 or 64 bit words (complex<float> is one 64 bit
+ * word, complex<double> two), so big-endian hosts copy them as is.
+ */
+struct uvi_layout {
+    uint8_t uvi;         // UVI_* subtype
+    uint8_t word_size;   // of the words on the wire, in bytes
+    uint8_t item_words;  // words per element
+};
+
+// Indexed by pmt_base::type() - pmt_base::U8VECTOR
+static const uvi_layout uvi_layouts[] = {
+    { UVI_U8, 1, 1 },  { UVI_S8, 1, 1 },  { UVI_U16, 2, 1 }, { UVI_S16, 2, 1 },
+    { UVI_U32, 4, 1 }, { UVI_S32, 4, 1 }, { UVI_U64, 8, 1 }, { UVI_S64, 8, 1 },
+    { UVI_F32, 4, 1 }, { UVI_F64, 8, 1 }, { UVI_C32, 8, 1 }, { UVI_C64, 8, 2 },
+};
+
+static const uvi_layout& layout_of(const pmt_t& uvector)
 {
-    boost::endian::native_to_big_inplace(i);
-    return sb.sputn((char*)&i, sizeof(i)) != std::streambuf::traits_type::eof();
+    return uvi_layouts[uvector->type() - pmt_base::U8VECTOR];
 }
 
-// always writes big-endian
-static bool serialize_untagged_u32(uint32_t i, std::streambuf& sb)
+// Copies n words between host and wire order, either way
+template <typename W>
+static void copy_words(uint8_t* dst, const uint8_t* src, size_t n)
 {
-    boost::endian::native_to_big_inplace(i);
-    return sb.sputn((char*)&i, sizeof(i)) != std::streambuf::traits_type::eof();
+    if (boost::endian::order::native == boost::endian::order::big) {
+        memcpy(dst, src, n * sizeof(W));
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        W w;
+        memcpy(&w, src + i * sizeof(W), sizeof(W));
+        boost::endian::endian_reverse_inplace(w);
+        memcpy(dst + i * sizeof(W), &w, sizeof(W));
+    }
 }
 
-static bool serialize_untagged_f64(double i, std::streambuf& sb)
+static void copy_words(uint8_t* dst, const uint8_t* src, size_t n, size_t word_size)
 {
-    typedef union {
-        double id;
-        uint64_t ii;
-    } iu_t;
-    iu_t iu;
-    iu.id = i;
-    boost::endian::native_to_big_inplace(iu.ii);
-    return sb.sputn((char*)&iu.ii, sizeof(iu.ii)) != std::streambuf::traits_type::eof();
+    switch (word_size) {
+    case 1:
+        memcpy(dst, src, n);
+        break;
+    case 2:
+        copy_words<uint16_t>(dst, src, n);
+        break;
+    case 4:
+        copy_words<uint32_t>(dst, src, n);
+        break;
+    default:
+        copy_words<uint64_t>(dst, src, n);
+        break;
+    }
 }
 
-// always writes big-endian
-static bool serialize_untagged_u64(uint64_t i, std::streambuf& sb)
+template <typename T>
+static inline uint8_t* put(uint8_t* p, T i)
 {
     boost::endian::native_to_big_inplace(i);
-    return sb.sputn((char*)&i, sizeof(i)) != std::streambuf::traits_type::eof();
+    memcpy(p, &i, sizeof(i));
+    return p + sizeof(i);
 }
 
-// always writes big-endian
-static bool
-serialize_untagged_u8_array(const uint8_t* data, size_t length, std::streambuf& sb)
+static inline uint8_t* put_f64(uint8_t* p, double x)
 {
-    return sb.sputn((char*)data, length) != std::streambuf::traits_type::eof();
+    uint64_t i;
+    memcpy(&i, &x, sizeof(i));
+    return put(p, i);
 }
 
-static bool
-serialize_untagged_u16_array(const uint16_t* data, size_t length, std::streambuf& sb)
+static inline bool fits_int32(long i)
 {
-    std::vector<uint16_t> bedata(length);
-    for (size_t i = 0; i < length; i++) {
-        bedata[i] = boost::endian::native_to_big(data[i]);
-    }
-    return sb.sputn((char*)&bedata[0], length * sizeof(uint16_t)) !=
-           std::streambuf::traits_type::eof();
+    return (sizeof(long) <= 4) || (i >= std::numeric_limits<std::int32_t>::min() &&
+                                   i <= std::numeric_limits<std::int32_t>::max());
 }
 
-static bool
-serialize_untagged_u32_array(const uint32_t* data, size_t length, std::streambuf& sb)
+/*
+ * Number of bytes write_buffer() puts out for x.
+ *
+ * N.B., Circular structures cause infinite recursion.
+ */
+static size_t serialized_size_of(const pmt_t& x)
 {
-    std::vector<uint32_t> bedata(length);
-    for (size_t i = 0; i < length; i++) {
-        bedata[i] = boost::endian::native_to_big(data[i]);
+    size_t size = 0;
+    pmt_t obj = x; // the tail of a list, as we go
+
+    while (true) {
+        switch (obj->type()) {
+        case pmt_base::BOOL:
+        case pmt_base::NIL:
+            return size + 1;
+        case pmt_base::SYMBOL:
+            return size + 3 + static_cast<pmt_symbol*>(obj.get())->name().size();
+        case pmt_base::INTEGER:
+            return size + (fits_int32(to_long(obj)) ? 5 : 9);
+        case pmt_base::UINT64:
+        case pmt_base::REAL:
+            return size + 9;
+        case pmt_base::COMPLEX:
+            return size + 17;
+        case pmt_base::PAIR:
+        case pmt_base::DICT:
+            size += 1 + serialized_size_of(car(obj));
+            obj = cdr(obj);
+            continue;
+        case pmt_base::HASH_DICT: // same bytes as the a-list it stands for
+            obj = dict_items(obj);
+            continue;
+        case pmt_base::VECTOR:
+        case pmt_base::TUPLE: {
+            size_t len = length(obj);
+            size += 5;
+            for (size_t i = 0; i < len; i++)
+                size += serialized_size_of(obj->is_vector() ? vector_ref(obj, i)
+                                                            : tuple_ref(obj, i));
+            return size;
+        }
+        default:
+            if (obj->is_uniform_vector())
+                return size + 8 + length(obj) * uniform_vector_itemsize(obj);
+            throw notimplemented("pmt::serialize (?)", obj);
+        }
     }
-    return sb.sputn((char*)&bedata[0], length * sizeof(uint32_t)) !=
-           std::streambuf::traits_type::eof();
 }
 
-static bool
-serialize_untagged_u64_array(const uint64_t* data, size_t length, std::streambuf& sb)
+// Writes x at p, which has room for serialized_size_of(x); returns the end
+static uint8_t* write_buffer(const pmt_t& x, uint8_t* p)
 {
-    std::vector<uint64_t> bedata(length);
-    for (size_t i = 0; i < length; i++) {
-        bedata[i] = boost::endian::native_to_big(data[i]);
+    pmt_t obj = x; // the tail of a list, as we go
+
+    while (true) {
+        switch (obj->type()) {
+        case pmt_base::BOOL:
+            *p++ = eq(obj, PMT_T) ? PST_TRUE : PST_FALSE;
+            return p;
+        case pmt_base::NIL:
+            *p++ = PST_NULL;
+            return p;
+        case pmt_base::SYMBOL: {
+            const std::string& s = static_cast<pmt_symbol*>(obj.get())->name();
+            *p++ = PST_SYMBOL;
+            p = put(p, uint16_t(s.size()));
+            memcpy(p, s.data(), s.size());
+            return p + s.size();
+        }
+        case pmt_base::INTEGER: {
+            long i = to_long(obj);
+            if (fits_int32(i)) {
+                *p++ = PST_INT32;
+                return put(p, uint32_t(i));
+            }
+            *p++ = PST_INT64;
+            return put(p, uint64_t(i));
+        }
+        case pmt_base::UINT64:
+            *p++ = PST_UINT64;
+            return put(p, to_uint64(obj));
+        case pmt_base::REAL:
+            *p++ = PST_DOUBLE;
+            return put_f64(p, to_double(obj));
+        case pmt_base::COMPLEX: {
+            std::complex<double> z = to_complex(obj);
+            *p++ = PST_COMPLEX;
+            p = put_f64(p, z.real());
+            return put_f64(p, z.imag());
+        }
+        case pmt_base::PAIR:
+        case pmt_base::DICT:
+            *p++ = obj->is_dict() ? PST_DICT : PST_PAIR;
+            p = write_buffer(car(obj), p);
+            obj = cdr(obj);
+            continue;
+        case pmt_base::HASH_DICT:
+            obj = dict_items(obj);
+            continue;
+        case pmt_base::VECTOR:
+        case pmt_base::TUPLE: {
+            size_t len = length(obj);
+            *p++ = obj->is_vector() ? PST_VECTOR : PST_TUPLE;
+            p = put(p, uint32_t(len));
+            for (size_t i = 0; i < len; i++)
+                p = write_buffer(obj->is_vector() ? vector_ref(obj, i)
+                                                  : tuple_ref(obj, i),
+                                 p);
+            return p;
+        }
+        default: {
+            if (!obj->is_uniform_vector())
+                throw notimplemented("pmt::serialize (?)", obj);
+
+            const uvi_layout& l = layout_of(obj);
+            size_t len = length(obj);
+            size_t nbytes;
+            const void* elements = uniform_vector_elements(obj, nbytes);
+            *p++ = PST_UNIFORM_VECTOR;
+            *p++ = l.uvi;
+            p = put(p, uint32_t(len));
+            *p++ = 1; // npad
+            *p++ = 0;
+            if (nbytes)
+                copy_words(p, (const uint8_t*)elements, len * l.item_words, l.word_size);
+            return p + nbytes;
+        }
+        }
     }
-    return sb.sputn((char*)&bedata[0], length * sizeof(uint64_t)) !=
-           std::streambuf::traits_type::eof();
 }
 
 // ----------------------------------------------------------------
@@ -253,267 +385,32 @@ static bool deserialize_untagged_u64_vector(std::vector<uint64_t>& data,
  *
  * N.B., Circular structures cause infinite recursion.
  */
-bool serialize(pmt_t obj, std::streambuf& sb)
+bool serialize(const pmt_t& obj, std::streambuf& sb)
 {
-    bool ok = true;
-
-tail_recursion:
-
-    if (is_bool(obj)) {
-        if (eq(obj, PMT_T))
-            return serialize_untagged_u8(PST_TRUE, sb);
-        else
-            return serialize_untagged_u8(PST_FALSE, sb);
-    }
-
-    if (is_null(obj))
-        return serialize_untagged_u8(PST_NULL, sb);
-
-    if (is_symbol(obj)) {
-        const std::string s = symbol_to_string(obj);
-        size_t len = s.size();
-        ok = serialize_untagged_u8(PST_SYMBOL, sb);
-        ok &= serialize_untagged_u16(len, sb);
-        ok &= serialize_untagged_u8_array((const uint8_t*)s.c_str(), len, sb);
-        return ok;
-    }
-
-    if (is_pair(obj)) {
-        ok = serialize_untagged_u8(is_dict(obj) ? PST_DICT : PST_PAIR, sb);
-        ok &= serialize(car(obj), sb);
-        if (!ok)
-            return false;
-        obj = cdr(obj);
-        goto tail_recursion;
-    }
-
-    if (is_number(obj)) {
-
-        if (is_uint64(obj)) {
-            uint64_t i = to_uint64(obj);
-            ok = serialize_untagged_u8(PST_UINT64, sb);
-            ok &= serialize_untagged_u64(i, sb);
-            return ok;
-        } else {
-            if (is_integer(obj)) {
-                long i = to_long(obj);
-                if ((sizeof(long) > 4) &&
-                    ((i < std::numeric_limits<std::int32_t>::min() ||
-                      i > std::numeric_limits<std::int32_t>::max()))) {
-                    // Serializing as 4 bytes won't work for this value, serialize as 8
-                    // bytes
-                    ok = serialize_untagged_u8(PST_INT64, sb);
-                    ok &= serialize_untagged_u64(i, sb);
-                } else {
-                    ok = serialize_untagged_u8(PST_INT32, sb);
-                    ok &= serialize_untagged_u32(i, sb);
-                }
-                return ok;
-            }
-        }
-
-        if (is_real(obj)) {
-            double i = to_double(obj);
-            ok = serialize_untagged_u8(PST_DOUBLE, sb);
-            ok &= serialize_untagged_f64(i, sb);
-            return ok;
-        }
-
-        if (is_complex(obj)) {
-            std::complex<double> i = to_complex(obj);
-            ok = serialize_untagged_u8(PST_COMPLEX, sb);
-            ok &= serialize_untagged_f64(i.real(), sb);
-            ok &= serialize_untagged_f64(i.imag(), sb);
-            return ok;
-        }
+    // Built up in memory, and handed to sb in one go
+    size_t len = serialized_size_of(obj);
+    uint8_t small[256];
+    std::vector<uint8_t> large;
+    uint8_t* buf = small;
+    if (len > sizeof(small)) {
+        large.resize(len);
+        buf = large.data();
     }
+    write_buffer(obj, buf);
 
-    if (is_vector(obj)) {
-        size_t vec_len = pmt::length(obj);
-        ok = serialize_untagged_u8(PST_VECTOR, sb);
-        ok &= serialize_untagged_u32(vec_len, sb);
-        for (size_t i = 0; i < vec_len; i++) {
-            ok &= serialize(vector_ref(obj, i), sb);
-        }
-        return ok;
-    }
-
-    if (is_uniform_vector(obj)) {
-        size_t npad = 1;
-        size_t vec_len = pmt::length(obj);
-
-        if (is_u8vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_U8, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u8_array(&u8vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_s8vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_S8, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u8_array(
-                (uint8_t*)&s8vector_elements(obj)[0], vec_len, sb);
-
-            return ok;
-        }
-
-        if (is_u16vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_U16, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u16_array(&u16vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_s16vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_S16, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u16_array(
-                (uint16_t*)&s16vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_u32vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_U32, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u32_array(&u32vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_s32vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_S32, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u32_array(
-                (uint32_t*)&s32vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_u64vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_U64, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u64_array(&u64vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_s64vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_S64, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u64_array(
-                (uint64_t*)&s64vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_f32vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_F32, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u32_array(
-                (uint32_t*)&f32vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_f64vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_F64, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            ok &= serialize_untagged_u64_array(
-                (uint64_t*)&f64vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_c32vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_C32, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            // Note that if endianness causes byte swap that real/imag will also be
-            // swapped
-            ok &= serialize_untagged_u64_array(
-                (uint64_t*)&c32vector_elements(obj)[0], vec_len, sb);
-            return ok;
-        }
-
-        if (is_c64vector(obj)) {
-            ok = serialize_untagged_u8(PST_UNIFORM_VECTOR, sb);
-            ok &= serialize_untagged_u8(UVI_C64, sb);
-            ok &= serialize_untagged_u32(vec_len, sb);
-            ok &= serialize_untagged_u8(npad, sb);
-            for (size_t i = 0; i < npad; i++) {
-                ok &= serialize_untagged_u8(0, sb);
-            }
-            // No known portable 128 bit swap function, so double the length
-            ok &= serialize_untagged_u64_array(
-                (uint64_t*)&c64vector_elements(obj)[0], vec_len * 2, sb);
-            return ok;
-        }
-    }
-
-    if (is_dict(obj))
-        throw notimplemented("pmt::serialize (dict)", obj);
+    return sb.sputn((const char*)buf, len) == std::streamsize(len);
+}
 
-    if (is_tuple(obj)) {
-        size_t tuple_len = pmt::length(obj);
-        ok = serialize_untagged_u8(PST_TUPLE, sb);
-        ok &= serialize_untagged_u32(tuple_len, sb);
-        for (size_t i = 0; i < tuple_len; i++) {
-            ok &= serialize(tuple_ref(obj, i), sb);
-        }
-        return ok;
-    }
-    // throw pmt_notimplemented("pmt::serialize (tuple)", obj);
+size_t serialized_size(const pmt_t& obj) { return serialized_size_of(obj); }
 
-    throw notimplemented("pmt::serialize (?)", obj);
+size_t serialize_to_buffer(const pmt_t& obj, void* buf, size_t len)
+{
+    size_t size = serialized_size_of(obj);
+    if (size > len)
+        throw out_of_range("pmt::serialize_to_buffer: buffer too small",
+                           from_uint64(size));
+    write_buffer(obj, static_cast<uint8_t*>(buf));
+    return size;
 }
 
 /*
@@ -709,14 +606,230 @@ error:
     throw exception("pmt::deserialize: malformed input stream", PMT_F);
 }
 
+// ----------------------------------------------------------------
+// input from a contiguous buffer
+// ----------------------------------------------------------------
+
+namespace {
+
+class buffer_reader
+{
+    const uint8_t* d_p;
+    const uint8_t* d_end;
+
+public:
+    buffer_reader(const void* buf, size_t len)
+        : d_p(static_cast<const uint8_t*>(buf)), d_end(d_p + len)
+    {
+    }
+
+    const uint8_t* pos() const { return d_p; }
+    bool at_end() const { return d_p == d_end; }
+    void unget() { d_p--; }
+
+    const uint8_t* take(size_t n)
+    {
+        if (size_t(d_end - d_p) < n)
+            throw exception("pmt::deserialize: malformed input stream", PMT_F);
+        const uint8_t* p = d_p;
+        d_p += n;
+        return p;
+    }
+
+    uint8_t u8() { return *take(1); }
+
+    template <typename T>
+    T get()
+    {
+        T i;
+        memcpy(&i, take(sizeof(i)), sizeof(i));
+        return boost::endian::big_to_native(i);
+    }
+
+    double f64()
+    {
+        uint64_t i = get<uint64_t>();
+        double x;
+        memcpy(&x, &i, sizeof(x));
+        return x;
+    }
+};
+
+} // namespace
+
+static pmt_t parse_buffer_pair(buffer_reader& r, uint8_t type);
+
+static pmt_t make_uniform_vector(uint8_t uvi, size_t k)
+{
+    switch (uvi) {
+    case UVI_U8:
+        return make_u8vector(k, 0);
+    case UVI_S8:
+        return make_s8vector(k, 0);
+    case UVI_U16:
+        return make_u16vector(k, 0);
+    case UVI_S16:
+        return make_s16vector(k, 0);
+    case UVI_U32:
+        return make_u32vector(k, 0);
+    case UVI_S32:
+        return make_s32vector(k, 0);
+    case UVI_U64:
+        return make_u64vector(k, 0);
+    case UVI_S64:
+        return make_s64vector(k, 0);
+    case UVI_F32:
+        return make_f32vector(k, 0);
+    case UVI_F64:
+        return make_f64vector(k, 0);
+    case UVI_C32:
+        return make_c32vector(k, 0);
+    case UVI_C64:
+        return make_c64vector(k, 0);
+    default:
+        throw exception("pmt::deserialize: malformed input stream, tag value = ",
+                        from_long(PST_UNIFORM_VECTOR));
+    }
+}
+
+// As deserialize(), from r
+static pmt_t parse_buffer(buffer_reader& r)
+{
+    uint8_t tag = r.u8();
+    switch (tag) {
+    case PST_TRUE:
+        return PMT_T;
+
+    case PST_FALSE:
+        return PMT_F;
+
+    case PST_NULL:
+        return PMT_NIL;
+
+    case PST_SYMBOL: {
+        uint16_t len = r.get<uint16_t>();
+        return intern(std::string((const char*)r.take(len), len));
+    }
+
+    case PST_INT32:
+        return from_long((int32_t)r.get<uint32_t>());
+
+    case PST_UINT64:
+        return from_uint64(r.get<uint64_t>());
+
+    case PST_INT64:
+        return from_long(r.get<uint64_t>());
+
+    case PST_PAIR:
+    case PST_DICT:
+        return parse_buffer_pair(r, tag);
+
+    case PST_DOUBLE:
+        return from_double(r.f64());
+
+    case PST_COMPLEX: {
+        double re = r.f64();
+        double im = r.f64();
+        return make_rectangular(re, im);
+    }
+
+    case PST_TUPLE: {
+        uint32_t nitems = r.get<uint32_t>();
+        pmt_tuple* t = new pmt_tuple(nitems);
+        pmt_t tuple(t);
+        for (uint32_t i = 0; i < nitems; i++)
+            t->_set(i, parse_buffer(r));
+        return tuple;
+    }
+
+    case PST_VECTOR: {
+        uint32_t nitems = r.get<uint32_t>();
+        pmt_t vec = make_vector(nitems, PMT_NIL);
+        for (uint32_t i = 0; i < nitems; i++)
+            vector_set(vec, i, parse_buffer(r));
+        return vec;
+    }
+
+    case PST_UNIFORM_VECTOR: {
+        uint8_t uvi = r.u8();
+        uint32_t nitems = r.get<uint32_t>();
+        uint8_t npad = r.u8();
+        r.take(npad);
+
+        if (uvi > UVI_C64)
+            throw exception("pmt::deserialize: malformed input stream, tag value = ",
+                            from_long(tag));
+        const uvi_layout& l = uvi_layouts[uvi];
+        size_t nwords = size_t(nitems) * l.item_words;
+        const uint8_t* words = r.take(nwords * l.word_size);
+
+        pmt_t vec = make_uniform_vector(uvi, nitems);
+        size_t nbytes;
+        uint8_t* elements = (uint8_t*)uniform_vector_writable_elements(vec, nbytes);
+        if (nbytes)
+            copy_words(elements, words, nwords, l.word_size);
+        return vec;
+    }
+
+    case PST_COMMENT:
+        throw notimplemented("pmt::deserialize: tag value = ", from_long(tag));
+
+    default:
+        throw exception("pmt::deserialize: malformed input stream, tag value = ",
+                        from_long(tag));
+    }
+}
+
+// As parse_pair(), from r
+static pmt_t parse_buffer_pair(buffer_reader& r, uint8_t type)
+{
+    pmt_t val, lastnptr = PMT_NIL, expr;
+
+    while (true) {
+        expr = parse_buffer(r); // the car
+        pmt_t nptr = type == PST_DICT ? dcons(expr, PMT_NIL) : cons(expr, PMT_NIL);
+        if (is_null(lastnptr))
+            val = nptr;
+        else
+            set_cdr(lastnptr, nptr);
+        lastnptr = nptr;
+
+        uint8_t tag = r.u8(); // of the cdr
+        if (tag == PST_PAIR)
+            continue;
+        if (tag == PST_NULL) {
+            expr = PMT_NIL;
+            break;
+        }
+        r.unget();
+        expr = parse_buffer(r);
+        break;
+    }
+
+    set_cdr(lastnptr, expr);
+    return val;
+}
+
+pmt_t deserialize_from_buffer(const void* buf, size_t len, size_t& used)
+{
+    buffer_reader r(buf, len);
+    if (r.at_end()) {
+        used = 0;
+        return PMT_EOF;
+    }
+    pmt_t obj = parse_buffer(r);
+    used = r.pos() - static_cast<const uint8_t*>(buf);
+    return obj;
+}
+
 /*
  * provide a simple string accessor to the serialized pmt form
  */
-std::string serialize_str(pmt_t obj)
+std::string serialize_str(const pmt_t& obj)
 {
-    std::stringbuf sb;
-    serialize(obj, sb);
-    return sb.str();
+    std::string s(serialized_size_of(obj), '\0');
+    write_buffer(obj, (uint8_t*)&s[0]);
+    return s;
 }
 
 /*
@@ -724,8 +837,8 @@ std::string serialize_str(pmt_t obj)
  */
 pmt_t deserialize_str(std::string s)
 {
-    std::stringbuf sb(s);
-    return deserialize(sb);
+    size_t used;
+    return deserialize_from_buffer(s.data(), s.size(), used);
 }
 
 /*
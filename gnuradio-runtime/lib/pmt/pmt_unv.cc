@@ -27,19 +27,20 @@
 
 namespace pmt {
 
-static pmt_u8vector* _u8vector(pmt_t x) { return dynamic_cast<pmt_u8vector*>(x.get()); }
+static pmt_u8vector* _u8vector(const pmt_t& x)
+{
+    return static_cast<pmt_u8vector*>(x.get());
+}
 
 
-pmt_u8vector::pmt_u8vector(size_t k, uint8_t fill) : d_v(k)
+pmt_u8vector::pmt_u8vector(size_t k, uint8_t fill)
+    : pmt_uniform_vector(U8VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_u8vector::pmt_u8vector(size_t k, const uint8_t* data) : d_v(k)
+pmt_u8vector::pmt_u8vector(size_t k, const uint8_t* data)
+    : pmt_uniform_vector(U8VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(uint8_t));
 }
 
 uint8_t pmt_u8vector::ref(size_t k) const
@@ -80,7 +81,7 @@ void* pmt_u8vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_u8vector(pmt_t obj) { return obj->is_u8vector(); }
+bool is_u8vector(const pmt_t& obj) { return obj->is_u8vector(); }
 
 pmt_t make_u8vector(size_t k, uint8_t fill) { return pmt_t(new pmt_u8vector(k, fill)); }
 
@@ -98,28 +99,28 @@ pmt_t init_u8vector(size_t k, const std::vector<uint8_t>& data)
         new pmt_u8vector(k, static_cast<uint8_t>(0))); // fills an empty vector with 0
 }
 
-uint8_t u8vector_ref(pmt_t vector, size_t k)
+uint8_t u8vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_u8vector())
         throw wrong_type("pmt_u8vector_ref", vector);
     return _u8vector(vector)->ref(k);
 }
 
-void u8vector_set(pmt_t vector, size_t k, uint8_t obj)
+void u8vector_set(const pmt_t& vector, size_t k, uint8_t obj)
 {
     if (!vector->is_u8vector())
         throw wrong_type("pmt_u8vector_set", vector);
     _u8vector(vector)->set(k, obj);
 }
 
-const uint8_t* u8vector_elements(pmt_t vector, size_t& len)
+const uint8_t* u8vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_u8vector())
         throw wrong_type("pmt_u8vector_elements", vector);
     return _u8vector(vector)->elements(len);
 }
 
-const std::vector<uint8_t> u8vector_elements(pmt_t vector)
+const std::vector<uint8_t> u8vector_elements(const pmt_t& vector)
 {
     if (!vector->is_u8vector())
         throw wrong_type("pmt_u8vector_elements", vector);
@@ -130,7 +131,7 @@ const std::vector<uint8_t> u8vector_elements(pmt_t vector)
 }
 
 
-uint8_t* u8vector_writable_elements(pmt_t vector, size_t& len)
+uint8_t* u8vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_u8vector())
         throw wrong_type("pmt_u8vector_writable_elements", vector);
@@ -150,19 +151,20 @@ const std::string pmt_u8vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_s8vector* _s8vector(pmt_t x) { return dynamic_cast<pmt_s8vector*>(x.get()); }
+static pmt_s8vector* _s8vector(const pmt_t& x)
+{
+    return static_cast<pmt_s8vector*>(x.get());
+}
 
 
-pmt_s8vector::pmt_s8vector(size_t k, int8_t fill) : d_v(k)
+pmt_s8vector::pmt_s8vector(size_t k, int8_t fill)
+    : pmt_uniform_vector(S8VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_s8vector::pmt_s8vector(size_t k, const int8_t* data) : d_v(k)
+pmt_s8vector::pmt_s8vector(size_t k, const int8_t* data)
+    : pmt_uniform_vector(S8VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(int8_t));
 }
 
 int8_t pmt_s8vector::ref(size_t k) const
@@ -203,7 +205,7 @@ void* pmt_s8vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_s8vector(pmt_t obj) { return obj->is_s8vector(); }
+bool is_s8vector(const pmt_t& obj) { return obj->is_s8vector(); }
 
 pmt_t make_s8vector(size_t k, int8_t fill) { return pmt_t(new pmt_s8vector(k, fill)); }
 
@@ -221,28 +223,28 @@ pmt_t init_s8vector(size_t k, const std::vector<int8_t>& data)
         new pmt_s8vector(k, static_cast<int8_t>(0))); // fills an empty vector with 0
 }
 
-int8_t s8vector_ref(pmt_t vector, size_t k)
+int8_t s8vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_s8vector())
         throw wrong_type("pmt_s8vector_ref", vector);
     return _s8vector(vector)->ref(k);
 }
 
-void s8vector_set(pmt_t vector, size_t k, int8_t obj)
+void s8vector_set(const pmt_t& vector, size_t k, int8_t obj)
 {
     if (!vector->is_s8vector())
         throw wrong_type("pmt_s8vector_set", vector);
     _s8vector(vector)->set(k, obj);
 }
 
-const int8_t* s8vector_elements(pmt_t vector, size_t& len)
+const int8_t* s8vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_s8vector())
         throw wrong_type("pmt_s8vector_elements", vector);
     return _s8vector(vector)->elements(len);
 }
 
-const std::vector<int8_t> s8vector_elements(pmt_t vector)
+const std::vector<int8_t> s8vector_elements(const pmt_t& vector)
 {
     if (!vector->is_s8vector())
         throw wrong_type("pmt_s8vector_elements", vector);
@@ -253,7 +255,7 @@ const std::vector<int8_t> s8vector_elements(pmt_t vector)
 }
 
 
-int8_t* s8vector_writable_elements(pmt_t vector, size_t& len)
+int8_t* s8vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_s8vector())
         throw wrong_type("pmt_s8vector_writable_elements", vector);
@@ -273,22 +275,20 @@ const std::string pmt_s8vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_u16vector* _u16vector(pmt_t x)
+static pmt_u16vector* _u16vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_u16vector*>(x.get());
+    return static_cast<pmt_u16vector*>(x.get());
 }
 
 
-pmt_u16vector::pmt_u16vector(size_t k, uint16_t fill) : d_v(k)
+pmt_u16vector::pmt_u16vector(size_t k, uint16_t fill)
+    : pmt_uniform_vector(U16VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_u16vector::pmt_u16vector(size_t k, const uint16_t* data) : d_v(k)
+pmt_u16vector::pmt_u16vector(size_t k, const uint16_t* data)
+    : pmt_uniform_vector(U16VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(uint16_t));
 }
 
 uint16_t pmt_u16vector::ref(size_t k) const
@@ -329,7 +329,7 @@ void* pmt_u16vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_u16vector(pmt_t obj) { return obj->is_u16vector(); }
+bool is_u16vector(const pmt_t& obj) { return obj->is_u16vector(); }
 
 pmt_t make_u16vector(size_t k, uint16_t fill)
 {
@@ -350,28 +350,28 @@ pmt_t init_u16vector(size_t k, const std::vector<uint16_t>& data)
         new pmt_u16vector(k, static_cast<uint16_t>(0))); // fills an empty vector with 0
 }
 
-uint16_t u16vector_ref(pmt_t vector, size_t k)
+uint16_t u16vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_u16vector())
         throw wrong_type("pmt_u16vector_ref", vector);
     return _u16vector(vector)->ref(k);
 }
 
-void u16vector_set(pmt_t vector, size_t k, uint16_t obj)
+void u16vector_set(const pmt_t& vector, size_t k, uint16_t obj)
 {
     if (!vector->is_u16vector())
         throw wrong_type("pmt_u16vector_set", vector);
     _u16vector(vector)->set(k, obj);
 }
 
-const uint16_t* u16vector_elements(pmt_t vector, size_t& len)
+const uint16_t* u16vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_u16vector())
         throw wrong_type("pmt_u16vector_elements", vector);
     return _u16vector(vector)->elements(len);
 }
 
-const std::vector<uint16_t> u16vector_elements(pmt_t vector)
+const std::vector<uint16_t> u16vector_elements(const pmt_t& vector)
 {
     if (!vector->is_u16vector())
         throw wrong_type("pmt_u16vector_elements", vector);
@@ -382,7 +382,7 @@ const std::vector<uint16_t> u16vector_elements(pmt_t vector)
 }
 
 
-uint16_t* u16vector_writable_elements(pmt_t vector, size_t& len)
+uint16_t* u16vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_u16vector())
         throw wrong_type("pmt_u16vector_writable_elements", vector);
@@ -401,22 +401,20 @@ const std::string pmt_u16vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_s16vector* _s16vector(pmt_t x)
+static pmt_s16vector* _s16vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_s16vector*>(x.get());
+    return static_cast<pmt_s16vector*>(x.get());
 }
 
 
-pmt_s16vector::pmt_s16vector(size_t k, int16_t fill) : d_v(k)
+pmt_s16vector::pmt_s16vector(size_t k, int16_t fill)
+    : pmt_uniform_vector(S16VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_s16vector::pmt_s16vector(size_t k, const int16_t* data) : d_v(k)
+pmt_s16vector::pmt_s16vector(size_t k, const int16_t* data)
+    : pmt_uniform_vector(S16VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(int16_t));
 }
 
 int16_t pmt_s16vector::ref(size_t k) const
@@ -457,7 +455,7 @@ void* pmt_s16vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_s16vector(pmt_t obj) { return obj->is_s16vector(); }
+bool is_s16vector(const pmt_t& obj) { return obj->is_s16vector(); }
 
 pmt_t make_s16vector(size_t k, int16_t fill) { return pmt_t(new pmt_s16vector(k, fill)); }
 
@@ -475,28 +473,28 @@ pmt_t init_s16vector(size_t k, const std::vector<int16_t>& data)
         new pmt_s16vector(k, static_cast<int16_t>(0))); // fills an empty vector with 0
 }
 
-int16_t s16vector_ref(pmt_t vector, size_t k)
+int16_t s16vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_s16vector())
         throw wrong_type("pmt_s16vector_ref", vector);
     return _s16vector(vector)->ref(k);
 }
 
-void s16vector_set(pmt_t vector, size_t k, int16_t obj)
+void s16vector_set(const pmt_t& vector, size_t k, int16_t obj)
 {
     if (!vector->is_s16vector())
         throw wrong_type("pmt_s16vector_set", vector);
     _s16vector(vector)->set(k, obj);
 }
 
-const int16_t* s16vector_elements(pmt_t vector, size_t& len)
+const int16_t* s16vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_s16vector())
         throw wrong_type("pmt_s16vector_elements", vector);
     return _s16vector(vector)->elements(len);
 }
 
-const std::vector<int16_t> s16vector_elements(pmt_t vector)
+const std::vector<int16_t> s16vector_elements(const pmt_t& vector)
 {
     if (!vector->is_s16vector())
         throw wrong_type("pmt_s16vector_elements", vector);
@@ -507,7 +505,7 @@ const std::vector<int16_t> s16vector_elements(pmt_t vector)
 }
 
 
-int16_t* s16vector_writable_elements(pmt_t vector, size_t& len)
+int16_t* s16vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_s16vector())
         throw wrong_type("pmt_s16vector_writable_elements", vector);
@@ -526,22 +524,20 @@ const std::string pmt_s16vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_u32vector* _u32vector(pmt_t x)
+static pmt_u32vector* _u32vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_u32vector*>(x.get());
+    return static_cast<pmt_u32vector*>(x.get());
 }
 
 
-pmt_u32vector::pmt_u32vector(size_t k, uint32_t fill) : d_v(k)
+pmt_u32vector::pmt_u32vector(size_t k, uint32_t fill)
+    : pmt_uniform_vector(U32VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_u32vector::pmt_u32vector(size_t k, const uint32_t* data) : d_v(k)
+pmt_u32vector::pmt_u32vector(size_t k, const uint32_t* data)
+    : pmt_uniform_vector(U32VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(uint32_t));
 }
 
 uint32_t pmt_u32vector::ref(size_t k) const
@@ -582,7 +578,7 @@ void* pmt_u32vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_u32vector(pmt_t obj) { return obj->is_u32vector(); }
+bool is_u32vector(const pmt_t& obj) { return obj->is_u32vector(); }
 
 pmt_t make_u32vector(size_t k, uint32_t fill)
 {
@@ -603,28 +599,28 @@ pmt_t init_u32vector(size_t k, const std::vector<uint32_t>& data)
         new pmt_u32vector(k, static_cast<uint32_t>(0))); // fills an empty vector with 0
 }
 
-uint32_t u32vector_ref(pmt_t vector, size_t k)
+uint32_t u32vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_u32vector())
         throw wrong_type("pmt_u32vector_ref", vector);
     return _u32vector(vector)->ref(k);
 }
 
-void u32vector_set(pmt_t vector, size_t k, uint32_t obj)
+void u32vector_set(const pmt_t& vector, size_t k, uint32_t obj)
 {
     if (!vector->is_u32vector())
         throw wrong_type("pmt_u32vector_set", vector);
     _u32vector(vector)->set(k, obj);
 }
 
-const uint32_t* u32vector_elements(pmt_t vector, size_t& len)
+const uint32_t* u32vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_u32vector())
         throw wrong_type("pmt_u32vector_elements", vector);
     return _u32vector(vector)->elements(len);
 }
 
-const std::vector<uint32_t> u32vector_elements(pmt_t vector)
+const std::vector<uint32_t> u32vector_elements(const pmt_t& vector)
 {
     if (!vector->is_u32vector())
         throw wrong_type("pmt_u32vector_elements", vector);
@@ -635,7 +631,7 @@ const std::vector<uint32_t> u32vector_elements(pmt_t vector)
 }
 
 
-uint32_t* u32vector_writable_elements(pmt_t vector, size_t& len)
+uint32_t* u32vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_u32vector())
         throw wrong_type("pmt_u32vector_writable_elements", vector);
@@ -654,22 +650,20 @@ const std::string pmt_u32vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_s32vector* _s32vector(pmt_t x)
+static pmt_s32vector* _s32vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_s32vector*>(x.get());
+    return static_cast<pmt_s32vector*>(x.get());
 }
 
 
-pmt_s32vector::pmt_s32vector(size_t k, int32_t fill) : d_v(k)
+pmt_s32vector::pmt_s32vector(size_t k, int32_t fill)
+    : pmt_uniform_vector(S32VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_s32vector::pmt_s32vector(size_t k, const int32_t* data) : d_v(k)
+pmt_s32vector::pmt_s32vector(size_t k, const int32_t* data)
+    : pmt_uniform_vector(S32VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(int32_t));
 }
 
 int32_t pmt_s32vector::ref(size_t k) const
@@ -710,7 +704,7 @@ void* pmt_s32vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_s32vector(pmt_t obj) { return obj->is_s32vector(); }
+bool is_s32vector(const pmt_t& obj) { return obj->is_s32vector(); }
 
 pmt_t make_s32vector(size_t k, int32_t fill) { return pmt_t(new pmt_s32vector(k, fill)); }
 
@@ -728,28 +722,28 @@ pmt_t init_s32vector(size_t k, const std::vector<int32_t>& data)
         new pmt_s32vector(k, static_cast<int32_t>(0))); // fills an empty vector with 0
 }
 
-int32_t s32vector_ref(pmt_t vector, size_t k)
+int32_t s32vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_s32vector())
         throw wrong_type("pmt_s32vector_ref", vector);
     return _s32vector(vector)->ref(k);
 }
 
-void s32vector_set(pmt_t vector, size_t k, int32_t obj)
+void s32vector_set(const pmt_t& vector, size_t k, int32_t obj)
 {
     if (!vector->is_s32vector())
         throw wrong_type("pmt_s32vector_set", vector);
     _s32vector(vector)->set(k, obj);
 }
 
-const int32_t* s32vector_elements(pmt_t vector, size_t& len)
+const int32_t* s32vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_s32vector())
         throw wrong_type("pmt_s32vector_elements", vector);
     return _s32vector(vector)->elements(len);
 }
 
-const std::vector<int32_t> s32vector_elements(pmt_t vector)
+const std::vector<int32_t> s32vector_elements(const pmt_t& vector)
 {
     if (!vector->is_s32vector())
         throw wrong_type("pmt_s32vector_elements", vector);
@@ -760,7 +754,7 @@ const std::vector<int32_t> s32vector_elements(pmt_t vector)
 }
 
 
-int32_t* s32vector_writable_elements(pmt_t vector, size_t& len)
+int32_t* s32vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_s32vector())
         throw wrong_type("pmt_s32vector_writable_elements", vector);
@@ -779,22 +773,20 @@ const std::string pmt_s32vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_u64vector* _u64vector(pmt_t x)
+static pmt_u64vector* _u64vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_u64vector*>(x.get());
+    return static_cast<pmt_u64vector*>(x.get());
 }
 
 
-pmt_u64vector::pmt_u64vector(size_t k, uint64_t fill) : d_v(k)
+pmt_u64vector::pmt_u64vector(size_t k, uint64_t fill)
+    : pmt_uniform_vector(U64VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_u64vector::pmt_u64vector(size_t k, const uint64_t* data) : d_v(k)
+pmt_u64vector::pmt_u64vector(size_t k, const uint64_t* data)
+    : pmt_uniform_vector(U64VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(uint64_t));
 }
 
 uint64_t pmt_u64vector::ref(size_t k) const
@@ -835,7 +827,7 @@ void* pmt_u64vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_u64vector(pmt_t obj) { return obj->is_u64vector(); }
+bool is_u64vector(const pmt_t& obj) { return obj->is_u64vector(); }
 
 pmt_t make_u64vector(size_t k, uint64_t fill)
 {
@@ -856,28 +848,28 @@ pmt_t init_u64vector(size_t k, const std::vector<uint64_t>& data)
         new pmt_u64vector(k, static_cast<uint64_t>(0))); // fills an empty vector with 0
 }
 
-uint64_t u64vector_ref(pmt_t vector, size_t k)
+uint64_t u64vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_u64vector())
         throw wrong_type("pmt_u64vector_ref", vector);
     return _u64vector(vector)->ref(k);
 }
 
-void u64vector_set(pmt_t vector, size_t k, uint64_t obj)
+void u64vector_set(const pmt_t& vector, size_t k, uint64_t obj)
 {
     if (!vector->is_u64vector())
         throw wrong_type("pmt_u64vector_set", vector);
     _u64vector(vector)->set(k, obj);
 }
 
-const uint64_t* u64vector_elements(pmt_t vector, size_t& len)
+const uint64_t* u64vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_u64vector())
         throw wrong_type("pmt_u64vector_elements", vector);
     return _u64vector(vector)->elements(len);
 }
 
-const std::vector<uint64_t> u64vector_elements(pmt_t vector)
+const std::vector<uint64_t> u64vector_elements(const pmt_t& vector)
 {
     if (!vector->is_u64vector())
         throw wrong_type("pmt_u64vector_elements", vector);
@@ -888,7 +880,7 @@ const std::vector<uint64_t> u64vector_elements(pmt_t vector)
 }
 
 
-uint64_t* u64vector_writable_elements(pmt_t vector, size_t& len)
+uint64_t* u64vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_u64vector())
         throw wrong_type("pmt_u64vector_writable_elements", vector);
@@ -907,22 +899,20 @@ const std::string pmt_u64vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_s64vector* _s64vector(pmt_t x)
+static pmt_s64vector* _s64vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_s64vector*>(x.get());
+    return static_cast<pmt_s64vector*>(x.get());
 }
 
 
-pmt_s64vector::pmt_s64vector(size_t k, int64_t fill) : d_v(k)
+pmt_s64vector::pmt_s64vector(size_t k, int64_t fill)
+    : pmt_uniform_vector(S64VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_s64vector::pmt_s64vector(size_t k, const int64_t* data) : d_v(k)
+pmt_s64vector::pmt_s64vector(size_t k, const int64_t* data)
+    : pmt_uniform_vector(S64VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(int64_t));
 }
 
 int64_t pmt_s64vector::ref(size_t k) const
@@ -963,7 +953,7 @@ void* pmt_s64vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_s64vector(pmt_t obj) { return obj->is_s64vector(); }
+bool is_s64vector(const pmt_t& obj) { return obj->is_s64vector(); }
 
 pmt_t make_s64vector(size_t k, int64_t fill) { return pmt_t(new pmt_s64vector(k, fill)); }
 
@@ -981,28 +971,28 @@ pmt_t init_s64vector(size_t k, const std::vector<int64_t>& data)
         new pmt_s64vector(k, static_cast<int64_t>(0))); // fills an empty vector with 0
 }
 
-int64_t s64vector_ref(pmt_t vector, size_t k)
+int64_t s64vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_s64vector())
         throw wrong_type("pmt_s64vector_ref", vector);
     return _s64vector(vector)->ref(k);
 }
 
-void s64vector_set(pmt_t vector, size_t k, int64_t obj)
+void s64vector_set(const pmt_t& vector, size_t k, int64_t obj)
 {
     if (!vector->is_s64vector())
         throw wrong_type("pmt_s64vector_set", vector);
     _s64vector(vector)->set(k, obj);
 }
 
-const int64_t* s64vector_elements(pmt_t vector, size_t& len)
+const int64_t* s64vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_s64vector())
         throw wrong_type("pmt_s64vector_elements", vector);
     return _s64vector(vector)->elements(len);
 }
 
-const std::vector<int64_t> s64vector_elements(pmt_t vector)
+const std::vector<int64_t> s64vector_elements(const pmt_t& vector)
 {
     if (!vector->is_s64vector())
         throw wrong_type("pmt_s64vector_elements", vector);
@@ -1013,7 +1003,7 @@ const std::vector<int64_t> s64vector_elements(pmt_t vector)
 }
 
 
-int64_t* s64vector_writable_elements(pmt_t vector, size_t& len)
+int64_t* s64vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_s64vector())
         throw wrong_type("pmt_s64vector_writable_elements", vector);
@@ -1032,22 +1022,20 @@ const std::string pmt_s64vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_f32vector* _f32vector(pmt_t x)
+static pmt_f32vector* _f32vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_f32vector*>(x.get());
+    return static_cast<pmt_f32vector*>(x.get());
 }
 
 
-pmt_f32vector::pmt_f32vector(size_t k, float fill) : d_v(k)
+pmt_f32vector::pmt_f32vector(size_t k, float fill)
+    : pmt_uniform_vector(F32VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_f32vector::pmt_f32vector(size_t k, const float* data) : d_v(k)
+pmt_f32vector::pmt_f32vector(size_t k, const float* data)
+    : pmt_uniform_vector(F32VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(float));
 }
 
 float pmt_f32vector::ref(size_t k) const
@@ -1088,7 +1076,7 @@ void* pmt_f32vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_f32vector(pmt_t obj) { return obj->is_f32vector(); }
+bool is_f32vector(const pmt_t& obj) { return obj->is_f32vector(); }
 
 pmt_t make_f32vector(size_t k, float fill) { return pmt_t(new pmt_f32vector(k, fill)); }
 
@@ -1106,28 +1094,28 @@ pmt_t init_f32vector(size_t k, const std::vector<float>& data)
         new pmt_f32vector(k, static_cast<float>(0))); // fills an empty vector with 0
 }
 
-float f32vector_ref(pmt_t vector, size_t k)
+float f32vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_f32vector())
         throw wrong_type("pmt_f32vector_ref", vector);
     return _f32vector(vector)->ref(k);
 }
 
-void f32vector_set(pmt_t vector, size_t k, float obj)
+void f32vector_set(const pmt_t& vector, size_t k, float obj)
 {
     if (!vector->is_f32vector())
         throw wrong_type("pmt_f32vector_set", vector);
     _f32vector(vector)->set(k, obj);
 }
 
-const float* f32vector_elements(pmt_t vector, size_t& len)
+const float* f32vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_f32vector())
         throw wrong_type("pmt_f32vector_elements", vector);
     return _f32vector(vector)->elements(len);
 }
 
-const std::vector<float> f32vector_elements(pmt_t vector)
+const std::vector<float> f32vector_elements(const pmt_t& vector)
 {
     if (!vector->is_f32vector())
         throw wrong_type("pmt_f32vector_elements", vector);
@@ -1138,7 +1126,7 @@ const std::vector<float> f32vector_elements(pmt_t vector)
 }
 
 
-float* f32vector_writable_elements(pmt_t vector, size_t& len)
+float* f32vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_f32vector())
         throw wrong_type("pmt_f32vector_writable_elements", vector);
@@ -1159,22 +1147,20 @@ const std::string pmt_f32vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_f64vector* _f64vector(pmt_t x)
+static pmt_f64vector* _f64vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_f64vector*>(x.get());
+    return static_cast<pmt_f64vector*>(x.get());
 }
 
 
-pmt_f64vector::pmt_f64vector(size_t k, double fill) : d_v(k)
+pmt_f64vector::pmt_f64vector(size_t k, double fill)
+    : pmt_uniform_vector(F64VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_f64vector::pmt_f64vector(size_t k, const double* data) : d_v(k)
+pmt_f64vector::pmt_f64vector(size_t k, const double* data)
+    : pmt_uniform_vector(F64VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(double));
 }
 
 double pmt_f64vector::ref(size_t k) const
@@ -1215,7 +1201,7 @@ void* pmt_f64vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_f64vector(pmt_t obj) { return obj->is_f64vector(); }
+bool is_f64vector(const pmt_t& obj) { return obj->is_f64vector(); }
 
 pmt_t make_f64vector(size_t k, double fill) { return pmt_t(new pmt_f64vector(k, fill)); }
 
@@ -1233,28 +1219,28 @@ pmt_t init_f64vector(size_t k, const std::vector<double>& data)
         new pmt_f64vector(k, static_cast<double>(0))); // fills an empty vector with 0
 }
 
-double f64vector_ref(pmt_t vector, size_t k)
+double f64vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_f64vector())
         throw wrong_type("pmt_f64vector_ref", vector);
     return _f64vector(vector)->ref(k);
 }
 
-void f64vector_set(pmt_t vector, size_t k, double obj)
+void f64vector_set(const pmt_t& vector, size_t k, double obj)
 {
     if (!vector->is_f64vector())
         throw wrong_type("pmt_f64vector_set", vector);
     _f64vector(vector)->set(k, obj);
 }
 
-const double* f64vector_elements(pmt_t vector, size_t& len)
+const double* f64vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_f64vector())
         throw wrong_type("pmt_f64vector_elements", vector);
     return _f64vector(vector)->elements(len);
 }
 
-const std::vector<double> f64vector_elements(pmt_t vector)
+const std::vector<double> f64vector_elements(const pmt_t& vector)
 {
     if (!vector->is_f64vector())
         throw wrong_type("pmt_f64vector_elements", vector);
@@ -1265,7 +1251,7 @@ const std::vector<double> f64vector_elements(pmt_t vector)
 }
 
 
-double* f64vector_writable_elements(pmt_t vector, size_t& len)
+double* f64vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_f64vector())
         throw wrong_type("pmt_f64vector_writable_elements", vector);
@@ -1287,22 +1273,20 @@ const std::string pmt_f64vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_c32vector* _c32vector(pmt_t x)
+static pmt_c32vector* _c32vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_c32vector*>(x.get());
+    return static_cast<pmt_c32vector*>(x.get());
 }
 
 
-pmt_c32vector::pmt_c32vector(size_t k, std::complex<float> fill) : d_v(k)
+pmt_c32vector::pmt_c32vector(size_t k, std::complex<float> fill)
+    : pmt_uniform_vector(C32VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_c32vector::pmt_c32vector(size_t k, const std::complex<float>* data) : d_v(k)
+pmt_c32vector::pmt_c32vector(size_t k, const std::complex<float>* data)
+    : pmt_uniform_vector(C32VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(std::complex<float>));
 }
 
 std::complex<float> pmt_c32vector::ref(size_t k) const
@@ -1343,7 +1327,7 @@ void* pmt_c32vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_c32vector(pmt_t obj) { return obj->is_c32vector(); }
+bool is_c32vector(const pmt_t& obj) { return obj->is_c32vector(); }
 
 pmt_t make_c32vector(size_t k, std::complex<float> fill)
 {
@@ -1364,28 +1348,28 @@ pmt_t init_c32vector(size_t k, const std::vector<std::complex<float>>& data)
         k, static_cast<std::complex<float>>(0))); // fills an empty vector with 0
 }
 
-std::complex<float> c32vector_ref(pmt_t vector, size_t k)
+std::complex<float> c32vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_c32vector())
         throw wrong_type("pmt_c32vector_ref", vector);
     return _c32vector(vector)->ref(k);
 }
 
-void c32vector_set(pmt_t vector, size_t k, std::complex<float> obj)
+void c32vector_set(const pmt_t& vector, size_t k, std::complex<float> obj)
 {
     if (!vector->is_c32vector())
         throw wrong_type("pmt_c32vector_set", vector);
     _c32vector(vector)->set(k, obj);
 }
 
-const std::complex<float>* c32vector_elements(pmt_t vector, size_t& len)
+const std::complex<float>* c32vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_c32vector())
         throw wrong_type("pmt_c32vector_elements", vector);
     return _c32vector(vector)->elements(len);
 }
 
-const std::vector<std::complex<float>> c32vector_elements(pmt_t vector)
+const std::vector<std::complex<float>> c32vector_elements(const pmt_t& vector)
 {
     if (!vector->is_c32vector())
         throw wrong_type("pmt_c32vector_elements", vector);
@@ -1396,7 +1380,7 @@ const std::vector<std::complex<float>> c32vector_elements(pmt_t vector)
 }
 
 
-std::complex<float>* c32vector_writable_elements(pmt_t vector, size_t& len)
+std::complex<float>* c32vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_c32vector())
         throw wrong_type("pmt_c32vector_writable_elements", vector);
@@ -1417,22 +1401,20 @@ const std::string pmt_c32vector::string_ref(size_t k) const
 
 namespace pmt {
 
-static pmt_c64vector* _c64vector(pmt_t x)
+static pmt_c64vector* _c64vector(const pmt_t& x)
 {
-    return dynamic_cast<pmt_c64vector*>(x.get());
+    return static_cast<pmt_c64vector*>(x.get());
 }
 
 
-pmt_c64vector::pmt_c64vector(size_t k, std::complex<double> fill) : d_v(k)
+pmt_c64vector::pmt_c64vector(size_t k, std::complex<double> fill)
+    : pmt_uniform_vector(C64VECTOR), d_v(k, fill)
 {
-    for (size_t i = 0; i < k; i++)
-        d_v[i] = fill;
 }
 
-pmt_c64vector::pmt_c64vector(size_t k, const std::complex<double>* data) : d_v(k)
+pmt_c64vector::pmt_c64vector(size_t k, const std::complex<double>* data)
+    : pmt_uniform_vector(C64VECTOR), d_v(data, data + k)
 {
-    if (k)
-        memcpy(&d_v[0], data, k * sizeof(std::complex<double>));
 }
 
 std::complex<double> pmt_c64vector::ref(size_t k) const
@@ -1473,7 +1455,7 @@ void* pmt_c64vector::uniform_writable_elements(size_t& len)
     return len ? (&d_v[0]) : nullptr;
 }
 
-bool is_c64vector(pmt_t obj) { return obj->is_c64vector(); }
+bool is_c64vector(const pmt_t& obj) { return obj->is_c64vector(); }
 
 pmt_t make_c64vector(size_t k, std::complex<double> fill)
 {
@@ -1494,28 +1476,28 @@ pmt_t init_c64vector(size_t k, const std::vector<std::complex<double>>& data)
         k, static_cast<std::complex<double>>(0))); // fills an empty vector with 0
 }
 
-std::complex<double> c64vector_ref(pmt_t vector, size_t k)
+std::complex<double> c64vector_ref(const pmt_t& vector, size_t k)
 {
     if (!vector->is_c64vector())
         throw wrong_type("pmt_c64vector_ref", vector);
     return _c64vector(vector)->ref(k);
 }
 
-void c64vector_set(pmt_t vector, size_t k, std::complex<double> obj)
+void c64vector_set(const pmt_t& vector, size_t k, std::complex<double> obj)
 {
     if (!vector->is_c64vector())
         throw wrong_type("pmt_c64vector_set", vector);
     _c64vector(vector)->set(k, obj);
 }
 
-const std::complex<double>* c64vector_elements(pmt_t vector, size_t& len)
+const std::complex<double>* c64vector_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_c64vector())
         throw wrong_type("pmt_c64vector_elements", vector);
     return _c64vector(vector)->elements(len);
 }
 
-const std::vector<std::complex<double>> c64vector_elements(pmt_t vector)
+const std::vector<std::complex<double>> c64vector_elements(const pmt_t& vector)
 {
     if (!vector->is_c64vector())
         throw wrong_type("pmt_c64vector_elements", vector);
@@ -1526,7 +1508,7 @@ const std::vector<std::complex<double>> c64vector_elements(pmt_t vector)
 }
 
 
-std::complex<double>* c64vector_writable_elements(pmt_t vector, size_t& len)
+std::complex<double>* c64vector_writable_elements(const pmt_t& vector, size_t& len)
 {
     if (!vector->is_c64vector())
         throw wrong_type("pmt_c64vector_writable_elements", vector);
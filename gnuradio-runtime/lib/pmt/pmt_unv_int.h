@@ -29,7 +29,6 @@ public:
     pmt_u8vector(size_t k, const uint8_t* data);
     // ~pmt_u8vector();
 
-    bool is_u8vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(uint8_t); }
     uint8_t ref(size_t k) const;
@@ -54,7 +53,6 @@ public:
     pmt_s8vector(size_t k, const int8_t* data);
     // ~pmt_s8vector();
 
-    bool is_s8vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(int8_t); }
     int8_t ref(size_t k) const;
@@ -79,7 +77,6 @@ public:
     pmt_u16vector(size_t k, const uint16_t* data);
     // ~pmt_u16vector();
 
-    bool is_u16vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(uint16_t); }
     uint16_t ref(size_t k) const;
@@ -104,7 +101,6 @@ public:
     pmt_s16vector(size_t k, const int16_t* data);
     // ~pmt_s16vector();
 
-    bool is_s16vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(int16_t); }
     int16_t ref(size_t k) const;
@@ -129,7 +125,6 @@ public:
     pmt_u32vector(size_t k, const uint32_t* data);
     // ~pmt_u32vector();
 
-    bool is_u32vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(uint32_t); }
     uint32_t ref(size_t k) const;
@@ -154,7 +149,6 @@ public:
     pmt_s32vector(size_t k, const int32_t* data);
     // ~pmt_s32vector();
 
-    bool is_s32vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(int32_t); }
     int32_t ref(size_t k) const;
@@ -179,7 +173,6 @@ public:
     pmt_u64vector(size_t k, const uint64_t* data);
     // ~pmt_u64vector();
 
-    bool is_u64vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(uint64_t); }
     uint64_t ref(size_t k) const;
@@ -204,7 +197,6 @@ public:
     pmt_s64vector(size_t k, const int64_t* data);
     // ~pmt_s64vector();
 
-    bool is_s64vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(int64_t); }
     int64_t ref(size_t k) const;
@@ -229,7 +221,6 @@ public:
     pmt_f32vector(size_t k, const float* data);
     // ~pmt_f32vector();
 
-    bool is_f32vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(float); }
     float ref(size_t k) const;
@@ -254,7 +245,6 @@ public:
     pmt_f64vector(size_t k, const double* data);
     // ~pmt_f64vector();
 
-    bool is_f64vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(double); }
     double ref(size_t k) const;
@@ -279,7 +269,6 @@ public:
     pmt_c32vector(size_t k, const std::complex<float>* data);
     // ~pmt_c32vector();
 
-    bool is_c32vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(std::complex<float>); }
     std::complex<float> ref(size_t k) const;
@@ -304,7 +293,6 @@ public:
     pmt_c64vector(size_t k, const std::complex<double>* data);
     // ~pmt_c64vector();
 
-    bool is_c64vector() const override { return true; }
     size_t length() const override { return d_v.size(); }
     size_t itemsize() const override { return sizeof(std::complex<double>); }
     std::complex<double> ref(size_t k) const;
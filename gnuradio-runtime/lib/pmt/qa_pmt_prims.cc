@@ -14,6 +14,7 @@
 #include <boost/test/unit_test.hpp>
 #include <cstring>
 #include <sstream>
+#include <thread>
 
 BOOST_AUTO_TEST_CASE(test_symbols)
 {
@@ -59,6 +60,32 @@ BOOST_AUTO_TEST_CASE(test_symbols)
         BOOST_CHECK(v1[i] == v2[i]);
 }
 
+BOOST_AUTO_TEST_CASE(test_symbols_threads)
+{
+    // Enough symbols to make the table grow while the threads look them up
+    static const int NTHREADS = 4;
+    static const int N = 8192;
+    std::vector<std::vector<pmt::pmt_t>> syms(NTHREADS, std::vector<pmt::pmt_t>(N));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NTHREADS; t++)
+        threads.emplace_back([&syms, t] {
+            for (int i = 0; i < N; i++) {
+                int k = (i + t * N / NTHREADS) % N;
+                syms[t][k] = pmt::intern("threads-" + std::to_string(k));
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int i = 0; i < N; i++) {
+        pmt::pmt_t sym = pmt::intern("threads-" + std::to_string(i));
+        BOOST_CHECK_EQUAL(pmt::symbol_to_string(sym), "threads-" + std::to_string(i));
+        for (int t = 0; t < NTHREADS; t++)
+            BOOST_CHECK(syms[t][i] == sym);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_booleans)
 {
     pmt::pmt_t sym = pmt::mp("test");
@@ -328,6 +355,32 @@ BOOST_AUTO_TEST_CASE(test_equivalence)
     BOOST_CHECK(pmt::equal(v0, v1));
 }
 
+BOOST_AUTO_TEST_CASE(test_types)
+{
+    pmt::pmt_t dict = pmt::dict_add(pmt::make_dict(), pmt::mp("k"), pmt::PMT_T);
+    BOOST_CHECK_EQUAL(pmt::PMT_T->type(), pmt::pmt_base::BOOL);
+    BOOST_CHECK_EQUAL(pmt::PMT_NIL->type(), pmt::pmt_base::NIL);
+    BOOST_CHECK_EQUAL(pmt::mp("k")->type(), pmt::pmt_base::SYMBOL);
+    BOOST_CHECK_EQUAL(pmt::from_long(1)->type(), pmt::pmt_base::INTEGER);
+    BOOST_CHECK_EQUAL(pmt::from_uint64(1)->type(), pmt::pmt_base::UINT64);
+    BOOST_CHECK_EQUAL(pmt::from_double(1)->type(), pmt::pmt_base::REAL);
+    BOOST_CHECK_EQUAL(pmt::from_complex(1, 1)->type(), pmt::pmt_base::COMPLEX);
+    BOOST_CHECK_EQUAL(pmt::cons(dict, dict)->type(), pmt::pmt_base::PAIR);
+    BOOST_CHECK_EQUAL(dict->type(), pmt::pmt_base::DICT);
+    BOOST_CHECK_EQUAL(pmt::make_vector(1, dict)->type(), pmt::pmt_base::VECTOR);
+    BOOST_CHECK_EQUAL(pmt::make_tuple()->type(), pmt::pmt_base::TUPLE);
+    BOOST_CHECK_EQUAL(pmt::make_any(1)->type(), pmt::pmt_base::ANY);
+    BOOST_CHECK_EQUAL(pmt::make_u8vector(1, 0)->type(), pmt::pmt_base::U8VECTOR);
+    BOOST_CHECK_EQUAL(pmt::make_c64vector(1, 0)->type(), pmt::pmt_base::C64VECTOR);
+
+    // The kinds that span several types
+    BOOST_CHECK(dict->is_pair());
+    BOOST_CHECK(pmt::from_complex(1, 1)->is_number());
+    BOOST_CHECK(!pmt::PMT_T->is_number());
+    BOOST_CHECK(pmt::make_f32vector(1, 0)->is_uniform_vector());
+    BOOST_CHECK(!pmt::make_vector(1, dict)->is_uniform_vector());
+}
+
 BOOST_AUTO_TEST_CASE(test_misc)
 {
     pmt::pmt_t k0 = pmt::mp("k0");
@@ -390,6 +443,134 @@ BOOST_AUTO_TEST_CASE(test_dict)
     dict = pmt::reverse(dict);
     BOOST_CHECK(pmt::eqv(pmt::dict_ref(dict, k0, not_found), v0));
     BOOST_CHECK(pmt::is_dict(dict));
+
+    // Deleting from the middle keeps the order of the others
+    dict = pmt::dict_add(dict, k1, v1);
+    BOOST_CHECK(pmt::equal(pmt::list4(k1, k0, k2, k3), pmt::dict_keys(dict)));
+    pmt::pmt_t without_k0 = pmt::dict_delete(dict, k0);
+    BOOST_CHECK(pmt::is_dict(without_k0));
+    BOOST_CHECK(pmt::equal(pmt::list3(k1, k2, k3), pmt::dict_keys(without_k0)));
+    BOOST_CHECK(pmt::equal(pmt::list4(k1, k0, k2, k3), pmt::dict_keys(dict)));
+    BOOST_CHECK(pmt::equal(dict, pmt::dict_delete(dict, pmt::mp("k4"))));
+    BOOST_CHECK_THROW(pmt::dict_delete(pmt::list1(k0), k1), pmt::wrong_type);
+
+    // Numbers are keys by value
+    dict = pmt::dict_add(dict, pmt::from_long(7), v2);
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(dict, pmt::from_long(7), not_found), v2));
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(dict, pmt::from_double(7), not_found), not_found));
+}
+
+BOOST_AUTO_TEST_CASE(test_large_alist_dict)
+{
+    // However many entries it has, a dict from make_dict() is an a-list
+    const int n = 12;
+    std::vector<pmt::pmt_t> keys;
+    pmt::pmt_t dict = pmt::make_dict();
+    for (int i = 0; i < n; i++) {
+        keys.push_back(pmt::mp("key" + std::to_string(i)));
+        dict = pmt::dict_add(dict, keys[i], pmt::from_long(i));
+    }
+
+    BOOST_CHECK(pmt::is_dict(dict));
+    BOOST_CHECK(pmt::is_pair(dict));
+    BOOST_CHECK_EQUAL(pmt::length(dict), size_t(n));
+    int left = n;
+    for (pmt::pmt_t l = dict; pmt::is_pair(l); l = pmt::cdr(l)) {
+        left--;
+        BOOST_CHECK(pmt::eq(pmt::car(pmt::car(l)), keys[left]));
+        BOOST_CHECK_EQUAL(pmt::to_long(pmt::cdr(pmt::car(l))), left);
+    }
+    BOOST_CHECK_EQUAL(left, 0);
+    BOOST_CHECK(pmt::eq(pmt::car(pmt::nth(n - 1, dict)), keys[0]));
+    BOOST_CHECK_EQUAL(pmt::to_long(pmt::cdr(pmt::assq(keys[3], dict))), 3);
+    BOOST_CHECK(pmt::eq(pmt::dict_items(dict), dict));
+}
+
+BOOST_AUTO_TEST_CASE(test_hash_dict)
+{
+    const int n = 200;
+    std::vector<pmt::pmt_t> keys;
+    pmt::pmt_t dict = pmt::make_hash_dict();
+    pmt::pmt_t alist = pmt::make_dict();
+    pmt::pmt_t half;
+    for (int i = 0; i < n; i++) {
+        keys.push_back(pmt::mp("key" + std::to_string(i)));
+        dict = pmt::dict_add(dict, keys[i], pmt::from_long(i));
+        alist = pmt::dcons(pmt::cons(keys[i], pmt::from_long(i)), alist);
+        if (i == n / 2 - 1)
+            half = dict;
+    }
+    pmt::pmt_t not_found = pmt::mp("not found");
+
+    BOOST_CHECK(pmt::is_dict(pmt::make_hash_dict()));
+    BOOST_CHECK_EQUAL(pmt::length(pmt::make_hash_dict()), size_t(0));
+    BOOST_CHECK(pmt::is_dict(dict));
+    BOOST_CHECK(!pmt::is_pair(dict));
+    BOOST_CHECK_THROW(pmt::car(dict), pmt::wrong_type);
+    BOOST_CHECK_THROW(pmt::cdr(dict), pmt::wrong_type);
+    BOOST_CHECK_EQUAL(pmt::length(dict), size_t(n));
+
+    // Walking it goes through dict_items(), most recently added first
+    int left = n;
+    for (pmt::pmt_t l = pmt::dict_items(dict); pmt::is_pair(l); l = pmt::cdr(l)) {
+        left--;
+        BOOST_CHECK(pmt::eq(pmt::caar(l), keys[left]));
+        BOOST_CHECK_EQUAL(pmt::to_long(pmt::cdar(l)), left);
+    }
+    BOOST_CHECK_EQUAL(left, 0);
+    for (int i = 0; i < n; i++)
+        BOOST_CHECK_EQUAL(pmt::to_long(pmt::dict_ref(dict, keys[i], not_found)), i);
+    BOOST_CHECK(!pmt::dict_has_key(dict, pmt::mp("key-1")));
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(dict, pmt::from_long(0), not_found), not_found));
+
+    // Same entries, in the same order, as the a-list
+    BOOST_CHECK(pmt::equal(dict, alist));
+    BOOST_CHECK(pmt::equal(pmt::dict_keys(dict), pmt::dict_keys(alist)));
+    BOOST_CHECK(pmt::equal(pmt::dict_values(dict), pmt::dict_values(alist)));
+    BOOST_CHECK_EQUAL(pmt::serialize_str(dict), pmt::serialize_str(alist));
+    BOOST_CHECK_EQUAL(pmt::write_string(dict), pmt::write_string(alist));
+    BOOST_CHECK(pmt::equal(pmt::deserialize_str(pmt::serialize_str(dict)), dict));
+    BOOST_CHECK(pmt::equal(pmt::to_tuple(dict), pmt::to_tuple(alist)));
+
+    // Earlier versions don't change
+    BOOST_CHECK_EQUAL(pmt::length(half), size_t(n / 2));
+    BOOST_CHECK(!pmt::dict_has_key(half, keys[n / 2]));
+    BOOST_CHECK(pmt::dict_has_key(half, keys[n / 2 - 1]));
+
+    // Replacing moves the key to the front
+    pmt::pmt_t replaced = pmt::dict_add(dict, keys[10], pmt::PMT_T);
+    BOOST_CHECK_EQUAL(pmt::length(replaced), size_t(n));
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(replaced, keys[10], not_found), pmt::PMT_T));
+    BOOST_CHECK(pmt::eqv(pmt::car(pmt::dict_keys(replaced)), keys[10]));
+    BOOST_CHECK_EQUAL(pmt::to_long(pmt::dict_ref(dict, keys[10], not_found)), 10);
+    BOOST_CHECK(pmt::equal(pmt::acons(keys[10], pmt::PMT_T, dict), replaced));
+
+    // Deleting
+    BOOST_CHECK(pmt::equal(pmt::dict_delete(dict, pmt::mp("key-1")), dict));
+    pmt::pmt_t odd = dict;
+    for (int i = 0; i < n; i += 2)
+        odd = pmt::dict_delete(odd, keys[i]);
+    BOOST_CHECK_EQUAL(pmt::length(odd), size_t(n / 2));
+    for (int i = 0; i < n; i++)
+        BOOST_CHECK_EQUAL(pmt::dict_has_key(odd, keys[i]), i % 2 == 1);
+    for (int i = 1; i < n; i += 2)
+        odd = pmt::dict_delete(odd, keys[i]);
+    BOOST_CHECK(pmt::is_dict(odd));
+    BOOST_CHECK_EQUAL(pmt::length(odd), size_t(0));
+    BOOST_CHECK(pmt::is_null(pmt::dict_items(odd)));
+
+    // Numbers are keys by value
+    pmt::pmt_t numbers = pmt::make_hash_dict();
+    for (int i = 0; i < n; i++)
+        numbers = pmt::dict_add(numbers, pmt::from_long(i), pmt::from_double(i));
+    numbers = pmt::dict_add(numbers, pmt::from_double(0.0), pmt::PMT_T);
+    for (int i = 0; i < n; i++)
+        BOOST_CHECK_EQUAL(
+            pmt::to_double(pmt::dict_ref(numbers, pmt::from_long(i), not_found)), i);
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(numbers, pmt::from_double(-0.0), not_found),
+                         pmt::PMT_T));
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(numbers, pmt::from_uint64(1), not_found),
+                         not_found));
 }
 
 BOOST_AUTO_TEST_CASE(test_pdu)
@@ -559,6 +740,242 @@ BOOST_AUTO_TEST_CASE(test_serialize)
     // FIXME add tests for malformed input too.
 }
 
+BOOST_AUTO_TEST_CASE(test_serialize_buffer)
+{
+    pmt::pmt_t meta = pmt::make_dict();
+    meta = pmt::dict_add(meta, pmt::mp("freq"), pmt::from_double(2.4e9));
+    meta = pmt::dict_add(meta, pmt::mp("offset"), pmt::from_uint64(1ULL << 40));
+    meta = pmt::dict_add(meta, pmt::mp("count"), pmt::from_long(-5000000000L));
+    meta = pmt::dict_add(meta, pmt::mp("z"), pmt::from_complex(1.5, -2.5));
+    meta = pmt::dict_add(
+        meta, pmt::mp("v"), pmt::make_vector(2, pmt::make_tuple(pmt::PMT_T, pmt::PMT_F)));
+    std::vector<std::complex<float>> c32 = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+    std::vector<int16_t> s16 = { -1, 2, 0x1234 };
+    pmt::pmt_t objs[] = { pmt::cons(meta, pmt::init_c32vector(c32.size(), c32)),
+                          pmt::init_s16vector(s16.size(), s16),
+                          pmt::make_u8vector(0, 0),
+                          pmt::list3(pmt::mp("a"), pmt::mp(1), pmt::mp("b")) };
+
+    for (const auto& obj : objs) {
+        // the same bytes as through a streambuf
+        std::stringbuf sb;
+        pmt::serialize(obj, sb);
+        std::string s = sb.str();
+        BOOST_CHECK_EQUAL(pmt::serialized_size(obj), s.size());
+        BOOST_CHECK_EQUAL(pmt::serialize_str(obj), s);
+
+        std::vector<char> buf(s.size() + 4, 'x');
+        BOOST_CHECK_EQUAL(pmt::serialize_to_buffer(obj, buf.data(), buf.size()),
+                          s.size());
+        BOOST_CHECK(memcmp(buf.data(), s.data(), s.size()) == 0);
+        BOOST_CHECK_THROW(pmt::serialize_to_buffer(obj, buf.data(), s.size() - 1),
+                          pmt::out_of_range);
+
+        // trailing bytes are left alone
+        size_t used;
+        BOOST_CHECK(pmt::equal(
+            pmt::deserialize_from_buffer(buf.data(), buf.size(), used), obj));
+        BOOST_CHECK_EQUAL(used, s.size());
+
+        BOOST_CHECK_THROW(pmt::deserialize_from_buffer(s.data(), s.size() - 1, used),
+                          pmt::exception);
+    }
+
+    size_t used = 1;
+    BOOST_CHECK(pmt::eq(pmt::deserialize_from_buffer(nullptr, 0, used), pmt::PMT_EOF));
+    BOOST_CHECK_EQUAL(used, size_t(0));
+}
+
+static std::string from_hex(const std::string& hex)
+{
+    std::string s;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2)
+        s.push_back(char(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    return s;
+}
+
+BOOST_AUTO_TEST_CASE(test_serialize_golden)
+{
+    pmt::pmt_t meta = pmt::make_dict();
+    meta = pmt::dict_add(meta, pmt::mp("freq"), pmt::from_double(2.4e9));
+    meta = pmt::dict_add(meta, pmt::mp("offset"), pmt::from_uint64(1ULL << 40));
+    meta = pmt::dict_add(meta, pmt::mp("count"), pmt::from_long(-5000000000L));
+    meta = pmt::dict_add(meta, pmt::mp("z"), pmt::from_complex(1.5, -2.5));
+    meta = pmt::dict_add(
+        meta, pmt::mp("v"), pmt::make_vector(2, pmt::make_tuple(pmt::PMT_T, pmt::PMT_F)));
+    pmt::pmt_t nested = pmt::dict_add(pmt::make_dict(), pmt::mp("meta"), meta);
+    nested = pmt::dict_add(nested, pmt::mp("n"), pmt::from_long(7));
+    pmt::pmt_t large = pmt::make_dict();
+    for (int i = 0; i < 12; i++)
+        large = pmt::dict_add(large, pmt::mp("k" + std::to_string(i)), pmt::from_long(i));
+
+    const uint8_t u8[] = { 1, 2, 255 };
+    const int8_t s8[] = { -1, 0, 127 };
+    const uint16_t u16[] = { 1, 0x1234, 65535 };
+    const int16_t s16[] = { -1, 2, 0x1234 };
+    const uint32_t u32[] = { 1, 0x12345678, 4000000000U };
+    const int32_t s32[] = { -1, 2, -2000000000 };
+    const uint64_t u64[] = { 1, 0x123456789abcdef0ULL, 1ULL << 63 };
+    const int64_t s64[] = { -1, 2, -(1LL << 62) };
+    const float f32[] = { 0.5, -1.25, 3e38f };
+    const double f64[] = { 0.5, -1.25, 1e300 };
+    const std::complex<float> c32[] = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+    const std::complex<double> c64[] = { { 1, -2 }, { 0.5, 1e300 } };
+
+    const std::vector<pmt::pmt_t> objs = {
+        pmt::PMT_T,
+        pmt::PMT_F,
+        pmt::PMT_NIL,
+        pmt::mp("freq"),
+        pmt::mp(std::string(300, 's')),
+        pmt::from_long(42),
+        pmt::from_long(-5000000000L),
+        pmt::from_uint64(1ULL << 40),
+        pmt::from_double(2.4e9),
+        pmt::from_complex(1.5, -2.5),
+        pmt::cons(pmt::mp("a"), pmt::from_long(1)),
+        pmt::list3(pmt::mp("a"), pmt::mp(1), pmt::mp("b")),
+        pmt::make_tuple(pmt::PMT_T,
+                        pmt::make_tuple(pmt::from_long(1),
+                                        pmt::make_tuple(pmt::mp("x"), pmt::PMT_NIL)),
+                        pmt::from_double(0.5)),
+        pmt::make_vector(2, pmt::make_tuple(pmt::PMT_T, pmt::PMT_F)),
+        meta,
+        nested,
+        large,
+        pmt::init_u8vector(3, u8),
+        pmt::init_s8vector(3, s8),
+        pmt::init_u16vector(3, u16),
+        pmt::init_s16vector(3, s16),
+        pmt::init_u32vector(3, u32),
+        pmt::init_s32vector(3, s32),
+        pmt::init_u64vector(3, u64),
+        pmt::init_s64vector(3, s64),
+        pmt::init_f32vector(3, f32),
+        pmt::init_f64vector(3, f64),
+        pmt::init_c32vector(3, c32),
+        pmt::init_c64vector(2, c64),
+        pmt::make_u8vector(0, 0),
+        pmt::cons(meta, pmt::init_c32vector(3, c32)),
+    };
+
+    // What the stream serializer wrote before serialize_to_buffer() and
+    // deserialize_from_buffer() were added
+    const std::vector<std::string> golden = {
+        // #t
+        from_hex("00"),
+        // #f
+        from_hex("01"),
+        // ()
+        from_hex("06"),
+        // symbol
+        from_hex("02000466726571"),
+        from_hex("02012c") + std::string(300, 's'), // 300 character symbol
+        // int32
+        from_hex("030000002a"),
+        // int64
+        from_hex("0dfffffffed5fa0e00"),
+        // uint64
+        from_hex("0b0000010000000000"),
+        // double
+        from_hex("0441e1e1a300000000"),
+        // complex
+        from_hex("053ff8000000000000c004000000000000"),
+        // pair
+        from_hex("07020001610300000001"),
+        // list
+        from_hex("0702000161070300000001070200016206"),
+        // nested tuples
+        from_hex("0c00000003000c0000000203000000010c0000000202000178"
+                 "06043fe0000000000000"),
+        // vector
+        from_hex("08000000020c0000000200010c000000020001"),
+        // dict
+        from_hex("09070200017608000000020c0000000200010c00000002000109070200017a053ff800"
+                 "0000000000c0040000000000000907020005636f756e740dfffffffed5fa0e00090702"
+                 "00066f66667365740b00000100000000000907020004667265710441e1e1a300000000"
+                 "06"),
+        // nested dicts
+        from_hex("09070200016e030000000709070200046d65746109070200017608000000020c000000"
+                 "0200010c00000002000109070200017a053ff8000000000000c0040000000000000907"
+                 "020005636f756e740dfffffffed5fa0e0009070200066f66667365740b000001000000"
+                 "00000907020004667265710441e1e1a3000000000606"),
+        // 12 entry dict
+        from_hex("09070200036b3131030000000b09070200036b3130030000000a09070200026b390300"
+                 "00000909070200026b38030000000809070200026b37030000000709070200026b3603"
+                 "0000000609070200026b35030000000509070200026b34030000000409070200026b33"
+                 "030000000309070200026b32030000000209070200026b31030000000109070200026b"
+                 "30030000000006"),
+        // u8vector
+        from_hex("0a000000000301000102ff"),
+        // s8vector
+        from_hex("0a01000000030100ff007f"),
+        // u16vector
+        from_hex("0a0200000003010000011234ffff"),
+        // s16vector
+        from_hex("0a03000000030100ffff00021234"),
+        // u32vector
+        from_hex("0a040000000301000000000112345678ee6b2800"),
+        // s32vector
+        from_hex("0a05000000030100ffffffff0000000288ca6c00"),
+        // u64vector
+        from_hex("0a060000000301000000000000000001123456789abcdef08000000000000000"),
+        // s64vector
+        from_hex("0a07000000030100ffffffffffffffff0000000000000002c000000000000000"),
+        // f32vector
+        from_hex("0a080000000301003f000000bfa000007f61b1e6"),
+        // f64vector
+        from_hex("0a090000000301003fe0000000000000bff40000000000007e37e43c8800759c"),
+        // c32vector
+        from_hex("0a0a000000030100400000003f800000408000004040000040c0000040a00000"),
+        // c64vector
+        from_hex("0a0b0000000201003ff0000000000000c0000000000000003fe00000000000007e37e4"
+                 "3c8800759c"),
+        // empty u8vector
+        from_hex("0a00000000000100"),
+        // PDU
+        from_hex("0709070200017608000000020c0000000200010c00000002000109070200017a053ff8"
+                 "000000000000c0040000000000000907020005636f756e740dfffffffed5fa0e000907"
+                 "0200066f66667365740b00000100000000000907020004667265710441e1e1a3000000"
+                 "00060a0a000000030100400000003f800000408000004040000040c0000040a00000"),
+    };
+    BOOST_REQUIRE_EQUAL(objs.size(), golden.size());
+
+    for (size_t i = 0; i < objs.size(); i++) {
+        const pmt::pmt_t& obj = objs[i];
+        const std::string& bytes = golden[i];
+        BOOST_TEST_CONTEXT("object " << i << ": " << pmt::write_string(obj))
+        {
+            std::stringbuf sb;
+            BOOST_CHECK(pmt::serialize(obj, sb));
+            BOOST_CHECK(sb.str() == bytes);
+            BOOST_CHECK(pmt::serialize_str(obj) == bytes);
+            BOOST_CHECK_EQUAL(pmt::serialized_size(obj), bytes.size());
+            std::vector<char> buf(bytes.size());
+            BOOST_CHECK_EQUAL(pmt::serialize_to_buffer(obj, buf.data(), buf.size()),
+                              bytes.size());
+            BOOST_CHECK(std::string(buf.begin(), buf.end()) == bytes);
+
+            std::stringbuf in(bytes);
+            BOOST_CHECK(pmt::equal(pmt::deserialize(in), obj));
+            BOOST_CHECK(pmt::equal(pmt::deserialize_str(bytes), obj));
+            size_t used;
+            BOOST_CHECK(pmt::equal(
+                pmt::deserialize_from_buffer(bytes.data(), bytes.size(), used), obj));
+            BOOST_CHECK_EQUAL(used, bytes.size());
+        }
+    }
+
+    // A hash dict goes out as the a-list with the same entries
+    pmt::pmt_t hash = pmt::make_hash_dict();
+    for (int i = 0; i < 12; i++)
+        hash = pmt::dict_add(hash, pmt::mp("k" + std::to_string(i)), pmt::from_long(i));
+    BOOST_CHECK(pmt::serialize_str(hash) == golden[16]);
+    size_t used;
+    BOOST_CHECK(pmt::equal(
+        pmt::deserialize_from_buffer(golden[16].data(), golden[16].size(), used), hash));
+}
+
 BOOST_AUTO_TEST_CASE(test_sets)
 {
     pmt::pmt_t s1 = pmt::mp("s1");
@@ -0,0 +1,196 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "flat_flowgraph.h"
+#include <gnuradio/io_signature.h>
+#include <gnuradio/sync_block.h>
+#include <gnuradio/top_block.h>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Buffer sizes are multiples of this many items in all cases below
+#define GRANULARITY 1024
+
+static long resize(long old_nitems, float full, long min_nitems, long max_nitems)
+{
+    return gr::flat_flowgraph::adaptive_buffer_nitems(
+        old_nitems, full, GRANULARITY, min_nitems, max_nitems);
+}
+
+BOOST_AUTO_TEST_CASE(t0_grow)
+{
+    BOOST_CHECK_EQUAL(resize(8192, 0.9f, 1000, 65536), 16384);
+    BOOST_CHECK_EQUAL(resize(8192, 1.0f, 1000, 65536), 16384);
+
+    // Up to the largest multiple of the granularity within the limit
+    BOOST_CHECK_EQUAL(resize(32768, 0.9f, 1000, 50000), 49152);
+    BOOST_CHECK_EQUAL(resize(65536, 0.9f, 1000, 65536 + 500), 65536);
+
+    // A buffer already over the limit doesn't shrink when it's full
+    BOOST_CHECK_EQUAL(resize(8192, 0.9f, 1000, 4096), 8192);
+}
+
+BOOST_AUTO_TEST_CASE(t1_shrink)
+{
+    BOOST_CHECK_EQUAL(resize(16384, 0.1f, 1000, 65536), 8192);
+    BOOST_CHECK_EQUAL(resize(16384, 0.0f, 1000, 65536), 8192);
+
+    // Not below what downstream needs, rounded up to the granularity
+    BOOST_CHECK_EQUAL(resize(4096, 0.1f, 3000, 65536), 3072);
+
+    // Nor up to it, if the buffer is smaller already
+    BOOST_CHECK_EQUAL(resize(2048, 0.1f, 3000, 65536), 2048);
+}
+
+BOOST_AUTO_TEST_CASE(t2_keep)
+{
+    BOOST_CHECK_EQUAL(resize(8192, 0.5f, 1000, 65536), 8192);
+    BOOST_CHECK_EQUAL(resize(8192, 0.75f, 1000, 65536), 8192);
+    BOOST_CHECK_EQUAL(resize(8192, 0.25f, 1000, 65536), 8192);
+}
+
+#ifdef GR_PERFORMANCE_COUNTERS
+
+namespace {
+
+// Counts from 0 to nitems - 1, a few items at a time, and holds at
+// half way until go() is called
+class ramp_source : public gr::sync_block
+{
+    const int d_nitems;
+    std::atomic<int> d_limit;
+    int d_next = 0;
+
+public:
+    ramp_source(int nitems)
+        : gr::sync_block("ramp_source",
+                         gr::io_signature::make(0, 0, 0),
+                         gr::io_signature::make(1, 1, sizeof(int))),
+          d_nitems(nitems),
+          d_limit(nitems / 2)
+    {
+    }
+
+    void go() { d_limit = d_nitems; }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override
+    {
+        if (d_next == d_nitems)
+            return WORK_DONE;
+
+        // Mostly empty buffers downstream
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+        int* out = static_cast<int*>(output_items[0]);
+        int n = std::min({ noutput_items, 64, d_limit - d_next });
+        for (int i = 0; i < n; i++)
+            out[i] = d_next++;
+        return n;
+    }
+};
+
+class pass : public gr::sync_block
+{
+public:
+    pass()
+        : gr::sync_block("pass",
+                         gr::io_signature::make(1, 1, sizeof(int)),
+                         gr::io_signature::make(1, 1, sizeof(int)))
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override
+    {
+        std::copy_n(static_cast<const int*>(input_items[0]),
+                    noutput_items,
+                    static_cast<int*>(output_items[0]));
+        return noutput_items;
+    }
+};
+
+class collect_sink : public gr::sync_block
+{
+public:
+    std::atomic<int> nitems{ 0 };
+    std::vector<int> data;
+
+    collect_sink()
+        : gr::sync_block("collect_sink",
+                         gr::io_signature::make(1, 1, sizeof(int)),
+                         gr::io_signature::make(0, 0, 0))
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override
+    {
+        const int* in = static_cast<const int*>(input_items[0]);
+        data.insert(data.end(), in, in + noutput_items);
+        nitems += noutput_items;
+        return noutput_items;
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t3_no_items_lost)
+{
+    // Read whenever a flowgraph is reconfigured
+    setenv("GR_CONF_SCHEDULER_ADAPTIVE_BUFFERS", "True", 1);
+
+    const int nitems = 40000;
+    auto src = gnuradio::make_block_sptr<ramp_source>(nitems);
+    auto p = gnuradio::make_block_sptr<pass>();
+    auto sink = gnuradio::make_block_sptr<collect_sink>();
+    gr::top_block_sptr tb = gr::make_top_block("adaptive_buffers");
+    tb->connect(src, 0, p, 0);
+    tb->connect(p, 0, sink, 0);
+    tb->start();
+
+    // Once half of the items went through, the buffers are empty
+    while (sink->nitems < nitems / 2)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::string sizes = tb->buffer_size_list();
+    long max_output = p->max_output_buffer(0);
+    long min_output = p->min_output_buffer(0);
+    tb->lock();
+    tb->unlock();
+
+    // The mostly empty buffers shrank, and the limits set on the
+    // blocks stayed as they were
+    BOOST_CHECK(tb->buffer_size_list() != sizes);
+    BOOST_CHECK_EQUAL(p->max_output_buffer(0), max_output);
+    BOOST_CHECK_EQUAL(p->min_output_buffer(0), min_output);
+
+    src->go();
+    tb->wait();
+    unsetenv("GR_CONF_SCHEDULER_ADAPTIVE_BUFFERS");
+
+    BOOST_REQUIRE_EQUAL(sink->data.size(), static_cast<size_t>(nitems));
+    for (int i = 0; i < nitems; i++)
+        BOOST_REQUIRE_EQUAL(sink->data[i], i);
+}
+
+#endif /* GR_PERFORMANCE_COUNTERS */
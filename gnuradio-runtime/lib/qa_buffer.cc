@@ -18,7 +18,9 @@
 #include <gnuradio/buffer_reader.h>
 #include <gnuradio/random.h>
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <cstdlib>
+#include <thread>
 
 
 static void leak_check(void f())
@@ -255,6 +257,61 @@ static void t3_body()
     }
 }
 
+// ----------------------------------------------------------------------------
+// single writer, single reader in separate threads, without taking the
+// mutex (double mapped buffers use atomic indices)
+// ----------------------------------------------------------------------------
+
+static void t4_body()
+{
+    int nitems = 4000 / sizeof(int);
+    static const int total = 1000000;
+
+    gr::buffer_sptr buf(gr::buffer_double_mapped::make_buffer(
+        nitems, sizeof(int), nitems, 1, gr::block_sptr()));
+    gr::buffer_reader_sptr r1(gr::buffer_add_reader(buf, 0, gr::block_sptr()));
+
+    BOOST_REQUIRE(buf->atomic_indices());
+
+    std::thread writer([&buf]() {
+        int write_counter = 0;
+        while (write_counter < total) {
+            int n = std::min(buf->space_available(), total - write_counter);
+            if (n == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            int* wp = (int*)buf->write_pointer();
+            for (int i = 0; i < n; i++)
+                *wp++ = write_counter++;
+            buf->update_write_pointer(n);
+        }
+    });
+
+    int read_counter = 0;
+    int errors = 0;
+    while (read_counter < total) {
+        int m = r1->items_available();
+        if (m == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        const int* rp = (const int*)r1->read_pointer();
+        for (int i = 0; i < m; i++) {
+            if (*rp++ != read_counter++)
+                errors++;
+        }
+        r1->update_read_pointer(m);
+    }
+    writer.join();
+
+    BOOST_CHECK_EQUAL(0, errors);
+    BOOST_CHECK_EQUAL(total, read_counter);
+    BOOST_CHECK_EQUAL(0, r1->items_available());
+    BOOST_CHECK_EQUAL((uint64_t)total, buf->nitems_written());
+    BOOST_CHECK_EQUAL((uint64_t)total, r1->nitems_read());
+}
+
 
 // ----------------------------------------------------------------------------
 BOOST_AUTO_TEST_CASE(t0) { leak_check(t0_body); }
@@ -264,3 +321,5 @@ BOOST_AUTO_TEST_CASE(t1) { leak_check(t1_body); }
 BOOST_AUTO_TEST_CASE(t2) { leak_check(t2_body); }
 
 BOOST_AUTO_TEST_CASE(t3) { leak_check(t3_body); }
+
+BOOST_AUTO_TEST_CASE(t4) { leak_check(t4_body); }
@@ -0,0 +1,158 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "flat_flowgraph.h"
+#include <gnuradio/hier_block2.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/sync_block.h>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+class pass : public gr::sync_block
+{
+public:
+    pass(int ninputs, int noutputs)
+        : gr::sync_block("pass",
+                         gr::io_signature::make(ninputs, ninputs, sizeof(float)),
+                         gr::io_signature::make(noutputs, noutputs, sizeof(float)))
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override
+    {
+        return noutput_items;
+    }
+};
+
+std::shared_ptr<pass> make_pass(int ninputs = 1, int noutputs = 1)
+{
+    return gnuradio::make_block_sptr<pass>(ninputs, noutputs);
+}
+
+gr::hier_block2_sptr make_hier(const std::string& name)
+{
+    return gr::make_hier_block2(name,
+                                gr::io_signature::make(1, 1, sizeof(float)),
+                                gr::io_signature::make(1, 1, sizeof(float)));
+}
+
+std::vector<std::string> flat_edges(const gr::hier_block2_sptr& hier)
+{
+    gr::flat_flowgraph_sptr ffg = hier->flatten();
+    std::vector<std::string> v;
+    for (const auto& e : ffg->edges())
+        v.push_back(e.identifier());
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// src -> outer[ a -> inner[ c1 -> c2 ] -> b ] -> sink
+struct nested {
+    gr::hier_block2_sptr top = gr::make_hier_block2(
+        "top", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0));
+    gr::hier_block2_sptr outer = make_hier("outer");
+    gr::hier_block2_sptr inner = make_hier("inner");
+    std::shared_ptr<pass> src = make_pass(0, 1);
+    std::shared_ptr<pass> sink = make_pass(1, 0);
+    std::shared_ptr<pass> a = make_pass();
+    std::shared_ptr<pass> b = make_pass();
+    std::shared_ptr<pass> c1 = make_pass();
+    std::shared_ptr<pass> c2 = make_pass();
+
+    nested()
+    {
+        inner->connect(inner, 0, c1, 0);
+        inner->connect(c1, 0, c2, 0);
+        inner->connect(c2, 0, inner, 0);
+
+        outer->connect(outer, 0, a, 0);
+        outer->connect(a, 0, inner, 0);
+        outer->connect(inner, 0, b, 0);
+        outer->connect(b, 0, outer, 0);
+
+        top->connect(src, 0, outer, 0);
+        top->connect(outer, 0, sink, 0);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t0_repeated)
+{
+    nested n;
+    std::vector<std::string> first = flat_edges(n.top);
+    std::vector<std::string> second = flat_edges(n.top);
+
+    BOOST_CHECK_EQUAL(first.size(), 5u);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        first.begin(), first.end(), second.begin(), second.end());
+}
+
+BOOST_AUTO_TEST_CASE(t1_changed_grandchild)
+{
+    nested n;
+    flat_edges(n.top);
+
+    // Only the innermost hier block changes; flattening the top one
+    // has to see it.
+    auto c3 = make_pass();
+    n.inner->disconnect(n.c1, 0, n.c2, 0);
+    n.inner->connect(n.c1, 0, c3, 0);
+    n.inner->connect(c3, 0, n.c2, 0);
+
+    std::vector<std::string> v = flat_edges(n.top);
+    BOOST_CHECK_EQUAL(v.size(), 6u);
+    std::string c1_c3 = n.c1->alias() + ":0->" + c3->alias() + ":0";
+    BOOST_CHECK(std::find(v.begin(), v.end(), c1_c3) != v.end());
+
+    std::vector<std::string> again = flat_edges(n.top);
+    BOOST_CHECK_EQUAL_COLLECTIONS(v.begin(), v.end(), again.begin(), again.end());
+}
+
+BOOST_AUTO_TEST_CASE(t2_unconnected)
+{
+    nested n;
+    n.inner->disconnect(n.c2, 0, n.inner, 0);
+
+    // Still an error the second time, when nothing changed
+    BOOST_CHECK_THROW(n.top->flatten(), std::runtime_error);
+    BOOST_CHECK_THROW(n.top->flatten(), std::runtime_error);
+
+    n.inner->connect(n.c2, 0, n.inner, 0);
+    BOOST_CHECK_EQUAL(flat_edges(n.top).size(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(t3_disconnected_released)
+{
+    nested n;
+    flat_edges(n.top);
+
+    // Take c1 out; the blocks above must not keep it alive until the
+    // next flatten.
+    std::weak_ptr<pass> c1 = n.c1;
+    n.inner->disconnect(n.inner, 0, n.c1, 0);
+    n.inner->disconnect(n.c1, 0, n.c2, 0);
+    n.inner->connect(n.inner, 0, n.c2, 0);
+    n.c1.reset();
+    BOOST_CHECK(c1.expired());
+
+    BOOST_CHECK_EQUAL(flat_edges(n.top).size(), 4u);
+}
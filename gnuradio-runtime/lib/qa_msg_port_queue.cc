@@ -0,0 +1,207 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/msg_port_queue.h>
+#include <gnuradio/top_block.h>
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(t0_push_pop)
+{
+    gr::msg_port_queue q;
+    BOOST_CHECK(q.empty());
+    BOOST_CHECK(!q.pop());
+
+    for (long i = 0; i < 10; i++)
+        q.push(pmt::from_long(i));
+    BOOST_CHECK_EQUAL(q.size(), 10u);
+
+    for (long i = 0; i < 10; i++)
+        BOOST_CHECK_EQUAL(pmt::to_long(q.pop()), i);
+    BOOST_CHECK(q.empty());
+    BOOST_CHECK(!q.pop());
+}
+
+BOOST_AUTO_TEST_CASE(t1_drain)
+{
+    gr::msg_port_queue q;
+    std::vector<pmt::pmt_t> msgs;
+    BOOST_CHECK_EQUAL(q.drain(msgs), 0u);
+
+    for (long i = 0; i < 10; i++)
+        q.push(pmt::from_long(i));
+
+    BOOST_CHECK_EQUAL(q.drain(msgs, 4), 4u);
+    BOOST_CHECK_EQUAL(q.size(), 6u);
+    BOOST_CHECK_EQUAL(q.drain(msgs), 6u);
+    BOOST_CHECK(q.empty());
+
+    BOOST_REQUIRE_EQUAL(msgs.size(), 10u);
+    for (long i = 0; i < 10; i++)
+        BOOST_CHECK_EQUAL(pmt::to_long(msgs[i]), i);
+}
+
+BOOST_AUTO_TEST_CASE(t2_producers)
+{
+    // Messages of every producer come out in the order they went in
+    const long nproducers = 4;
+    const long nmsgs = 100000;
+    gr::msg_port_queue q;
+
+    std::vector<std::thread> producers;
+    for (long p = 0; p < nproducers; p++) {
+        producers.emplace_back([&q, p, nmsgs]() {
+            for (long i = 0; i < nmsgs; i++)
+                q.push(pmt::cons(pmt::from_long(p), pmt::from_long(i)));
+        });
+    }
+
+    std::vector<long> next(nproducers, 0);
+    std::vector<pmt::pmt_t> msgs;
+    long nreceived = 0;
+    bool in_order = true;
+    while (nreceived < nproducers * nmsgs) {
+        msgs.clear();
+        if (q.drain(msgs) == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (const auto& m : msgs) {
+            long p = pmt::to_long(pmt::car(m));
+            in_order &= (pmt::to_long(pmt::cdr(m)) == next[p]++);
+        }
+        nreceived += msgs.size();
+    }
+
+    for (auto& t : producers)
+        t.join();
+
+    BOOST_CHECK(in_order);
+    BOOST_CHECK(q.empty());
+    for (long p = 0; p < nproducers; p++)
+        BOOST_CHECK_EQUAL(next[p], nmsgs);
+}
+
+namespace {
+// Records the batches its handler gets
+class batch_block : public gr::block
+{
+public:
+    std::vector<size_t> batches;
+    std::vector<long> received;
+
+    batch_block()
+        : gr::block("batch_block",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0))
+    {
+        message_port_register_in(pmt::mp("in"));
+        message_port_register_out(pmt::mp("out"));
+        set_msg_handler_batch(pmt::mp("in"), [this](const std::vector<pmt::pmt_t>& m) {
+            batches.push_back(m.size());
+            for (const auto& msg : m)
+                received.push_back(pmt::to_long(msg));
+        });
+    }
+
+    using gr::block::dispatch_msg;
+    using gr::block::dispatch_msgs;
+    using gr::block::has_msg_handler;
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t3_batch_handler)
+{
+    auto b = std::make_shared<batch_block>();
+    const pmt::pmt_t in = pmt::mp("in");
+    BOOST_CHECK(b->has_msg_handler(in));
+
+    std::vector<pmt::pmt_t> msgs;
+    for (long i = 0; i < 5; i++)
+        msgs.push_back(pmt::from_long(i));
+    b->dispatch_msgs(in, msgs);
+    b->dispatch_msg(in, pmt::from_long(5));
+
+    BOOST_REQUIRE_EQUAL(b->batches.size(), 2u);
+    BOOST_CHECK_EQUAL(b->batches[0], 5u);
+    BOOST_CHECK_EQUAL(b->batches[1], 1u);
+    BOOST_REQUIRE_EQUAL(b->received.size(), 6u);
+    for (long i = 0; i < 6; i++)
+        BOOST_CHECK_EQUAL(b->received[i], i);
+
+    // A per message handler replaces the batch handler
+    long nsingle = 0;
+    b->set_msg_handler(in, [&nsingle](pmt::pmt_t) { nsingle++; });
+    b->dispatch_msgs(in, msgs);
+    BOOST_CHECK_EQUAL(nsingle, 5);
+    BOOST_CHECK_EQUAL(b->batches.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(t4_iterator)
+{
+    // What's left of the std::deque interface for get_iterator()
+    gr::msg_port_queue q;
+    BOOST_CHECK(q.begin() == q.end());
+
+    for (long i = 0; i < 5; i++)
+        q.push(pmt::from_long(i));
+
+    std::vector<long> seen;
+    for (auto it = q.begin(); it != q.end(); ++it)
+        seen.push_back(pmt::to_long(*it));
+    BOOST_CHECK_EQUAL(seen.size(), 5u);
+    for (long i = 0; i < 5; i++)
+        BOOST_CHECK_EQUAL(seen[i], i);
+    BOOST_CHECK(!q.at(5));
+
+    // Erasing in the middle, at the front and past the end
+    auto it = q.begin();
+    ++it;
+    ++it;
+    q.erase(it);
+    q.erase(q.begin());
+    q.erase(q.end());
+    BOOST_CHECK_EQUAL(q.size(), 3u);
+
+    std::vector<pmt::pmt_t> msgs;
+    q.push(pmt::from_long(5));
+    BOOST_REQUIRE_EQUAL(q.drain(msgs), 4u);
+    BOOST_CHECK_EQUAL(pmt::to_long(msgs[0]), 1);
+    BOOST_CHECK_EQUAL(pmt::to_long(msgs[1]), 3);
+    BOOST_CHECK_EQUAL(pmt::to_long(msgs[2]), 4);
+    BOOST_CHECK_EQUAL(pmt::to_long(msgs[3]), 5);
+}
+
+BOOST_AUTO_TEST_CASE(t5_register_after_start)
+{
+    auto src = std::make_shared<batch_block>();
+    auto dst = std::make_shared<batch_block>();
+    src->message_port_register_in(pmt::mp("extra"));
+
+    gr::top_block_sptr tb = gr::make_top_block("register_after_start");
+    tb->msg_connect(src, "out", dst, "in");
+    tb->start();
+
+    // The queues are searched without a lock from now on
+    BOOST_CHECK_THROW(dst->message_port_register_in(pmt::mp("late")),
+                      std::runtime_error);
+    dst->message_port_register_in(pmt::mp("in"));
+
+    tb->stop();
+    tb->wait();
+}
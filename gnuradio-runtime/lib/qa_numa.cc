@@ -0,0 +1,63 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "numa.h"
+#include "vmcircbuf.h"
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+#include <memory>
+#include <numeric>
+
+BOOST_AUTO_TEST_CASE(t0_topology)
+{
+    int nnodes = gr::numa::num_nodes();
+    BOOST_REQUIRE(nnodes >= 1);
+
+    // Every CPU of a node maps back to that node
+    for (int n = 0; n < nnodes; n++) {
+        for (int cpu : gr::numa::node_cpus(n))
+            BOOST_CHECK_EQUAL(gr::numa::node_of_cpu(cpu), n);
+    }
+
+    BOOST_CHECK(gr::numa::node_cpus(nnodes).empty());
+    BOOST_CHECK(gr::numa::node_cpus(-1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(t1_bind_buffer)
+{
+    const int nnodes = gr::numa::num_nodes();
+    const size_t size = 16 * gr::vmcircbuf_sysconfig::granularity();
+
+    std::unique_ptr<gr::vmcircbuf> c(gr::vmcircbuf_sysconfig::make(size));
+    BOOST_REQUIRE(c);
+    char* p = static_cast<char*>(c->pointer_to_first_copy());
+
+    // Binding only works (and is only needed) with more than one node
+    const int node = nnodes - 1;
+    BOOST_CHECK_EQUAL(gr::numa::bind_memory(p, size, node), nnodes > 1);
+
+    // Touch the pages through the second copy; they still end up on our node
+    memset(c->pointer_to_second_copy(), 0x5a, size);
+    BOOST_CHECK_EQUAL(p[0], 0x5a);
+
+    std::vector<size_t> bytes =
+        gr::numa::bytes_per_node(p, size, c->pointer_to_second_copy());
+    BOOST_REQUIRE_EQUAL(bytes.size(), (size_t)nnodes);
+    if (nnodes > 1) {
+        BOOST_CHECK_EQUAL(bytes[node], size);
+    } else {
+        size_t total = std::accumulate(bytes.begin(), bytes.end(), size_t(0));
+        BOOST_CHECK(total == size || total == 0);
+    }
+}
@@ -0,0 +1,223 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/sync_block.h>
+#include <gnuradio/top_block.h>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+typedef std::chrono::steady_clock steady;
+
+// Counts up, at rate items per second, like a receiver would
+class count_source : public gr::sync_block
+{
+    double d_rate;
+    steady::time_point d_t0;
+    uint64_t d_next = 0;
+
+public:
+    std::atomic<int> nstarts{ 0 };
+
+    count_source(double rate)
+        : gr::sync_block("count_source",
+                         gr::io_signature::make(0, 0, 0),
+                         gr::io_signature::make(1, 1, sizeof(uint64_t))),
+          d_rate(rate)
+    {
+    }
+
+    bool start() override
+    {
+        if (nstarts++ == 0)
+            d_t0 = steady::now();
+        return true;
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override
+    {
+        uint64_t due;
+        while (true) {
+            std::chrono::duration<double> t = steady::now() - d_t0;
+            due = static_cast<uint64_t>(t.count() * d_rate);
+            if (due > d_next)
+                break;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        uint64_t* out = static_cast<uint64_t*>(output_items[0]);
+        int n = static_cast<int>(std::min<uint64_t>(due - d_next, noutput_items));
+        for (int i = 0; i < n; i++)
+            out[i] = d_next++;
+        return n;
+    }
+};
+
+class pass : public gr::sync_block
+{
+public:
+    pass()
+        : gr::sync_block("pass",
+                         gr::io_signature::make(1, 1, sizeof(uint64_t)),
+                         gr::io_signature::make(1, 1, sizeof(uint64_t)))
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override
+    {
+        std::copy_n(static_cast<const uint64_t*>(input_items[0]),
+                    noutput_items,
+                    static_cast<uint64_t*>(output_items[0]));
+        return noutput_items;
+    }
+};
+
+// Counts the items missing from the count, and records the longest
+// time between two calls of work(): the gap in the stream.
+class gap_sink : public gr::sync_block
+{
+    steady::time_point d_last;
+
+public:
+    std::atomic<int> nstarts{ 0 };
+    std::atomic<uint64_t> nitems{ 0 };
+    uint64_t first = 0;
+    uint64_t next = 0;
+    uint64_t nmissing = 0;
+    bool in_order = true;
+    double max_gap = 0; // seconds
+
+    gap_sink()
+        : gr::sync_block("gap_sink",
+                         gr::io_signature::make(1, 1, sizeof(uint64_t)),
+                         gr::io_signature::make(0, 0, 0))
+    {
+    }
+
+    bool start() override
+    {
+        nstarts++;
+        return true;
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override
+    {
+        steady::time_point now = steady::now();
+        const uint64_t* in = static_cast<const uint64_t*>(input_items[0]);
+
+        if (nitems == 0) {
+            first = next = in[0];
+        } else {
+            std::chrono::duration<double> gap = now - d_last;
+            max_gap = std::max(max_gap, gap.count());
+        }
+        d_last = now;
+
+        for (int i = 0; i < noutput_items; i++) {
+            if (in[i] > next)
+                nmissing += in[i] - next;
+            in_order = in_order && in[i] >= next;
+            next = in[i] + 1;
+        }
+        nitems += noutput_items;
+        return noutput_items;
+    }
+};
+
+struct branches {
+    gr::top_block_sptr tb = gr::make_top_block("reconfigure");
+    std::shared_ptr<count_source> src = gnuradio::make_block_sptr<count_source>(200e3);
+    std::shared_ptr<gap_sink> sink1 = gnuradio::make_block_sptr<gap_sink>();
+    std::shared_ptr<pass> pass2 = gnuradio::make_block_sptr<pass>();
+    std::shared_ptr<gap_sink> sink2 = gnuradio::make_block_sptr<gap_sink>();
+    std::shared_ptr<gap_sink> sink3 = gnuradio::make_block_sptr<gap_sink>();
+    uint64_t nitems_locked = 0; // items sink1 got while tb was locked
+
+    // src -> sink1, the untouched branch, and src -> pass2 -> sink2,
+    // which gets sink3 instead of sink2 while running
+    void run()
+    {
+        tb->connect(src, 0, sink1, 0);
+        tb->connect(src, 0, pass2, 0);
+        tb->connect(pass2, 0, sink2, 0);
+        tb->start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        tb->lock();
+        uint64_t before = sink1->nitems;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        nitems_locked = sink1->nitems - before;
+        tb->disconnect(pass2, 0, sink2, 0);
+        tb->connect(pass2, 0, sink3, 0);
+        tb->unlock();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        tb->stop();
+        tb->wait();
+
+        BOOST_TEST_MESSAGE("untouched branch: longest gap "
+                           << sink1->max_gap * 1e3 << " ms, " << sink1->nmissing
+                           << " items missing");
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t0_incremental)
+{
+    gr::prefs::singleton()->set_bool("Scheduler", "incremental_reconfig", true);
+    branches b;
+    b.run();
+    gr::prefs::singleton()->set_bool("Scheduler", "incremental_reconfig", false);
+
+    // The untouched branch kept running, even while locked
+    BOOST_CHECK_EQUAL(b.src->nstarts.load(), 1);
+    BOOST_CHECK_EQUAL(b.sink1->nstarts.load(), 1);
+    BOOST_CHECK(b.sink1->in_order);
+    BOOST_CHECK_EQUAL(b.sink1->nmissing, 0u);
+    BOOST_CHECK_GT(b.nitems_locked, 0u);
+
+    // The other one picked up where it was
+    BOOST_CHECK_EQUAL(b.sink2->nstarts.load(), 1);
+    BOOST_CHECK_EQUAL(b.sink3->nstarts.load(), 1);
+    BOOST_CHECK_GT(b.sink3->nitems.load(), 0u);
+    BOOST_CHECK_GT(b.sink3->first, 0u);
+    BOOST_CHECK(b.sink3->in_order);
+    BOOST_CHECK_EQUAL(b.sink3->nmissing, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(t1_full_restart)
+{
+    branches b;
+    b.run();
+
+    // Everything stopped and started again; the items that were in the
+    // buffers at the time are lost.
+    BOOST_CHECK_EQUAL(b.src->nstarts.load(), 2);
+    BOOST_CHECK_EQUAL(b.sink1->nstarts.load(), 2);
+    BOOST_CHECK(b.sink1->in_order);
+    BOOST_CHECK_GT(b.sink3->nitems.load(), 0u);
+}
@@ -0,0 +1,102 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/random.h>
+#include <boost/test/unit_test.hpp>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace {
+
+class rate_block : public gr::block
+{
+public:
+    rate_block()
+        : gr::block("rate_block",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0))
+    {
+    }
+};
+
+// How tag offsets were always rescaled: with GMP, rounding half up
+uint64_t gmp_rescale(uint64_t offset, const mpq_class& rate)
+{
+    mpz_class x;
+    mpz_import(x.get_mpz_t(), 1, 1, sizeof(offset), 0, 0, &offset);
+    x = x * rate + mpq_class(1, 2);
+    return x.get_ui();
+}
+
+void check_offsets(rate_block& blk)
+{
+    const uint64_t max = std::numeric_limits<uint64_t>::max();
+    std::vector<uint64_t> offsets = { 0, 1, 2, 3, 7, 999, 1000, 1001, max, max - 1 };
+    for (uint64_t i = 1; i < 64; i++) {
+        offsets.push_back(uint64_t(1) << i);
+        offsets.push_back((uint64_t(1) << i) - 1);
+    }
+    gr::xoroshiro128p_prng rng(42);
+    for (int i = 0; i < 10000; i++)
+        offsets.push_back(rng());
+
+    std::vector<gr::tag_t> tags(offsets.size());
+    for (size_t i = 0; i < offsets.size(); i++)
+        tags[i].offset = offsets[i];
+    blk.rescale_tag_offsets(tags);
+
+    for (size_t i = 0; i < offsets.size(); i++) {
+        uint64_t expected = gmp_rescale(offsets[i], blk.mp_relative_rate());
+        if (tags[i].offset != expected) {
+            BOOST_ERROR("rate " << blk.mp_relative_rate().get_str() << ", offset "
+                                << offsets[i] << ": " << tags[i].offset
+                                << " != " << expected);
+            return;
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t0_integer_rates)
+{
+    const uint64_t max = std::numeric_limits<uint64_t>::max();
+    const std::vector<std::pair<uint64_t, uint64_t>> rates = {
+        { 1, 1 },     { 1, 2 },         { 2, 1 },    { 3, 7 },
+        { 147, 160 }, { 48000, 44100 }, { 1, 1000000 },
+        { max, 1 },   { 1, max },       { max, 3 },  { 3, max },
+        { max, max - 1 }
+    };
+
+    auto blk = std::make_shared<rate_block>();
+    for (const auto& r : rates) {
+        blk->set_relative_rate(r.first, r.second);
+        check_offsets(*blk);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(t1_double_rates)
+{
+    auto blk = std::make_shared<rate_block>();
+    // the last two need more than 64 bits and take the GMP path
+    for (double rate : { 0.5, 0.1, 1.0 / 3.0, 2.5, 1e-5, 1e-300, 1e300 }) {
+        blk->set_relative_rate(rate);
+        check_offsets(*blk);
+    }
+    blk->set_inverse_relative_rate(3.0);
+    check_offsets(*blk);
+}
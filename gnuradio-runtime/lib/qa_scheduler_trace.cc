@@ -0,0 +1,81 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "scheduler_trace.h"
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+static bool contains(const std::string& s, const std::string& what)
+{
+    return s.find(what) != std::string::npos;
+}
+
+BOOST_AUTO_TEST_CASE(t0_disabled)
+{
+    gr::trace::set_enabled(false);
+    {
+        gr::trace::scope span(gr::trace::event_type::BLKD_IN, 1);
+    }
+    gr::trace::notify(1, 2);
+
+    std::ostringstream os;
+    gr::trace::write_chrome_json(os);
+    BOOST_CHECK(!contains(os.str(), "\"ph\""));
+}
+
+BOOST_AUTO_TEST_CASE(t1_chrome_json)
+{
+    using namespace gr::trace;
+    set_enabled(true);
+    register_block(1001, "src");
+    register_block(1002, "sink");
+
+    // sink waits for input until src has done its work and notified it
+    std::thread sink([]() {
+        int64_t start = now();
+        {
+            scope span(event_type::BLKD_IN, 1002);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        record({ start, now(), 1002, -1, 100, 100, event_type::WORK });
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    int64_t start = now();
+    record({ start, now(), 1001, -1, 100, 64, event_type::WORK });
+    notify(1001, 1002);
+    sink.join();
+    set_enabled(false);
+
+    std::ostringstream os;
+    write_chrome_json(os);
+    std::string json = os.str();
+
+    BOOST_CHECK(contains(json, "\"traceEvents\""));
+    BOOST_CHECK(contains(json, "\"thread_name\""));
+    BOOST_CHECK(contains(json, "\"name\":\"src\",\"args\":{\"noutput_items\":100,"
+                               "\"result\":64}"));
+    BOOST_CHECK(contains(json, "\"name\":\"BLKD_IN\",\"args\":{\"block\":\"sink\"}"));
+    // the notification woke up sink, so it is drawn as a flow
+    BOOST_CHECK(contains(json, "\"ph\":\"s\""));
+    BOOST_CHECK(contains(json, "\"ph\":\"f\""));
+    BOOST_CHECK(contains(json, "\"from\":\"src\",\"to\":\"sink\""));
+
+    // Written events are forgotten
+    std::ostringstream again;
+    write_chrome_json(again);
+    BOOST_CHECK(!contains(again.str(), "\"ph\":\"X\""));
+}
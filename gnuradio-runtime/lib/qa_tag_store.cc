@@ -0,0 +1,82 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/tag_store.h>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+static gr::tag_t make_tag(uint64_t offset, long value)
+{
+    gr::tag_t tag;
+    tag.offset = offset;
+    tag.key = pmt::intern("key");
+    tag.value = pmt::from_long(value);
+    return tag;
+}
+
+static std::vector<long> values(gr::tag_store& store)
+{
+    std::vector<long> v;
+    for (const auto& tag : store)
+        v.push_back(pmt::to_long(tag.value));
+    return v;
+}
+
+BOOST_AUTO_TEST_CASE(t0_order)
+{
+    gr::tag_store store;
+    BOOST_CHECK(store.empty());
+
+    store.add(make_tag(10, 0));
+    store.add(make_tag(20, 1));
+    store.add(make_tag(5, 2));  // out of order
+    store.add(make_tag(10, 3)); // same offset, goes after the first one
+    store.add(std::vector<gr::tag_t>{ make_tag(20, 4), make_tag(30, 5) });
+    store.add(std::vector<gr::tag_t>{ make_tag(25, 6), make_tag(1, 7) });
+
+    std::vector<long> expected = { 7, 2, 0, 3, 1, 4, 6, 5 };
+    BOOST_CHECK_EQUAL(store.size(), expected.size());
+    std::vector<long> v = values(store);
+    BOOST_CHECK_EQUAL_COLLECTIONS(v.begin(), v.end(), expected.begin(), expected.end());
+
+    BOOST_CHECK_EQUAL(store.lower_bound(10)->offset, 10u);
+    BOOST_CHECK_EQUAL(store.upper_bound(10)->offset, 20u);
+    BOOST_CHECK_EQUAL(store.upper_bound(20) - store.lower_bound(10), 4);
+    BOOST_CHECK(store.lower_bound(31) == store.end());
+}
+
+BOOST_AUTO_TEST_CASE(t1_prune)
+{
+    gr::tag_store store;
+    for (long i = 0; i < 100; i++)
+        store.add(make_tag(i, i));
+    store.begin()[60].marked_deleted.push_back(42);
+
+    store.prune(10);
+    BOOST_CHECK_EQUAL(store.size(), 90u);
+    BOOST_CHECK_EQUAL(store.begin()->offset, 10u);
+
+    // Dropping the pruned tags must not lose what the others carry
+    store.prune(55);
+    BOOST_CHECK_EQUAL(store.size(), 45u);
+    BOOST_CHECK_EQUAL(store.begin()->offset, 55u);
+    BOOST_REQUIRE_EQUAL(store.lower_bound(60)->marked_deleted.size(), 1u);
+    BOOST_CHECK_EQUAL(store.lower_bound(60)->marked_deleted[0], 42);
+    BOOST_CHECK(store.lower_bound(61)->marked_deleted.empty());
+
+    store.add(make_tag(200, 200));
+    store.prune(1000);
+    BOOST_CHECK(store.empty());
+    BOOST_CHECK(store.begin() == store.end());
+}
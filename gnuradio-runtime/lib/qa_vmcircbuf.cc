@@ -12,8 +12,11 @@
 #include <config.h>
 #endif
 
+#include "pagesize.h"
 #include "vmcircbuf.h"
+#include "vmcircbuf_mmap_hugetlb.h"
 #include <boost/test/unit_test.hpp>
+#include <memory>
 
 BOOST_AUTO_TEST_CASE(test_all)
 {
@@ -21,3 +24,39 @@ BOOST_AUTO_TEST_CASE(test_all)
 
     BOOST_REQUIRE(gr::vmcircbuf_sysconfig::test_all_factories(verbose));
 }
+
+BOOST_AUTO_TEST_CASE(test_hugetlb)
+{
+    gr::vmcircbuf_factory* f = gr::vmcircbuf_mmap_hugetlb_factory::singleton();
+    size_t granularity = f->granularity();
+    BOOST_REQUIRE(granularity > 0);
+    BOOST_CHECK_EQUAL(granularity % gr::pagesize(), 0u);
+
+    // Sizes that aren't whole huge pages are refused, not rounded
+    BOOST_CHECK(f->make(gr::pagesize()) == nullptr);
+
+    // Without (enough) huge pages make() fails cleanly; otherwise both
+    // copies have to map the same memory.
+    std::unique_ptr<gr::vmcircbuf> c(f->make(2 * granularity));
+    if (!c) {
+        BOOST_TEST_MESSAGE("no huge pages available");
+        return;
+    }
+
+    unsigned int* p1 = (unsigned int*)c->pointer_to_first_copy();
+    unsigned int* p2 = (unsigned int*)c->pointer_to_second_copy();
+    BOOST_CHECK_EQUAL((size_t)p1 % granularity, 0u);
+    BOOST_CHECK_EQUAL((char*)p2 - (char*)p1, (long)(2 * granularity));
+
+    size_t n = 2 * granularity / sizeof(unsigned int);
+    for (size_t i = 0; i < n; i++)
+        p1[i] = i;
+    for (size_t i = 0; i < n; i++) {
+        if (p2[i] != i) {
+            BOOST_FAIL("second copy differs at " << i);
+        }
+    }
+
+    p2[n - 1] = 0xdeadbeef;
+    BOOST_CHECK_EQUAL(p1[n - 1], 0xdeadbeef);
+}
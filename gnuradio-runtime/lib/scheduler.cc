@@ -13,6 +13,7 @@
 #endif
 
 #include "scheduler.h"
+#include <stdexcept>
 
 namespace gr {
 
@@ -24,4 +25,15 @@ scheduler::scheduler(flat_flowgraph_sptr ffg,
 
 scheduler::~scheduler() {}
 
+std::set<basic_block_sptr>
+scheduler::stop_blocks(const std::set<basic_block_sptr>& blocks)
+{
+    throw std::logic_error("scheduler: can't stop single blocks");
+}
+
+void scheduler::start_blocks(flat_flowgraph_sptr ffg)
+{
+    throw std::logic_error("scheduler: can't start single blocks");
+}
+
 } /* namespace gr */
@@ -15,6 +15,7 @@
 #include <gnuradio/api.h>
 #include <gnuradio/block.h>
 #include <boost/core/noncopyable.hpp>
+#include <set>
 
 namespace gr {
 
@@ -50,6 +51,26 @@ public:
      * \brief Block until the graph is done.
      */
     virtual void wait() = 0;
+
+    /*!
+     * \brief Whether this scheduler can stop_blocks() and
+     * start_blocks() while the other blocks keep running.
+     */
+    virtual bool can_reconfigure() const { return false; }
+
+    /*!
+     * \brief Stop the threads running any of \p blocks, and wait for
+     * them to exit. Other blocks keep running.
+     *
+     * \returns the blocks whose threads are still running
+     */
+    virtual std::set<basic_block_sptr>
+    stop_blocks(const std::set<basic_block_sptr>& blocks);
+
+    /*!
+     * \brief Start the blocks of \p ffg that aren't running.
+     */
+    virtual void start_blocks(flat_flowgraph_sptr ffg);
 };
 
 } /* namespace gr */
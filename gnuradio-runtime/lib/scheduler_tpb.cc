@@ -14,31 +14,110 @@
 
 #include "scheduler_tpb.h"
 #include "tpb_thread_body.h"
+#include <gnuradio/thread/thread.h>
 #include <gnuradio/thread/thread_body_wrapper.h>
+#include <algorithm>
+#include <list>
+#include <set>
 #include <sstream>
 
 namespace gr {
 
+// One thread: a block, or a fused chain of blocks
+struct tpb_thread {
+    block_vector_t blocks;
+    std::unique_ptr<boost::thread> thread;
+    bool done = false; // its body has returned
+};
+
+// The threads of a scheduler. They hold on to this too, so it stays
+// around if the scheduler goes away before they do.
+struct tpb_threads {
+    gr::thread::mutex mutex;             // protects the members below
+    gr::thread::condition_variable cond; // a thread is done
+    std::list<std::shared_ptr<tpb_thread>> threads;
+};
+
+static bool is_done(const std::shared_ptr<tpb_thread>& t) { return t->done; }
+
+// Marks its thread done however the thread body ends
+class tpb_done
+{
+    std::shared_ptr<tpb_threads> d_threads;
+    tpb_thread* d_thread;
+
+public:
+    tpb_done(std::shared_ptr<tpb_threads> threads, tpb_thread* thread)
+        : d_threads(threads), d_thread(thread)
+    {
+    }
+
+    ~tpb_done()
+    {
+        gr::thread::scoped_lock lock(d_threads->mutex);
+        d_thread->done = true;
+        d_threads->cond.notify_all();
+    }
+};
+
 class tpb_container
 {
     block_sptr d_block;
     int d_max_noutput_items;
     thread::barrier_sptr d_start_sync;
+    std::shared_ptr<tpb_threads> d_threads;
+    tpb_thread* d_thread;
 
 public:
     tpb_container(block_sptr block,
                   int max_noutput_items,
-                  thread::barrier_sptr start_sync)
-        : d_block(block), d_max_noutput_items(max_noutput_items), d_start_sync(start_sync)
+                  thread::barrier_sptr start_sync,
+                  std::shared_ptr<tpb_threads> threads,
+                  tpb_thread* thread)
+        : d_block(block),
+          d_max_noutput_items(max_noutput_items),
+          d_start_sync(start_sync),
+          d_threads(threads),
+          d_thread(thread)
     {
     }
 
     void operator()()
     {
+        tpb_done done(d_threads, d_thread);
         tpb_thread_body body(d_block, d_start_sync, d_max_noutput_items);
     }
 };
 
+class tpb_chain_container
+{
+    block_vector_t d_blocks;
+    int d_max_noutput_items;
+    thread::barrier_sptr d_start_sync;
+    std::shared_ptr<tpb_threads> d_threads;
+    tpb_thread* d_thread;
+
+public:
+    tpb_chain_container(const block_vector_t& blocks,
+                        int max_noutput_items,
+                        thread::barrier_sptr start_sync,
+                        std::shared_ptr<tpb_threads> threads,
+                        tpb_thread* thread)
+        : d_blocks(blocks),
+          d_max_noutput_items(max_noutput_items),
+          d_start_sync(start_sync),
+          d_threads(threads),
+          d_thread(thread)
+    {
+    }
+
+    void operator()()
+    {
+        tpb_done done(d_threads, d_thread);
+        tpb_chain_thread_body body(d_blocks, d_start_sync, d_max_noutput_items);
+    }
+};
+
 scheduler_sptr
 scheduler_tpb::make(flat_flowgraph_sptr ffg, int max_noutput_items, bool catch_exceptions)
 {
@@ -48,7 +127,66 @@ scheduler_tpb::make(flat_flowgraph_sptr ffg, int max_noutput_items, bool catch_e
 scheduler_tpb::scheduler_tpb(flat_flowgraph_sptr ffg,
                              int max_noutput_items,
                              bool catch_exceptions)
-    : scheduler(ffg, max_noutput_items, catch_exceptions)
+    : scheduler(ffg, max_noutput_items, catch_exceptions),
+      d_threads(std::make_shared<tpb_threads>()),
+      d_max_noutput_items(max_noutput_items),
+      d_catch_exceptions(catch_exceptions)
+{
+    start_blocks(ffg);
+}
+
+scheduler_tpb::~scheduler_tpb() { stop(); }
+
+void scheduler_tpb::stop()
+{
+    gr::thread::scoped_lock lock(d_threads->mutex);
+    for (const auto& t : d_threads->threads)
+        t->thread->interrupt();
+}
+
+void scheduler_tpb::wait()
+{
+    gr::thread::scoped_lock lock(d_threads->mutex);
+    while (!std::all_of(d_threads->threads.begin(), d_threads->threads.end(), is_done))
+        d_threads->cond.wait(lock);
+
+    for (const auto& t : d_threads->threads)
+        t->thread->join();
+    d_threads->threads.clear();
+}
+
+std::set<basic_block_sptr>
+scheduler_tpb::stop_blocks(const std::set<basic_block_sptr>& blocks)
+{
+    gr::thread::scoped_lock lock(d_threads->mutex);
+
+    std::vector<std::shared_ptr<tpb_thread>> stopping;
+    for (const auto& t : d_threads->threads) {
+        auto stops = [&blocks](const block_sptr& b) { return blocks.count(b) > 0; };
+        if (std::any_of(t->blocks.begin(), t->blocks.end(), stops)) {
+            t->thread->interrupt();
+            stopping.push_back(t);
+        }
+    }
+    while (!std::all_of(stopping.begin(), stopping.end(), is_done))
+        d_threads->cond.wait(lock);
+
+    // Reap those, and the threads that were done anyway; start_blocks()
+    // starts the blocks of both again.
+    std::set<basic_block_sptr> running;
+    for (auto t = d_threads->threads.begin(); t != d_threads->threads.end();) {
+        if ((*t)->done) {
+            (*t)->thread->join();
+            t = d_threads->threads.erase(t);
+        } else {
+            running.insert((*t)->blocks.begin(), (*t)->blocks.end());
+            t++;
+        }
+    }
+    return running;
+}
+
+void scheduler_tpb::start_blocks(flat_flowgraph_sptr ffg)
 {
     int block_max_noutput_items;
 
@@ -60,18 +198,59 @@ scheduler_tpb::scheduler_tpb(flat_flowgraph_sptr ffg,
     used_blocks = ffg->topological_sort(used_blocks);
     block_vector_t blocks = flat_flowgraph::make_block_vector(used_blocks);
 
-    // Ensure that the done flag is clear on all blocks
+    gr::thread::scoped_lock lock(d_threads->mutex);
+
+    std::set<block_sptr> running;
+    for (const auto& t : d_threads->threads)
+        running.insert(t->blocks.begin(), t->blocks.end());
 
+    // Chains of blocks the flowgraph fused share one thread
+    // ([Scheduler] tpb_fuse_chains); every other block gets its own.
+    // A chain is either running or stopped as a whole.
+
+    std::vector<block_vector_t> chains;
+    std::set<block_sptr> fused;
+    for (const auto& chain : ffg->fused_chains()) {
+        fused.insert(chain.begin(), chain.end());
+        if (!running.count(chain[0]))
+            chains.push_back(chain);
+    }
+
+    std::vector<size_t> singles; // indices into blocks
     for (size_t i = 0; i < blocks.size(); i++) {
-        blocks[i]->detail()->set_done(false);
+        if (!fused.count(blocks[i]) && !running.count(blocks[i]))
+            singles.push_back(i);
+    }
+
+    // Ensure that the done flag is clear on all blocks we start
+
+    for (const auto& b : blocks) {
+        if (!running.count(b))
+            b->detail()->set_done(false);
     }
 
     thread::barrier_sptr start_sync =
-        std::make_shared<thread::barrier>(blocks.size() + 1);
+        std::make_shared<thread::barrier>(singles.size() + chains.size() + 1);
+
+    for (size_t i = 0; i < chains.size(); i++) {
+        std::stringstream name;
+        name << "thread-per-block[chain " << i << "]: " << chains[i][0] << " +"
+             << chains[i].size() - 1;
+
+        auto t = std::make_shared<tpb_thread>();
+        t->blocks = chains[i];
+        t->thread = std::make_unique<boost::thread>(
+            thread::thread_body_wrapper<tpb_chain_container>(
+                tpb_chain_container(
+                    chains[i], d_max_noutput_items, start_sync, d_threads, t.get()),
+                name.str(),
+                d_catch_exceptions));
+        d_threads->threads.push_back(t);
+    }
 
     // Fire off a thead for each block
 
-    for (size_t i = 0; i < blocks.size(); i++) {
+    for (size_t i : singles) {
         std::stringstream name;
         name << "thread-per-block[" << i << "]: " << blocks[i];
 
@@ -79,20 +258,22 @@ scheduler_tpb::scheduler_tpb(flat_flowgraph_sptr ffg,
         if (blocks[i]->is_set_max_noutput_items()) {
             block_max_noutput_items = blocks[i]->max_noutput_items();
         } else {
-            block_max_noutput_items = max_noutput_items;
+            block_max_noutput_items = d_max_noutput_items;
         }
-        d_threads.create_thread(thread::thread_body_wrapper<tpb_container>(
-            tpb_container(blocks[i], block_max_noutput_items, start_sync),
-            name.str(),
-            catch_exceptions));
+
+        auto t = std::make_shared<tpb_thread>();
+        t->blocks = { blocks[i] };
+        t->thread = std::make_unique<boost::thread>(
+            thread::thread_body_wrapper<tpb_container>(
+                tpb_container(
+                    blocks[i], block_max_noutput_items, start_sync, d_threads, t.get()),
+                name.str(),
+                d_catch_exceptions));
+        d_threads->threads.push_back(t);
     }
+
+    lock.unlock();
     start_sync->wait();
 }
 
-scheduler_tpb::~scheduler_tpb() { stop(); }
-
-void scheduler_tpb::stop() { d_threads.interrupt_all(); }
-
-void scheduler_tpb::wait() { d_threads.join_all(); }
-
 } /* namespace gr */
@@ -13,16 +13,20 @@
 
 #include "scheduler.h"
 #include <gnuradio/api.h>
-#include <gnuradio/thread/thread_group.h>
+#include <memory>
 
 namespace gr {
 
+struct tpb_threads;
+
 /*!
  * \brief Concrete scheduler that uses a kernel thread-per-block
  */
 class GR_RUNTIME_API scheduler_tpb : public scheduler
 {
-    gr::thread::thread_group d_threads;
+    std::shared_ptr<tpb_threads> d_threads;
+    int d_max_noutput_items;
+    bool d_catch_exceptions;
 
 protected:
     /*!
@@ -49,6 +53,21 @@ public:
      * \brief Block until the graph is done.
      */
     void wait() override;
+
+    bool can_reconfigure() const override { return true; }
+
+    /*!
+     * \brief Stop the threads running any of \p blocks; a fused chain
+     * stops as a whole.
+     */
+    std::set<basic_block_sptr>
+    stop_blocks(const std::set<basic_block_sptr>& blocks) override;
+
+    /*!
+     * \brief Start a thread for every block of \p ffg, or fused chain,
+     * that isn't running.
+     */
+    void start_blocks(flat_flowgraph_sptr ffg) override;
 };
 
 } /* namespace gr */
@@ -0,0 +1,340 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "scheduler_trace.h"
+#include <gnuradio/logger.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/thread/thread.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace gr {
+namespace trace {
+
+std::atomic<bool> s_enabled{ false };
+
+namespace {
+
+struct ring {
+    std::vector<event> events;      // size is a power of 2
+    std::atomic<uint64_t> head{ 0 }; // number of events ever recorded
+    uint64_t read = 0;               // events written out; under s_mutex
+    std::atomic<bool> in_use{ true };
+};
+
+gr::thread::mutex s_mutex; // protects everything below
+std::vector<std::unique_ptr<ring>> s_rings;
+std::map<long, std::string> s_names;
+size_t s_ring_size = 16384;
+std::string s_file;
+
+// Gives the ring back when the thread exits; it's reused once written out
+struct ring_owner {
+    ring* r = nullptr;
+    ~ring_owner()
+    {
+        if (r)
+            r->in_use = false;
+    }
+};
+thread_local ring_owner tl_ring;
+
+ring* acquire_ring()
+{
+    gr::thread::scoped_lock guard(s_mutex);
+    for (const auto& r : s_rings) {
+        if (!r->in_use && r->head.load() == r->read) {
+            r->in_use = true;
+            r->events.resize(s_ring_size);
+            return r.get();
+        }
+    }
+    s_rings.push_back(std::make_unique<ring>());
+    s_rings.back()->events.resize(s_ring_size);
+    return s_rings.back().get();
+}
+
+void write_string(std::ostream& os, const std::string& s)
+{
+    os << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            os << ' ';
+        else
+            os << c;
+    }
+    os << '"';
+}
+
+const char* category(event_type type)
+{
+    switch (type) {
+    case event_type::WORK:
+        return "work";
+    case event_type::FLATTEN:
+    case event_type::VALIDATE:
+    case event_type::ALLOCATE:
+    case event_type::START:
+        return "startup";
+    default:
+        return "wait";
+    }
+}
+
+} // namespace
+
+const char* type_name(event_type type)
+{
+    switch (type) {
+    case event_type::BLKD_IN:
+        return "BLKD_IN";
+    case event_type::BLKD_OUT:
+        return "BLKD_OUT";
+    case event_type::IDLE:
+        return "idle";
+    case event_type::NOTIFY:
+        return "notify";
+    case event_type::FLATTEN:
+        return "flatten";
+    case event_type::VALIDATE:
+        return "validate";
+    case event_type::ALLOCATE:
+        return "allocate";
+    case event_type::START:
+        return "start";
+    default:
+        return "work";
+    }
+}
+
+void configure()
+{
+    prefs* p = prefs::singleton();
+
+    gr::thread::scoped_lock guard(s_mutex);
+    s_file = p->get_string("PerfCounters", "trace_file", "");
+    size_t n = std::max(p->get_long("PerfCounters", "trace_buffer_events", 16384), 16L);
+    s_ring_size = 16;
+    while (s_ring_size < n)
+        s_ring_size *= 2;
+    s_enabled.store(!s_file.empty(), std::memory_order_relaxed);
+}
+
+void set_enabled(bool on) { s_enabled.store(on, std::memory_order_relaxed); }
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void record(const event& e)
+{
+    ring* r = tl_ring.r;
+    if (r == nullptr)
+        r = tl_ring.r = acquire_ring();
+
+    // Only this thread writes to the ring; the release store publishes
+    // the event to write_chrome_json().
+    uint64_t h = r->head.load(std::memory_order_relaxed);
+    r->events[h & (r->events.size() - 1)] = e;
+    r->head.store(h + 1, std::memory_order_release);
+}
+
+void register_block(long id, const std::string& name)
+{
+    gr::thread::scoped_lock guard(s_mutex);
+    s_names[id] = name;
+}
+
+void write_chrome_json(std::ostream& os)
+{
+    gr::thread::scoped_lock guard(s_mutex);
+
+    // The events of each thread since the last call, oldest first; tids
+    // count from 1. The head belongs to the thread writing the ring, so
+    // only our read cursor moves.
+    std::vector<std::vector<event>> threads;
+    for (const auto& r : s_rings) {
+        uint64_t head = r->head.load(std::memory_order_acquire);
+        uint64_t n = std::min<uint64_t>(head - r->read, r->events.size());
+        std::vector<event> events;
+        events.reserve(n);
+        for (uint64_t i = head - n; i < head; i++)
+            events.push_back(r->events[i & (r->events.size() - 1)]);
+        threads.push_back(std::move(events));
+        r->read = head;
+    }
+
+    int64_t t0 = INT64_MAX;
+    std::map<long, size_t> thread_of_block; // where its work calls ran
+    std::vector<std::vector<event>> waits(threads.size());
+    for (size_t t = 0; t < threads.size(); t++) {
+        for (const auto& e : threads[t]) {
+            t0 = std::min(t0, e.start);
+            if (e.type == event_type::WORK)
+                thread_of_block[e.block] = t;
+            else if (e.type == event_type::BLKD_IN || e.type == event_type::BLKD_OUT)
+                waits[t].push_back(e); // don't overlap, so sorted by start
+        }
+    }
+
+    auto block_name = [](long id) {
+        const auto& name = s_names.find(id);
+        return name == s_names.end() ? std::to_string(id) : name->second;
+    };
+    auto us = [](int64_t ns) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.3f", ns / 1000.0);
+        return std::string(buf);
+    };
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    auto begin_event = [&os, &first]() {
+        os << (first ? "" : ",\n");
+        first = false;
+    };
+
+    for (size_t t = 0; t < threads.size(); t++) {
+        if (threads[t].empty())
+            continue;
+
+        // Name the thread after the blocks that ran on it
+        std::vector<long> blocks;
+        bool worker = false;
+        for (const auto& e : threads[t]) {
+            worker |= (e.type == event_type::IDLE);
+            if (e.type == event_type::WORK &&
+                std::find(blocks.begin(), blocks.end(), e.block) == blocks.end())
+                blocks.push_back(e.block);
+        }
+        std::string name = worker ? "worker " + std::to_string(t + 1) : "";
+        for (size_t i = 0; !worker && i < blocks.size(); i++)
+            name += (i ? "+" : "") + block_name(blocks[i]);
+        begin_event();
+        os << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << t + 1
+           << ",\"args\":{\"name\":";
+        write_string(os, name.empty() ? "thread " + std::to_string(t + 1) : name);
+        os << "}}";
+    }
+
+    // (thread, index in waits) -> (thread, notification) that woke it up
+    std::map<std::pair<size_t, size_t>, std::pair<size_t, event>> wakeups;
+    for (size_t t = 0; t < threads.size(); t++) {
+        for (const auto& e : threads[t]) {
+            if (e.type != event_type::NOTIFY) {
+                begin_event();
+                os << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << t + 1
+                   << ",\"ts\":" << us(e.start - t0) << ",\"dur\":" << us(e.end - e.start)
+                   << ",\"cat\":\"" << category(e.type) << "\",\"name\":";
+                if (e.type == event_type::WORK) {
+                    write_string(os, block_name(e.block));
+                    os << ",\"args\":{\"noutput_items\":" << e.nitems
+                       << ",\"result\":" << e.result << "}}";
+                } else {
+                    os << '"' << type_name(e.type) << '"';
+                    if (e.block >= 0) {
+                        os << ",\"args\":{\"block\":";
+                        write_string(os, block_name(e.block));
+                        os << "}";
+                    }
+                    os << "}";
+                }
+                continue;
+            }
+
+            // Only notifications that woke up a waiting thread are
+            // interesting, and of those the first one into each wait.
+            const auto& peer = thread_of_block.find(e.peer);
+            if (peer == thread_of_block.end())
+                continue;
+            const auto& peer_waits = waits[peer->second];
+            auto w = std::upper_bound(
+                peer_waits.begin(),
+                peer_waits.end(),
+                e.start,
+                [](int64_t t, const event& x) { return t < x.start; });
+            if (w == peer_waits.begin() || (--w)->end < e.start)
+                continue;
+
+            std::pair<size_t, size_t> key(peer->second, w - peer_waits.begin());
+            const auto& wakeup = wakeups.find(key);
+            if (wakeup == wakeups.end() || e.start < wakeup->second.second.start)
+                wakeups[key] = std::make_pair(t, e);
+        }
+    }
+
+    // Draw them as arrows into the wait
+    uint64_t flow_id = 0;
+    for (const auto& wakeup : wakeups) {
+        size_t from = wakeup.second.first;
+        size_t to = wakeup.first.first;
+        const event& e = wakeup.second.second;
+
+        flow_id++;
+        begin_event();
+        os << "{\"ph\":\"s\",\"pid\":1,\"tid\":" << from + 1
+           << ",\"ts\":" << us(e.start - t0) << ",\"id\":" << flow_id
+           << ",\"cat\":\"notify\",\"name\":\"notify\"}";
+        begin_event();
+        os << "{\"ph\":\"f\",\"bp\":\"e\",\"pid\":1,\"tid\":" << to + 1
+           << ",\"ts\":" << us(e.start - t0) << ",\"id\":" << flow_id
+           << ",\"cat\":\"notify\",\"name\":\"notify\",\"args\":{\"from\":";
+        write_string(os, block_name(e.block));
+        os << ",\"to\":";
+        write_string(os, block_name(e.peer));
+        os << "}}";
+    }
+    os << "\n]}\n";
+}
+
+void write_trace_file()
+{
+    // Don't overwrite the trace of the last run with an empty one, e.g.
+    // when wait() is called again by the top_block's destructor.
+    std::string file;
+    {
+        gr::thread::scoped_lock guard(s_mutex);
+        file = s_file;
+        if (std::none_of(s_rings.begin(), s_rings.end(), [](const auto& r) {
+                return r->head.load() > r->read;
+            }))
+            return;
+    }
+    if (file.empty())
+        return;
+
+    std::ofstream os(file);
+    if (os)
+        write_chrome_json(os);
+    if (!os) {
+        gr::logger_ptr logger, debug_logger;
+        gr::configure_default_loggers(logger, debug_logger, "scheduler_trace");
+        GR_LOG_ERROR(logger, "could not write trace file " + file);
+    }
+}
+
+} /* namespace trace */
+} /* namespace gr */
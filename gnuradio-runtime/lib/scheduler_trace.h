@@ -0,0 +1,155 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_RUNTIME_SCHEDULER_TRACE_H
+#define INCLUDED_GR_RUNTIME_SCHEDULER_TRACE_H
+
+#include <gnuradio/api.h>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace gr {
+namespace trace {
+
+/*!
+ * \brief Per-call tracing of the schedulers.
+ * \ingroup internal
+ *
+ * When [PerfCounters] trace_file is set, the schedulers record every
+ * general_work call, every wait for input or output (BLKD_IN/BLKD_OUT),
+ * idle time of work-stealing workers and every notification sent to a
+ * neighboring block. Starting a flowgraph is traced as well: the
+ * phases of top_block::start(), and the buffer allocation and start()
+ * of every block, so the trace shows where the time up to the first
+ * work call went. Each thread writes into its own ring buffer of
+ * [PerfCounters] trace_buffer_events events, without any locking; the
+ * oldest events are overwritten when it's full. After the flowgraph
+ * has stopped (when top_block::wait() returns) everything is written
+ * to the trace file as Chrome trace event JSON, which chrome://tracing
+ * and ui.perfetto.dev open.
+ *
+ * When tracing is off every hook is a single test of a flag, and
+ * without GR_PERFORMANCE_COUNTERS the hooks compile to nothing.
+ */
+
+enum class event_type : uint8_t {
+    WORK,     //!< a general_work call
+    BLKD_IN,  //!< waiting for input
+    BLKD_OUT, //!< waiting for output buffer space
+    IDLE,     //!< a work-stealing worker with nothing to do
+    NOTIFY,   //!< block told peer that its buffers changed
+    FLATTEN,  //!< top_block::start(): flattening the hierarchy
+    VALIDATE, //!< top_block::start(): checking the flat flowgraph
+    ALLOCATE, //!< allocating the buffers of a block, or of all of them
+    START,    //!< a block's start(), or starting the scheduler
+};
+
+struct event {
+    int64_t start; //!< ns, see now()
+    int64_t end;   //!< ns; start for NOTIFY
+    long block;    //!< unique_id of the block, -1 if none
+    long peer;     //!< NOTIFY: unique_id of the notified block
+    int nitems;    //!< WORK: noutput_items
+    int result;    //!< WORK: what general_work returned
+    event_type type;
+};
+
+extern GR_RUNTIME_API std::atomic<bool> s_enabled;
+
+//! Is tracing on? Cheap enough to call on every work call.
+inline bool enabled()
+{
+#ifdef GR_PERFORMANCE_COUNTERS
+    return s_enabled.load(std::memory_order_relaxed);
+#else
+    return false;
+#endif
+}
+
+/*!
+ * \brief Turn tracing on if [PerfCounters] trace_file is set.
+ *
+ * Called before any scheduler threads are started.
+ */
+GR_RUNTIME_API void configure();
+
+//! Turn tracing on or off; only while no scheduler is running.
+GR_RUNTIME_API void set_enabled(bool on);
+
+//! Monotonic time in ns, the time base of all events.
+GR_RUNTIME_API int64_t now();
+
+//! Add \p e to the calling thread's ring buffer.
+GR_RUNTIME_API void record(const event& e);
+
+//! What events of type \p type are called in the trace.
+GR_RUNTIME_API const char* type_name(event_type type);
+
+//! Name to show for block \p id in the trace.
+GR_RUNTIME_API void register_block(long id, const std::string& name);
+
+/*!
+ * \brief Write all recorded events as Chrome trace event JSON and
+ * forget them.
+ *
+ * Only call this while no scheduler is running.
+ */
+GR_RUNTIME_API void write_chrome_json(std::ostream& os);
+
+//! write_chrome_json() to the configured trace file, if any events were recorded.
+GR_RUNTIME_API void write_trace_file();
+
+/*!
+ * \brief Records the time from its construction to its destruction,
+ * e.g. a wait, as one event.
+ */
+class scope
+{
+public:
+    scope(event_type type, long block) : d_start(enabled() ? now() : 0)
+    {
+        d_event.type = type;
+        d_event.block = block;
+    }
+    ~scope()
+    {
+        if (d_start) {
+            d_event.start = d_start;
+            d_event.end = now();
+            d_event.peer = -1;
+            d_event.nitems = 0;
+            d_event.result = 0;
+            record(d_event);
+        }
+    }
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+private:
+    int64_t d_start;
+    event d_event;
+};
+
+//! Record that \p block notified \p peer.
+inline void notify(long block, long peer)
+{
+    if (enabled()) {
+        int64_t t = now();
+        record({ t, t, block, peer, 0, 0, event_type::NOTIFY });
+    }
+}
+
+} /* namespace trace */
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_RUNTIME_SCHEDULER_TRACE_H */
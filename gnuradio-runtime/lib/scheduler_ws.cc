@@ -0,0 +1,424 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "block_executor.h"
+#include "scheduler_trace.h"
+#include "scheduler_ws.h"
+#include <gnuradio/block_detail.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/thread/thread_body_wrapper.h>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <sstream>
+#include <vector>
+
+namespace gr {
+
+// Tasks blocked on input are re-run at least this often, matching the
+// timed wait in tpb_thread_body.
+static const int64_t poll_interval_ns = 250000000;
+
+static int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct ws_task {
+    enum {
+        IDLE,             // waiting for a notification
+        QUEUED,           // sitting in exactly one worker deque
+        RUNNING,          // a worker is running an iteration
+        RUNNING_NOTIFIED, // ... and got notified meanwhile; re-queue it
+        FINISHED,         // DONE, never queue again
+    };
+
+    block_sptr block;
+    int max_noutput_items;
+    std::unique_ptr<block_executor> exec; // made by the worker starting it
+    std::atomic<int> state;
+    std::atomic<bool> blocked_in;
+    std::vector<pmt::pmt_t> msgs; // drained from one port at a time
+
+    ws_task(block_sptr b, int max_noutput_items)
+        : block(b), max_noutput_items(max_noutput_items), state(QUEUED), blocked_in(false)
+    {
+    }
+};
+
+struct ws_worker {
+    scheduler_ws* owner;
+    size_t index;
+    gr::thread::mutex mutex; // protects tasks
+    std::deque<ws_task*> tasks;
+
+    ws_worker(scheduler_ws* o, size_t i) : owner(o), index(i) {}
+};
+
+static thread_local ws_worker* tl_worker = nullptr;
+
+scheduler_sptr
+scheduler_ws::make(flat_flowgraph_sptr ffg, int max_noutput_items, bool catch_exceptions)
+{
+    return scheduler_sptr(new scheduler_ws(ffg, max_noutput_items, catch_exceptions));
+}
+
+scheduler_ws::scheduler_ws(flat_flowgraph_sptr ffg,
+                           int max_noutput_items,
+                           bool catch_exceptions)
+    : scheduler(ffg, max_noutput_items, catch_exceptions),
+      d_nidle(0),
+      d_npending(0),
+      d_nlive(0),
+      d_stop(false),
+      d_next(0),
+      d_next_poll(now_ns() + poll_interval_ns),
+      d_nrunning(0),
+      d_catch_exceptions(catch_exceptions)
+{
+    gr::configure_default_loggers(d_logger, d_debug_logger, "scheduler_ws");
+
+    basic_block_vector_t used_blocks = ffg->calc_used_blocks();
+    used_blocks = ffg->topological_sort(used_blocks);
+    block_vector_t blocks = flat_flowgraph::make_block_vector(used_blocks);
+
+    // Ensure that the done flag is clear on all blocks
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        blocks[i]->detail()->set_done(false);
+    }
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        int block_max_noutput_items = max_noutput_items;
+        if (blocks[i]->is_set_max_noutput_items()) {
+            block_max_noutput_items = blocks[i]->max_noutput_items();
+        }
+        blocks[i]->clear_finished();
+        d_tasks.push_back(std::make_unique<ws_task>(blocks[i], block_max_noutput_items));
+    }
+    d_nlive = d_tasks.size();
+
+    prefs* p = prefs::singleton();
+    d_max_nmsgs = static_cast<size_t>(p->get_long("DEFAULT", "max_messages", 100));
+    long nthreads = p->get_long("Scheduler", "ws_nthreads", 0);
+    if (nthreads <= 0) {
+        nthreads = std::max(1u, boost::thread::hardware_concurrency());
+    }
+    nthreads = std::max(1L, std::min(nthreads, static_cast<long>(d_tasks.size())));
+
+    for (long i = 0; i < nthreads; i++) {
+        d_workers.push_back(std::make_unique<ws_worker>(this, i));
+    }
+
+    // Hook into the notifications blocks send each other, and queue
+    // every block once to get things going. Each worker starts the
+    // blocks it was given (making the executors starts the blocks), so
+    // they start in parallel; all of them are started before any work
+    // is done, as with thread-per-block.
+
+    for (size_t i = 0; i < d_tasks.size(); i++) {
+        ws_task* t = d_tasks[i].get();
+        t->block->detail()->d_tpb.set_wakeup([this, t]() { notify(t); });
+        d_workers[i % d_workers.size()]->tasks.push_back(t);
+        d_npending++;
+    }
+
+    d_nrunning = d_workers.size();
+    thread::barrier_sptr start_sync =
+        std::make_shared<thread::barrier>(d_workers.size() + 1);
+    for (size_t i = 0; i < d_workers.size(); i++) {
+        ws_worker* w = d_workers[i].get();
+        std::stringstream name;
+        name << "work-stealing[" << i << "]";
+
+        auto body = [this, w, start_sync]() { run_worker(w, start_sync); };
+        d_threads.create_thread(thread::thread_body_wrapper<decltype(body)>(
+            body, name.str(), catch_exceptions));
+    }
+    start_sync->wait();
+}
+
+scheduler_ws::~scheduler_ws()
+{
+    stop();
+    wait();
+}
+
+void scheduler_ws::stop()
+{
+    d_stop = true;
+    {
+        gr::thread::scoped_lock guard(d_park_mutex);
+        d_park_cond.notify_all();
+    }
+    d_threads.interrupt_all();
+}
+
+void scheduler_ws::wait() { d_threads.join_all(); }
+
+void scheduler_ws::notify(ws_task* t)
+{
+    int s = t->state.load();
+    while (true) {
+        if (s == ws_task::IDLE) {
+            if (t->state.compare_exchange_weak(s, ws_task::QUEUED)) {
+                push(t, false);
+                return;
+            }
+        } else if (s == ws_task::RUNNING) {
+            if (t->state.compare_exchange_weak(s, ws_task::RUNNING_NOTIFIED))
+                return;
+        } else {
+            return; // already queued, already notified or finished
+        }
+    }
+}
+
+void scheduler_ws::push(ws_task* t, bool yield)
+{
+    // Wakeups raised by one of our workers stay on that worker, so a
+    // downstream block tends to run right after its upstream block,
+    // while the data is still in cache. Anything else is spread out.
+    ws_worker* w = tl_worker;
+    if (w == nullptr || w->owner != this) {
+        w = d_workers[d_next++ % d_workers.size()].get();
+    }
+
+    {
+        gr::thread::scoped_lock guard(w->mutex);
+        if (yield)
+            w->tasks.push_front(t);
+        else
+            w->tasks.push_back(t);
+    }
+
+    d_npending++;
+    if (d_nidle.load() > 0) {
+        gr::thread::scoped_lock guard(d_park_mutex);
+        d_park_cond.notify_one();
+    }
+}
+
+ws_task* scheduler_ws::pop(ws_worker* w)
+{
+    ws_task* t = nullptr;
+    {
+        gr::thread::scoped_lock guard(w->mutex);
+        if (!w->tasks.empty()) {
+            t = w->tasks.back();
+            w->tasks.pop_back();
+        }
+    }
+
+    // Nothing of our own to do; steal the oldest task of another worker.
+    for (size_t i = 1; t == nullptr && i < d_workers.size(); i++) {
+        ws_worker* victim = d_workers[(w->index + i) % d_workers.size()].get();
+        gr::thread::scoped_lock guard(victim->mutex);
+        if (!victim->tasks.empty()) {
+            t = victim->tasks.front();
+            victim->tasks.pop_front();
+        }
+    }
+
+    if (t)
+        d_npending--;
+    return t;
+}
+
+void scheduler_ws::park()
+{
+    gr::thread::scoped_lock guard(d_park_mutex);
+    d_nidle++;
+    if (d_npending.load() <= 0 && !d_stop && d_nlive.load() > 0) {
+        trace::scope span(trace::event_type::IDLE, -1);
+        d_park_cond.timed_wait(guard,
+                               boost::posix_time::microseconds(poll_interval_ns / 1000));
+    }
+    d_nidle--;
+}
+
+void scheduler_ws::poll_blocked()
+{
+    int64_t next = d_next_poll.load();
+    int64_t now = now_ns();
+    if (now < next || !d_next_poll.compare_exchange_strong(next, now + poll_interval_ns))
+        return;
+
+    for (const auto& t : d_tasks) {
+        if (t->blocked_in && t->state.load() == ws_task::IDLE)
+            notify(t.get());
+    }
+}
+
+void scheduler_ws::run_task(ws_task* t)
+{
+    block* b = t->block.get();
+    block_detail* d = b->detail().get();
+    block_executor::state s;
+    pmt::pmt_t msg;
+
+    t->state = ws_task::RUNNING;
+
+    try {
+        // handle any queued up messages
+        for (auto& i : b->msg_queue) {
+            if (i.second.empty())
+                continue;
+            if (b->has_msg_handler(i.first)) {
+                i.second.drain(t->msgs, i.second.size());
+                b->dispatch_msgs(i.first, t->msgs);
+                t->msgs.clear();
+            } else {
+                // If we don't have a handler but are building up messages,
+                // prune the queue from the front to keep memory in check.
+                if (i.second.size() > d_max_nmsgs) {
+                    GR_LOG_WARN(
+                        d_logger,
+                        "asynchronous message buffer overflowing, dropping message");
+                    msg = i.second.pop();
+                }
+            }
+        }
+
+        // run one iteration if we are a connected stream block
+        if (d->noutputs() > 0 || d->ninputs() > 0) {
+            s = t->exec->run_one_iteration();
+        } else {
+            s = block_executor::BLKD_IN;
+            // a msg port only block wants to shutdown
+            if (b->finished()) {
+                s = block_executor::DONE;
+            }
+        }
+    } catch (boost::thread_interrupted const&) {
+        throw;
+    } catch (std::exception const& e) {
+        if (!d_catch_exceptions)
+            throw;
+        std::ostringstream msg;
+        msg << "ERROR block[" << b->alias() << "]: " << e.what();
+        GR_LOG_ERROR(d_logger, msg.str());
+        d->set_done(true);
+        s = block_executor::DONE;
+    }
+
+    if (b->finished() && s == block_executor::READY_NO_OUTPUT) {
+        s = block_executor::DONE;
+        d->set_done(true);
+    }
+
+    if (!d->ninputs() && s == block_executor::READY_NO_OUTPUT) {
+        s = block_executor::BLKD_IN;
+    }
+
+    switch (s) {
+    case block_executor::READY: // Tell neighbors we made progress.
+        d->d_tpb.notify_neighbors(d);
+        t->state = ws_task::QUEUED;
+        push(t, true);
+        break;
+
+    case block_executor::READY_NO_OUTPUT: // Notify upstream only
+        d->d_tpb.notify_upstream(d);
+        t->state = ws_task::QUEUED;
+        push(t, true);
+        break;
+
+    case block_executor::DONE: // Game over.
+        b->notify_msg_neighbors();
+        d->d_tpb.notify_neighbors(d);
+        finish_task(t);
+        break;
+
+    case block_executor::BLKD_IN: // Wait for input.
+    case block_executor::BLKD_OUT: // Wait for output buffer space.
+    {
+        t->blocked_in = (s == block_executor::BLKD_IN);
+        int expected = ws_task::RUNNING;
+        if (!t->state.compare_exchange_strong(expected, ws_task::IDLE)) {
+            // a neighbor made progress while we were running
+            t->state = ws_task::QUEUED;
+            push(t, true);
+        }
+    } break;
+
+    default:
+        throw std::runtime_error("possible memory corruption in scheduler");
+    }
+}
+
+void scheduler_ws::finish_task(ws_task* t)
+{
+    t->state = ws_task::FINISHED;
+    t->exec.reset(); // stop the block
+
+    if (--d_nlive == 0) {
+        gr::thread::scoped_lock guard(d_park_mutex);
+        d_park_cond.notify_all();
+    }
+}
+
+void scheduler_ws::run_worker(ws_worker* w, thread::barrier_sptr start_sync)
+{
+    // The last worker out stops the blocks that didn't finish (only
+    // happens after stop()) and detaches us from the blocks.
+    struct cleanup {
+        scheduler_ws* s;
+        ~cleanup()
+        {
+            tl_worker = nullptr;
+            if (--s->d_nrunning > 0)
+                return;
+            for (const auto& t : s->d_tasks) {
+                t->block->detail()->d_tpb.set_wakeup(nullptr);
+                t->exec.reset();
+            }
+        }
+    } guard{ this };
+
+    thread::set_thread_name(thread::get_current_thread_id(),
+                            boost::str(boost::format("ws-worker%d") % w->index));
+    tl_worker = w;
+
+    // Start our blocks. If one of them can't be started, stop all
+    // workers, but don't leave the others waiting at the barrier.
+    std::exception_ptr error;
+    try {
+        for (ws_task* t : w->tasks)
+            t->exec = std::make_unique<block_executor>(t->block, t->max_noutput_items);
+    } catch (...) {
+        error = std::current_exception();
+        d_stop = true;
+    }
+    start_sync->wait();
+    if (error)
+        std::rethrow_exception(error);
+
+    while (!d_stop && d_nlive.load() > 0) {
+        boost::this_thread::interruption_point();
+
+        poll_blocked();
+
+        ws_task* t = pop(w);
+        if (t == nullptr) {
+            park();
+            continue;
+        }
+        run_task(t);
+    }
+}
+
+} /* namespace gr */
@@ -0,0 +1,105 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_SCHEDULER_WS_H
+#define INCLUDED_GR_SCHEDULER_WS_H
+
+#include "scheduler.h"
+#include <gnuradio/api.h>
+#include <gnuradio/logger.h>
+#include <gnuradio/thread/thread_group.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace gr {
+
+struct ws_task;
+struct ws_worker;
+
+/*!
+ * \brief Concrete scheduler that runs all blocks on a fixed pool of
+ * worker threads with work stealing.
+ *
+ * Instead of one kernel thread per block, a block is a task that is
+ * queued on a worker whenever one of its neighbors notifies it (the
+ * same notifications the thread-per-block scheduler uses to wake its
+ * threads). A worker runs one iteration of the block executor and,
+ * depending on the returned state, re-queues the task (READY) or
+ * leaves it idle until the next notification (BLKD_IN, BLKD_OUT).
+ * Every worker owns a deque: it pops the most recently woken task
+ * from the back, and idle workers steal the oldest task from the
+ * front of another worker's deque.
+ *
+ * The pool size is read from the [Scheduler] ws_nthreads preference;
+ * 0 (the default) uses one worker per hardware thread. Per-block
+ * processor affinity and thread priority are not applied, since
+ * blocks do not own a thread.
+ */
+class GR_RUNTIME_API scheduler_ws : public scheduler
+{
+    std::vector<std::unique_ptr<ws_task>> d_tasks;
+    std::vector<std::unique_ptr<ws_worker>> d_workers;
+    gr::thread::thread_group d_threads;
+
+    gr::thread::mutex d_park_mutex; // protects parking of idle workers
+    gr::thread::condition_variable d_park_cond;
+    std::atomic<int> d_nidle;         // workers parked on d_park_cond
+    std::atomic<int> d_npending;      // tasks sitting in any deque
+    std::atomic<int> d_nlive;         // tasks that aren't DONE yet
+    std::atomic<bool> d_stop;         // stop() was called
+    std::atomic<unsigned> d_next;     // round-robin target for external wakeups
+    std::atomic<int64_t> d_next_poll; // when to next re-run tasks blocked on input
+    std::atomic<int> d_nrunning;      // workers that haven't exited yet
+    size_t d_max_nmsgs;
+    bool d_catch_exceptions;
+
+    gr::logger_ptr d_logger, d_debug_logger;
+
+protected:
+    /*!
+     * \brief Construct a scheduler and begin evaluating the graph.
+     *
+     * The scheduler will continue running until all blocks
+     * report that they are done or the stop method is called.
+     */
+    scheduler_ws(flat_flowgraph_sptr ffg, int max_noutput_items, bool catch_exceptions);
+
+public:
+    static scheduler_sptr make(flat_flowgraph_sptr ffg,
+                               int max_noutput_items = 100000,
+                               bool catch_exceptions = true);
+
+    ~scheduler_ws() override;
+
+    /*!
+     * \brief Tell the scheduler to stop executing.
+     */
+    void stop() override;
+
+    /*!
+     * \brief Block until the graph is done.
+     */
+    void wait() override;
+
+private:
+    void notify(ws_task* t);
+    void push(ws_task* t, bool yield);
+    ws_task* pop(ws_worker* w);
+    void park();
+    void poll_blocked();
+    void run_task(ws_task* t);
+    void finish_task(ws_task* t);
+    void run_worker(ws_worker* w, thread::barrier_sptr start_sync);
+};
+
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_SCHEDULER_WS_H */
@@ -0,0 +1,46 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/tag_store.h>
+
+namespace gr {
+
+void tag_store::add(const std::vector<tag_t>& tags)
+{
+    // In order and after our newest tag: one bulk append
+    if (std::is_sorted(tags.begin(), tags.end(), tag_t::offset_compare) &&
+        (empty() || tags.empty() || d_tags.back().offset <= tags.front().offset)) {
+        d_tags.insert(d_tags.end(), tags.begin(), tags.end());
+        return;
+    }
+
+    for (const auto& tag : tags)
+        add(tag);
+}
+
+void tag_store::prune(uint64_t offset)
+{
+    d_first = lower_bound(offset) - d_tags.begin();
+
+    if (d_first == d_tags.size()) {
+        clear(); // keeps the capacity
+    } else if (d_first >= d_tags.size() / 2) {
+        // Move the live tags to the front; there are at most as many
+        // of them as were pruned since the last time.
+        d_tags.erase(d_tags.begin(), d_tags.begin() + d_first);
+        d_first = 0;
+    }
+}
+
+} /* namespace gr */
@@ -79,6 +79,27 @@ bool tagged_stream_block::check_topology(int ninputs, int /* noutputs */)
 }
 
 
+void tagged_stream_block::get_packet_tags(unsigned which_input, bool from_window)
+{
+    std::vector<tag_t>& tags = d_packet_tags[which_input];
+    uint64_t start = nitems_read(which_input);
+
+    if (!from_window) {
+        get_tags_in_range(tags, which_input, start, start + 1);
+        return;
+    }
+
+    // The window's tags are sorted by offset and packets come in order,
+    // so every packet picks up where the one before it left off
+    std::vector<tag_t>& window = d_window_tags[which_input];
+    size_t& pos = d_window_pos[which_input];
+    while (pos < window.size() && window[pos].offset < start)
+        pos++;
+    tags.clear();
+    for (; pos < window.size() && window[pos].offset == start; pos++)
+        tags.push_back(std::move(window[pos])); // looked at once
+}
+
 int tagged_stream_block::general_work(int noutput_items,
                                       gr_vector_int& ninput_items,
                                       gr_vector_const_void_star& input_items,
@@ -88,53 +109,108 @@ int tagged_stream_block::general_work(int noutput_items,
         return work(noutput_items, ninput_items, input_items, output_items);
     }
 
-    // Read TSB tags, unless we...
-    // ...don't have inputs or ...     ... we already set it in a previous run.
-    if (!d_n_input_items_reqd.empty() && d_n_input_items_reqd[0] == 0) {
-        std::vector<std::vector<tag_t>> tags(input_items.size(), std::vector<tag_t>());
-        for (unsigned i = 0; i < input_items.size(); i++) {
-            get_tags_in_range(tags[i], i, nitems_read(i), nitems_read(i) + 1);
+    // Packets are produce()d as they are done, so we can only run more
+    // than one per call if the scheduler propagates no tags after we
+    // return: those would come after the items they belong to.
+    const unsigned ninputs = input_items.size();
+    const bool batch =
+        ninputs > 0 && (output_items.empty() || tag_propagation_policy() == TPP_DONT ||
+                        tag_propagation_policy() == TPP_CUSTOM);
+
+    d_packet_tags.resize(ninputs);
+    d_packet_inputs.assign(input_items.begin(), input_items.end());
+    d_packet_outputs.assign(output_items.begin(), output_items.end());
+    d_nconsumed.assign(ninputs, 0);
+    bool have_window = false;
+    int npackets = 0;
+    int nproduced = 0;
+
+    while (true) {
+        // Read TSB tags, unless we...
+        // ...don't have inputs or ...     ... we already set it in a previous run.
+        if (!d_n_input_items_reqd.empty() && d_n_input_items_reqd[0] == 0) {
+            for (unsigned i = 0; i < ninputs; i++) {
+                if (d_nconsumed[i] == ninput_items[i])
+                    return npackets > 0 ? WORK_CALLED_PRODUCE : 0;
+            }
+            if (npackets > 0 && !have_window) {
+                // One look at the tags of everything that is left
+                // instead of one per packet
+                d_window_tags.resize(ninputs);
+                d_window_pos.assign(ninputs, 0);
+                for (unsigned i = 0; i < ninputs; i++) {
+                    get_tags_in_range(d_window_tags[i],
+                                      i,
+                                      nitems_read(i),
+                                      nitems_read(i) + ninput_items[i] - d_nconsumed[i]);
+                }
+                have_window = true;
+            }
+            for (unsigned i = 0; i < ninputs; i++) {
+                get_packet_tags(i, have_window);
+            }
+            d_n_input_items_reqd.assign(ninputs, -1);
+            parse_length_tags(d_packet_tags, d_n_input_items_reqd);
         }
-        d_n_input_items_reqd.assign(input_items.size(), -1);
-        parse_length_tags(tags, d_n_input_items_reqd);
-    }
-    for (unsigned i = 0; i < input_items.size(); i++) {
-        if (d_n_input_items_reqd[i] == -1) {
-            GR_LOG_FATAL(
-                d_logger,
-                boost::format("Missing a required length tag on port %1% at item #%2%") %
-                    i % nitems_read(i));
-            throw std::runtime_error("Missing length tag.");
+        for (unsigned i = 0; i < ninputs; i++) {
+            if (d_n_input_items_reqd[i] == -1) {
+                GR_LOG_FATAL(
+                    d_logger,
+                    boost::format(
+                        "Missing a required length tag on port %1% at item #%2%") %
+                        i % nitems_read(i));
+                throw std::runtime_error("Missing length tag.");
+            }
+            if (d_n_input_items_reqd[i] > ninput_items[i] - d_nconsumed[i]) {
+                return npackets > 0 ? WORK_CALLED_PRODUCE : 0;
+            }
         }
-        if (d_n_input_items_reqd[i] > ninput_items[i]) {
+
+        int min_output_size = calculate_output_stream_length(d_n_input_items_reqd);
+        if (noutput_items - nproduced < min_output_size) {
+            if (npackets > 0)
+                return WORK_CALLED_PRODUCE;
+            set_min_noutput_items(min_output_size);
             return 0;
         }
-    }
+        set_min_noutput_items(1);
 
-    int min_output_size = calculate_output_stream_length(d_n_input_items_reqd);
-    if (noutput_items < min_output_size) {
-        set_min_noutput_items(min_output_size);
-        return 0;
-    }
-    set_min_noutput_items(1);
+        // WORK CALLED HERE //
+        int n_produced = work(noutput_items - nproduced,
+                              d_n_input_items_reqd,
+                              d_packet_inputs,
+                              d_packet_outputs);
+        //////////////////////
 
-    // WORK CALLED HERE //
-    int n_produced = work(noutput_items, d_n_input_items_reqd, input_items, output_items);
-    //////////////////////
+        if (n_produced == WORK_DONE) {
+            return n_produced;
+        }
+        for (unsigned i = 0; i < ninputs; i++) {
+            consume(i, d_n_input_items_reqd[i]);
+            d_nconsumed[i] += d_n_input_items_reqd[i];
+            d_packet_inputs[i] = static_cast<const char*>(d_packet_inputs[i]) +
+                                 d_n_input_items_reqd[i] *
+                                     input_signature()->sizeof_stream_item(i);
+        }
+        if (n_produced > 0) {
+            update_length_tags(n_produced, output_items.size());
+        }
 
-    if (n_produced == WORK_DONE) {
-        return n_produced;
-    }
-    for (int i = 0; i < (int)d_n_input_items_reqd.size(); i++) {
-        consume(i, d_n_input_items_reqd[i]);
-    }
-    if (n_produced > 0) {
-        update_length_tags(n_produced, output_items.size());
-    }
+        d_n_input_items_reqd.assign(ninputs, 0);
 
-    d_n_input_items_reqd.assign(input_items.size(), 0);
+        // A work() that calls produce() itself ends the batch, too
+        if (!batch || n_produced == WORK_CALLED_PRODUCE) {
+            return npackets > 0 ? WORK_CALLED_PRODUCE : n_produced;
+        }
 
-    return n_produced;
+        for (unsigned o = 0; o < output_items.size() && n_produced > 0; o++) {
+            produce(o, n_produced);
+            d_packet_outputs[o] = static_cast<char*>(d_packet_outputs[o]) +
+                                  n_produced * output_signature()->sizeof_stream_item(o);
+        }
+        nproduced += std::max(n_produced, 0);
+        npackets++;
+    }
 }
 
 } /* namespace gr */
@@ -77,6 +77,8 @@ std::string top_block::edge_list() { return d_impl->edge_list(); }
 
 std::string top_block::msg_edge_list() { return d_impl->msg_edge_list(); }
 
+std::string top_block::buffer_size_list() { return d_impl->buffer_size_list(); }
+
 void top_block::dump() { d_impl->dump(); }
 
 int top_block::max_noutput_items() { return d_impl->max_noutput_items(); }
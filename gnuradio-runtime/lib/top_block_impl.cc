@@ -14,6 +14,8 @@
 
 #include "flat_flowgraph.h"
 #include "scheduler_tpb.h"
+#include "scheduler_trace.h"
+#include "scheduler_ws.h"
 #include "terminate_handler.h"
 #include "top_block_impl.h"
 #include <gnuradio/logger.h>
@@ -23,7 +25,9 @@
 #include <unistd.h>
 #include <cstdlib>
 #include <cstring>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
 
 namespace gr {
 
@@ -37,7 +41,8 @@ static struct scheduler_table {
     const char* name;
     scheduler_maker f;
 } scheduler_table[] = {
-    { "TPB", scheduler_tpb::make } // first entry is default
+    { "TPB", scheduler_tpb::make }, // first entry is default
+    { "WS", scheduler_ws::make }
 };
 
 static scheduler_sptr
@@ -71,13 +76,49 @@ make_scheduler(flat_flowgraph_sptr ffg, int max_noutput_items, bool catch_except
     return factory(ffg, max_noutput_items, catch_exceptions);
 }
 
+// Times the phases of getting a flowgraph going, for the debug log
+// and, when tracing, for the trace, ahead of the first work calls.
+class startup_timer
+{
+public:
+    startup_timer() : d_start(trace::now()), d_last(d_start) {}
+
+    // The phase of type since the last one is done
+    void phase(trace::event_type type)
+    {
+        int64_t t = trace::now();
+        if (trace::enabled())
+            trace::record({ d_last, t, -1, -1, 0, 0, type });
+        d_phases.emplace_back(type, t - d_last);
+        d_last = t;
+    }
+
+    std::string summary() const
+    {
+        std::ostringstream s;
+        s.precision(2);
+        s << std::fixed << (d_last - d_start) / 1e6 << " ms (";
+        for (size_t i = 0; i < d_phases.size(); i++)
+            s << (i ? ", " : "") << trace::type_name(d_phases[i].first) << " "
+              << d_phases[i].second / 1e6 << " ms";
+        s << ")";
+        return s.str();
+    }
+
+private:
+    int64_t d_start;
+    int64_t d_last;
+    std::vector<std::pair<trace::event_type, int64_t>> d_phases;
+};
+
 top_block_impl::top_block_impl(top_block* owner, bool catch_exceptions = true)
     : d_owner(owner),
       d_ffg(),
       d_state(IDLE),
       d_lock_count(0),
       d_retry_wait(false),
-      d_catch_exceptions(catch_exceptions)
+      d_catch_exceptions(catch_exceptions),
+      d_incremental(false)
 {
     install_terminate_handler();
     gr::configure_default_loggers(d_logger, d_debug_logger, "top_block_impl");
@@ -106,11 +147,16 @@ void top_block_impl::start(int max_noutput_items)
     if (d_lock_count > 0)
         throw std::runtime_error("top_block::start: can't start with flow graph locked");
 
+    trace::configure();
+    startup_timer timer;
+
     // Create new flat flow graph by flattening hierarchy
     d_ffg = d_owner->flatten();
+    timer.phase(trace::event_type::FLATTEN);
 
     // Validate new simple flow graph and wire it up
     d_ffg->validate();
+    timer.phase(trace::event_type::VALIDATE);
     d_ffg->setup_connections();
 
     // Only export perf. counters if ControlPort config param is
@@ -119,9 +165,15 @@ void top_block_impl::start(int max_noutput_items)
     if (p->get_bool("ControlPort", "on", false) &&
         p->get_bool("PerfCounters", "export", false))
         d_ffg->enable_pc_rpc();
+    timer.phase(trace::event_type::ALLOCATE);
 
     d_scheduler = make_scheduler(d_ffg, d_max_noutput_items, d_catch_exceptions);
+    d_incremental = p->get_bool("Scheduler", "incremental_reconfig", false) &&
+                    d_scheduler->can_reconfigure();
     d_state = RUNNING;
+    timer.phase(trace::event_type::START);
+
+    GR_LOG_DEBUG(d_debug_logger, "started in " + timer.summary());
 }
 
 void top_block_impl::stop()
@@ -139,7 +191,15 @@ void top_block_impl::stop()
 void top_block_impl::wait()
 {
     do {
-        wait_for_jobs();
+        // unlock() may replace the scheduler while we wait for it
+        scheduler_sptr scheduler;
+        {
+            gr::thread::scoped_lock lock(d_mutex);
+            scheduler = d_scheduler;
+        }
+        if (scheduler)
+            scheduler->wait();
+
         {
             gr::thread::scoped_lock lock(d_mutex);
             if (!d_lock_count) {
@@ -153,6 +213,10 @@ void top_block_impl::wait()
             d_lock_cond.wait(lock);
         }
     } while (true);
+
+    // All scheduler threads are gone, so the trace is complete
+    if (trace::enabled())
+        trace::write_trace_file();
 }
 
 void top_block_impl::wait_for_jobs()
@@ -166,7 +230,8 @@ void top_block_impl::wait_for_jobs()
 void top_block_impl::lock()
 {
     gr::thread::scoped_lock lock(d_mutex);
-    if (d_scheduler)
+    // Incrementally, restart() stops only what it has to
+    if (d_scheduler && !d_incremental)
         d_scheduler->stop();
     d_lock_count++;
 }
@@ -193,17 +258,45 @@ void top_block_impl::unlock()
  */
 void top_block_impl::restart()
 {
+    if (d_incremental) {
+        // Stop only the blocks whose connections change, rewire them
+        // and start them again; everything else keeps running.
+        startup_timer timer;
+        flat_flowgraph_sptr new_ffg = d_owner->flatten();
+        timer.phase(trace::event_type::FLATTEN);
+        new_ffg->validate();
+        timer.phase(trace::event_type::VALIDATE);
+        std::set<basic_block_sptr> running =
+            d_scheduler->stop_blocks(new_ffg->calc_changed_blocks(d_ffg));
+        new_ffg->merge_connections(d_ffg, running);
+        d_ffg = new_ffg;
+        timer.phase(trace::event_type::ALLOCATE);
+        d_scheduler->start_blocks(d_ffg);
+        timer.phase(trace::event_type::START);
+        GR_LOG_DEBUG(d_debug_logger, "reconfigured in " + timer.summary());
+
+        // wait() may have seen all threads gone in between
+        d_retry_wait = true;
+        return;
+    }
+
     wait_for_jobs();
 
     // Create new simple flow graph
+    startup_timer timer;
     flat_flowgraph_sptr new_ffg = d_owner->flatten();
-    new_ffg->validate();               // check consistency, sanity, etc
+    timer.phase(trace::event_type::FLATTEN);
+    new_ffg->validate(); // check consistency, sanity, etc
+    timer.phase(trace::event_type::VALIDATE);
     new_ffg->merge_connections(d_ffg); // reuse buffers, etc
     d_ffg = new_ffg;
+    timer.phase(trace::event_type::ALLOCATE);
 
     // Create a new scheduler to execute it
     d_scheduler = make_scheduler(d_ffg, d_max_noutput_items, d_catch_exceptions);
     d_retry_wait = true;
+    timer.phase(trace::event_type::START);
+    GR_LOG_DEBUG(d_debug_logger, "restarted in " + timer.summary());
 }
 
 std::string top_block_impl::edge_list()
@@ -222,6 +315,14 @@ std::string top_block_impl::msg_edge_list()
         return "";
 }
 
+std::string top_block_impl::buffer_size_list()
+{
+    if (d_ffg)
+        return d_ffg->buffer_size_list();
+    else
+        return "";
+}
+
 void top_block_impl::dump()
 {
     if (d_ffg)
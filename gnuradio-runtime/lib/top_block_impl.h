@@ -51,6 +51,9 @@ public:
     // Return a string list of msg edges
     std::string msg_edge_list();
 
+    // Return a string list of output buffer sizes
+    std::string buffer_size_list();
+
     // Dump the flowgraph to stdout
     void dump();
 
@@ -74,6 +77,7 @@ protected:
     boost::condition_variable d_lock_cond;
     int d_max_noutput_items;
     bool d_catch_exceptions;
+    bool d_incremental; // only stop the blocks a reconfiguration changes
 
 private:
     void restart();
@@ -12,14 +12,180 @@
 #include <config.h>
 #endif
 
+#include "scheduler_trace.h"
 #include <gnuradio/block.h>
 #include <gnuradio/block_detail.h>
 #include <gnuradio/buffer.h>
 #include <gnuradio/buffer_reader.h>
+#include <gnuradio/prefs.h>
 #include <gnuradio/tpb_detail.h>
+#include <algorithm>
+#include <chrono>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#define GR_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define GR_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define GR_CPU_RELAX()
+#endif
 
 namespace gr {
 
+static int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+tpb_detail::tpb_detail()
+    : input_changed(false),
+      output_changed(false),
+      d_nsleepers(0),
+      d_has_wakeup(false),
+      d_spin_ns(0),
+      d_max_spin_ns(0),
+      d_eventcount(false)
+{
+    long spin_us = prefs::singleton()->get_long("Scheduler", "tpb_max_spin_us", 0);
+    // Spinning on a single CPU only keeps the thread we wait for off it
+    if (boost::thread::hardware_concurrency() > 1)
+        d_max_spin_ns = std::max(0L, spin_us) * 1000;
+    d_spin_ns = d_max_spin_ns;
+    d_eventcount = d_max_spin_ns > 0;
+}
+
+void tpb_detail::set_wakeup(std::function<void()> f)
+{
+    gr::thread::scoped_lock guard(mutex);
+    d_has_wakeup = static_cast<bool>(f);
+    wakeup = std::move(f);
+}
+
+void tpb_detail::set_changed(std::atomic<bool>& changed,
+                             gr::thread::condition_variable& cond)
+{
+    if (!d_eventcount) {
+        gr::thread::scoped_lock guard(mutex);
+        changed.store(true, std::memory_order_relaxed);
+        cond.notify_one();
+        if (wakeup)
+            wakeup();
+        return;
+    }
+
+    // The fence orders the buffer updates we are notifying about before
+    // the flag (see clear_changed). Setting the flag and checking for
+    // sleepers are both seq_cst, as are their counterparts in
+    // wait_changed, so either we see the sleeper or it sees the flag.
+    // If nobody is about to sleep, that's all; no lock and no syscall.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    changed.exchange(true, std::memory_order_seq_cst);
+
+    if (d_nsleepers.load(std::memory_order_seq_cst) > 0) {
+        gr::thread::scoped_lock guard(mutex);
+        cond.notify_one();
+    }
+
+    if (d_has_wakeup.load(std::memory_order_acquire)) {
+        gr::thread::scoped_lock guard(mutex);
+        if (wakeup)
+            wakeup();
+    }
+}
+
+void tpb_detail::notify_msg()
+{
+    if (!d_eventcount) {
+        gr::thread::scoped_lock guard(mutex);
+        input_changed.store(true, std::memory_order_relaxed);
+        input_cond.notify_one();
+        output_changed.store(true, std::memory_order_relaxed);
+        output_cond.notify_one();
+        if (wakeup)
+            wakeup();
+        return;
+    }
+
+    set_changed(input_changed, input_cond);
+    set_changed(output_changed, output_cond);
+}
+
+namespace {
+// Announces a sleeper for as long as it is in scope; waiting on a
+// condition variable is an interruption point, stop() may unwind it.
+class sleeper_guard
+{
+public:
+    sleeper_guard(std::atomic<int>& nsleepers) : d_nsleepers(nsleepers)
+    {
+        d_nsleepers.fetch_add(1, std::memory_order_seq_cst);
+    }
+    ~sleeper_guard() { d_nsleepers.fetch_sub(1, std::memory_order_relaxed); }
+
+private:
+    std::atomic<int>& d_nsleepers;
+};
+} // namespace
+
+void tpb_detail::sleep_changed(std::atomic<bool>& changed,
+                               gr::thread::condition_variable& cond,
+                               long timeout_ms)
+{
+    gr::thread::scoped_lock guard(mutex);
+    if (timeout_ms > 0) {
+        if (!changed.load(std::memory_order_seq_cst)) {
+            cond.timed_wait(guard, boost::posix_time::milliseconds(timeout_ms));
+        }
+    } else {
+        while (!changed.load(std::memory_order_seq_cst)) {
+            cond.wait(guard);
+        }
+    }
+}
+
+void tpb_detail::wait_changed(std::atomic<bool>& changed,
+                              gr::thread::condition_variable& cond,
+                              long timeout_ms)
+{
+    if (!d_eventcount) {
+        sleep_changed(changed, cond, timeout_ms);
+        return;
+    }
+
+    int64_t start = now_ns();
+
+    // Spin for a while first; waking a sleeping thread costs a couple of
+    // syscalls and tens of microseconds of latency.
+    if (d_spin_ns > 0) {
+        int64_t deadline = start + d_spin_ns;
+        do {
+            for (int i = 0; i < 64; i++) {
+                if (changed.load(std::memory_order_acquire))
+                    goto done;
+                GR_CPU_RELAX();
+            }
+        } while (now_ns() < deadline);
+    }
+
+    {
+        sleeper_guard sleeping(d_nsleepers);
+        sleep_changed(changed, cond, timeout_ms);
+    }
+
+done:
+    // Adapt the spin budget: a wait that a bit more spinning would have
+    // covered raises it, a long one halves it so idle blocks stop
+    // burning CPU.
+    int64_t waited = now_ns() - start;
+    if (waited < d_max_spin_ns)
+        d_spin_ns = std::min(d_max_spin_ns, std::max(d_spin_ns, 2 * waited));
+    else
+        d_spin_ns /= 2;
+}
+
 /*
  * We assume that no worker threads are ever running when the graph
  * structure is being manipulated, thus it's safe for us to poke
@@ -33,7 +199,10 @@ void tpb_detail::notify_upstream(block_detail* d)
 
     for (size_t i = 0; i < d->d_input.size(); i++) {
         // Can you say, "pointer chasing?"
-        d->d_input[i]->buffer()->link()->detail()->d_tpb.set_output_changed();
+        block_sptr up = d->d_input[i]->buffer()->link();
+        up->detail()->d_tpb.set_output_changed();
+        if (trace::enabled())
+            trace::notify(d->d_input[i]->link()->unique_id(), up->unique_id());
     }
 }
 
@@ -44,8 +213,12 @@ void tpb_detail::notify_downstream(block_detail* d)
 
     for (size_t i = 0; i < d->d_output.size(); i++) {
         buffer_sptr buf = d->d_output[i];
-        for (size_t j = 0, k = buf->nreaders(); j < k; j++)
-            buf->reader(j)->link()->detail()->d_tpb.set_input_changed();
+        for (size_t j = 0, k = buf->nreaders(); j < k; j++) {
+            block_sptr down = buf->reader(j)->link();
+            down->detail()->d_tpb.set_input_changed();
+            if (trace::enabled())
+                trace::notify(buf->link()->unique_id(), down->unique_id());
+        }
     }
 }
 
@@ -12,15 +12,47 @@
 #include <config.h>
 #endif
 
+#include "numa.h"
+#include "scheduler_trace.h"
 #include "tpb_thread_body.h"
 #include <gnuradio/prefs.h>
 #include <pmt/pmt.h>
 #include <boost/format.hpp>
 #include <boost/thread.hpp>
 #include <iostream>
+#include <vector>
 
 namespace gr {
 
+void tpb_thread_body::handle_msgs(block* b,
+                                  std::vector<pmt::pmt_t>& msgs,
+                                  size_t max_nmsgs,
+                                  gr::logger_ptr logger)
+{
+    for (auto& i : b->msg_queue) {
+        if (i.second.empty())
+            continue;
+
+        // Check if we have a message handler attached before getting
+        // any messages. This is mostly a protection for the unknown
+        // startup sequence of the threads.
+        if (b->has_msg_handler(i.first)) {
+            // only what's queued now, producers may keep pushing
+            i.second.drain(msgs, i.second.size());
+            b->dispatch_msgs(i.first, msgs);
+            msgs.clear();
+        } else {
+            // If we don't have a handler but are building up messages,
+            // prune the queue from the front to keep memory in check.
+            if (i.second.size() > max_nmsgs) {
+                GR_LOG_WARN(logger,
+                            "asynchronous message buffer overflowing, dropping message");
+                i.second.pop();
+            }
+        }
+    }
+}
+
 tpb_thread_body::tpb_thread_body(block_sptr block,
                                  gr::thread::barrier_sptr start_sync,
                                  int max_noutput_items)
@@ -41,7 +73,7 @@ tpb_thread_body::tpb_thread_body(block_sptr block,
 
     block_detail* d = block->detail().get();
     block_executor::state s;
-    pmt::pmt_t msg;
+    std::vector<pmt::pmt_t> msgs; // drained from one port at a time
 
     d->threaded = true;
     d->thread = gr::thread::get_current_thread_id();
@@ -70,6 +102,9 @@ tpb_thread_body::tpb_thread_body(block_sptr block,
     // Set thread affinity if it was set before fg was started.
     if (!block->processor_affinity().empty()) {
         gr::thread::thread_bind_to_processor(d->thread, block->processor_affinity());
+    } else if (d->numa_node() >= 0) {
+        // otherwise stay on the NUMA node our buffers were placed on
+        gr::thread::thread_bind_to_processor(d->thread, numa::node_cpus(d->numa_node()));
     }
 
     // Set thread priority if it was set before fg was started
@@ -87,24 +122,7 @@ tpb_thread_body::tpb_thread_body(block_sptr block,
         d->d_tpb.clear_changed();
 
         // handle any queued up messages
-        for (const auto& i : block->msg_queue) {
-            // Check if we have a message handler attached before getting
-            // any messages. This is mostly a protection for the unknown
-            // startup sequence of the threads.
-            if (block->has_msg_handler(i.first)) {
-                while ((msg = block->delete_head_nowait(i.first))) {
-                    block->dispatch_msg(i.first, msg);
-                }
-            } else {
-                // If we don't have a handler but are building up messages,
-                // prune the queue from the front to keep memory in check.
-                if (block->nmsgs(i.first) > max_nmsgs) {
-                    GR_LOG_WARN(
-                        LOG, "asynchronous message buffer overflowing, dropping message");
-                    msg = block->delete_head_nowait(i.first);
-                }
-            }
-        }
+        handle_msgs(block.get(), msgs, max_nmsgs, LOG);
 
         // run one iteration if we are a connected stream block
         if (d->noutputs() > 0 || d->ninputs() > 0) {
@@ -140,23 +158,14 @@ tpb_thread_body::tpb_thread_body(block_sptr block,
             d->d_tpb.notify_neighbors(d);
             return;
 
-        case block_executor::BLKD_IN: // Wait for input.
-        {
-            gr::thread::scoped_lock guard(d->d_tpb.mutex);
-
-            if (!d->d_tpb.input_changed) {
-                boost::system_time const timeout =
-                    boost::get_system_time() + boost::posix_time::milliseconds(250);
-                d->d_tpb.input_cond.timed_wait(guard, timeout);
-            }
+        case block_executor::BLKD_IN: { // Wait for input.
+            trace::scope span(trace::event_type::BLKD_IN, block->unique_id());
+            d->d_tpb.wait_input(250);
         } break;
 
-        case block_executor::BLKD_OUT: // Wait for output buffer space.
-        {
-            gr::thread::scoped_lock guard(d->d_tpb.mutex);
-            while (!d->d_tpb.output_changed) {
-                d->d_tpb.output_cond.wait(guard);
-            }
+        case block_executor::BLKD_OUT: { // Wait for output buffer space.
+            trace::scope span(trace::event_type::BLKD_OUT, block->unique_id());
+            d->d_tpb.wait_output();
         } break;
 
         default:
@@ -167,4 +176,122 @@ tpb_thread_body::tpb_thread_body(block_sptr block,
 
 tpb_thread_body::~tpb_thread_body() {}
 
+tpb_chain_thread_body::tpb_chain_thread_body(const block_vector_t& blocks,
+                                             gr::thread::barrier_sptr start_sync,
+                                             int max_noutput_items)
+{
+    thread::set_thread_name(gr::thread::get_current_thread_id(),
+                            boost::str(boost::format("%s%d+%d") % blocks[0]->name() %
+                                       blocks[0]->unique_id() % (blocks.size() - 1)));
+
+    prefs* p = prefs::singleton();
+    size_t max_nmsgs = static_cast<size_t>(p->get_long("DEFAULT", "max_messages", 100));
+    gr::logger_ptr logger, debug_logger;
+    gr::configure_default_loggers(logger, debug_logger, "tpb_chain_thread_body");
+
+    // Detach from the blocks however we leave, before our tpb_detail
+    // goes away; the executors stop the blocks when they are reset.
+    struct cleanup {
+        const block_vector_t& blocks;
+        ~cleanup()
+        {
+            for (const auto& b : blocks)
+                b->detail()->d_tpb.set_wakeup(nullptr);
+        }
+    } guard{ blocks };
+
+    // Fused blocks have no affinity, but may be placed on a NUMA node
+    if (blocks[0]->detail()->numa_node() >= 0) {
+        gr::thread::thread_bind_to_processor(
+            gr::thread::get_current_thread_id(),
+            numa::node_cpus(blocks[0]->detail()->numa_node()));
+    }
+
+    for (const auto& b : blocks) {
+        block_detail* d = b->detail().get();
+        d->threaded = true;
+        d->thread = gr::thread::get_current_thread_id();
+
+        // make sure our blocks aren't finished
+        b->clear_finished();
+
+        // If set, use internal value instead of global value
+        int block_max_noutput_items = max_noutput_items;
+        if (b->is_set_max_noutput_items())
+            block_max_noutput_items = b->max_noutput_items();
+        d_execs.push_back(std::make_unique<block_executor>(b, block_max_noutput_items));
+
+        d->d_tpb.set_wakeup([this]() { d_tpb.notify_msg(); });
+    }
+
+    std::vector<pmt::pmt_t> msgs; // drained from one port at a time
+    size_t ndone = 0;
+    start_sync->wait();
+    while (1) {
+        boost::this_thread::interruption_point();
+
+        d_tpb.clear_changed();
+
+        // One pass over the chain, upstream first, so what a block just
+        // produced is consumed downstream while it is still in cache.
+        bool progress = false;
+        for (size_t i = 0; i < blocks.size(); i++) {
+            if (!d_execs[i])
+                continue;
+
+            block* b = blocks[i].get();
+            block_detail* d = b->detail().get();
+
+            // handle any queued up messages
+            tpb_thread_body::handle_msgs(b, msgs, max_nmsgs, logger);
+
+            block_executor::state s = d_execs[i]->run_one_iteration();
+
+            if (b->finished() && s == block_executor::READY_NO_OUTPUT) {
+                s = block_executor::DONE;
+                d->set_done(true);
+            }
+
+            switch (s) {
+            case block_executor::READY: // Tell neighbors we made progress.
+                d->d_tpb.notify_neighbors(d);
+                progress = true;
+                break;
+
+            case block_executor::READY_NO_OUTPUT: // Notify upstream only
+                d->d_tpb.notify_upstream(d);
+                progress = true;
+                break;
+
+            case block_executor::DONE: // This one's over; stop it.
+                b->notify_msg_neighbors();
+                d->d_tpb.notify_neighbors(d);
+                d_execs[i].reset();
+                progress = true;
+                ndone++;
+                break;
+
+            case block_executor::BLKD_IN:
+            case block_executor::BLKD_OUT:
+                break;
+
+            default:
+                throw std::runtime_error("possible memory corruption in scheduler");
+            }
+        }
+
+        if (ndone == blocks.size())
+            return;
+
+        // Nobody in the chain could do anything; wait for a neighbor
+        // (inside or outside the chain) to notify one of our blocks.
+        if (!progress) {
+            trace::scope span(trace::event_type::BLKD_IN, -1);
+            d_tpb.wait_input(250);
+        }
+    }
+}
+
+tpb_chain_thread_body::~tpb_chain_thread_body() {}
+
 } /* namespace gr */
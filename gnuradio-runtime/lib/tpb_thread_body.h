@@ -15,6 +15,9 @@
 #include <gnuradio/block.h>
 #include <gnuradio/block_detail.h>
 #include <gnuradio/thread/thread.h>
+#include <gnuradio/tpb_detail.h>
+#include <memory>
+#include <vector>
 
 namespace gr {
 
@@ -34,6 +37,40 @@ public:
                     thread::barrier_sptr start_sync,
                     int max_noutput_items = 100000);
     ~tpb_thread_body();
+
+    /*!
+     * Handle the messages queued up for block \p b: dispatch them to
+     * its handlers, or drop the oldest beyond \p max_nmsgs on ports
+     * without one. \p msgs is scratch space, left empty.
+     */
+    static void handle_msgs(block* b,
+                            std::vector<pmt::pmt_t>& msgs,
+                            size_t max_nmsgs,
+                            gr::logger_ptr logger);
+};
+
+/*!
+ * \brief The body of a thread-per-block thread that runs a fused
+ * chain of blocks (see flat_flowgraph::fused_chains()).
+ *
+ * The blocks keep their own executors and buffers, so tags, history
+ * and sample delays work as usual; they just take turns in one
+ * thread, upstream first, so each block reads what its upstream
+ * neighbor wrote moments before, and no thread has to be woken up to
+ * pass data along the chain. The constructor turns
+ * into the main loop which returns when all blocks are done or is
+ * interrupted.
+ */
+class GR_RUNTIME_API tpb_chain_thread_body
+{
+    std::vector<std::unique_ptr<block_executor>> d_execs;
+    tpb_detail d_tpb; // notified whenever one of the blocks is
+
+public:
+    tpb_chain_thread_body(const block_vector_t& blocks,
+                          thread::barrier_sptr start_sync,
+                          int max_noutput_items = 100000);
+    ~tpb_chain_thread_body();
 };
 
 } /* namespace gr */
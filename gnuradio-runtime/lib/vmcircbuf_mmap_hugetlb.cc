@@ -0,0 +1,166 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vmcircbuf_mmap_hugetlb.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdexcept>
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#include <boost/format.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// 2MB, the huge page size on x86-64 and most aarch64 systems
+#define GR_DEFAULT_HUGEPAGE_SIZE (2 * (1L << 20))
+
+namespace gr {
+
+// The size of the huge pages MFD_HUGETLB hands out
+static size_t hugepage_size()
+{
+    static const size_t s_size = []() {
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        size_t kb;
+        while (meminfo >> key) {
+            if (key == "Hugepagesize:" && meminfo >> kb)
+                return kb * 1024;
+            meminfo.ignore(256, '\n');
+        }
+        return (size_t)GR_DEFAULT_HUGEPAGE_SIZE;
+    }();
+    return s_size;
+}
+
+vmcircbuf_mmap_hugetlb::vmcircbuf_mmap_hugetlb(size_t size) : gr::vmcircbuf(size)
+{
+#if !defined(HAVE_MMAP) || !defined(HAVE_MEMFD_CREATE)
+    GR_LOG_ERROR(d_logger, "mmap or memfd_create is not available");
+    throw std::runtime_error("gr::vmcircbuf_mmap_hugetlb");
+#else
+    gr::thread::scoped_lock guard(s_vm_mutex);
+
+    size_t hugepage = hugepage_size();
+
+    if (size <= 0 || (size % hugepage) != 0) {
+        GR_LOG_ERROR(d_logger, "invalid size =" + std::to_string(size));
+        throw std::runtime_error("gr::vmcircbuf_mmap_hugetlb");
+    }
+
+    int fd = memfd_create("gnuradio", MFD_CLOEXEC | MFD_HUGETLB);
+    if (fd == -1) {
+        GR_LOG_DEBUG(d_debug_logger,
+                     boost::format("memfd_create failed: %s") % strerror(errno));
+        throw std::runtime_error("gr::vmcircbuf_mmap_hugetlb");
+    }
+
+    if (ftruncate(fd, (off_t)size) == -1) {
+        close(fd); // cleanup
+        GR_LOG_DEBUG(d_debug_logger,
+                     boost::format("ftruncate failed: %s") % strerror(errno));
+        throw std::runtime_error("gr::vmcircbuf_mmap_hugetlb");
+    }
+
+    // Reserve an address range for both copies, aligned to a huge page
+    // (which mappings of huge pages have to be), and drop the slack.
+    char* reserved = (char*)mmap(0,
+                                 2 * size + hugepage,
+                                 PROT_NONE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                                 -1,
+                                 (off_t)0);
+    if (reserved == MAP_FAILED) {
+        close(fd); // cleanup
+        GR_LOG_ERROR(d_logger, "mmap (1) failed");
+        throw std::runtime_error("gr::vmcircbuf_mmap_hugetlb");
+    }
+
+    char* first_copy =
+        (char*)(((uintptr_t)reserved + hugepage - 1) & ~(uintptr_t)(hugepage - 1));
+    if (first_copy > reserved)
+        munmap(reserved, first_copy - reserved);
+    munmap(first_copy + 2 * size, reserved + hugepage - first_copy);
+
+    // Map the segment twice, back to back. This is where the huge pages
+    // are reserved; if there aren't enough, the mmap fails.
+    for (int i = 0; i < 2; i++) {
+        void* copy = mmap(first_copy + i * size,
+                          size,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_FIXED,
+                          fd,
+                          (off_t)0);
+        if (copy == MAP_FAILED) {
+            GR_LOG_DEBUG(d_debug_logger,
+                         boost::format("mmap (%d) failed: %s") % (i + 2) %
+                             strerror(errno));
+            munmap(first_copy, 2 * size);
+            close(fd); // cleanup
+            throw std::runtime_error("gr::vmcircbuf_mmap_hugetlb");
+        }
+    }
+
+    close(fd); // fd no longer needed.  The mapping is retained.
+
+    // Now remember the important stuff
+    d_base = first_copy;
+    d_size = size;
+#endif
+}
+
+vmcircbuf_mmap_hugetlb::~vmcircbuf_mmap_hugetlb()
+{
+#if defined(HAVE_MMAP)
+    gr::thread::scoped_lock guard(s_vm_mutex);
+
+    if (munmap(d_base, 2 * d_size) == -1) {
+        GR_LOG_ERROR(d_logger, "munmap (2) failed");
+    }
+#endif
+}
+
+// ----------------------------------------------------------------
+//			The factory interface
+// ----------------------------------------------------------------
+
+// Made up front: buffer_double_mapped asks for it without holding the
+// vmcircbuf lock, and several flowgraphs may start at the same time
+gr::vmcircbuf_factory* vmcircbuf_mmap_hugetlb_factory::s_the_factory =
+    new gr::vmcircbuf_mmap_hugetlb_factory();
+
+gr::vmcircbuf_factory* vmcircbuf_mmap_hugetlb_factory::singleton()
+{
+    return s_the_factory;
+}
+
+int vmcircbuf_mmap_hugetlb_factory::granularity() { return hugepage_size(); }
+
+gr::vmcircbuf* vmcircbuf_mmap_hugetlb_factory::make(size_t size)
+{
+    try {
+        return new vmcircbuf_mmap_hugetlb(size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+} /* namespace gr */
@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GR_VMCIRCBUF_MMAP_HUGETLB_H
+#define GR_VMCIRCBUF_MMAP_HUGETLB_H
+
+#include "vmcircbuf.h"
+#include <gnuradio/api.h>
+
+namespace gr {
+
+/*!
+ * \brief concrete class to implement circular buffers with mmap and
+ * huge pages (memfd_create with MFD_HUGETLB)
+ * \ingroup internal
+ *
+ * Huge pages are reserved when the buffer is mapped, so running out
+ * of them makes the constructor throw rather than the first access
+ * fault.
+ */
+class GR_RUNTIME_API vmcircbuf_mmap_hugetlb : public gr::vmcircbuf
+{
+public:
+    vmcircbuf_mmap_hugetlb(size_t size);
+    ~vmcircbuf_mmap_hugetlb() override;
+};
+
+/*!
+ * \brief concrete factory for circular buffers built using mmap and huge pages
+ *
+ * Not one of vmcircbuf_sysconfig::all_factories(), since its
+ * granularity (the default huge page size, typically 2 MB) is far too
+ * coarse for most buffers. buffer_double_mapped uses it for large
+ * buffers if the [DEFAULT] hugepage_buffers preference is set, and
+ * falls back to the default factory if it fails.
+ */
+class GR_RUNTIME_API vmcircbuf_mmap_hugetlb_factory : public gr::vmcircbuf_factory
+{
+private:
+    static gr::vmcircbuf_factory* s_the_factory;
+
+public:
+    static gr::vmcircbuf_factory* singleton();
+
+    const char* name() const override { return "gr::vmcircbuf_mmap_hugetlb_factory"; }
+
+    /*!
+     * \brief return granularity of mapping, the default huge page size
+     */
+    int granularity() override;
+
+    /*!
+     * \brief return a gr::vmcircbuf, or 0 if unable.
+     *
+     * Call this to create a doubly mapped circular buffer.
+     */
+    gr::vmcircbuf* make(size_t size) override;
+};
+
+} /* namespace gr */
+
+#endif /* GR_VMCIRCBUF_MMAP_HUGETLB_H */
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(basic_block.h)                                             */
-/* BINDTOOL_HEADER_FILE_HASH(5c1d5b8a3666a2e0e7a6fafae07afa29)                     */
+/* BINDTOOL_HEADER_FILE_HASH(25a43d32ca288a248c4e189339896ec3)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -194,26 +194,23 @@ void bind_basic_block(py::module& m)
              D(basic_block, delete_head_nowait))
 
 
-        .def("get_iterator",
-             &basic_block::get_iterator,
-             py::arg("which_port"),
-             D(basic_block, get_iterator))
-
-
-        .def("erase_msg",
-             &basic_block::erase_msg,
-             py::arg("which_port"),
-             py::arg("it"),
-             D(basic_block, erase_msg))
-
-
         .def("has_msg_port",
              &basic_block::has_msg_port,
              py::arg("which_port"),
              D(basic_block, has_msg_port))
 
 
-        .def("get_msg_map", &basic_block::get_msg_map, D(basic_block, get_msg_map))
+        // A snapshot of the queued messages, as the std::deque based
+        // queues used to be converted
+        .def(
+            "get_msg_map",
+            [](const basic_block& self) {
+                std::map<pmt::pmt_t, std::vector<pmt::pmt_t>, pmt::comparator> msgs;
+                for (const auto& queue : self.get_msg_map())
+                    msgs[queue.first].assign(queue.second.begin(), queue.second.end());
+                return msgs;
+            },
+            D(basic_block, get_msg_map))
 
 
         // .def("add_rpc_variable",&basic_block::add_rpc_variable,
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(block_detail.h)                                            */
-/* BINDTOOL_HEADER_FILE_HASH(61794baf0e727516eb0eedc08753a17a)                     */
+/* BINDTOOL_HEADER_FILE_HASH(d406a32ba91b8d5d5c7ada9de735e661)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -184,6 +184,15 @@ void bind_block_detail(py::module& m)
              D(block_detail, unset_processor_affinity))
 
 
+        .def("numa_node", &block_detail::numa_node, D(block_detail, numa_node))
+
+
+        .def("set_numa_node",
+             &block_detail::set_numa_node,
+             py::arg("node"),
+             D(block_detail, set_numa_node))
+
+
         .def("thread_priority",
              &block_detail::thread_priority,
              D(block_detail, thread_priority))
@@ -335,6 +344,11 @@ void bind_block_detail(py::module& m)
              D(block_detail, pc_work_time_total))
 
 
+        .def("pc_numa_node_bytes",
+             &block_detail::pc_numa_node_bytes,
+             D(block_detail, pc_numa_node_bytes))
+
+
         .def("consumed", &block_detail::consumed, D(block_detail, consumed))
 
         ;
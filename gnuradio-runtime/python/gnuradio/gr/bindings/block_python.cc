@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(block.h)                                                   */
-/* BINDTOOL_HEADER_FILE_HASH(1c265259ee70fb7b389cc57a9334a1f1)                     */
+/* BINDTOOL_HEADER_FILE_HASH(1f98b7abf5a91e256c48fb60b040971c)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -391,6 +391,11 @@ void bind_block(py::module& m)
         .def("pc_throughput_avg", &block::pc_throughput_avg, D(block, pc_throughput_avg))
 
 
+        .def("pc_numa_node_bytes",
+             &block::pc_numa_node_bytes,
+             D(block, pc_numa_node_bytes))
+
+
         .def("reset_perf_counters",
              &block::reset_perf_counters,
              D(block, reset_perf_counters))
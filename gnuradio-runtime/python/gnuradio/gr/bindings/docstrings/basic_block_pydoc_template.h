@@ -66,6 +66,9 @@ static const char* __doc_gr_basic_block_message_port_register_out = R"doc()doc";
 static const char* __doc_gr_basic_block_message_port_pub = R"doc()doc";
 
 
+static const char* __doc_gr_basic_block_message_port_pub_batch = R"doc()doc";
+
+
 static const char* __doc_gr_basic_block_message_port_sub = R"doc()doc";
 
 
@@ -90,6 +90,12 @@ static const char* __doc_gr_block_detail_set_processor_affinity = R"doc()doc";
 static const char* __doc_gr_block_detail_unset_processor_affinity = R"doc()doc";
 
 
+static const char* __doc_gr_block_detail_numa_node = R"doc()doc";
+
+
+static const char* __doc_gr_block_detail_set_numa_node = R"doc()doc";
+
+
 static const char* __doc_gr_block_detail_thread_priority = R"doc()doc";
 
 
@@ -174,6 +180,9 @@ static const char* __doc_gr_block_detail_pc_work_time_var = R"doc()doc";
 static const char* __doc_gr_block_detail_pc_work_time_total = R"doc()doc";
 
 
+static const char* __doc_gr_block_detail_pc_numa_node_bytes = R"doc()doc";
+
+
 static const char* __doc_gr_block_detail_consumed = R"doc()doc";
 
 
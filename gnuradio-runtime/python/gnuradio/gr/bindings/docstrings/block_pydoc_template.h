@@ -231,6 +231,9 @@ static const char* __doc_gr_block_pc_work_time_total = R"doc()doc";
 static const char* __doc_gr_block_pc_throughput_avg = R"doc()doc";
 
 
+static const char* __doc_gr_block_pc_numa_node_bytes = R"doc()doc";
+
+
 static const char* __doc_gr_block_reset_perf_counters = R"doc()doc";
 
 
@@ -15,9 +15,18 @@
  */
 
 
+static const char* __doc_gr_metadata_keys_packet_len = R"doc()doc";
+
+
 static const char* __doc_gr_metadata_keys_pdu_num = R"doc()doc";
 
 
+static const char* __doc_gr_metadata_keys_rx_freq = R"doc()doc";
+
+
+static const char* __doc_gr_metadata_keys_rx_rate = R"doc()doc";
+
+
 static const char* __doc_gr_metadata_keys_rx_time = R"doc()doc";
 
 
@@ -42,6 +42,9 @@ static const char* __doc_gr_top_block_edge_list = R"doc()doc";
 static const char* __doc_gr_top_block_msg_edge_list = R"doc()doc";
 
 
+static const char* __doc_gr_top_block_buffer_size_list = R"doc()doc";
+
+
 static const char* __doc_gr_top_block_dump = R"doc()doc";
 
 
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(flowgraph.h)                                               */
-/* BINDTOOL_HEADER_FILE_HASH(53d5d6556e06c6423bdcb73f499fa305)                     */
+/* BINDTOOL_HEADER_FILE_HASH(b760a7747460f3bea08be0198b205870)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
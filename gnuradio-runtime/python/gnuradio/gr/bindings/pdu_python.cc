@@ -45,9 +45,18 @@ void bind_pdu(py::module& m)
 
     py::module m_metadata_keys = m.def_submodule("metadata_keys");
 
+    m_metadata_keys.def(
+        "packet_len", &::gr::metadata_keys::packet_len, D(metadata_keys, packet_len));
+
     m_metadata_keys.def(
         "pdu_num", &::gr::metadata_keys::pdu_num, D(metadata_keys, pdu_num));
 
+    m_metadata_keys.def(
+        "rx_freq", &::gr::metadata_keys::rx_freq, D(metadata_keys, rx_freq));
+
+    m_metadata_keys.def(
+        "rx_rate", &::gr::metadata_keys::rx_rate, D(metadata_keys, rx_rate));
+
     m_metadata_keys.def(
         "rx_time", &::gr::metadata_keys::rx_time, D(metadata_keys, rx_time));
 
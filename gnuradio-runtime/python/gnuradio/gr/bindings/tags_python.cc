@@ -15,7 +15,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(tags.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(25435955fa46de2924e0b648c4f8dd43)                     */
+/* BINDTOOL_HEADER_FILE_HASH(a6ddbbdad02f168486509a4bd08f37dd)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(top_block.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(96d9ff1131a52a5089606f658e0ff48e)                     */
+/* BINDTOOL_HEADER_FILE_HASH(c6c00a41a642e8989d656f86bfaa1d65)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -111,6 +111,11 @@ void bind_top_block(py::module& m)
         .def("msg_edge_list", &top_block::msg_edge_list, D(top_block, msg_edge_list))
 
 
+        .def("buffer_size_list",
+             &top_block::buffer_size_list,
+             D(top_block, buffer_size_list))
+
+
         .def("dump", &top_block::dump, D(top_block, dump))
 
 
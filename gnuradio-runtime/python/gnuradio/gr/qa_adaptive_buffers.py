@@ -0,0 +1,64 @@
+#!/usr/bin/env python
+#
+# Copyright 2021 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+import os
+import time
+
+# Read whenever a flowgraph is reconfigured
+os.environ["GR_CONF_SCHEDULER_ADAPTIVE_BUFFERS"] = "True"
+
+from gnuradio import gr, gr_unittest, blocks
+
+
+def buffer_sizes(tb):
+    sizes = {}
+    for line in tb.buffer_size_list().splitlines():
+        port, nitems = line.split()[:2]
+        sizes[port] = int(nitems)
+    return sizes
+
+
+class test_adaptive_buffers (gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_001_sizes_listed(self):
+        src = blocks.null_source(gr.sizeof_float)
+        hd = blocks.head(gr.sizeof_float, 100000)
+        dst = blocks.null_sink(gr.sizeof_float)
+        self.tb.connect(src, hd, dst)
+        self.tb.run()
+        sizes = buffer_sizes(self.tb)
+        self.assertEqual(sorted(sizes.keys()),
+                         sorted([src.alias() + ":0", hd.alias() + ":0"]))
+        for nitems in sizes.values():
+            self.assertGreater(nitems, 0)
+
+    def test_002_run_after_resize(self):
+        # Whatever sizes are picked, the reconfiguration loses no items
+        src = blocks.null_source(gr.sizeof_float)
+        thr = blocks.throttle(gr.sizeof_float, 100000)
+        hd = blocks.head(gr.sizeof_float, 100000)
+        dst = blocks.vector_sink_f()
+        self.tb.connect(src, thr, hd, dst)
+        self.tb.start()
+        time.sleep(0.5)
+        self.tb.lock()
+        self.tb.unlock()
+        self.tb.wait()
+        self.assertEqual(100000, len(dst.data()))
+
+
+if __name__ == '__main__':
+    gr_unittest.run(test_adaptive_buffers)
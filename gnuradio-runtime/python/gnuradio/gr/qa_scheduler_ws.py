@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+#
+# Copyright 2021 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+import os
+import time
+
+# The scheduler is picked once per process, on the first start()
+os.environ["GR_SCHEDULER"] = "WS"
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+
+
+class test_scheduler_ws (gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_000_empty_fg(self):
+        self.tb.start()
+        self.tb.stop()
+        self.tb.wait()
+
+    def test_001_long_chain(self):
+        src_data = list(range(100000))
+        src = blocks.vector_source_i(src_data)
+        dst = blocks.vector_sink_i()
+        upstream = src
+        for i in range(40):
+            op = blocks.copy(gr.sizeof_int)
+            self.tb.connect(upstream, op)
+            upstream = op
+        self.tb.connect(upstream, dst)
+        self.tb.run()
+        self.assertEqual(src_data, dst.data())
+
+    def test_002_fan_out(self):
+        src_data = list(range(100000))
+        src = blocks.vector_source_i(src_data)
+        dsts = []
+        for i in range(32):
+            op = blocks.copy(gr.sizeof_int)
+            dst = blocks.vector_sink_i()
+            self.tb.connect(src, op, dst)
+            dsts.append(dst)
+        self.tb.run()
+        for dst in dsts:
+            self.assertEqual(src_data, dst.data())
+
+    def test_003_tags(self):
+        src_data = list(range(1000))
+        tags = [gr.python_to_tag((i, pmt.intern("key"), pmt.from_long(i)))
+                for i in range(0, 1000, 100)]
+        src = blocks.vector_source_i(src_data, False, 1, tags)
+        op = blocks.copy(gr.sizeof_int)
+        dst = blocks.vector_sink_i()
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        self.assertEqual(src_data, dst.data())
+        self.assertEqual([t.offset for t in dst.tags()], list(range(0, 1000, 100)))
+
+    def test_004_messages(self):
+        strobe = blocks.message_strobe(pmt.intern("hello"), 10)
+        dbg = blocks.message_debug()
+        self.tb.msg_connect(strobe, "strobe", dbg, "store")
+        self.tb.start()
+        time.sleep(0.5)
+        self.tb.stop()
+        self.tb.wait()
+        self.assertGreater(dbg.num_messages(), 0)
+
+    def test_005_stop_free_running(self):
+        src = blocks.null_source(gr.sizeof_float)
+        dst = blocks.null_sink(gr.sizeof_float)
+        self.tb.connect(src, dst)
+        self.tb.start()
+        time.sleep(0.1)
+        self.tb.stop()
+        self.tb.wait()
+
+    def test_006_lock_unlock(self):
+        src = blocks.null_source(gr.sizeof_float)
+        op = blocks.copy(gr.sizeof_float)
+        dst = blocks.null_sink(gr.sizeof_float)
+        self.tb.connect(src, op, dst)
+        self.tb.start()
+        self.tb.lock()
+        self.tb.disconnect(src, op, dst)
+        self.tb.connect(src, dst)
+        self.tb.unlock()
+        time.sleep(0.1)
+        self.tb.stop()
+        self.tb.wait()
+
+
+if __name__ == '__main__':
+    gr_unittest.run(test_scheduler_ws)
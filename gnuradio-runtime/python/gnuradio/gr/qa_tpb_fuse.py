@@ -0,0 +1,90 @@
+#!/usr/bin/env python
+#
+# Copyright 2021 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+import os
+import time
+
+# Read whenever a flowgraph is set up
+os.environ["GR_CONF_SCHEDULER_TPB_FUSE_CHAINS"] = "True"
+os.environ["GR_CONF_SCHEDULER_TPB_FUSE_TILE_SIZE"] = "1024"
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+
+
+class test_tpb_fuse (gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_001_chain(self):
+        src_data = list(range(100000))
+        tags = [gr.python_to_tag((i, pmt.intern("key"), pmt.from_long(i)))
+                for i in range(0, 100000, 1000)]
+        src = blocks.vector_source_i(src_data, False, 1, tags)
+        dst = blocks.vector_sink_i()
+        upstream = src
+        for i in range(10):
+            op = blocks.add_const_ii(1)
+            self.tb.connect(upstream, op)
+            upstream = op
+        self.tb.connect(upstream, dst)
+        self.tb.run()
+        self.assertEqual([x + 10 for x in src_data], dst.data())
+        self.assertEqual([t.offset for t in dst.tags()],
+                         list(range(0, 100000, 1000)))
+
+    def test_002_fan_out(self):
+        # The blocks after the fan out fuse, the source doesn't
+        src_data = list(range(10000))
+        src = blocks.vector_source_i(src_data)
+        dsts = []
+        for i in range(4):
+            op0 = blocks.add_const_ii(1)
+            op1 = blocks.add_const_ii(i)
+            dst = blocks.vector_sink_i()
+            self.tb.connect(src, op0, op1, dst)
+            dsts.append(dst)
+        self.tb.run()
+        for i, dst in enumerate(dsts):
+            self.assertEqual([x + 1 + i for x in src_data], dst.data())
+
+    def test_003_stop_free_running(self):
+        src = blocks.null_source(gr.sizeof_float)
+        op0 = blocks.add_const_ff(0)
+        op1 = blocks.add_const_ff(0)
+        dst = blocks.null_sink(gr.sizeof_float)
+        self.tb.connect(src, op0, op1, dst)
+        self.tb.start()
+        time.sleep(0.1)
+        self.tb.stop()
+        self.tb.wait()
+
+    def test_004_lock_unlock(self):
+        src = blocks.null_source(gr.sizeof_float)
+        op0 = blocks.add_const_ff(0)
+        op1 = blocks.add_const_ff(0)
+        dst = blocks.null_sink(gr.sizeof_float)
+        self.tb.connect(src, op0, op1, dst)
+        self.tb.start()
+        self.tb.lock()
+        self.tb.disconnect(op1, dst)
+        self.tb.connect(op1, blocks.add_const_ff(0), dst)
+        self.tb.unlock()
+        time.sleep(0.1)
+        self.tb.stop()
+        self.tb.wait()
+
+
+if __name__ == '__main__':
+    gr_unittest.run(test_tpb_fuse)
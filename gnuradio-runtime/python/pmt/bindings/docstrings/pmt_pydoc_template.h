@@ -693,6 +693,9 @@ static const char* __doc_pmt_is_dict = R"doc()doc";
 static const char* __doc_pmt_make_dict = R"doc()doc";
 
 
+static const char* __doc_pmt_make_hash_dict = R"doc()doc";
+
+
 static const char* __doc_pmt_dict_add = R"doc()doc";
 
 
@@ -837,6 +840,15 @@ static const char* __doc_pmt_serialize = R"doc()doc";
 static const char* __doc_pmt_deserialize = R"doc()doc";
 
 
+static const char* __doc_pmt_serialized_size = R"doc()doc";
+
+
+static const char* __doc_pmt_serialize_to_buffer = R"doc()doc";
+
+
+static const char* __doc_pmt_deserialize_from_buffer = R"doc()doc";
+
+
 static const char* __doc_pmt_dump_sizeof = R"doc()doc";
 
 
@@ -1048,77 +1048,77 @@ void bind_pmt(py::module& m)
 
 
     m.def("u8vector_elements",
-          (uint8_t const* (*)(pmt::pmt_t, size_t&)) & ::pmt::u8vector_elements,
+          (uint8_t const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::u8vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(u8vector_elements, 0));
 
 
     m.def("s8vector_elements",
-          (int8_t const* (*)(pmt::pmt_t, size_t&)) & ::pmt::s8vector_elements,
+          (int8_t const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::s8vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(s8vector_elements, 0));
 
 
     m.def("u16vector_elements",
-          (uint16_t const* (*)(pmt::pmt_t, size_t&)) & ::pmt::u16vector_elements,
+          (uint16_t const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::u16vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(u16vector_elements, 0));
 
 
     m.def("s16vector_elements",
-          (int16_t const* (*)(pmt::pmt_t, size_t&)) & ::pmt::s16vector_elements,
+          (int16_t const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::s16vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(s16vector_elements, 0));
 
 
     m.def("u32vector_elements",
-          (uint32_t const* (*)(pmt::pmt_t, size_t&)) & ::pmt::u32vector_elements,
+          (uint32_t const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::u32vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(u32vector_elements, 0));
 
 
     m.def("s32vector_elements",
-          (int32_t const* (*)(pmt::pmt_t, size_t&)) & ::pmt::s32vector_elements,
+          (int32_t const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::s32vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(s32vector_elements, 0));
 
 
     m.def("u64vector_elements",
-          (uint64_t const* (*)(pmt::pmt_t, size_t&)) & ::pmt::u64vector_elements,
+          (uint64_t const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::u64vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(u64vector_elements, 0));
 
 
     m.def("s64vector_elements",
-          (int64_t const* (*)(pmt::pmt_t, size_t&)) & ::pmt::s64vector_elements,
+          (int64_t const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::s64vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(s64vector_elements, 0));
 
 
     m.def("f32vector_elements",
-          (float const* (*)(pmt::pmt_t, size_t&)) & ::pmt::f32vector_elements,
+          (float const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::f32vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(f32vector_elements, 0));
 
 
     m.def("f64vector_elements",
-          (double const* (*)(pmt::pmt_t, size_t&)) & ::pmt::f64vector_elements,
+          (double const* (*)(pmt::pmt_t const&, size_t&)) & ::pmt::f64vector_elements,
           py::arg("v"),
           py::arg("len"),
           D(f64vector_elements, 0));
 
 
     m.def("c32vector_elements",
-          (std::complex<float> const* (*)(pmt::pmt_t, size_t&)) &
+          (std::complex<float> const* (*)(pmt::pmt_t const&, size_t&)) &
               ::pmt::c32vector_elements,
           py::arg("v"),
           py::arg("len"),
@@ -1126,7 +1126,7 @@ void bind_pmt(py::module& m)
 
 
     m.def("c64vector_elements",
-          (std::complex<double> const* (*)(pmt::pmt_t, size_t&)) &
+          (std::complex<double> const* (*)(pmt::pmt_t const&, size_t&)) &
               ::pmt::c64vector_elements,
           py::arg("v"),
           py::arg("len"),
@@ -1134,14 +1134,15 @@ void bind_pmt(py::module& m)
 
     m.def("u8vector_elements",
           (std::vector<unsigned char, std::allocator<unsigned char>> const (*)(
-              pmt::pmt_t)) &
+              pmt::pmt_t const&)) &
               ::pmt::u8vector_elements,
           py::arg("v"),
           D(u8vector_elements, 1));
 
 
     m.def("s8vector_elements",
-          (std::vector<signed char, std::allocator<signed char>> const (*)(pmt::pmt_t)) &
+          (std::vector<signed char, std::allocator<signed char>> const (*)(
+              pmt::pmt_t const&)) &
               ::pmt::s8vector_elements,
           py::arg("v"),
           D(s8vector_elements, 1));
@@ -1149,57 +1150,57 @@ void bind_pmt(py::module& m)
 
     m.def("u16vector_elements",
           (std::vector<unsigned short, std::allocator<unsigned short>> const (*)(
-              pmt::pmt_t)) &
+              pmt::pmt_t const&)) &
               ::pmt::u16vector_elements,
           py::arg("v"),
           D(u16vector_elements, 1));
 
 
     m.def("s16vector_elements",
-          (std::vector<short, std::allocator<short>> const (*)(pmt::pmt_t)) &
+          (std::vector<short, std::allocator<short>> const (*)(pmt::pmt_t const&)) &
               ::pmt::s16vector_elements,
           py::arg("v"),
           D(s16vector_elements, 1));
 
 
-    m.def(
-        "u32vector_elements",
-        (std::vector<unsigned int, std::allocator<unsigned int>> const (*)(pmt::pmt_t)) &
-            ::pmt::u32vector_elements,
-        py::arg("v"),
-        D(u32vector_elements, 1));
+    m.def("u32vector_elements",
+          (std::vector<unsigned int, std::allocator<unsigned int>> const (*)(
+              pmt::pmt_t const&)) &
+              ::pmt::u32vector_elements,
+          py::arg("v"),
+          D(u32vector_elements, 1));
 
 
     m.def("s32vector_elements",
-          (std::vector<int, std::allocator<int>> const (*)(pmt::pmt_t)) &
+          (std::vector<int, std::allocator<int>> const (*)(pmt::pmt_t const&)) &
               ::pmt::s32vector_elements,
           py::arg("v"),
           D(s32vector_elements, 1));
 
 
     m.def("u64vector_elements",
-          (std::vector<uint64_t, std::allocator<uint64_t>> const (*)(pmt::pmt_t)) &
+          (std::vector<uint64_t, std::allocator<uint64_t>> const (*)(pmt::pmt_t const&)) &
               ::pmt::u64vector_elements,
           py::arg("v"),
           D(u64vector_elements, 1));
 
 
     m.def("s64vector_elements",
-          (std::vector<int64_t, std::allocator<int64_t>> const (*)(pmt::pmt_t)) &
+          (std::vector<int64_t, std::allocator<int64_t>> const (*)(pmt::pmt_t const&)) &
               ::pmt::s64vector_elements,
           py::arg("v"),
           D(s64vector_elements, 1));
 
 
     m.def("f32vector_elements",
-          (std::vector<float, std::allocator<float>> const (*)(pmt::pmt_t)) &
+          (std::vector<float, std::allocator<float>> const (*)(pmt::pmt_t const&)) &
               ::pmt::f32vector_elements,
           py::arg("v"),
           D(f32vector_elements, 1));
 
 
     m.def("f64vector_elements",
-          (std::vector<double, std::allocator<double>> const (*)(pmt::pmt_t)) &
+          (std::vector<double, std::allocator<double>> const (*)(pmt::pmt_t const&)) &
               ::pmt::f64vector_elements,
           py::arg("v"),
           D(f64vector_elements, 1));
@@ -1208,18 +1209,19 @@ void bind_pmt(py::module& m)
     m.def(
         "c32vector_elements",
         (std::vector<std::complex<float>, std::allocator<std::complex<float>>> const (*)(
-            pmt::pmt_t)) &
+            pmt::pmt_t const&)) &
             ::pmt::c32vector_elements,
         py::arg("v"),
         D(c32vector_elements, 1));
 
 
-    m.def("c64vector_elements",
-          (std::vector<std::complex<double>,
-                       std::allocator<std::complex<double>>> const (*)(pmt::pmt_t)) &
-              ::pmt::c64vector_elements,
-          py::arg("v"),
-          D(c64vector_elements, 1));
+    m.def(
+        "c64vector_elements",
+        (std::vector<std::complex<double>,
+                     std::allocator<std::complex<double>>> const (*)(pmt::pmt_t const&)) &
+            ::pmt::c64vector_elements,
+        py::arg("v"),
+        D(c64vector_elements, 1));
 
     m.def("uniform_vector_writable_elements",
           &::pmt::uniform_vector_writable_elements,
@@ -1318,6 +1320,9 @@ void bind_pmt(py::module& m)
     m.def("make_dict", &::pmt::make_dict, D(make_dict));
 
 
+    m.def("make_hash_dict", &::pmt::make_hash_dict, D(make_hash_dict));
+
+
     m.def("dict_add",
           &::pmt::dict_add,
           py::arg("dict"),
@@ -1504,6 +1509,9 @@ void bind_pmt(py::module& m)
     m.def("deserialize", &::pmt::deserialize, py::arg("source"), D(deserialize));
 
 
+    m.def("serialized_size", &::pmt::serialized_size, py::arg("obj"), D(serialized_size));
+
+
     m.def("dump_sizeof", &::pmt::dump_sizeof, D(dump_sizeof));
 
     m.def("length", &pmt::length, py::arg("v"));
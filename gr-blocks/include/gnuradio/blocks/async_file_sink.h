@@ -0,0 +1,80 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_ASYNC_FILE_SINK_H
+#define INCLUDED_GR_ASYNC_FILE_SINK_H
+
+#include <gnuradio/blocks/file_sink_base.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+namespace blocks {
+
+/*!
+ * \brief Write stream to file with several writes in flight.
+ * \ingroup file_operators_blk
+ *
+ * \details
+ * Like file_sink, but work() only copies the input into one of a ring of
+ * staging buffers; full buffers are written in the background, through
+ * io_uring on Linux or a small pool of threads elsewhere.  A latency spike
+ * of the disk is absorbed by the buffers instead of stalling the flowgraph.
+ *
+ * When every buffer is still being written, work() either waits
+ * (backpressure, counted by backpressure_waits() and backpressure_time())
+ * or, with \p drop set, throws away the input that doesn't fit
+ * (dropped_items()).
+ *
+ * With \p direct the file is written with O_DIRECT, past the page cache,
+ * where the file system supports it.  The last, partial buffer is written
+ * without it when the flowgraph stops or the file is closed, so the file
+ * keeps its exact length.
+ */
+class BLOCKS_API async_file_sink : virtual public sync_block,
+                                   virtual public file_sink_base
+{
+public:
+    // gr::blocks::async_file_sink::sptr
+    typedef std::shared_ptr<async_file_sink> sptr;
+
+    /*!
+     * \brief Make an async file sink.
+     * \param itemsize size of the input data items.
+     * \param filename name of the file to open and write output to.
+     * \param append if true, data is appended to the file instead of
+     *        overwriting the initial content.
+     * \param buffer_size bytes per staging buffer, rounded up to 4 kB.
+     * \param nbuffers number of staging buffers, and so of writes in flight.
+     * \param direct write with O_DIRECT.
+     * \param drop drop input instead of waiting when all buffers are in
+     *        flight.
+     */
+    static sptr make(size_t itemsize,
+                     const char* filename,
+                     bool append = false,
+                     size_t buffer_size = 4 * 1024 * 1024,
+                     int nbuffers = 8,
+                     bool direct = false,
+                     bool drop = false);
+
+    //! Items thrown away because all buffers were in flight
+    virtual uint64_t dropped_items() const = 0;
+
+    //! Number of work() calls that had to wait for a write to finish
+    virtual uint64_t backpressure_waits() const = 0;
+
+    //! Total time work() waited for writes to finish, in seconds
+    virtual double backpressure_time() const = 0;
+};
+
+} /* namespace blocks */
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_ASYNC_FILE_SINK_H */
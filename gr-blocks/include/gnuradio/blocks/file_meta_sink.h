@@ -54,6 +54,14 @@ enum gr_file_types {
  * the first header (at position 0 in the file) and reading where
  * the data segment starts plus the data segment size. Following
  * will either be a new header or EOF.
+ *
+ * With \p write_index a sidecar index (named filename.idx) lists the
+ * stream offset, rx_time, rate and file positions of every segment, so
+ * readers such as file_meta_source can seek by sample or time without
+ * walking the headers, and split a recording into segments they read in
+ * parallel. With detached headers and a \p max_segment_size that is a
+ * multiple of 4096 items, segments that are not cut short by a tag start
+ * on page boundaries of the data file.
  */
 class BLOCKS_API file_meta_sink : virtual public sync_block
 {
@@ -79,6 +87,8 @@ public:
      *    information.
      * \param detached_header (bool): Set to true to store the header
      *    info in a separate file (named filename.hdr)
+     * \param write_index (bool): Set to true to also write a segment
+     *    index (named filename.idx)
      */
     static sptr make(size_t itemsize,
                      const std::string& filename,
@@ -88,7 +98,8 @@ public:
                      bool complex = true,
                      size_t max_segment_size = 1000000,
                      pmt::pmt_t extra_dict = pmt::make_dict(),
-                     bool detached_header = false);
+                     bool detached_header = false,
+                     bool write_index = false);
 
     virtual bool open(const std::string& filename) = 0;
     virtual void close() = 0;
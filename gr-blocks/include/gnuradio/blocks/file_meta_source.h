@@ -35,6 +35,12 @@ namespace blocks {
  *
  * Any item inside of the extra header dictionary is ready out and
  * made into a stream tag.
+ *
+ * If the file was written with an index (filename.idx, see
+ * file_meta_sink), seek() and seek_time() jump to any sample with a
+ * binary search of the index instead of reading every header before it.
+ * The header tags of the segment are sent again at the new position,
+ * with rx_time advanced to the first item produced.
  */
 class BLOCKS_API file_meta_source : virtual public sync_block
 {
@@ -62,6 +68,20 @@ public:
                       const std::string& hdr_filename = "") = 0;
     virtual void close() = 0;
     virtual void do_update() = 0;
+
+    /*!
+     * \brief Continue at stream offset \p sample, counted from the start
+     * of the file. Needs an index; returns false if there is none or the
+     * sample is not covered by it.
+     */
+    virtual bool seek(uint64_t sample) = 0;
+
+    /*!
+     * \brief Continue at the first sample at or after rx_time
+     * \p secs + \p frac_secs. Needs an index; returns false if there is
+     * none or the recording starts later or ends before.
+     */
+    virtual bool seek_time(uint64_t secs, double frac_secs) = 0;
 };
 
 } /* namespace blocks */
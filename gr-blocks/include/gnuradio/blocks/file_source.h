@@ -42,17 +42,25 @@ public:
      * If \p len is non-zero, only items (offset, offset+len) will
      * be produced.
      *
+     * If \p use_mmap is turned on, regular files are memory mapped and
+     * downstream blocks read the items straight from the page cache,
+     * without copying them into the output buffer. After a repeat or a
+     * seek the items are copied until all readers have caught up. The
+     * file must not be truncated while it is mapped.
+     *
      * \param itemsize        the size of each item in the file, in bytes
      * \param filename        name of the file to source from
      * \param repeat  repeat file from start
      * \param offset  begin this many items into file
      * \param len     produce only items (offset, offset+len)
+     * \param use_mmap        read the file through a memory mapping
      */
     static sptr make(size_t itemsize,
                      const char* filename,
                      bool repeat = false,
                      uint64_t offset = 0,
-                     uint64_t len = 0);
+                     uint64_t len = 0,
+                     bool use_mmap = false);
 
     /*!
      * \brief seek file to \p seek_point relative to \p whence
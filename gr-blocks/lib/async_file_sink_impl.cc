@@ -0,0 +1,124 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "async_file_sink_impl.h"
+#include <gnuradio/io_signature.h>
+#include <boost/format.hpp>
+#include <algorithm>
+
+namespace gr {
+namespace blocks {
+
+async_file_sink::sptr async_file_sink::make(size_t itemsize,
+                                            const char* filename,
+                                            bool append,
+                                            size_t buffer_size,
+                                            int nbuffers,
+                                            bool direct,
+                                            bool drop)
+{
+    return gnuradio::make_block_sptr<async_file_sink_impl>(
+        itemsize, filename, append, buffer_size, nbuffers, direct, drop);
+}
+
+async_file_sink_impl::async_file_sink_impl(size_t itemsize,
+                                           const char* filename,
+                                           bool append,
+                                           size_t buffer_size,
+                                           int nbuffers,
+                                           bool direct,
+                                           bool drop)
+    : sync_block("async_file_sink",
+                 io_signature::make(1, 1, itemsize),
+                 io_signature::make(0, 0, 0)),
+      file_sink_base(filename, true, append),
+      d_itemsize(itemsize),
+      d_buffer_size(buffer_size),
+      d_nbuffers(nbuffers),
+      d_direct(direct),
+      d_drop(drop),
+      d_dropping(false),
+      d_dropped_items(0),
+      d_backpressure_waits(0),
+      d_backpressure_ns(0)
+{
+    if (nbuffers < 2)
+        throw std::invalid_argument("async_file_sink needs at least 2 buffers");
+}
+
+// The writer has to finish before file_sink_base closes the file under it
+async_file_sink_impl::~async_file_sink_impl() { d_writer.reset(); }
+
+void async_file_sink_impl::update_writer()
+{
+    if (d_updated) {
+        if (d_writer) {
+            d_writer->flush();
+            d_writer.reset();
+        }
+        do_update();
+    }
+
+    if (d_fp && !d_writer) {
+        d_writer.reset(new async_file_writer(
+            fileno(d_fp), d_buffer_size, d_nbuffers, d_direct, basic_block::d_logger));
+        GR_LOG_DEBUG(basic_block::d_debug_logger,
+                     boost::format("writing with %s") % d_writer->backend());
+    }
+}
+
+int async_file_sink_impl::work(int noutput_items,
+                               gr_vector_const_void_star& input_items,
+                               gr_vector_void_star& output_items)
+{
+    const char* inbuf = static_cast<const char*>(input_items[0]);
+
+    update_writer();
+
+    if (!d_writer)
+        return noutput_items; // drop output on the floor
+
+    int nitems = noutput_items;
+    if (d_drop) {
+        nitems = std::min<size_t>(noutput_items, d_writer->writable() / d_itemsize);
+        if (nitems < noutput_items) {
+            if (!d_dropping)
+                GR_LOG_WARN(basic_block::d_logger, "disk too slow, dropping samples");
+            d_dropped_items += noutput_items - nitems;
+        }
+        d_dropping = nitems < noutput_items;
+    }
+
+    double waited = d_writer->write(inbuf, nitems * d_itemsize);
+    if (waited > 0) {
+        d_backpressure_waits++;
+        d_backpressure_ns += waited * 1e9;
+    }
+
+    if (d_unbuffered)
+        d_writer->submit_partial();
+
+    return noutput_items;
+}
+
+bool async_file_sink_impl::stop()
+{
+    update_writer();
+    if (d_writer)
+        d_writer->flush();
+    return true;
+}
+
+} /* namespace blocks */
+} /* namespace gr */
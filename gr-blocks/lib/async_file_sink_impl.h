@@ -0,0 +1,63 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_ASYNC_FILE_SINK_IMPL_H
+#define INCLUDED_GR_ASYNC_FILE_SINK_IMPL_H
+
+#include "async_file_writer.h"
+#include <gnuradio/blocks/async_file_sink.h>
+#include <atomic>
+
+namespace gr {
+namespace blocks {
+
+class async_file_sink_impl : public async_file_sink
+{
+private:
+    const size_t d_itemsize;
+    const size_t d_buffer_size;
+    const int d_nbuffers;
+    const bool d_direct;
+    const bool d_drop;
+
+    std::unique_ptr<async_file_writer> d_writer;
+    bool d_dropping;
+
+    std::atomic<uint64_t> d_dropped_items;
+    std::atomic<uint64_t> d_backpressure_waits;
+    std::atomic<uint64_t> d_backpressure_ns;
+
+    void update_writer();
+
+public:
+    async_file_sink_impl(size_t itemsize,
+                         const char* filename,
+                         bool append,
+                         size_t buffer_size,
+                         int nbuffers,
+                         bool direct,
+                         bool drop);
+    ~async_file_sink_impl() override;
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+
+    bool stop() override;
+
+    uint64_t dropped_items() const override { return d_dropped_items; }
+    uint64_t backpressure_waits() const override { return d_backpressure_waits; }
+    double backpressure_time() const override { return d_backpressure_ns * 1e-9; }
+};
+
+} /* namespace blocks */
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_ASYNC_FILE_SINK_IMPL_H */
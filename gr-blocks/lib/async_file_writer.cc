@@ -0,0 +1,526 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "async_file_writer.h"
+#include <fcntl.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef HAVE_IO_H
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace gr {
+namespace blocks {
+
+namespace {
+// O_DIRECT wants buffers, lengths and offsets aligned to the logical block
+// size of the device; a page covers all common ones.
+constexpr size_t alignment = 4096;
+constexpr unsigned max_pool_threads = 4;
+
+int write_at(int fd, const char* data, size_t len, uint64_t offset)
+{
+    while (len > 0) {
+#ifdef _WIN32
+        // No positional writes; the pool has a single thread here.
+        if (_lseeki64(fd, offset, SEEK_SET) < 0)
+            return errno;
+        int n = _write(fd, data, (unsigned)std::min<size_t>(len, INT_MAX));
+#else
+        ssize_t n = pwrite(fd, data, len, offset);
+#endif
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return errno;
+        }
+        if (n == 0)
+            return EIO;
+        data += n;
+        len -= n;
+        offset += n;
+    }
+    return 0;
+}
+} // namespace
+
+struct async_file_writer::staging_buffer {
+    char* data;
+    size_t len;
+    size_t done;
+    uint64_t offset;
+};
+
+#ifdef HAVE_IO_URING
+// A bare io_uring on the kernel interface, just what is needed to queue
+// writes and reap their completions.
+struct async_file_writer::uring {
+    int fd = -1;
+    void* sq_ptr = MAP_FAILED;
+    size_t sq_len = 0;
+    void* cq_ptr = MAP_FAILED;
+    size_t cq_len = 0;
+    io_uring_sqe* sqes = (io_uring_sqe*)MAP_FAILED;
+    size_t sqes_len = 0;
+
+    unsigned *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    io_uring_cqe* cqes;
+
+    std::vector<iovec> iovs;
+    unsigned pending = 0; // queued, not yet taken by the kernel
+
+    bool setup(unsigned entries)
+    {
+        io_uring_params p;
+        memset(&p, 0, sizeof(p));
+        fd = syscall(__NR_io_uring_setup, entries, &p);
+        if (fd < 0)
+            return false;
+
+        sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_len = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+        single_mmap = p.features & IORING_FEAT_SINGLE_MMAP;
+#endif
+        if (single_mmap)
+            sq_len = cq_len = std::max(sq_len, cq_len);
+
+        sq_ptr = mmap(nullptr,
+                      sq_len,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE,
+                      fd,
+                      IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED)
+            return false;
+        if (single_mmap) {
+            cq_ptr = sq_ptr;
+        } else {
+            cq_ptr = mmap(nullptr,
+                          cq_len,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE,
+                          fd,
+                          IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED)
+                return false;
+        }
+        sqes_len = p.sq_entries * sizeof(io_uring_sqe);
+        sqes = (io_uring_sqe*)mmap(nullptr,
+                                   sqes_len,
+                                   PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_POPULATE,
+                                   fd,
+                                   IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+            return false;
+
+        char* sq = (char*)sq_ptr;
+        sq_tail = (unsigned*)(sq + p.sq_off.tail);
+        sq_mask = (unsigned*)(sq + p.sq_off.ring_mask);
+        sq_array = (unsigned*)(sq + p.sq_off.array);
+        char* cq = (char*)cq_ptr;
+        cq_head = (unsigned*)(cq + p.cq_off.head);
+        cq_tail = (unsigned*)(cq + p.cq_off.tail);
+        cq_mask = (unsigned*)(cq + p.cq_off.ring_mask);
+        cqes = (io_uring_cqe*)(cq + p.cq_off.cqes);
+
+        iovs.resize(entries);
+        return true;
+    }
+
+    ~uring()
+    {
+        if (sqes != MAP_FAILED)
+            munmap(sqes, sqes_len);
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+            munmap(cq_ptr, cq_len);
+        if (sq_ptr != MAP_FAILED)
+            munmap(sq_ptr, sq_len);
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    void queue_write(int file_fd, int buf, char* data, size_t len, uint64_t offset)
+    {
+        // Only this thread moves the submission tail
+        unsigned tail = *sq_tail;
+        unsigned index = tail & *sq_mask;
+        io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        iovs[buf].iov_base = data;
+        iovs[buf].iov_len = len;
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->fd = file_fd;
+        sqe->addr = (uint64_t)&iovs[buf];
+        sqe->len = 1;
+        sqe->off = offset;
+        sqe->user_data = buf;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        pending++;
+    }
+
+    // Hands the queued writes to the kernel and waits for min_complete
+    // completions; returns 0 or an errno.
+    int enter(unsigned min_complete)
+    {
+        for (;;) {
+            int ret = syscall(__NR_io_uring_enter,
+                              fd,
+                              pending,
+                              min_complete,
+                              min_complete ? IORING_ENTER_GETEVENTS : 0,
+                              nullptr,
+                              0);
+            if (ret >= 0) {
+                pending -= ret;
+                return 0;
+            }
+            if (errno != EINTR)
+                return errno;
+        }
+    }
+};
+#else
+struct async_file_writer::uring {
+};
+#endif
+
+async_file_writer::async_file_writer(int fd,
+                                     size_t buffer_size,
+                                     unsigned nbuffers,
+                                     bool direct,
+                                     gr::logger_ptr logger)
+    : d_fd(fd),
+      d_buffer_size((std::max<size_t>(buffer_size, 1) + alignment - 1) / alignment *
+                    alignment),
+      d_direct(direct),
+      d_logger(logger),
+      d_cur(-1),
+      d_cur_len(0),
+      d_offset(0),
+      d_inflight(0),
+      d_error(0),
+      d_pool_stop(false)
+{
+    nbuffers = std::max(nbuffers, 2u);
+
+#ifdef _WIN32
+    int64_t end = _lseeki64(fd, 0, SEEK_END);
+#else
+    // The writes carry their own offsets; with O_APPEND they would all go to
+    // the end of the file in whatever order they finish.
+    int flags = fcntl(fd, F_GETFL);
+    if (flags >= 0 && (flags & O_APPEND))
+        fcntl(fd, F_SETFL, flags & ~O_APPEND);
+    off_t end = lseek(fd, 0, SEEK_END);
+#endif
+    d_offset = end < 0 ? 0 : end;
+
+    if (d_direct) {
+#ifdef O_DIRECT
+        if (d_offset % alignment) {
+            GR_LOG_WARN(d_logger, "file ends unaligned, not using O_DIRECT");
+            d_direct = false;
+        } else if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_DIRECT) < 0) {
+            GR_LOG_WARN(d_logger,
+                        std::string("can't use O_DIRECT: ") + strerror(errno));
+            d_direct = false;
+        }
+#else
+        GR_LOG_WARN(d_logger, "O_DIRECT is not supported on this platform");
+        d_direct = false;
+#endif
+    }
+
+    d_buffers.resize(nbuffers);
+    for (unsigned i = 0; i < nbuffers; i++) {
+        staging_buffer& b = d_buffers[i];
+        b.data = (char*)volk_malloc(d_buffer_size, alignment);
+        if (!b.data)
+            throw std::bad_alloc();
+        b.len = b.done = 0;
+        b.offset = 0;
+        d_free.push_back(i);
+    }
+
+#ifdef HAVE_IO_URING
+    d_uring.reset(new uring);
+    if (!d_uring->setup(nbuffers)) {
+        GR_LOG_DEBUG(d_logger,
+                     std::string("io_uring not available, using threads: ") +
+                         strerror(errno));
+        d_uring.reset();
+    }
+#endif
+
+    if (!d_uring) {
+#ifdef _WIN32
+        unsigned nthreads = 1;
+#else
+        unsigned nthreads = std::min(nbuffers, max_pool_threads);
+#endif
+        for (unsigned i = 0; i < nthreads; i++)
+            d_pool.emplace_back([this]() { pool_worker(); });
+    }
+}
+
+async_file_writer::~async_file_writer()
+{
+    try {
+        flush();
+    } catch (const std::exception& e) {
+        GR_LOG_ERROR(d_logger, e.what());
+    }
+
+    if (!d_pool.empty()) {
+        {
+            gr::thread::scoped_lock lock(d_pool_mutex);
+            d_pool_stop = true;
+        }
+        d_pool_cond.notify_all();
+        for (auto& t : d_pool)
+            t.join();
+    }
+
+    for (auto& b : d_buffers)
+        volk_free(b.data);
+}
+
+const char* async_file_writer::backend() const
+{
+    return d_uring ? "io_uring" : "threads";
+}
+
+size_t async_file_writer::writable()
+{
+    if (d_inflight > 0)
+        reap(false);
+
+    size_t n = d_free.size() * d_buffer_size;
+    if (d_cur >= 0)
+        n += d_buffer_size - d_cur_len;
+    return n;
+}
+
+double async_file_writer::write(const char* data, size_t len)
+{
+    double waited = 0;
+
+    check_error();
+
+    while (len > 0) {
+        if (d_cur < 0) {
+            if (d_free.empty())
+                reap(false);
+            if (d_free.empty()) {
+                auto start = std::chrono::steady_clock::now();
+                reap(true);
+                waited += std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+                check_error();
+                continue;
+            }
+            d_cur = d_free.back();
+            d_free.pop_back();
+            d_cur_len = 0;
+        }
+
+        size_t n = std::min(len, d_buffer_size - d_cur_len);
+        memcpy(d_buffers[d_cur].data + d_cur_len, data, n);
+        d_cur_len += n;
+        data += n;
+        len -= n;
+
+        if (d_cur_len == d_buffer_size)
+            submit_current();
+    }
+
+    check_error();
+    return waited;
+}
+
+void async_file_writer::submit_partial()
+{
+    if (!d_direct && d_cur >= 0 && d_cur_len > 0)
+        submit_current();
+}
+
+void async_file_writer::flush()
+{
+    if (d_cur >= 0 && d_cur_len > 0) {
+        if (d_direct && d_cur_len % alignment) {
+            // O_DIRECT can't write the unaligned tail.  Let the rest finish and
+            // write it through the page cache; as the file now ends unaligned,
+            // anything after it has to go that way too.
+            while (d_inflight > 0 && !d_error)
+                reap(true);
+#ifdef O_DIRECT
+            fcntl(d_fd, F_SETFL, fcntl(d_fd, F_GETFL) & ~O_DIRECT);
+#endif
+            d_direct = false;
+        }
+        submit_current();
+    }
+
+    while (d_inflight > 0 && !d_error)
+        reap(true);
+
+    check_error();
+}
+
+void async_file_writer::submit_current()
+{
+    staging_buffer& b = d_buffers[d_cur];
+    b.len = d_cur_len;
+    b.done = 0;
+    b.offset = d_offset;
+    d_offset += d_cur_len;
+    d_inflight++;
+
+    int buf = d_cur;
+    d_cur = -1;
+    d_cur_len = 0;
+    start_write(buf);
+}
+
+void async_file_writer::start_write(int buf)
+{
+    staging_buffer& b = d_buffers[buf];
+
+#ifdef HAVE_IO_URING
+    if (d_uring) {
+        d_uring->queue_write(
+            d_fd, buf, b.data + b.done, b.len - b.done, b.offset + b.done);
+        if (int error = d_uring->enter(0)) {
+            if (!d_error)
+                d_error = error;
+        }
+        return;
+    }
+#endif
+
+    {
+        gr::thread::scoped_lock lock(d_pool_mutex);
+        d_pool_jobs.push_back(buf);
+    }
+    d_pool_cond.notify_all();
+}
+
+void async_file_writer::reap(bool wait)
+{
+#ifdef HAVE_IO_URING
+    if (d_uring) {
+        if (wait || d_uring->pending) {
+            if (int error = d_uring->enter(wait ? 1 : 0)) {
+                if (!d_error)
+                    d_error = error;
+                return;
+            }
+        }
+
+        unsigned head = *d_uring->cq_head;
+        unsigned tail = __atomic_load_n(d_uring->cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = d_uring->cqes[head & *d_uring->cq_mask];
+            int buf = cqe.user_data;
+            int res = cqe.res;
+            head++;
+            __atomic_store_n(d_uring->cq_head, head, __ATOMIC_RELEASE);
+
+            staging_buffer& b = d_buffers[buf];
+            if (res > 0 && b.done + res < b.len) {
+                // Short write: queue the rest
+                b.done += res;
+                start_write(buf);
+            } else {
+                complete(buf, res < 0 ? -res : (res == 0 && b.len ? EIO : 0));
+            }
+        }
+        return;
+    }
+#endif
+
+    std::deque<std::pair<int, int>> done;
+    {
+        gr::thread::scoped_lock lock(d_pool_mutex);
+        while (wait && d_pool_done.empty())
+            d_pool_cond.wait(lock);
+        done.swap(d_pool_done);
+    }
+    for (const auto& d : done)
+        complete(d.first, d.second);
+}
+
+void async_file_writer::complete(int buf, int error)
+{
+    if (error && !d_error)
+        d_error = error;
+    d_inflight--;
+    d_free.push_back(buf);
+}
+
+void async_file_writer::check_error()
+{
+    if (d_error)
+        throw std::runtime_error(std::string("async file write failed: ") +
+                                 strerror(d_error));
+}
+
+void async_file_writer::pool_worker()
+{
+    for (;;) {
+        int buf;
+        {
+            gr::thread::scoped_lock lock(d_pool_mutex);
+            while (d_pool_jobs.empty() && !d_pool_stop)
+                d_pool_cond.wait(lock);
+            if (d_pool_jobs.empty())
+                return;
+            buf = d_pool_jobs.front();
+            d_pool_jobs.pop_front();
+        }
+
+        const staging_buffer& b = d_buffers[buf];
+        int error = write_at(d_fd, b.data + b.done, b.len - b.done, b.offset + b.done);
+
+        {
+            gr::thread::scoped_lock lock(d_pool_mutex);
+            d_pool_done.emplace_back(buf, error);
+        }
+        d_pool_cond.notify_all();
+    }
+}
+
+} /* namespace blocks */
+} /* namespace gr */
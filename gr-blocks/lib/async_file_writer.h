@@ -0,0 +1,104 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_BLOCKS_ASYNC_FILE_WRITER_H
+#define INCLUDED_BLOCKS_ASYNC_FILE_WRITER_H
+
+#include <gnuradio/logger.h>
+#include <gnuradio/thread/thread.h>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace gr {
+namespace blocks {
+
+/*!
+ * \brief Writes a stream to a file descriptor with several writes in flight.
+ *
+ * Data is copied into a ring of aligned staging buffers; every full buffer
+ * is handed to io_uring, or where that is not available to a small pool of
+ * threads doing positional writes, and returns to the ring once it is on
+ * disk.  With \p direct the descriptor is switched to O_DIRECT, so the
+ * buffers bypass the page cache; the unaligned tail is written without it
+ * by flush().
+ *
+ * The descriptor stays owned by the caller, but must not be written to or
+ * closed until flush() returned or the writer is destroyed.
+ */
+class async_file_writer
+{
+public:
+    async_file_writer(int fd,
+                      size_t buffer_size,
+                      unsigned nbuffers,
+                      bool direct,
+                      gr::logger_ptr logger);
+    ~async_file_writer();
+
+    //! "io_uring" or "threads"
+    const char* backend() const;
+
+    //! Bytes write() takes right now without waiting for the disk.
+    size_t writable();
+
+    /*!
+     * Copies \p len bytes into the staging buffers, waiting for writes to
+     * finish if all of them are in flight.  Returns the time spent waiting
+     * in seconds.  Throws if an earlier write failed.
+     */
+    double write(const char* data, size_t len);
+
+    //! Starts writing the partly filled buffer (not in O_DIRECT mode).
+    void submit_partial();
+
+    //! Writes everything and waits until it is done.
+    void flush();
+
+private:
+    struct staging_buffer;
+    struct uring;
+
+    const int d_fd;
+    const size_t d_buffer_size;
+    bool d_direct;
+    gr::logger_ptr d_logger;
+
+    std::vector<staging_buffer> d_buffers;
+    std::vector<int> d_free;
+    int d_cur;         // buffer being filled, -1 if none
+    size_t d_cur_len;  // bytes in it
+    uint64_t d_offset; // file offset of the next write
+    unsigned d_inflight;
+    int d_error; // errno of the first failed write
+
+    std::unique_ptr<uring> d_uring;
+
+    // Thread pool backend
+    gr::thread::mutex d_pool_mutex;
+    gr::thread::condition_variable d_pool_cond;
+    std::deque<int> d_pool_jobs;
+    std::deque<std::pair<int, int>> d_pool_done; // buffer, errno
+    bool d_pool_stop;
+    std::vector<gr::thread::thread> d_pool;
+
+    void start_write(int buf);
+    void reap(bool wait);
+    void complete(int buf, int error);
+    void submit_current();
+    void check_error();
+    void pool_worker();
+};
+
+} /* namespace blocks */
+} /* namespace gr */
+
+#endif /* INCLUDED_BLOCKS_ASYNC_FILE_WRITER_H */
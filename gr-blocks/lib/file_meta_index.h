@@ -0,0 +1,53 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_BLOCKS_FILE_META_INDEX_H
+#define INCLUDED_BLOCKS_FILE_META_INDEX_H
+
+#include <cstdint>
+
+namespace gr {
+namespace blocks {
+
+/*
+ * Sidecar index of a metadata file (named filename.idx), written by
+ * file_meta_sink and read by file_meta_source.
+ *
+ * An index_file_header is followed by one index_record per segment, in
+ * stream order, all in host byte order. Sample offsets and, for a
+ * recording without time jumps backwards, rx_time grow monotonically, so
+ * both can be binary searched. The segment size follows from the next
+ * record or, for the last one, from its header.
+ */
+constexpr char METADATA_INDEX_MAGIC[8] = { 'G', 'R', 'M', 'E', 'T', 'A', 'I', 'X' };
+constexpr uint32_t METADATA_INDEX_VERSION = 1;
+
+struct index_file_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size; // sizeof(index_record)
+};
+
+struct index_record {
+    uint64_t sample;        // stream offset of the first item of the segment
+    uint64_t secs;          // rx_time of that item
+    double frac_secs;
+    double rate;            // rx_rate of the segment
+    uint64_t header_offset; // of the header, in the header or data file
+    uint64_t data_offset;   // of the first item, in the data file
+};
+
+static_assert(sizeof(index_file_header) == 16, "index header must be packed");
+static_assert(sizeof(index_record) == 48, "index record must be packed");
+
+} /* namespace blocks */
+} /* namespace gr */
+
+#endif /* INCLUDED_BLOCKS_FILE_META_INDEX_H */
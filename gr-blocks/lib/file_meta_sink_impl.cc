@@ -14,11 +14,13 @@
 
 #include "file_meta_sink_impl.h"
 #include <gnuradio/io_signature.h>
+#include <gnuradio/pdu.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <boost/format.hpp>
 #include <cstdio>
+#include <cstring>
 #include <stdexcept>
 
 // win32 (mingw/msvc) specific
@@ -38,6 +40,12 @@
 #define OUR_O_LARGEFILE 0
 #endif
 
+#ifdef _MSC_VER
+#define GR_FTELL _ftelli64
+#else
+#define GR_FTELL ftello
+#endif
+
 
 namespace gr {
 namespace blocks {
@@ -51,7 +59,8 @@ file_meta_sink::sptr file_meta_sink::make(size_t itemsize,
                                           bool complex,
                                           size_t max_segment_size,
                                           pmt::pmt_t extra_dict,
-                                          bool detached_header)
+                                          bool detached_header,
+                                          bool write_index)
 {
     return gnuradio::make_block_sptr<file_meta_sink_impl>(itemsize,
                                                           filename,
@@ -61,7 +70,8 @@ file_meta_sink::sptr file_meta_sink::make(size_t itemsize,
                                                           complex,
                                                           max_segment_size,
                                                           extra_dict,
-                                                          detached_header);
+                                                          detached_header,
+                                                          write_index);
 }
 
 file_meta_sink_impl::file_meta_sink_impl(size_t itemsize,
@@ -72,7 +82,8 @@ file_meta_sink_impl::file_meta_sink_impl(size_t itemsize,
                                          bool complex,
                                          size_t max_segment_size,
                                          pmt::pmt_t extra_dict,
-                                         bool detached_header)
+                                         bool detached_header,
+                                         bool write_index)
     : sync_block("file_meta_sink",
                  io_signature::make(1, 1, itemsize),
                  io_signature::make(0, 0, 0)),
@@ -82,12 +93,17 @@ file_meta_sink_impl::file_meta_sink_impl(size_t itemsize,
       d_max_seg_size(max_segment_size),
       d_total_seg_size(0),
       d_updated(false),
-      d_unbuffered(false)
+      d_unbuffered(false),
+      d_write_index(write_index),
+      d_nitems(0),
+      d_index_pending(false)
 {
     d_fp = 0;
     d_new_fp = 0;
     d_hdr_fp = 0;
     d_new_hdr_fp = 0;
+    d_index_fp = 0;
+    d_new_index_fp = 0;
 
     if (detached_header == true)
         d_state = STATE_DETACHED;
@@ -124,10 +140,10 @@ file_meta_sink_impl::file_meta_sink_impl(size_t itemsize,
 
     do_update();
 
-    if (d_state == STATE_DETACHED)
-        write_header(d_hdr_fp, d_header, d_extra);
-    else
-        write_header(d_fp, d_header, d_extra);
+    FILE* hdr_fp = (d_state == STATE_DETACHED) ? d_hdr_fp : d_fp;
+    index_new_segment(hdr_fp);
+    write_header(hdr_fp, d_header, d_extra);
+    index_update_segment();
 }
 
 file_meta_sink_impl::~file_meta_sink_impl() { close(); }
@@ -141,6 +157,20 @@ bool file_meta_sink_impl::open(const std::string& filename)
     }
 
     ret = ret && _open(&d_new_fp, filename.c_str());
+
+    if (ret && d_write_index) {
+        std::string s = filename + ".idx";
+        ret = _open(&d_new_index_fp, s.c_str());
+        if (ret) {
+            index_file_header hdr;
+            memcpy(hdr.magic, METADATA_INDEX_MAGIC, sizeof(hdr.magic));
+            hdr.version = METADATA_INDEX_VERSION;
+            hdr.record_size = sizeof(index_record);
+            if (fwrite(&hdr, sizeof(hdr), 1, d_new_index_fp) != 1)
+                throw std::runtime_error("file_meta_sink: error writing index file.");
+        }
+    }
+
     d_updated = true;
     return ret;
 }
@@ -178,6 +208,16 @@ void file_meta_sink_impl::close()
 {
     gr::thread::scoped_lock guard(d_setlock); // hold mutex for duration of this function
     update_last_header();
+    index_write_segment();
+
+    if (d_new_index_fp) {
+        fclose(d_new_index_fp);
+        d_new_index_fp = 0;
+    }
+    if (d_index_fp) {
+        fclose(d_index_fp);
+        d_index_fp = 0;
+    }
 
     if (d_state == STATE_DETACHED) {
         if (d_new_hdr_fp) {
@@ -221,6 +261,13 @@ void file_meta_sink_impl::do_update()
         d_fp = d_new_fp; // install new file pointer
         d_new_fp = 0;
 
+        index_write_segment();
+        if (d_index_fp)
+            fclose(d_index_fp);
+        d_index_fp = d_new_index_fp;
+        d_new_index_fp = 0;
+        d_nitems = 0;
+
         d_updated = false;
     }
 }
@@ -287,6 +334,7 @@ void file_meta_sink_impl::update_last_header()
         if (d_fp)
             update_last_header_inline();
     }
+    index_update_segment();
 }
 
 void file_meta_sink_impl::update_last_header_inline()
@@ -337,15 +385,53 @@ void file_meta_sink_impl::write_and_update()
     s = pmt::from_uint64(METADATA_HEADER_SIZE + d_extra_size);
     update_header(mp("strt"), s);
 
-    if (d_state == STATE_DETACHED)
-        write_header(d_hdr_fp, d_header, d_extra);
-    else
-        write_header(d_fp, d_header, d_extra);
+    FILE* hdr_fp = (d_state == STATE_DETACHED) ? d_hdr_fp : d_fp;
+    index_new_segment(hdr_fp);
+    write_header(hdr_fp, d_header, d_extra);
+    index_update_segment();
+}
+
+void file_meta_sink_impl::index_new_segment(FILE* hdr_fp)
+{
+    if (!d_index_fp)
+        return;
+
+    // The previous segment is final once the next one starts
+    index_write_segment();
+    d_index_entry.sample = d_nitems;
+    d_index_entry.header_offset = GR_FTELL(hdr_fp);
+    d_index_pending = true;
+}
+
+void file_meta_sink_impl::index_update_segment()
+{
+    // Tags at the start of a segment rewrite its header in place, pick up
+    // the time, rate and data offset after every write.
+    if (!d_index_pending || !d_fp)
+        return;
+
+    pmt::pmt_t r = pmt::dict_ref(d_header, metadata_keys::rx_time(), pmt::PMT_NIL);
+    d_index_entry.secs = pmt::to_uint64(pmt::tuple_ref(r, 0));
+    d_index_entry.frac_secs = pmt::to_double(pmt::tuple_ref(r, 1));
+    d_index_entry.rate =
+        pmt::to_double(pmt::dict_ref(d_header, mp("rx_rate"), pmt::PMT_NIL));
+    d_index_entry.data_offset = GR_FTELL(d_fp) - d_total_seg_size * d_itemsize;
+}
+
+void file_meta_sink_impl::index_write_segment()
+{
+    if (!d_index_pending || !d_index_fp)
+        return;
+
+    if (fwrite(&d_index_entry, sizeof(d_index_entry), 1, d_index_fp) != 1)
+        throw std::runtime_error("file_meta_sink: error writing index file.");
+    fflush(d_index_fp);
+    d_index_pending = false;
 }
 
 void file_meta_sink_impl::update_rx_time()
 {
-    pmt::pmt_t rx_time = pmt::string_to_symbol("rx_time");
+    const pmt::pmt_t rx_time = metadata_keys::rx_time();
     pmt::pmt_t r = pmt::dict_ref(d_header, rx_time, pmt::PMT_NIL);
     uint64_t secs = pmt::to_uint64(pmt::tuple_ref(r, 0));
     double fracs = pmt::to_double(pmt::tuple_ref(r, 1));
@@ -399,6 +485,7 @@ int file_meta_sink_impl::work(int noutput_items,
             inbuf += count * d_itemsize;
 
             d_total_seg_size += count;
+            d_nitems += count;
 
             // Only add a new header if we are not at the position of the
             // next tag
@@ -432,6 +519,7 @@ int file_meta_sink_impl::work(int noutput_items,
         inbuf += count * d_itemsize;
 
         d_total_seg_size += count;
+        d_nitems += count;
         if (d_total_seg_size == d_max_seg_size) {
             update_last_header();
             update_rx_time();
@@ -11,6 +11,7 @@
 #ifndef INCLUDED_BLOCKS_FILE_META_SINK_IMPL_H
 #define INCLUDED_BLOCKS_FILE_META_SINK_IMPL_H
 
+#include "file_meta_index.h"
 #include <gnuradio/blocks/file_meta_sink.h>
 #include <pmt/pmt.h>
 
@@ -39,6 +40,13 @@ private:
     FILE *d_fp, *d_hdr_fp;
     meta_state_t d_state;
 
+    // Segment index, see file_meta_index.h
+    const bool d_write_index;
+    FILE *d_new_index_fp, *d_index_fp;
+    uint64_t d_nitems;          // items written to the current file
+    index_record d_index_entry; // of the current segment
+    bool d_index_pending;       // d_index_entry not written yet
+
 protected:
     void write_header(FILE* fp, pmt_t header, pmt_t extra);
     void update_header(pmt_t key, pmt_t value);
@@ -48,6 +56,10 @@ protected:
     void write_and_update();
     void update_rx_time();
 
+    void index_new_segment(FILE* hdr_fp);
+    void index_update_segment();
+    void index_write_segment();
+
     bool _open(FILE** fp, const char* filename);
 
 public:
@@ -59,7 +71,8 @@ public:
                         bool complex = true,
                         size_t max_segment_size = 1000000,
                         pmt::pmt_t extra_dict = pmt::make_dict(),
-                        bool detached_header = false);
+                        bool detached_header = false,
+                        bool write_index = false);
     ~file_meta_sink_impl() override;
 
     bool open(const std::string& filename) override;
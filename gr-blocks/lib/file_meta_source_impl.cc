@@ -18,7 +18,10 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <stdexcept>
 
 // win32 (mingw/msvc) specific
@@ -38,6 +41,14 @@
 #define OUR_O_LARGEFILE 0
 #endif
 
+#ifdef _MSC_VER
+#define GR_FSEEK _fseeki64
+#define GR_FTELL _ftelli64
+#else
+#define GR_FSEEK fseeko
+#define GR_FTELL ftello
+#endif
+
 
 namespace gr {
 namespace blocks {
@@ -62,7 +73,11 @@ file_meta_source_impl::file_meta_source_impl(const std::string& filename,
       d_samp_rate(0),
       d_seg_size(0),
       d_updated(false),
-      d_repeat(repeat)
+      d_repeat(repeat),
+      d_new_data_size(0),
+      d_data_size(0),
+      d_seek_pending(false),
+      d_seek_sample(0)
 {
     d_fp = 0;
     d_new_fp = 0;
@@ -251,10 +266,59 @@ bool file_meta_source_impl::open(const std::string& filename,
     }
 
     ret = ret && _open(&d_new_fp, filename.c_str());
+    if (ret)
+        load_index(filename);
     d_updated = true;
     return ret;
 }
 
+void file_meta_source_impl::load_index(const std::string& filename)
+{
+    gr::thread::scoped_lock guard(d_setlock);
+    d_new_index.clear();
+
+    std::string s = filename + ".idx";
+    FILE* fp = fopen(s.c_str(), "rb");
+    if (!fp)
+        return; // no index, the file can only be read front to back
+
+    index_file_header hdr;
+    uint64_t size = 0;
+    if (fread(&hdr, sizeof(hdr), 1, fp) != 1 ||
+        memcmp(hdr.magic, METADATA_INDEX_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != METADATA_INDEX_VERSION ||
+        hdr.record_size != sizeof(index_record) || GR_FSEEK(fp, 0, SEEK_END) == -1 ||
+        (size = GR_FTELL(fp)) < sizeof(hdr) ||
+        GR_FSEEK(fp, sizeof(hdr), SEEK_SET) == -1) {
+        GR_LOG_WARN(d_logger, boost::format("%s: not a metadata index, ignored") % s);
+        fclose(fp);
+        return;
+    }
+
+    // A partly written last record (the sink is still running) is left out
+    d_new_index.resize((size - sizeof(hdr)) / sizeof(index_record));
+    size_t n = fread(d_new_index.data(), sizeof(index_record), d_new_index.size(), fp);
+    d_new_index.resize(n);
+    fclose(fp);
+
+    // The last segment runs to the end of the data file
+    if (GR_FSEEK(d_new_fp, 0, SEEK_END) == -1 ||
+        (d_new_data_size = GR_FTELL(d_new_fp)) == uint64_t(-1) ||
+        GR_FSEEK(d_new_fp, 0, SEEK_SET) == -1) {
+        GR_LOG_WARN(d_logger, boost::format("%s: can't tell its size") % filename);
+        d_new_index.clear();
+    }
+}
+
+// The stream offset just past the last item in the index
+uint64_t file_meta_source_impl::index_end() const
+{
+    const index_record& last = d_index.back();
+    if (d_data_size <= last.data_offset)
+        return last.sample;
+    return last.sample + (d_data_size - last.data_offset) / d_itemsize;
+}
+
 bool file_meta_source_impl::_open(FILE** fp, const char* filename)
 {
     gr::thread::scoped_lock guard(d_setlock); // hold mutex for duration of this function
@@ -327,14 +391,129 @@ void file_meta_source_impl::do_update()
         d_fp = d_new_fp; // install new file pointer
         d_new_fp = 0;
 
+        d_index = std::move(d_new_index);
+        d_new_index.clear();
+        d_data_size = d_new_data_size;
+        d_seek_pending = false;
+
         d_updated = false;
     }
 }
 
+bool file_meta_source_impl::seek(uint64_t sample)
+{
+    gr::thread::scoped_lock guard(d_setlock);
+
+    if (d_index.empty()) {
+        GR_LOG_WARN(d_logger, "no index, can't seek");
+        return false;
+    }
+    if (sample < d_index.front().sample || sample >= index_end()) {
+        GR_LOG_WARN(d_logger, "bad seek point");
+        return false;
+    }
+
+    // Applied by work(), which owns the file position
+    d_seek_sample = sample;
+    d_seek_pending = true;
+    return true;
+}
+
+bool file_meta_source_impl::seek_time(uint64_t secs, double frac_secs)
+{
+    gr::thread::scoped_lock guard(d_setlock);
+
+    if (d_index.empty()) {
+        GR_LOG_WARN(d_logger, "no index, can't seek");
+        return false;
+    }
+
+    // Last segment starting at or before the requested time
+    auto next =
+        std::upper_bound(d_index.begin(),
+                         d_index.end(),
+                         std::make_pair(secs, frac_secs),
+                         [](const std::pair<uint64_t, double>& t, const index_record& r) {
+                             return t.first < r.secs ||
+                                    (t.first == r.secs && t.second < r.frac_secs);
+                         });
+    if (next == d_index.begin()) {
+        GR_LOG_WARN(d_logger, "recording starts after seek time");
+        return false;
+    }
+    const index_record& rec = *(next - 1);
+
+    // Round up to the next sample, with some slack for the rounding of
+    // times that fall onto one
+    double offset = double(secs - rec.secs) + (frac_secs - rec.frac_secs);
+    uint64_t sample = rec.sample + uint64_t(std::ceil(offset * rec.rate - 1e-6));
+
+    // A time between two segments (recording paused) maps to the later one
+    if (next != d_index.end())
+        sample = std::min(sample, next->sample);
+    if (sample >= index_end()) {
+        GR_LOG_WARN(d_logger, "recording ends before seek time");
+        return false;
+    }
+
+    d_seek_sample = sample;
+    d_seek_pending = true;
+    return true;
+}
+
+void file_meta_source_impl::do_seek()
+{
+    d_seek_pending = false;
+
+    // seek() made sure that a segment starts at or before the sample
+    auto next = std::upper_bound(
+        d_index.begin(),
+        d_index.end(),
+        d_seek_sample,
+        [](uint64_t sample, const index_record& r) { return sample < r.sample; });
+    const index_record& rec = *(next - 1);
+
+    // Read the segment's header again; its tags are sent at the new position
+    FILE* hdr_fp = (d_state == STATE_DETACHED) ? d_hdr_fp : d_fp;
+    if (GR_FSEEK(hdr_fp, rec.header_offset, SEEK_SET) == -1)
+        throw std::runtime_error("file_meta_source: can't seek to header.");
+
+    pmt::pmt_t hdr = pmt::PMT_NIL, extras = pmt::PMT_NIL;
+    if (!read_header(hdr, extras))
+        throw std::runtime_error("file_meta_source: could not read indexed header.");
+    d_tags.clear();
+    parse_header(hdr, nitems_written(0), d_tags);
+    parse_extras(extras, nitems_written(0), d_tags);
+
+    uint64_t skip = std::min<uint64_t>(d_seek_sample - rec.sample, d_seg_size);
+    d_seg_size -= skip;
+
+    // Move rx_time to the first item produced
+    const pmt::pmt_t rx_time = pmt::string_to_symbol("rx_time");
+    uint64_t secs = pmt::to_uint64(pmt::tuple_ref(d_time_stamp, 0));
+    double frac = pmt::to_double(pmt::tuple_ref(d_time_stamp, 1)) + skip / d_samp_rate;
+    secs += uint64_t(frac);
+    frac -= uint64_t(frac);
+    d_time_stamp = pmt::make_tuple(pmt::from_uint64(secs), pmt::from_double(frac));
+    for (auto& t : d_tags) {
+        if (pmt::eq(t.key, rx_time))
+            t.value = d_time_stamp;
+    }
+
+    if (GR_FSEEK(d_fp, rec.data_offset + skip * d_itemsize, SEEK_SET) == -1)
+        throw std::runtime_error("file_meta_source: can't seek to data.");
+}
+
 int file_meta_source_impl::work(int noutput_items,
                                 gr_vector_const_void_star& input_items,
                                 gr_vector_void_star& output_items)
 {
+    {
+        gr::thread::scoped_lock lock(d_setlock);
+        if (d_seek_pending)
+            do_seek();
+    }
+
     // We've reached the end of a segment; parse the next header and get
     // the new tags to send and set the next segment size.
     if (d_seg_size == 0) {
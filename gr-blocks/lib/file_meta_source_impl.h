@@ -11,6 +11,7 @@
 #ifndef INCLUDED_BLOCKS_FILE_META_SOURCE_IMPL_H
 #define INCLUDED_BLOCKS_FILE_META_SOURCE_IMPL_H
 
+#include "file_meta_index.h"
 #include <gnuradio/blocks/file_meta_source.h>
 #include <gnuradio/tags.h>
 #include <gnuradio/thread/thread.h>
@@ -41,8 +42,19 @@ private:
 
     std::vector<tag_t> d_tags;
 
+    // Segment index, see file_meta_index.h
+    std::vector<index_record> d_new_index;
+    std::vector<index_record> d_index;
+    uint64_t d_new_data_size; // of the data file when the index was read
+    uint64_t d_data_size;
+    bool d_seek_pending;
+    uint64_t d_seek_sample;
+
 protected:
     bool _open(FILE** fp, const char* filename);
+    void load_index(const std::string& filename);
+    uint64_t index_end() const;
+    void do_seek();
     bool read_header(pmt_t& hdr, pmt_t& extras);
     void parse_header(pmt_t hdr, uint64_t offset, std::vector<tag_t>& tags);
     void parse_extras(pmt_t extras, uint64_t offset, std::vector<tag_t>& tags);
@@ -59,6 +71,9 @@ public:
     void close() override;
     void do_update() override;
 
+    bool seek(uint64_t sample) override;
+    bool seek_time(uint64_t secs, double frac_secs) override;
+
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items) override;
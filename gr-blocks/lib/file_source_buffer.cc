@@ -0,0 +1,200 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "file_source_buffer.h"
+#include <gnuradio/block.h>
+#include <gnuradio/buffer_reader.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace gr {
+namespace blocks {
+
+namespace {
+// While readers are pointed into the file the buffer memory is not used, the
+// single mapped callbacks only have to adjust the indices.
+void* no_copy(void* dest, const void*, std::size_t) { return dest; }
+} // namespace
+
+buffer_type
+    file_source_buffer::type(buftype<file_source_buffer, file_source_buffer>{});
+
+buffer_sptr file_source_buffer::make_buffer(int nitems,
+                                            size_t sizeof_item,
+                                            uint64_t downstream_lcm_nitems,
+                                            uint32_t downstream_max_out_mult,
+                                            block_sptr link,
+                                            block_sptr buf_owner)
+{
+    return buffer_sptr(new file_source_buffer(nitems,
+                                              sizeof_item,
+                                              downstream_lcm_nitems,
+                                              downstream_max_out_mult,
+                                              link,
+                                              buf_owner));
+}
+
+file_source_buffer::file_source_buffer(int nitems,
+                                       size_t sizeof_item,
+                                       uint64_t downstream_lcm_nitems,
+                                       uint32_t downstream_max_out_mult,
+                                       block_sptr link,
+                                       block_sptr buf_owner)
+    : buffer_single_mapped(nitems,
+                           sizeof_item,
+                           downstream_lcm_nitems,
+                           downstream_max_out_mult,
+                           link,
+                           buf_owner),
+      d_next(nullptr),
+      d_next_index(0),
+      d_run_start(0),
+      d_mapped(false)
+{
+    gr::configure_default_loggers(d_logger, d_debug_logger, "file_source_buffer");
+    if (!allocate_buffer(nitems))
+        throw std::bad_alloc();
+    d_next_index = d_write_index;
+}
+
+file_source_buffer::~file_source_buffer() {}
+
+bool file_source_buffer::do_allocate_buffer(size_t final_nitems, size_t sizeof_item)
+{
+    // Holds the items whenever readers cannot be pointed into the file
+    d_buffer.reset(new char[final_nitems * sizeof_item]());
+    d_base = d_buffer.get();
+    return true;
+}
+
+unsigned file_source_buffer::reader_window(buffer_reader* reader) const
+{
+    unsigned read_index = reader->get_read_index();
+    if (read_index == d_next_index)
+        return reader->items_available() ? d_bufsize : 0;
+    return (d_next_index + d_bufsize - read_index) % d_bufsize;
+}
+
+bool file_source_buffer::produce(const char* next)
+{
+    gr::thread::scoped_lock guard(d_map_mutex);
+
+    if (!next || next != d_next) {
+        if (d_mapped) {
+            // Readers may still look at the old run; give them a copy in
+            // the buffer before the file pointers stop being valid for
+            // these indices.
+            unsigned window = 0;
+            for (auto reader : d_readers)
+                window = std::max(window, reader_window(reader));
+
+            const char* src = d_next - window * d_sizeof_item;
+            unsigned start = (d_next_index + d_bufsize - window) % d_bufsize;
+            unsigned first = std::min(window, d_bufsize - start);
+            std::memcpy(&d_base[start * d_sizeof_item], src, first * d_sizeof_item);
+            std::memcpy(
+                d_base, src + first * d_sizeof_item, (window - first) * d_sizeof_item);
+            d_mapped = false;
+        }
+        d_next = next;
+        d_run_start = nitems_written();
+        return false;
+    }
+
+    if (!d_mapped) {
+        // Switch back once every reader, history included, sees only items
+        // of the current run.
+        uint64_t run = nitems_written() - d_run_start;
+        d_mapped = std::all_of(d_readers.begin(),
+                               d_readers.end(),
+                               [this, run](buffer_reader* r) {
+                                   return reader_window(r) <= run;
+                               });
+    }
+    return d_mapped;
+}
+
+void file_source_buffer::post_work(int nitems)
+{
+    if (nitems <= 0)
+        return;
+
+    gr::thread::scoped_lock guard(d_map_mutex);
+    if (d_next)
+        d_next += nitems * d_sizeof_item;
+    d_next_index = index_add(d_next_index, nitems);
+}
+
+const void* file_source_buffer::_read_pointer(unsigned int read_index)
+{
+    gr::thread::scoped_lock guard(d_map_mutex);
+
+    if (!d_mapped)
+        return &d_base[read_index * d_sizeof_item];
+
+    // Items are addressed by their distance to the newest one; equal indices
+    // can only be read by a reader with a full window.
+    unsigned back = (d_next_index + d_bufsize - read_index) % d_bufsize;
+    if (back == 0)
+        back = d_bufsize;
+    return d_next - back * d_sizeof_item;
+}
+
+bool file_source_buffer::input_blocked_callback(int items_required,
+                                                int items_avail,
+                                                unsigned read_index)
+{
+    gr::thread::scoped_lock guard(d_map_mutex);
+
+    unsigned write_index = d_write_index;
+    bool rc;
+    if (d_mapped)
+        rc = input_blocked_callback_logic(
+            items_required, items_avail, read_index, d_base, no_copy, no_copy);
+    else
+        rc = input_blocked_callback_logic(
+            items_required, items_avail, read_index, d_base, std::memcpy, std::memmove);
+
+    // The callback keeps the distances between the indices, shift ours along
+    d_next_index =
+        index_add(d_next_index, (d_write_index + d_bufsize - write_index) % d_bufsize);
+    return rc;
+}
+
+bool file_source_buffer::output_blocked_callback(int output_multiple, bool force)
+{
+    gr::thread::scoped_lock guard(d_map_mutex);
+
+    unsigned write_index = d_write_index;
+    bool rc;
+    if (d_mapped)
+        rc = output_blocked_callback_logic(output_multiple, force, d_base, no_copy);
+    else
+        rc = output_blocked_callback_logic(output_multiple, force, d_base, std::memmove);
+
+    d_next_index =
+        index_add(d_next_index, (d_write_index + d_bufsize - write_index) % d_bufsize);
+    return rc;
+}
+
+void file_source_buffer::update_reader_block_history(unsigned history, int delay)
+{
+    gr::thread::scoped_lock guard(d_map_mutex);
+    buffer_single_mapped::update_reader_block_history(history, delay);
+    d_next_index = d_write_index;
+}
+
+} /* namespace blocks */
+} /* namespace gr */
@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_BLOCKS_FILE_SOURCE_BUFFER_H
+#define INCLUDED_BLOCKS_FILE_SOURCE_BUFFER_H
+
+#include <gnuradio/buffer_single_mapped.h>
+#include <gnuradio/buffer_type.h>
+#include <gnuradio/thread/thread.h>
+#include <cstddef>
+
+namespace gr {
+namespace blocks {
+
+/*!
+ * \brief Output buffer of file_source that lets readers read a mapped file
+ *
+ * The buffer keeps the indices like any single mapped buffer, but as long
+ * as everything the readers can see (history included) is one contiguous
+ * run of the mapped file, read pointers point straight into the mapping and
+ * the writer does not have to copy anything.
+ *
+ * The writer announces where its next items are with produce().  When that
+ * is not where the previous ones ended (repeat, seek, another file), the
+ * items still in flight are copied into the buffer's own memory and the
+ * writer copies as well, until all readers have moved past the jump.
+ */
+class file_source_buffer : public buffer_single_mapped
+{
+public:
+    static buffer_type type;
+
+    static buffer_sptr make_buffer(int nitems,
+                                   size_t sizeof_item,
+                                   uint64_t downstream_lcm_nitems,
+                                   uint32_t downstream_max_out_mult,
+                                   block_sptr link = block_sptr(),
+                                   block_sptr buf_owner = block_sptr());
+
+    ~file_source_buffer() override;
+
+    /*!
+     * \brief Tells the buffer where the items of the next work call are
+     *
+     * \p next points to the next item in the mapped file, or is nullptr if
+     * the items do not come from a mapping.  Returns true if they need not
+     * be copied to the write pointer, which also means that no reader refers
+     * to an earlier run of the file any more.
+     */
+    bool produce(const char* next);
+
+    void post_work(int nitems) override;
+
+    const void* _read_pointer(unsigned int read_index) override;
+
+    bool input_blocked_callback(int items_required,
+                                int items_avail,
+                                unsigned read_index) override;
+
+    bool output_blocked_callback(int output_multiple, bool force) override;
+
+    void update_reader_block_history(unsigned history, int delay) override;
+
+protected:
+    bool do_allocate_buffer(size_t final_nitems, size_t sizeof_item) override;
+
+private:
+    gr::thread::mutex d_map_mutex;
+    const char* d_next;     // file address of the item at d_next_index
+    unsigned d_next_index;  // write index after the pending post_work()
+    uint64_t d_run_start;   // nitems_written() when the current run started
+    bool d_mapped;          // readers are pointed into the file
+
+    //! Items between the read index of \p reader and the write index
+    unsigned reader_window(buffer_reader* reader) const;
+
+    file_source_buffer(int nitems,
+                       size_t sizeof_item,
+                       uint64_t downstream_lcm_nitems,
+                       uint32_t downstream_max_out_mult,
+                       block_sptr link,
+                       block_sptr buf_owner);
+};
+
+} /* namespace blocks */
+} /* namespace gr */
+
+#endif /* INCLUDED_BLOCKS_FILE_SOURCE_BUFFER_H */
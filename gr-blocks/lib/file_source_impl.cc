@@ -13,15 +13,24 @@
 #endif
 
 #include "file_source_impl.h"
+#include <gnuradio/block_detail.h>
 #include <gnuradio/io_signature.h>
 #include <gnuradio/thread/thread.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #ifdef _MSC_VER
 #define GR_FSEEK _fseeki64
 #define GR_FTELL _ftelli64
@@ -40,23 +49,44 @@
 namespace gr {
 namespace blocks {
 
+namespace {
+// How far ahead of the read position the page cache is asked to be filled
+// in memory mapped mode
+constexpr uint64_t readahead_bytes = 16 * 1024 * 1024;
+
+void unmap(char* addr, size_t size)
+{
+#ifdef HAVE_SYS_MMAN_H
+    if (addr)
+        munmap(addr, size);
+#endif
+}
+} // namespace
+
 file_source::sptr file_source::make(size_t itemsize,
                                     const char* filename,
                                     bool repeat,
                                     uint64_t start_offset_items,
-                                    uint64_t length_items)
+                                    uint64_t length_items,
+                                    bool use_mmap)
 {
     return gnuradio::make_block_sptr<file_source_impl>(
-        itemsize, filename, repeat, start_offset_items, length_items);
+        itemsize, filename, repeat, start_offset_items, length_items, use_mmap);
 }
 
 file_source_impl::file_source_impl(size_t itemsize,
                                    const char* filename,
                                    bool repeat,
                                    uint64_t start_offset_items,
-                                   uint64_t length_items)
-    : sync_block(
-          "file_source", io_signature::make(0, 0, 0), io_signature::make(1, 1, itemsize)),
+                                   uint64_t length_items,
+                                   bool use_mmap)
+    : sync_block("file_source",
+                 io_signature::make(0, 0, 0),
+                 io_signature::make(1,
+                                    1,
+                                    itemsize,
+                                    use_mmap ? file_source_buffer::type
+                                             : buffer_double_mapped::type)),
       d_itemsize(itemsize),
       d_start_offset_items(start_offset_items),
       d_length_items(length_items),
@@ -66,8 +96,20 @@ file_source_impl::file_source_impl(size_t itemsize,
       d_updated(false),
       d_file_begin(true),
       d_repeat_cnt(0),
-      d_add_begin_tag(pmt::PMT_NIL)
+      d_add_begin_tag(pmt::PMT_NIL),
+      d_use_mmap(use_mmap),
+      d_map(nullptr),
+      d_map_size(0),
+      d_new_map(nullptr),
+      d_new_map_size(0),
+      d_readahead_begin(0),
+      d_readahead_end(0)
 {
+#ifndef HAVE_SYS_MMAN_H
+    if (d_use_mmap)
+        GR_LOG_WARN(d_logger, "memory mapping is not supported, reading with stdio");
+#endif
+
     open(filename, repeat, start_offset_items, length_items);
     do_update();
 
@@ -82,6 +124,22 @@ file_source_impl::~file_source_impl()
         fclose((FILE*)d_fp);
     if (d_new_fp)
         fclose((FILE*)d_new_fp);
+    unmap(d_map, d_map_size);
+    unmap(d_new_map, d_new_map_size);
+    for (const auto& m : d_retired_maps)
+        unmap(m.first, m.second);
+}
+
+bool file_source_impl::start()
+{
+    d_out_buffer = std::dynamic_pointer_cast<file_source_buffer>(detail()->output(0));
+    return true;
+}
+
+bool file_source_impl::stop()
+{
+    d_out_buffer.reset();
+    return true;
 }
 
 bool file_source_impl::seek(int64_t seek_point, int whence)
@@ -108,6 +166,12 @@ bool file_source_impl::seek(int64_t seek_point, int whence)
             GR_LOG_WARN(d_logger, "bad seek point");
             return 0;
         }
+        if (d_map) {
+            // work() reads at the position given by the items remaining
+            gr::thread::scoped_lock lock(fp_mutex);
+            d_items_remaining = d_start_offset_items + d_length_items - seek_point;
+            return 1;
+        }
         return GR_FSEEK((FILE*)d_fp, seek_point * d_itemsize, SEEK_SET) == 0;
     } else {
         GR_LOG_WARN(d_logger, "file not seekable");
@@ -128,6 +192,8 @@ void file_source_impl::open(const char* filename,
         fclose(d_new_fp);
         d_new_fp = 0;
     }
+    unmap(d_new_map, d_new_map_size);
+    d_new_map = nullptr;
 
     if ((d_new_fp = fopen(filename, "rb")) == NULL) {
         GR_LOG_ERROR(d_logger, boost::format("%s: %s") % filename % strerror(errno));
@@ -218,6 +284,10 @@ void file_source_impl::open(const char* filename,
         if (GR_FSEEK(d_new_fp, start_offset, SEEK_SET) == -1) {
             throw std::runtime_error("can't fseek()");
         }
+
+        if (d_use_mmap) {
+            map_file(file_size);
+        }
     }
 
     d_updated = true;
@@ -236,9 +306,56 @@ void file_source_impl::close()
         fclose(d_new_fp);
         d_new_fp = NULL;
     }
+    unmap(d_new_map, d_new_map_size);
+    d_new_map = nullptr;
     d_updated = true;
 }
 
+void file_source_impl::map_file(uint64_t file_size)
+{
+#ifdef HAVE_SYS_MMAN_H
+    if (file_size > std::numeric_limits<size_t>::max()) {
+        GR_LOG_WARN(d_logger, "file too large to map, reading with stdio");
+        return;
+    }
+
+    void* map = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, GR_FILENO(d_new_fp), 0);
+    if (map == MAP_FAILED) {
+        GR_LOG_WARN(d_logger,
+                    boost::format("can't map file, reading with stdio: %s") %
+                        strerror(errno));
+        return;
+    }
+
+    // The kernel can read ahead aggressively and drop pages once we are past
+    if (madvise(map, file_size, MADV_SEQUENTIAL)) {
+        GR_LOG_WARN(d_logger, "failed to advise to read sequentially");
+    }
+
+    d_new_map = static_cast<char*>(map);
+    d_new_map_size = file_size;
+#endif
+}
+
+void file_source_impl::readahead(uint64_t offset)
+{
+#ifdef HAVE_SYS_MMAN_H
+    // Ask for the next chunk when half of the last one is used up, or when
+    // the position jumped somewhere else
+    if (offset >= d_readahead_begin && offset + readahead_bytes / 2 <= d_readahead_end)
+        return;
+
+    static const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    uint64_t begin = offset - offset % page_size;
+    uint64_t end = std::min<uint64_t>(offset + readahead_bytes, d_map_size);
+    if (begin < end && madvise(d_map + begin, end - begin, MADV_WILLNEED)) {
+        GR_LOG_WARN(d_logger, "failed to advise we'll need file contents soon");
+    }
+    d_readahead_begin = offset;
+    d_readahead_end = end;
+#endif
+}
+
 void file_source_impl::do_update()
 {
     if (d_updated) {
@@ -251,6 +368,18 @@ void file_source_impl::do_update()
         d_new_fp = 0;
         d_updated = false;
         d_file_begin = true;
+
+        // Downstream may still be reading the old mapping; the buffer copies
+        // what is in flight and tells us when it is unused.
+        if (d_map)
+            d_retired_maps.emplace_back(d_map, d_map_size);
+        if (d_out_buffer)
+            d_out_buffer->produce(nullptr);
+        d_map = d_new_map;
+        d_map_size = d_new_map_size;
+        d_new_map = nullptr;
+        d_readahead_begin = 0;
+        d_readahead_end = 0;
     }
 }
 
@@ -274,6 +403,12 @@ int file_source_impl::work(int noutput_items,
         return WORK_DONE;
     }
 
+    if (d_map)
+        return work_mapped(noutput_items, o);
+
+    if (d_out_buffer)
+        d_out_buffer->produce(nullptr);
+
     while (size) {
 
         // Add stream tag whenever the file starts again
@@ -329,5 +464,42 @@ int file_source_impl::work(int noutput_items,
     return (noutput_items - size);
 }
 
+int file_source_impl::work_mapped(int noutput_items, char* out)
+{
+    // Add stream tag whenever the file starts again
+    if (d_file_begin && d_add_begin_tag != pmt::PMT_NIL) {
+        add_item_tag(
+            0, nitems_written(0), d_add_begin_tag, pmt::from_long(d_repeat_cnt), _id);
+        d_file_begin = false;
+    }
+
+    uint64_t item = d_start_offset_items + d_length_items - d_items_remaining;
+    uint64_t nitems = std::min((uint64_t)noutput_items, d_items_remaining);
+    const char* in = d_map + item * d_itemsize;
+
+    if (d_out_buffer && d_out_buffer->produce(in)) {
+        // Readers only see the current mapping from here on
+        for (const auto& m : d_retired_maps)
+            unmap(m.first, m.second);
+        d_retired_maps.clear();
+    } else {
+        memcpy(out, in, nitems * d_itemsize);
+    }
+    readahead((item + nitems) * d_itemsize);
+
+    // Stop at the end of the file, the next items are not contiguous with
+    // these in the mapping
+    d_items_remaining -= nitems;
+    if (d_items_remaining == 0 && d_repeat) {
+        d_items_remaining = d_length_items;
+        if (d_add_begin_tag != pmt::PMT_NIL) {
+            d_file_begin = true;
+            d_repeat_cnt++;
+        }
+    }
+
+    return nitems;
+}
+
 } /* namespace blocks */
 } /* namespace gr */
@@ -11,8 +11,11 @@
 #ifndef INCLUDED_BLOCKS_FILE_SOURCE_IMPL_H
 #define INCLUDED_BLOCKS_FILE_SOURCE_IMPL_H
 
+#include "file_source_buffer.h"
 #include <gnuradio/blocks/file_source.h>
 #include <boost/thread/mutex.hpp>
+#include <utility>
+#include <vector>
 
 namespace gr {
 namespace blocks {
@@ -33,19 +36,38 @@ private:
     long d_repeat_cnt;
     pmt::pmt_t d_add_begin_tag;
 
+    // Memory mapped mode
+    const bool d_use_mmap;
+    char* d_map; // mapping of d_fp, or nullptr
+    size_t d_map_size;
+    char* d_new_map;
+    size_t d_new_map_size;
+    // Mappings downstream blocks may still read from
+    std::vector<std::pair<char*, size_t>> d_retired_maps;
+    uint64_t d_readahead_begin; // bytes of d_map advised to be needed soon
+    uint64_t d_readahead_end;
+    std::shared_ptr<file_source_buffer> d_out_buffer;
+
     boost::mutex fp_mutex;
     pmt::pmt_t _id;
 
     void do_update();
+    void map_file(uint64_t file_size);
+    void readahead(uint64_t offset);
+    int work_mapped(int noutput_items, char* out);
 
 public:
     file_source_impl(size_t itemsize,
                      const char* filename,
                      bool repeat,
                      uint64_t offset,
-                     uint64_t len);
+                     uint64_t len,
+                     bool use_mmap);
     ~file_source_impl() override;
 
+    bool start() override;
+    bool stop() override;
+
     bool seek(int64_t seek_point, int whence) override;
     void open(const char* filename, bool repeat, uint64_t offset, uint64_t len) override;
     void close() override;
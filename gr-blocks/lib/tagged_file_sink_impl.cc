@@ -14,6 +14,7 @@
 
 #include "tagged_file_sink_impl.h"
 #include <gnuradio/io_signature.h>
+#include <gnuradio/pdu.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -71,8 +72,8 @@ int tagged_file_sink_impl::work(int noutput_items,
 
     uint64_t start_N = nitems_read(0);
     uint64_t end_N = start_N + (uint64_t)(noutput_items);
-    pmt::pmt_t bkey = pmt::string_to_symbol("burst");
-    pmt::pmt_t tkey = pmt::string_to_symbol("rx_time"); // use gr_tags::key_time
+    static const pmt::pmt_t bkey = pmt::string_to_symbol("burst");
+    const pmt::pmt_t tkey = metadata_keys::rx_time();
 
     std::vector<tag_t> all_tags;
     get_tags_in_range(all_tags, 0, start_N, end_N);
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(async_file_sink.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(94728ff2f508d511d926ec0bbc38b0b0)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/blocks/async_file_sink.h>
+// pydoc.h is automatically generated in the build directory
+#include <async_file_sink_pydoc.h>
+
+void bind_async_file_sink(py::module& m)
+{
+
+    using async_file_sink = ::gr::blocks::async_file_sink;
+
+
+    py::class_<async_file_sink,
+               gr::sync_block,
+               gr::block,
+               gr::basic_block,
+               gr::blocks::file_sink_base,
+               std::shared_ptr<async_file_sink>>(m, "async_file_sink", D(async_file_sink))
+
+        .def(py::init(&async_file_sink::make),
+             py::arg("itemsize"),
+             py::arg("filename"),
+             py::arg("append") = false,
+             py::arg("buffer_size") = 4 * 1024 * 1024,
+             py::arg("nbuffers") = 8,
+             py::arg("direct") = false,
+             py::arg("drop") = false,
+             D(async_file_sink, make))
+
+
+        .def("dropped_items",
+             &async_file_sink::dropped_items,
+             D(async_file_sink, dropped_items))
+
+
+        .def("backpressure_waits",
+             &async_file_sink::backpressure_waits,
+             D(async_file_sink, backpressure_waits))
+
+
+        .def("backpressure_time",
+             &async_file_sink::backpressure_time,
+             D(async_file_sink, backpressure_time))
+
+        ;
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr, blocks, __VA_ARGS__)
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+static const char* __doc_gr_blocks_async_file_sink = R"doc()doc";
+
+
+static const char* __doc_gr_blocks_async_file_sink_async_file_sink = R"doc()doc";
+
+
+static const char* __doc_gr_blocks_async_file_sink_make = R"doc()doc";
+
+
+static const char* __doc_gr_blocks_async_file_sink_dropped_items = R"doc()doc";
+
+
+static const char* __doc_gr_blocks_async_file_sink_backpressure_waits = R"doc()doc";
+
+
+static const char* __doc_gr_blocks_async_file_sink_backpressure_time = R"doc()doc";
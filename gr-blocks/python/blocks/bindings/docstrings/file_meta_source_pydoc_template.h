@@ -34,3 +34,9 @@ static const char* __doc_gr_blocks_file_meta_source_close = R"doc()doc";
 
 
 static const char* __doc_gr_blocks_file_meta_source_do_update = R"doc()doc";
+
+
+static const char* __doc_gr_blocks_file_meta_source_seek = R"doc()doc";
+
+
+static const char* __doc_gr_blocks_file_meta_source_seek_time = R"doc()doc";
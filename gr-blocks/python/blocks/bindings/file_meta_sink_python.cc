@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(file_meta_sink.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(124869add242e8f8a52cc8ae3a40da7f)                     */
+/* BINDTOOL_HEADER_FILE_HASH(9f0f4275951bb727b18b1d143c2b5582)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -60,6 +60,7 @@ void bind_file_meta_sink(py::module& m)
              py::arg("max_segment_size") = 1000000,
              py::arg("extra_dict") = pmt::make_dict(),
              py::arg("detached_header") = false,
+             py::arg("write_index") = false,
              D(file_meta_sink, make))
 
 
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(file_meta_source.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(689524753f7d659f05fd462802b55cac)                     */
+/* BINDTOOL_HEADER_FILE_HASH(05d02b958920f0c5b2ceded89e63e297)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -60,5 +60,18 @@ void bind_file_meta_source(py::module& m)
 
         .def("do_update", &file_meta_source::do_update, D(file_meta_source, do_update))
 
+
+        .def("seek",
+             &file_meta_source::seek,
+             py::arg("sample"),
+             D(file_meta_source, seek))
+
+
+        .def("seek_time",
+             &file_meta_source::seek_time,
+             py::arg("secs"),
+             py::arg("frac_secs"),
+             D(file_meta_source, seek_time))
+
         ;
 }
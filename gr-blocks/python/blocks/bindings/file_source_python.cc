@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(file_source.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(3ff3bf035951c8fd06dbb7456e7c7ba3)                     */
+/* BINDTOOL_HEADER_FILE_HASH(edcdd7fdbec8f1df249dbe502726eec7)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -45,6 +45,7 @@ void bind_file_source(py::module& m)
              py::arg("repeat") = false,
              py::arg("offset") = 0,
              py::arg("len") = 0,
+             py::arg("use_mmap") = false,
              D(file_source, make))
 
 
@@ -29,6 +29,7 @@ void bind_annotator_1to1(py::module&);
 void bind_annotator_alltoall(py::module&);
 void bind_annotator_raw(py::module&);
 void bind_argmax(py::module&);
+void bind_async_file_sink(py::module&);
 void bind_burst_tagger(py::module&);
 void bind_char_to_float(py::module&);
 void bind_char_to_short(py::module&);
@@ -239,6 +240,7 @@ PYBIND11_MODULE(blocks_python, m)
     bind_file_meta_source(m);
     bind_file_sink_base(m);
     bind_file_sink(m);
+    bind_async_file_sink(m);
     bind_file_source(m);
     bind_float_to_char(m);
     bind_float_to_complex(m);
@@ -11,6 +11,7 @@
 
 import sys
 import decimal
+import struct
 from gnuradio import gr, blocks
 import pmt
 
@@ -25,6 +26,12 @@ size  Size of data in bytes
 
 HEADER_LENGTH = blocks.METADATA_HEADER_SIZE
 
+# Sidecar index written by file_meta_sink (filename.idx), host byte order
+INDEX_MAGIC = b"GRMETAIX"
+INDEX_HEADER = struct.Struct("=8sII")    # magic, version, record size
+INDEX_RECORD = struct.Struct("=QQddQQ")  # sample, secs, frac secs, rate,
+                                         # header offset, data offset
+
 ftype_to_string = {blocks.GR_FILE_BYTE: "bytes",
                    blocks.GR_FILE_SHORT: "short",
                    blocks.GR_FILE_INT: "int",
@@ -178,3 +185,23 @@ def parse_extra_dict(p, info, VERBOSE=False):
             print("{0}: {1}".format(key, val))
 
     return info
+
+# READ THE SEGMENT INDEX OF A FILE, ONE DICTIONARY PER SEGMENT
+def read_index(filename):
+    with open(filename, "rb") as handle:
+        magic, version, record_size = INDEX_HEADER.unpack(
+            handle.read(INDEX_HEADER.size))
+        if magic != INDEX_MAGIC or record_size != INDEX_RECORD.size:
+            sys.stderr.write("{0} is not a metadata index.\n".format(filename))
+            sys.exit(1)
+        data = handle.read()
+
+    index = []
+    nrecords = len(data) // INDEX_RECORD.size
+    for rec in INDEX_RECORD.iter_unpack(data[:nrecords * INDEX_RECORD.size]):
+        index.append({"sample": rec[0],
+                      "rx_time": rec[1] + rec[2],
+                      "rx_rate": rec[3],
+                      "hdr_start": rec[4],
+                      "data_start": rec[5]})
+    return index
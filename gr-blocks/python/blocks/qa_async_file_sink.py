@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+#
+# Copyright 2021 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+import os
+import tempfile
+import array
+from gnuradio import gr, gr_unittest, blocks
+
+
+class test_async_file_sink(gr_unittest.TestCase):
+
+    def setUp(self):
+        os.environ['GR_CONF_CONTROLPORT_ON'] = 'False'
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_sink(self, filename, data, **kwargs):
+        src = blocks.vector_source_f(data)
+        snk = blocks.async_file_sink(gr.sizeof_float, filename, **kwargs)
+        self.tb.connect(src, snk)
+        self.tb.run()
+        self.tb.disconnect_all()
+        return snk
+
+    def read_file(self, filename, nitems):
+        result_data = array.array('f')
+        with open(filename, 'rb') as datafile:
+            result_data.fromfile(datafile, nitems)
+        return result_data
+
+    def test_async_file_sink(self):
+        # Several small buffers, with a partly filled one at the end
+        data = [float(x) for x in range(100000)]
+
+        with tempfile.NamedTemporaryFile() as temp:
+            snk = self.run_sink(temp.name, data, buffer_size=4096, nbuffers=4)
+
+            self.assertEqual(os.stat(temp.name).st_size, 4 * len(data))
+            self.assertFloatTuplesAlmostEqual(
+                data, self.read_file(temp.name, len(data)))
+            self.assertEqual(snk.dropped_items(), 0)
+
+    def test_async_file_sink_append(self):
+        data1 = [float(x) for x in range(1000)]
+        data2 = [float(-x) for x in range(3000)]
+
+        with tempfile.NamedTemporaryFile() as temp:
+            self.run_sink(temp.name, data1, buffer_size=4096, nbuffers=2)
+            self.run_sink(temp.name, data2, append=True,
+                          buffer_size=4096, nbuffers=2)
+
+            expected = data1 + data2
+            self.assertEqual(os.stat(temp.name).st_size, 4 * len(expected))
+            self.assertFloatTuplesAlmostEqual(
+                expected, self.read_file(temp.name, len(expected)))
+
+
+if __name__ == '__main__':
+    gr_unittest.run(test_async_file_sink)
@@ -192,6 +192,68 @@ class test_file_metadata(gr_unittest.TestCase):
         os.remove(outfile)
         os.remove(outfile_hdr)
 
+    def test_003_index(self):
+        N = 10000
+        outfile = "test_out_idx.dat"
+        outfile_idx = "test_out_idx.dat.idx"
+
+        samp_rate = 200000
+        data = sig_source_c(samp_rate, 1000, 1, N)
+        src = blocks.vector_source_c(data)
+        fsnk = blocks.file_meta_sink(gr.sizeof_gr_complex, outfile,
+                                     samp_rate, 1,
+                                     blocks.GR_FILE_FLOAT, True,
+                                     1000, pmt.make_dict(), False, True)
+        self.tb.connect(src, fsnk)
+        self.tb.run()
+        fsnk.close()
+
+        # One segment per 1000 items, and the empty one the sink starts
+        # when the last segment is full
+        index = parse_file_metadata.read_index(outfile_idx)
+        self.assertEqual([r["sample"] for r in index],
+                         list(range(0, N + 1, 1000)))
+        self.assertAlmostEqual(index[3]["rx_time"], 3000.0 / samp_rate)
+
+        # Seek by sample, into the middle of a segment
+        fsrc = blocks.file_meta_source(outfile, False)
+        self.assertTrue(fsrc.seek(4500))
+        vsnk = blocks.vector_sink_c()
+        tb = gr.top_block()
+        tb.connect(fsrc, vsnk)
+        tb.run()
+        fsrc.close()
+
+        self.assertComplexTuplesAlmostEqual(vsnk.data(), data[4500:], 5)
+        rx_time = [t for t in vsnk.tags()
+                   if pmt.eq(t.key, pmt.intern("rx_time"))]
+        self.assertEqual(rx_time[0].offset, 0)
+        self.assertAlmostEqual(
+            pmt.to_double(pmt.tuple_ref(rx_time[0].value, 1)),
+            4500.0 / samp_rate)
+
+        # Past the end, which the empty last segment doesn't move
+        fsrc = blocks.file_meta_source(outfile, False)
+        self.assertTrue(fsrc.seek(N - 1))
+        self.assertFalse(fsrc.seek(N))
+        self.assertFalse(fsrc.seek(N + 500))
+        self.assertFalse(fsrc.seek_time(0, float(N) / samp_rate))
+        fsrc.close()
+
+        # Seek by time
+        fsrc = blocks.file_meta_source(outfile, False)
+        self.assertTrue(fsrc.seek_time(0, 7200.0 / samp_rate))
+        vsnk = blocks.vector_sink_c()
+        tb = gr.top_block()
+        tb.connect(fsrc, vsnk)
+        tb.run()
+        fsrc.close()
+
+        self.assertComplexTuplesAlmostEqual(vsnk.data(), data[7200:], 5)
+
+        os.remove(outfile)
+        os.remove(outfile_idx)
+
 
 if __name__ == '__main__':
     gr_unittest.run(test_file_metadata)
@@ -144,6 +144,53 @@ class test_file_source(gr_unittest.TestCase):
         self.assertEqual(str(tags[1].value), "1")
         self.assertEqual(tags[1].offset, 1000)
 
+    def test_file_source_mmap(self):
+        expected_result = self._vector[100:100 + 600]
+
+        src = blocks.file_source(
+            gr.sizeof_float,
+            self._datafilename,
+            offset=100,
+            len=600,
+            use_mmap=True)
+        snk = blocks.vector_sink_f()
+        self.tb.connect(src, snk)
+        self.tb.run()
+
+        result_data = snk.data()
+        self.assertFloatTuplesAlmostEqual(expected_result, result_data)
+
+    def test_begin_tag_repeat_mmap(self):
+        expected_result = 3 * self._vector
+
+        src = blocks.file_source(
+            gr.sizeof_float, self._datafilename, True, use_mmap=True)
+        src.set_begin_tag(pmt.string_to_symbol("file_begin"))
+        head = blocks.head(gr.sizeof_float, 3 * len(self._vector))
+        snk = blocks.vector_sink_f()
+        self.tb.connect(src, head, snk)
+        self.tb.run()
+
+        result_data = snk.data()
+        self.assertFloatTuplesAlmostEqual(expected_result, result_data)
+        tags = snk.tags()
+        self.assertEqual(len(tags), 3)
+        self.assertEqual([t.offset for t in tags], [0, 1000, 2000])
+        self.assertEqual([str(t.value) for t in tags], ["0", "1", "2"])
+
+    def test_seek_mmap(self):
+        expected_result = self._vector[500:]
+
+        src = blocks.file_source(
+            gr.sizeof_float, self._datafilename, use_mmap=True)
+        self.assertTrue(src.seek(500, os.SEEK_SET))
+        snk = blocks.vector_sink_f()
+        self.tb.connect(src, snk)
+        self.tb.run()
+
+        result_data = snk.data()
+        self.assertFloatTuplesAlmostEqual(expected_result, result_data)
+
 
 if __name__ == '__main__':
     gr_unittest.run(test_file_source)
@@ -0,0 +1,154 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Per-call cost of the stream buffer index operations, with the
+ * buffer mutex held around each call (as the scheduler used to do)
+ * and without it (double mapped buffers use atomic indices), and
+ * the throughput of a writer and a reader thread moving small
+ * chunks through one buffer in both modes.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/buffer_double_mapped.h>
+#include <gnuradio/buffer_reader.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#define ITERATIONS 10000000
+#define NITEMS 4096
+#define CHUNK 64 // items per work call, a high-rate chain of small blocks
+#define STREAM_ITEMS (400 * 1000 * 1000)
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// The four calls a writer and a reader make per work() call
+template <bool locked>
+static void one_iteration(gr::buffer_sptr& buf, gr::buffer_reader_sptr& rdr, int n)
+{
+    int space, avail;
+    {
+        gr::thread::scoped_lock guard(*buf->mutex(), boost::defer_lock);
+        if (locked)
+            guard.lock();
+        space = buf->space_available();
+    }
+    {
+        gr::thread::scoped_lock guard(*buf->mutex(), boost::defer_lock);
+        if (locked)
+            guard.lock();
+        buf->update_write_pointer(std::min(space, n));
+    }
+    {
+        gr::thread::scoped_lock guard(*buf->mutex(), boost::defer_lock);
+        if (locked)
+            guard.lock();
+        avail = rdr->items_available();
+    }
+    {
+        gr::thread::scoped_lock guard(*buf->mutex(), boost::defer_lock);
+        if (locked)
+            guard.lock();
+        rdr->update_read_pointer(avail);
+    }
+}
+
+template <bool locked>
+static void benchmark_calls(const char* name)
+{
+    gr::buffer_sptr buf =
+        gr::buffer_double_mapped::make_buffer(NITEMS, sizeof(float), NITEMS, 1);
+    gr::buffer_reader_sptr rdr = gr::buffer_add_reader(buf, 0);
+
+    double start = now();
+    for (int i = 0; i < ITERATIONS; i++)
+        one_iteration<locked>(buf, rdr, CHUNK);
+    double elapsed = now() - start;
+
+    printf("%-12s %8.2f ns/call\n", name, elapsed * 1e9 / (4.0 * ITERATIONS));
+}
+
+template <bool locked>
+static void benchmark_stream(const char* name)
+{
+    gr::buffer_sptr buf =
+        gr::buffer_double_mapped::make_buffer(NITEMS, sizeof(float), NITEMS, 1);
+    gr::buffer_reader_sptr rdr = gr::buffer_add_reader(buf, 0);
+
+    double start = now();
+    std::thread writer([&buf]() {
+        long written = 0;
+        while (written < STREAM_ITEMS) {
+            int n;
+            {
+                gr::thread::scoped_lock guard(*buf->mutex(), boost::defer_lock);
+                if (locked)
+                    guard.lock();
+                n = std::min(buf->space_available(), CHUNK);
+            }
+            if (n == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            gr::thread::scoped_lock guard(*buf->mutex(), boost::defer_lock);
+            if (locked)
+                guard.lock();
+            buf->update_write_pointer(n);
+            written += n;
+        }
+    });
+
+    long nread = 0;
+    while (nread < STREAM_ITEMS) {
+        int m;
+        {
+            gr::thread::scoped_lock guard(*buf->mutex(), boost::defer_lock);
+            if (locked)
+                guard.lock();
+            m = std::min(rdr->items_available(), CHUNK);
+        }
+        if (m == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        gr::thread::scoped_lock guard(*buf->mutex(), boost::defer_lock);
+        if (locked)
+            guard.lock();
+        rdr->update_read_pointer(m);
+        nread += m;
+    }
+    writer.join();
+    double elapsed = now() - start;
+
+    printf("%-12s %8.2f Mitems/s\n", name, STREAM_ITEMS / elapsed * 1e-6);
+}
+
+int main(int argc, char** argv)
+{
+    printf("single thread, %d iterations of 4 calls:\n", ITERATIONS);
+    benchmark_calls<true>("mutex");
+    benchmark_calls<false>("atomic");
+
+    printf("\nwriter and reader threads, %d item chunks:\n", CHUNK);
+    benchmark_stream<true>("mutex");
+    benchmark_stream<false>("atomic");
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Random access into a 100 GB detached header recording, in a directory
+ * given on the command line (default /tmp).  The data file is sparse, so
+ * only the headers and the index take space.  Every seek restarts a small
+ * flowgraph, so the time of a run without seek is printed for reference.
+ * The baseline is reading the headers up to the segment, which is what a
+ * reader without index has to do at the very least.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "../lib/file_meta_index.h"
+#include <gnuradio/blocks/file_meta_sink.h>
+#include <gnuradio/blocks/file_meta_source.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/top_block.h>
+#include <pmt/pmt.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#define NBYTES (100ULL * 1024 * 1024 * 1024)
+#define SEG_ITEMS (1ULL << 20)
+#define NSEGS (NBYTES / sizeof(gr_complex) / SEG_ITEMS)
+#define RATE 1e6
+#define NSEEKS 200
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static std::string make_header(uint64_t seg, size_t extra_size)
+{
+    uint64_t sample = seg * SEG_ITEMS;
+    pmt::pmt_t timestamp =
+        pmt::make_tuple(pmt::from_uint64(sample / (uint64_t)RATE),
+                        pmt::from_double((sample % (uint64_t)RATE) / RATE));
+
+    pmt::pmt_t hdr = pmt::make_dict();
+    hdr = pmt::dict_add(hdr, pmt::mp("version"), pmt::mp(gr::blocks::METADATA_VERSION));
+    hdr = pmt::dict_add(hdr, pmt::mp("rx_rate"), pmt::mp(RATE));
+    hdr = pmt::dict_add(hdr, pmt::mp("rx_time"), timestamp);
+    hdr = pmt::dict_add(hdr, pmt::mp("size"), pmt::from_long(sizeof(gr_complex)));
+    hdr = pmt::dict_add(hdr, pmt::mp("type"), pmt::from_long(gr::blocks::GR_FILE_FLOAT));
+    hdr = pmt::dict_add(hdr, pmt::mp("cplx"), pmt::PMT_T);
+    hdr = pmt::dict_add(hdr,
+                        pmt::mp("strt"),
+                        pmt::from_uint64(gr::blocks::METADATA_HEADER_SIZE + extra_size));
+    hdr = pmt::dict_add(
+        hdr, pmt::mp("bytes"), pmt::from_uint64(SEG_ITEMS * sizeof(gr_complex)));
+    return pmt::serialize_str(hdr);
+}
+
+// Writes the headers and the index the way file_meta_sink does, next to a
+// sparse data file.
+static void make_recording(const std::string& filename)
+{
+    FILE* data = fopen(filename.c_str(), "wb");
+    if (!data || ftruncate(fileno(data), NBYTES) != 0) {
+        perror(filename.c_str());
+        exit(1);
+    }
+    fclose(data);
+
+    std::string extra = pmt::serialize_str(pmt::make_dict());
+    FILE* hdr_fp = fopen((filename + ".hdr").c_str(), "wb");
+    FILE* idx_fp = fopen((filename + ".idx").c_str(), "wb");
+
+    gr::blocks::index_file_header ih;
+    memcpy(ih.magic, gr::blocks::METADATA_INDEX_MAGIC, sizeof(ih.magic));
+    ih.version = gr::blocks::METADATA_INDEX_VERSION;
+    ih.record_size = sizeof(gr::blocks::index_record);
+    fwrite(&ih, sizeof(ih), 1, idx_fp);
+
+    for (uint64_t seg = 0; seg < NSEGS; seg++) {
+        std::string hdr = make_header(seg, extra.size());
+
+        gr::blocks::index_record rec;
+        rec.sample = seg * SEG_ITEMS;
+        rec.secs = rec.sample / (uint64_t)RATE;
+        rec.frac_secs = (rec.sample % (uint64_t)RATE) / RATE;
+        rec.rate = RATE;
+        rec.header_offset = seg * (hdr.size() + extra.size());
+        rec.data_offset = rec.sample * sizeof(gr_complex);
+        fwrite(&rec, sizeof(rec), 1, idx_fp);
+
+        fwrite(hdr.data(), 1, hdr.size(), hdr_fp);
+        fwrite(extra.data(), 1, extra.size(), hdr_fp);
+    }
+    fclose(hdr_fp);
+    fclose(idx_fp);
+}
+
+// Baseline: walk the header file up to the segment holding \p sample
+static void scan_headers(const std::string& filename, uint64_t sample)
+{
+    FILE* fp = fopen((filename + ".hdr").c_str(), "rb");
+    std::vector<char> buf(gr::blocks::METADATA_HEADER_SIZE);
+    uint64_t start = 0;
+    while (fread(buf.data(), 1, buf.size(), fp) == buf.size()) {
+        pmt::pmt_t hdr = pmt::deserialize_str(std::string(buf.data(), buf.size()));
+        uint64_t strt = pmt::to_uint64(pmt::dict_ref(hdr, pmt::mp("strt"), pmt::PMT_NIL));
+        uint64_t bytes =
+            pmt::to_uint64(pmt::dict_ref(hdr, pmt::mp("bytes"), pmt::PMT_NIL));
+        uint64_t seg_items = bytes / sizeof(gr_complex);
+        if (sample < start + seg_items)
+            break;
+        start += seg_items;
+        fseeko(fp, strt - buf.size(), SEEK_CUR);
+    }
+    fclose(fp);
+}
+
+int main(int argc, char** argv)
+{
+    std::string filename = std::string(argc > 1 ? argv[1] : "/tmp") +
+                           "/benchmark_file_meta_seek.dat";
+    const uint64_t nitems = NSEGS * SEG_ITEMS;
+
+    double start = now();
+    make_recording(filename);
+    printf("%llu MB, %llu segments in %s (%.2f s to create)\n",
+           NBYTES >> 20,
+           (unsigned long long)NSEGS,
+           filename.c_str(),
+           now() - start);
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<uint64_t> pick(0, nitems - 1);
+    std::vector<uint64_t> samples(NSEEKS);
+    for (auto& s : samples)
+        s = pick(rng);
+
+    start = now();
+    for (auto s : samples)
+        scan_headers(filename, s);
+    printf("%-24s %10.3f ms\n", "header scan", (now() - start) / NSEEKS * 1e3);
+
+    start = now();
+    auto src = gr::blocks::file_meta_source::make(filename, false, true);
+    printf("%-24s %10.3f ms\n", "open with index", (now() - start) * 1e3);
+
+    auto head = gr::blocks::head::make(sizeof(gr_complex), 4096);
+    auto sink = gr::blocks::null_sink::make(sizeof(gr_complex));
+    gr::top_block_sptr tb = gr::make_top_block("benchmark_file_meta_seek");
+    tb->connect(src, 0, head, 0);
+    tb->connect(head, 0, sink, 0);
+
+    start = now();
+    for (int i = 0; i < NSEEKS; i++) {
+        head->reset();
+        tb->run();
+    }
+    printf("%-24s %10.3f ms\n", "run, no seek", (now() - start) / NSEEKS * 1e3);
+
+    start = now();
+    for (auto s : samples) {
+        src->seek(s);
+        head->reset();
+        tb->run();
+    }
+    printf("%-24s %10.3f ms\n", "seek + run", (now() - start) / NSEEKS * 1e3);
+
+    start = now();
+    for (auto s : samples) {
+        src->seek_time(s / (uint64_t)RATE, (s % (uint64_t)RATE) / RATE);
+        head->reset();
+        tb->run();
+    }
+    printf("%-24s %10.3f ms\n", "seek_time + run", (now() - start) / NSEEKS * 1e3);
+
+    remove(filename.c_str());
+    remove((filename + ".hdr").c_str());
+    remove((filename + ".idx").c_str());
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Write rate of file_sink against async_file_sink, with and without
+ * O_DIRECT, into a directory given on the command line (default /tmp).
+ * Run it once on tmpfs and once on the recording disk; the time includes
+ * getting the last buffer out at stop().
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/blocks/async_file_sink.h>
+#include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/top_block.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#define NBYTES (4ULL * 1024 * 1024 * 1024)
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void run(const char* label, gr::basic_block_sptr sink)
+{
+    gr::top_block_sptr tb = gr::make_top_block("benchmark_file_sink");
+    gr::basic_block_sptr src = gr::blocks::null_source::make(sizeof(gr_complex));
+    gr::basic_block_sptr head =
+        gr::blocks::head::make(sizeof(gr_complex), NBYTES / sizeof(gr_complex));
+    tb->connect(src, 0, head, 0);
+    tb->connect(head, 0, sink, 0);
+
+    double start = now();
+    tb->run();
+    double elapsed = now() - start;
+
+    printf("%-28s %8.1f MB/s", label, NBYTES / elapsed * 1e-6);
+    auto async = std::dynamic_pointer_cast<gr::blocks::async_file_sink>(sink);
+    if (async) {
+        printf("  waited %llu times, %.2f s",
+               (unsigned long long)async->backpressure_waits(),
+               async->backpressure_time());
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    std::string filename = std::string(argc > 1 ? argv[1] : "/tmp") +
+                           "/benchmark_file_sink.dat";
+    const char* fn = filename.c_str();
+
+    printf("%llu MB to %s:\n", NBYTES >> 20, fn);
+    run("file_sink", gr::blocks::file_sink::make(sizeof(gr_complex), fn));
+    run("async_file_sink", gr::blocks::async_file_sink::make(sizeof(gr_complex), fn));
+    run("async_file_sink, O_DIRECT",
+        gr::blocks::async_file_sink::make(
+            sizeof(gr_complex), fn, false, 4 * 1024 * 1024, 8, true));
+    remove(fn);
+
+    return 0;
+}
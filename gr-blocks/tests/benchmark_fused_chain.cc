@@ -0,0 +1,76 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Throughput of a chain of cheap 1:1 blocks with the thread-per-block
+ * scheduler, with every block in its own thread and with the chain
+ * fused into one thread ([Scheduler] tpb_fuse_chains), for a short and
+ * a long chain.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/blocks/add_const_ff.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/top_block.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#define NSAMPLES (100 * 1000 * 1000)
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void run(const char* name, int nblocks)
+{
+    gr::top_block_sptr tb = gr::make_top_block("benchmark_fused_chain");
+    gr::basic_block_sptr upstream = gr::blocks::null_source::make(sizeof(float));
+    for (int i = 0; i < nblocks; i++) {
+        gr::basic_block_sptr op = gr::blocks::add_const_ff::make(0);
+        tb->connect(upstream, 0, op, 0);
+        upstream = op;
+    }
+    gr::basic_block_sptr head = gr::blocks::head::make(sizeof(float), NSAMPLES);
+    tb->connect(upstream, 0, head, 0);
+    tb->connect(head, 0, gr::blocks::null_sink::make(sizeof(float)), 0);
+
+    double start = now();
+    tb->run();
+    double elapsed = now() - start;
+
+    printf("%-24s %8.1f Msamples/s\n", name, NSAMPLES / elapsed * 1e-6);
+}
+
+int main(int argc, char** argv)
+{
+    const int nblocks[] = { 10, 40 };
+
+    for (int n : nblocks) {
+        printf("%d add_const_ff blocks, %d samples:\n", n, NSAMPLES);
+
+        // The flowgraph reads the preferences when it's set up
+        setenv("GR_CONF_SCHEDULER_TPB_FUSE_CHAINS", "False", 1);
+        run("thread per block", n);
+
+        setenv("GR_CONF_SCHEDULER_TPB_FUSE_CHAINS", "True", 1);
+        run("fused", n);
+    }
+
+    return 0;
+}
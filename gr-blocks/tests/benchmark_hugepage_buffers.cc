@@ -0,0 +1,150 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Throughput, data TLB misses and page faults of a chain of blocks
+ * with multi-MB output buffers, backed by normal pages and by huge
+ * pages ([DEFAULT] hugepage_buffers). Huge pages have to be reserved
+ * beforehand, e.g. with
+ *
+ *   echo 64 > /proc/sys/vm/nr_hugepages
+ *
+ * otherwise both runs use normal pages. TLB misses are counted with
+ * perf events where the kernel and hardware support them.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/blocks/add_const_ff.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/top_block.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define NBLOCKS 4
+#define NSAMPLES (1000 * 1000 * 1000)
+#define BUFFER_ITEMS (2 * 1024 * 1024) // 8 MB of floats
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// A counter of this process and all threads it starts from now on,
+// -1 if not available
+static int open_counter(uint32_t type, uint64_t config)
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static long long read_counter(int fd)
+{
+    long long count = 0;
+#ifdef __linux__
+    // inherited counts are added in when the threads exit
+    if (fd < 0 || read(fd, &count, sizeof(count)) != sizeof(count))
+        return -1;
+#endif
+    return count;
+}
+
+static void run(const char* name)
+{
+#ifdef __linux__
+    int dtlb = open_counter(PERF_TYPE_HW_CACHE,
+                            PERF_COUNT_HW_CACHE_DTLB |
+                                (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    int faults = open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+#else
+    int dtlb = -1, faults = -1;
+#endif
+
+    gr::top_block_sptr tb = gr::make_top_block("benchmark_hugepage_buffers");
+    gr::block_sptr upstream = gr::blocks::null_source::make(sizeof(float));
+    for (int i = 0; i < NBLOCKS; i++) {
+        gr::block_sptr op = gr::blocks::add_const_ff::make(0);
+        op->set_min_output_buffer(BUFFER_ITEMS);
+        tb->connect(upstream, 0, op, 0);
+        upstream = op;
+    }
+    gr::block_sptr head = gr::blocks::head::make(sizeof(float), NSAMPLES);
+    tb->connect(upstream, 0, head, 0);
+    tb->connect(head, 0, gr::blocks::null_sink::make(sizeof(float)), 0);
+
+    double start = now();
+    tb->run();
+    double elapsed = now() - start;
+    tb.reset();
+
+    long long ndtlb = read_counter(dtlb);
+    long long nfaults = read_counter(faults);
+    printf("%-14s %8.1f Msamples/s", name, NSAMPLES / elapsed * 1e-6);
+    if (ndtlb >= 0)
+        printf("  %12lld dTLB load misses", ndtlb);
+    else
+        printf("  %12s dTLB load misses", "n/a");
+    if (nfaults >= 0)
+        printf("  %8lld page faults\n", nfaults);
+    else
+        printf("  %8s page faults\n", "n/a");
+
+#ifdef __linux__
+    if (dtlb >= 0)
+        close(dtlb);
+    if (faults >= 0)
+        close(faults);
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    printf("%d add_const_ff blocks, %d MB buffers, %d samples:\n",
+           NBLOCKS,
+           (int)(BUFFER_ITEMS * sizeof(float) >> 20),
+           NSAMPLES);
+
+    // Buffers read the preference when they're allocated
+    setenv("GR_CONF_DEFAULT_HUGEPAGE_BUFFERS", "False", 1);
+    run("normal pages");
+
+    setenv("GR_CONF_DEFAULT_HUGEPAGE_BUFFERS", "True", 1);
+    run("huge pages");
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Cost of the PMT operations message and tag handling does for every
+ * packet: type checks and conversions, walking lists, looking up and
+ * adding dictionary entries, getting at the data of a PDU, and
+ * (de)serializing PDU metadata the way the ZMQ blocks do.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <pmt/pmt.h>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define ROUNDS 2000000
+#define DICT_SIZE 8
+#define LARGE_DICT_SIZE 32
+#define PAYLOAD_SIZE 1500
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Keeps the compiler from dropping the results
+static volatile long sink;
+
+static void benchmark(const char* name, const std::function<long()>& op)
+{
+    long x = 0;
+    double start = now();
+    for (int r = 0; r < ROUNDS; r++)
+        x += op();
+    double elapsed = now() - start;
+    sink = x;
+
+    printf("%-36s %8.2f ns\n", name, elapsed * 1e9 / ROUNDS);
+}
+
+int main(int argc, char** argv)
+{
+    pmt::pmt_t num = pmt::from_long(42);
+    pmt::pmt_t real = pmt::from_double(0.5);
+    pmt::pmt_t list = pmt::list6(num, num, num, num, num, num);
+
+    std::vector<pmt::pmt_t> keys;
+    pmt::pmt_t dict = pmt::make_dict();
+    for (int i = 0; i < DICT_SIZE; i++) {
+        keys.push_back(pmt::intern("key" + std::to_string(i)));
+        dict = pmt::dict_add(dict, keys.back(), pmt::from_long(i));
+    }
+    pmt::pmt_t last_key = keys.front(); // added first, so found last
+    pmt::pmt_t large_dict = dict;
+    for (int i = DICT_SIZE; i < LARGE_DICT_SIZE; i++)
+        large_dict = pmt::dict_add(
+            large_dict, pmt::intern("key" + std::to_string(i)), pmt::from_long(i));
+    pmt::pmt_t hash_dict = pmt::dict_update(pmt::make_hash_dict(), large_dict);
+    std::vector<uint8_t> payload(PAYLOAD_SIZE, 1);
+    pmt::pmt_t pdu = pmt::cons(dict, pmt::init_u8vector(PAYLOAD_SIZE, payload));
+
+    pmt::pmt_t meta = pmt::make_dict();
+    meta = pmt::dict_add(
+        meta,
+        pmt::mp("rx_time"),
+        pmt::make_tuple(pmt::from_uint64(1700000000), pmt::from_double(0.25)));
+    meta = pmt::dict_add(meta, pmt::mp("rx_freq"), pmt::from_double(2.4e9));
+    meta = pmt::dict_add(meta, pmt::mp("rx_rate"), pmt::from_double(1e6));
+    meta = pmt::dict_add(meta, pmt::mp("packet_len"), pmt::from_long(PAYLOAD_SIZE));
+    meta = pmt::dict_add(meta, pmt::mp("snr"), pmt::from_double(17.5));
+    std::string meta_bytes = pmt::serialize_str(meta);
+    std::vector<char> meta_buf(meta_bytes.size());
+
+    printf("%d rounds, dictionaries of %d (large: %d) entries:\n",
+           ROUNDS,
+           DICT_SIZE,
+           LARGE_DICT_SIZE);
+
+    benchmark("is_integer + to_long", [&] {
+        return pmt::is_integer(num) ? pmt::to_long(num) : 0;
+    });
+    benchmark("to_double", [&] { return long(pmt::to_double(real)); });
+    benchmark("eqv", [&] { return long(pmt::eqv(num, real)); });
+    benchmark("intern", [&] { return long(pmt::is_symbol(pmt::intern("key3"))); });
+    benchmark("length of a list", [&] { return long(pmt::length(list)); });
+    benchmark("car/cdr over a list", [&] {
+        long n = 0;
+        for (pmt::pmt_t p = list; pmt::is_pair(p); p = pmt::cdr(p))
+            n += pmt::to_long(pmt::car(p));
+        return n;
+    });
+    benchmark("dict_ref", [&] {
+        return pmt::to_long(pmt::dict_ref(dict, last_key, pmt::PMT_NIL));
+    });
+    benchmark("dict_has_key (missing)", [&] {
+        return long(pmt::dict_has_key(dict, pmt::PMT_T));
+    });
+    benchmark("dict_add (replace)", [&] {
+        return long(pmt::is_dict(pmt::dict_add(dict, last_key, num)));
+    });
+    benchmark("dict_ref (large)", [&] {
+        return pmt::to_long(pmt::dict_ref(large_dict, last_key, pmt::PMT_NIL));
+    });
+    benchmark("dict_add (large, replace)", [&] {
+        return long(pmt::is_dict(pmt::dict_add(large_dict, last_key, num)));
+    });
+    benchmark("dict_ref (large, hash)", [&] {
+        return pmt::to_long(pmt::dict_ref(hash_dict, last_key, pmt::PMT_NIL));
+    });
+    benchmark("dict_add (large, hash, replace)", [&] {
+        return long(pmt::is_dict(pmt::dict_add(hash_dict, last_key, num)));
+    });
+    benchmark("is_pdu + u8vector_elements", [&] {
+        size_t len = 0;
+        if (pmt::is_pdu(pdu))
+            pmt::u8vector_elements(pmt::cdr(pdu), len);
+        return long(len);
+    });
+    benchmark("uniform_vector_elements", [&] {
+        size_t len = 0;
+        pmt::uniform_vector_elements(pmt::cdr(pdu), len);
+        return long(len);
+    });
+    benchmark("equal (two dicts)", [&] { return long(pmt::equal(dict, dict)); });
+    benchmark("init_u8vector (payload)", [&] {
+        return long(pmt::length(pmt::init_u8vector(PAYLOAD_SIZE, payload.data())));
+    });
+    benchmark("serialize (metadata, stream)", [&] {
+        std::stringbuf sb;
+        pmt::serialize(meta, sb);
+        return long(sb.str().size());
+    });
+    benchmark("serialize_to_buffer (metadata)", [&] {
+        return long(pmt::serialize_to_buffer(meta, meta_buf.data(), meta_buf.size()));
+    });
+    benchmark("deserialize (metadata, stream)", [&] {
+        std::stringbuf sb(meta_bytes);
+        return long(pmt::is_dict(pmt::deserialize(sb)));
+    });
+    benchmark("deserialize_from_buffer (metadata)", [&] {
+        size_t used;
+        pmt::deserialize_from_buffer(meta_bytes.data(), meta_bytes.size(), used);
+        return long(used);
+    });
+
+    return 0;
+}
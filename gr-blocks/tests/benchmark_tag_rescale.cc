@@ -0,0 +1,99 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Cost of moving tag offsets through a block with a non-unity
+ * relative rate, with the block's integer fast path and with GMP
+ * for every tag, as tags were rescaled before.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/blocks/copy.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#define NTAGS (1000 * 1000)
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void gmp_rescale(std::vector<gr::tag_t>& tags, const mpq_class& rate)
+{
+    static const mpq_class one_half(1, 2);
+    mpz_class offset;
+    for (auto& t : tags) {
+        mpz_import(offset.get_mpz_t(), 1, 1, sizeof(t.offset), 0, 0, &t.offset);
+        offset = offset * rate + one_half;
+        t.offset = offset.get_ui();
+    }
+}
+
+static void benchmark(gr::block_sptr blk, const char* name)
+{
+    // e.g. a tag on every 1000th item of a long running flowgraph
+    std::vector<gr::tag_t> tags(NTAGS);
+    std::vector<uint64_t> offsets(NTAGS);
+    for (size_t i = 0; i < NTAGS; i++)
+        offsets[i] = 1000000000000 + i * 1000;
+
+    for (size_t i = 0; i < NTAGS; i++)
+        tags[i].offset = offsets[i];
+    double start = now();
+    gmp_rescale(tags, blk->mp_relative_rate());
+    double gmp = now() - start;
+    std::vector<uint64_t> expected(NTAGS);
+    for (size_t i = 0; i < NTAGS; i++)
+        expected[i] = tags[i].offset;
+
+    for (size_t i = 0; i < NTAGS; i++)
+        tags[i].offset = offsets[i];
+    start = now();
+    blk->rescale_tag_offsets(tags);
+    double fast = now() - start;
+    for (size_t i = 0; i < NTAGS; i++) {
+        if (tags[i].offset != expected[i]) {
+            printf("%s: mismatch at offset %llu\n",
+                   name,
+                   (unsigned long long)offsets[i]);
+            return;
+        }
+    }
+
+    printf("%-16s GMP %7.2f ns/tag, rescale_tag_offsets %7.2f ns/tag\n",
+           name,
+           gmp * 1e9 / NTAGS,
+           fast * 1e9 / NTAGS);
+}
+
+int main(int argc, char** argv)
+{
+    auto blk = gr::blocks::copy::make(sizeof(float));
+
+    blk->set_relative_rate(1, 8);
+    benchmark(blk, "1/8");
+    blk->set_relative_rate(147, 160);
+    benchmark(blk, "147/160");
+    blk->set_relative_rate(48000, 44100);
+    benchmark(blk, "48000/44100");
+    blk->set_relative_rate(0.1);
+    benchmark(blk, "0.1 (double)");
+    blk->set_relative_rate(1e-30);
+    benchmark(blk, "1e-30 (GMP)");
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Cost of the stream tag operations of one buffer (adding the tags
+ * of a work call, reading them back and pruning them), and the
+ * throughput of a chain of copy blocks when every few items carry
+ * a tag that has to be propagated through the whole chain.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/blocks/copy.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/tags_strobe.h>
+#include <gnuradio/buffer_double_mapped.h>
+#include <gnuradio/buffer_reader.h>
+#include <gnuradio/top_block.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#define NITEMS 8192
+#define CHUNK 512 // items per work call
+#define ROUNDS 200000
+#define CHAIN_LENGTH 8
+#define CHAIN_ITEMS (20 * 1000 * 1000)
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void benchmark_buffer(int tags_per_chunk)
+{
+    gr::buffer_sptr buf =
+        gr::buffer_double_mapped::make_buffer(NITEMS, sizeof(float), NITEMS, 1);
+    gr::buffer_reader_sptr rdr = gr::buffer_add_reader(buf, 0);
+
+    gr::tag_t tag;
+    tag.key = pmt::intern("burst");
+    tag.value = pmt::from_long(1);
+    std::vector<gr::tag_t> tags(tags_per_chunk, tag);
+    std::vector<gr::tag_t> out;
+
+    uint64_t offset = 0;
+    double start = now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < tags_per_chunk; i++)
+            tags[i].offset = offset + i * (CHUNK / tags_per_chunk);
+        buf->add_item_tags(tags);
+        buf->update_write_pointer(CHUNK);
+
+        rdr->get_tags_in_range(out, offset, offset + CHUNK, 0);
+        rdr->update_read_pointer(CHUNK);
+        offset += CHUNK;
+
+        gr::thread::scoped_lock guard(*buf->mutex());
+        buf->prune_tags(offset);
+    }
+    double elapsed = now() - start;
+
+    printf("%3d tags per %d items: %7.2f ns/tag\n",
+           tags_per_chunk,
+           CHUNK,
+           elapsed * 1e9 / (double(ROUNDS) * tags_per_chunk));
+}
+
+static void benchmark_chain(uint64_t tag_every)
+{
+    auto tb = gr::make_top_block("benchmark_tags");
+    auto src = gr::blocks::tags_strobe::make(sizeof(float), pmt::PMT_T, tag_every);
+    auto head = gr::blocks::head::make(sizeof(float), CHAIN_ITEMS);
+    tb->connect(src, 0, head, 0);
+
+    gr::basic_block_sptr up = head;
+    for (int i = 0; i < CHAIN_LENGTH; i++) {
+        auto copy = gr::blocks::copy::make(sizeof(float));
+        tb->connect(up, 0, copy, 0);
+        up = copy;
+    }
+    tb->connect(up, 0, gr::blocks::null_sink::make(sizeof(float)), 0);
+
+    double start = now();
+    tb->run();
+    double elapsed = now() - start;
+
+    printf("a tag every %4d items: %7.2f Mitems/s %7.3f Mtags/s\n",
+           int(tag_every),
+           CHAIN_ITEMS / elapsed * 1e-6,
+           CHAIN_ITEMS / double(tag_every) / elapsed * 1e-6);
+}
+
+int main(int argc, char** argv)
+{
+    printf("one buffer, %d work calls:\n", ROUNDS);
+    for (int n : { 1, 8, 64 })
+        benchmark_buffer(n);
+
+    printf("\n%d copy blocks, %d items:\n", CHAIN_LENGTH, CHAIN_ITEMS);
+    for (uint64_t every : { 4096, 64, 8 })
+        benchmark_chain(every);
+
+    return 0;
+}
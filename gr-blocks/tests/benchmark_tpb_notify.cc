@@ -0,0 +1,146 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Cost of a notification nobody waits for, and wake-up latency and
+ * CPU use of the thread-per-block notifications for a few spin
+ * budgets ([Scheduler] tpb_max_spin_us), under heavy load (two
+ * threads ping-ponging back to back) and light load (one wake-up per
+ * millisecond).
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/tpb_detail.h>
+
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define HEAVY_ROUNDS 200000
+#define LIGHT_ROUNDS 2000
+#define LIGHT_PERIOD_US 1000
+#define NOTIFY_ITERATIONS 10000000
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static double cpu_time()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec * 1e-6 + ru.ru_stime.tv_sec +
+           ru.ru_stime.tv_usec * 1e-6;
+#else
+    return 0;
+#endif
+}
+
+// Wait on tpb until cond() holds, the way a block thread does
+template <typename F>
+static void wait_for(gr::tpb_detail& tpb, F cond)
+{
+    while (true) {
+        tpb.clear_changed();
+        if (cond())
+            return;
+        tpb.wait_input(250);
+    }
+}
+
+static void run(int rounds, int period_us)
+{
+    gr::tpb_detail ping, pong;
+    std::atomic<int> request(-1), ack(-1);
+    std::atomic<double> sent(0);
+    std::vector<double> latency(rounds);
+
+    std::thread ponger([&]() {
+        for (int i = 0; i < rounds; i++) {
+            wait_for(pong, [&]() { return request.load() == i; });
+            latency[i] = now() - sent.load();
+            ack = i;
+            ping.notify_msg();
+        }
+    });
+
+    double start = now();
+    double start_cpu = cpu_time();
+    for (int i = 0; i < rounds; i++) {
+        if (period_us > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(period_us));
+        sent = now();
+        request = i;
+        pong.notify_msg();
+        wait_for(ping, [&]() { return ack.load() == i; });
+    }
+    double elapsed = now() - start;
+    double cpu = cpu_time() - start_cpu;
+    ponger.join();
+
+    std::sort(latency.begin(), latency.end());
+    printf("  latency median %7.2f us  p99 %8.2f us   cpu %5.1f%% of one core\n",
+           latency[rounds / 2] * 1e6,
+           latency[rounds * 99 / 100] * 1e6,
+           100.0 * cpu / elapsed);
+}
+
+// What every READY iteration pays per neighbor when the neighbor is busy
+static void notify_cost()
+{
+    gr::tpb_detail tpb;
+
+    double start = now();
+    for (int i = 0; i < NOTIFY_ITERATIONS; i++) {
+        tpb.notify_msg();
+        tpb.clear_changed();
+    }
+    double elapsed = now() - start;
+
+    printf("notify + clear, nobody waiting: %.2f ns\n",
+           elapsed * 1e9 / NOTIFY_ITERATIONS);
+}
+
+int main(int argc, char** argv)
+{
+    const char* budgets[] = { "0", "20", "100" };
+
+    notify_cost();
+
+    for (const char* b : budgets) {
+        // tpb_detail reads the preference when it's constructed
+        setenv("GR_CONF_SCHEDULER_TPB_MAX_SPIN_US", b, 1);
+        printf("tpb_max_spin_us = %s\n", b);
+        printf(" heavy load, %d back to back round trips:\n", HEAVY_ROUNDS);
+        run(HEAVY_ROUNDS, 0);
+        printf(" light load, %d round trips every %d us:\n",
+               LIGHT_ROUNDS,
+               LIGHT_PERIOD_US);
+        run(LIGHT_ROUNDS, LIGHT_PERIOD_US);
+    }
+
+    return 0;
+}
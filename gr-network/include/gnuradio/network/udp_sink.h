@@ -45,6 +45,16 @@ namespace network {
  * from the work function.  This block also supports IPv4 and IPv6
  * addresses and is automatically determined from the address
  * provided.
+ *
+ * On Linux the block hands many packets to the kernel per system call
+ * with sendmmsg(), gathering each packet from its header and the items
+ * in the input buffer without copying them, and lets the kernel split
+ * runs of packets (UDP GSO) where it supports that and a packet fits
+ * the path MTU unfragmented; if a segmented send fails the block falls
+ * back to one datagram per packet.  This needs the data part of a
+ * packet to hold a whole number of items.  The packet
+ * and system call rates are available from packet_rate() and
+ * send_call_rate() and through ControlPort.
  */
 class NETWORK_API udp_sink : virtual public gr::sync_block
 {
@@ -61,6 +71,26 @@ public:
                      int header_type,
                      int payloadsize,
                      bool send_eof);
+
+    /*!
+     * Total number of UDP packets sent.
+     */
+    virtual uint64_t packets_sent() const = 0;
+
+    /*!
+     * Total number of system calls made to send them.
+     */
+    virtual uint64_t send_calls() const = 0;
+
+    /*!
+     * Packets sent per second, measured over about a second of work calls.
+     */
+    virtual double packet_rate() const = 0;
+
+    /*!
+     * Send system calls per second, measured over about a second of work calls.
+     */
+    virtual double send_call_rate() const = 0;
 };
 
 } // namespace network
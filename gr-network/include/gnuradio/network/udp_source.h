@@ -42,6 +42,20 @@ namespace network {
  * IPv6 option that can be set on the block properties page.  It can
  * also be set to source zeros (no signal) in the event no data
  * is being received.
+ *
+ * When a header is in use, the block counts packets missing from the
+ * sequence and packets arriving behind it.  Both totals can be read
+ * with lost_packets() and reordered_packets(); with notify missed set,
+ * each gap is also tagged on the first item after it ("udp_lost", with
+ * the number of packets missing) and each late packet on its first item
+ * ("udp_reordered", with its sequence number).
+ *
+ * With high_rate set, on Linux, the block pulls many datagrams per
+ * system call with recvmmsg(), scatters each payload directly into the
+ * output buffer and asks for a larger socket receive buffer.  In that
+ * mode every datagram has to be exactly the payload size; others are
+ * dropped.  Leave it off if the sending application doesn't send
+ * payload size datagrams.  Without recvmmsg() the option is ignored.
  */
 class NETWORK_API udp_source : virtual public gr::sync_block
 {
@@ -58,7 +72,18 @@ public:
                      int payloadsize,
                      bool notify_missed,
                      bool source_zeros,
-                     bool ipv6);
+                     bool ipv6,
+                     bool high_rate = false);
+
+    /*!
+     * Total number of packets missing from the received sequence numbers.
+     */
+    virtual uint64_t lost_packets() const = 0;
+
+    /*!
+     * Total number of packets that arrived after a later sequence number.
+     */
+    virtual uint64_t reordered_packets() const = 0;
 };
 
 } // namespace network
@@ -16,10 +16,54 @@
 #include <gnuradio/io_signature.h>
 #include <boost/array.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
+
+#ifdef HAVE_SENDMMSG
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <cerrno>
+#include <cstring>
+#endif
 
 namespace gr {
 namespace network {
 
+namespace {
+// Messages handed to sendmmsg() per call at most
+constexpr int max_batch = 64;
+#ifdef UDP_SEGMENT
+// Kernel limits for one GSO send: total UDP payload and number of segments
+constexpr int max_gso_bytes = 65507;
+constexpr int max_gso_segments = 64;
+
+// MTU of the path to endpoint, or 0 if the kernel won't tell
+int path_mtu(boost::asio::io_service& io_service,
+             const boost::asio::ip::udp::endpoint& endpoint)
+{
+    int mtu = 0;
+#if defined(IP_MTU) && defined(IPV6_MTU)
+    // Only a connected socket knows its path; connecting a UDP socket just
+    // looks up the route
+    boost::asio::ip::udp::socket probe(io_service);
+    boost::system::error_code err;
+    probe.connect(endpoint, err);
+    if (err)
+        return 0;
+
+    socklen_t len = sizeof(mtu);
+    bool v6 = endpoint.address().is_v6();
+    if (getsockopt(probe.native_handle(),
+                   v6 ? IPPROTO_IPV6 : IPPROTO_IP,
+                   v6 ? IPV6_MTU : IP_MTU,
+                   &mtu,
+                   &len) != 0)
+        mtu = 0;
+#endif
+    return mtu;
+}
+#endif
+} // namespace
+
 udp_sink::sptr udp_sink::make(size_t itemsize,
                               size_t veclen,
                               const std::string& host,
@@ -51,7 +95,16 @@ udp_sink_impl::udp_sink_impl(size_t itemsize,
       d_header_size(0),
       d_seq_num(0),
       d_payloadsize(payloadsize),
-      b_send_eof(send_eof)
+      b_send_eof(send_eof),
+      d_localqueue(nullptr),
+      d_localbuffer(nullptr),
+      d_packets_sent(0),
+      d_send_calls(0),
+      d_packet_rate(0),
+      d_send_call_rate(0),
+      d_rate_start(std::chrono::steady_clock::now()),
+      d_rate_packets(0),
+      d_rate_send_calls(0)
 {
     // Lets set up the max payload size for the UDP packet based on the requested
     // payload size. Some important notes:  For a standard IP/UDP packet, say
@@ -101,21 +154,32 @@ udp_sink_impl::udp_sink_impl(size_t itemsize,
     d_precomp_datasize = d_payloadsize - d_header_size;
     d_precomp_data_overitemsize = d_precomp_datasize / d_itemsize;
 
-    d_localbuffer = new char[d_payloadsize];
+    // Packets holding a whole number of items are sent straight from the input
+    // buffer; anything else goes through the local queue.
+    d_items_per_packet = 0;
+#ifdef HAVE_SENDMMSG
+    if (d_precomp_datasize % d_block_size == 0)
+        d_items_per_packet = d_precomp_datasize / d_block_size;
+    d_segments = 1;
+#endif
 
-    long max_circ_buffer;
+    if (d_items_per_packet == 0) {
+        d_localbuffer = new char[d_payloadsize];
 
-    // Let's keep it from getting too big
-    if (d_payloadsize < 2000) {
-        max_circ_buffer = d_payloadsize * 4000;
-    } else {
-        if (d_payloadsize < 5000)
-            max_circ_buffer = d_payloadsize * 2000;
-        else
-            max_circ_buffer = d_payloadsize * 1500;
-    }
+        long max_circ_buffer;
 
-    d_localqueue = new boost::circular_buffer<char>(max_circ_buffer);
+        // Let's keep it from getting too big
+        if (d_payloadsize < 2000) {
+            max_circ_buffer = d_payloadsize * 4000;
+        } else {
+            if (d_payloadsize < 5000)
+                max_circ_buffer = d_payloadsize * 2000;
+            else
+                max_circ_buffer = d_payloadsize * 1500;
+        }
+
+        d_localqueue = new boost::circular_buffer<char>(max_circ_buffer);
+    }
 
     d_udpsocket = new boost::asio::ip::udp::socket(d_io_service);
 
@@ -150,6 +214,38 @@ udp_sink_impl::udp_sink_impl(size_t itemsize,
         d_udpsocket->open(boost::asio::ip::udp::v4());
     }
 
+#ifdef HAVE_SENDMMSG
+    if (d_items_per_packet > 0) {
+#ifdef UDP_SEGMENT
+        // Let the kernel cut runs of packets out of one large send.  Older
+        // kernels refuse the option, so one message stays one packet.  A
+        // segmented send can't be fragmented, so each packet, IP and UDP
+        // headers included, has to fit the path MTU.
+        int ip_udp_header_size = d_endpoint.address().is_v6() ? 48 : 28;
+        int mtu = path_mtu(d_io_service, d_endpoint);
+        int segments = std::min(max_gso_bytes / (int)d_payloadsize, max_gso_segments);
+        if (d_payloadsize + ip_udp_header_size > mtu)
+            segments = 1;
+        int gso_size = d_payloadsize;
+        if (segments > 1 && setsockopt(d_udpsocket->native_handle(),
+                                       IPPROTO_UDP,
+                                       UDP_SEGMENT,
+                                       &gso_size,
+                                       sizeof(gso_size)) == 0)
+            d_segments = segments;
+#endif
+        const int iov_per_packet = d_header_size > 0 ? 2 : 1;
+        d_msgs.resize(max_batch);
+        d_iovecs.resize(max_batch * d_segments * iov_per_packet);
+        d_headers.resize(max_batch * d_segments * d_header_size);
+        for (mmsghdr& msg : d_msgs) {
+            memset(&msg, 0, sizeof(mmsghdr));
+            msg.msg_hdr.msg_name = d_endpoint.data();
+            msg.msg_hdr.msg_namelen = d_endpoint.size();
+        }
+    }
+#endif
+
     int out_multiple = (d_payloadsize - d_header_size) / d_block_size;
 
     if (out_multiple == 1)
@@ -195,14 +291,14 @@ bool udp_sink_impl::stop()
     return true;
 }
 
-void udp_sink_impl::build_header()
+void udp_sink_impl::build_header(char* header)
 {
     switch (d_header_type) {
     case HEADERTYPE_SEQNUM: {
         d_seq_num++;
         header_seq_num seq_header;
         seq_header.seqnum = d_seq_num;
-        memcpy((void*)d_tmpheaderbuff, (void*)&seq_header, d_header_size);
+        memcpy((void*)header, (void*)&seq_header, d_header_size);
     } break;
 
     case HEADERTYPE_SEQPLUSSIZE: {
@@ -210,25 +306,145 @@ void udp_sink_impl::build_header()
         header_seq_plus_size seq_header_plus_size;
         seq_header_plus_size.seqnum = d_seq_num;
         seq_header_plus_size.length = d_payloadsize;
-        memcpy((void*)d_tmpheaderbuff, (void*)&seq_header_plus_size, d_header_size);
+        memcpy((void*)header, (void*)&seq_header_plus_size, d_header_size);
     } break;
     }
 }
 
+void udp_sink_impl::update_rates()
+{
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - d_rate_start).count();
+    if (elapsed < 1.0)
+        return;
+
+    uint64_t packets = d_packets_sent;
+    uint64_t send_calls = d_send_calls;
+    d_packet_rate = (packets - d_rate_packets) / elapsed;
+    d_send_call_rate = (send_calls - d_rate_send_calls) / elapsed;
+
+    d_rate_start = now;
+    d_rate_packets = packets;
+    d_rate_send_calls = send_calls;
+}
+
 int udp_sink_impl::work(int noutput_items,
                         gr_vector_const_void_star& input_items,
                         gr_vector_void_star& output_items)
 {
     gr::thread::scoped_lock guard(d_setlock);
 
-    long num_bytes_to_transmit = noutput_items * d_block_size;
     const char* in = (const char*)input_items[0];
+    int itemsreturned;
 
-    // Build a long local queue to pull from so we can break it up easier
-    for (int i = 0; i < num_bytes_to_transmit; i++) {
-        d_localqueue->push_back(in[i]);
+#ifdef HAVE_SENDMMSG
+    if (d_items_per_packet > 0)
+        itemsreturned = work_batched(noutput_items, in);
+    else
+#endif
+        itemsreturned = work_queued(noutput_items, in);
+
+    update_rates();
+
+    return itemsreturned;
+}
+
+#ifdef HAVE_SENDMMSG
+int udp_sink_impl::send_messages(int nmsgs)
+{
+    int nsent = 0;
+    while (nsent < nmsgs) {
+        int sent = sendmmsg(
+            d_udpsocket->native_handle(), &d_msgs[nsent], nmsgs - nsent, 0);
+        d_send_calls++;
+
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+#ifdef UDP_SEGMENT
+            if ((errno == EIO || errno == EINVAL || errno == EMSGSIZE) &&
+                d_segments > 1) {
+                // The device cannot checksum segmented sends (EIO), or the
+                // path changed and a packet no longer fits its MTU (EINVAL,
+                // EMSGSIZE).  Stop asking for segmentation and let work()
+                // send the rest one packet per message, which the kernel may
+                // fragment.
+                int err = errno;
+                int gso_size = 0;
+                setsockopt(d_udpsocket->native_handle(),
+                           IPPROTO_UDP,
+                           UDP_SEGMENT,
+                           &gso_size,
+                           sizeof(gso_size));
+                d_segments = 1;
+                GR_LOG_WARN(d_logger,
+                            std::string("UDP segmentation offload failed (") +
+                                strerror(err) + "), disabled.");
+                break;
+            }
+#endif
+            throw std::runtime_error(std::string("[UDP Sink] Unable to send: ") +
+                                     strerror(errno));
+        }
+
+        nsent += sent;
+    }
+
+    return nsent;
+}
+
+int udp_sink_impl::work_batched(int noutput_items, const char* in)
+{
+    const int iov_per_packet = d_header_size > 0 ? 2 : 1;
+    // send_messages() drops d_segments to 1 if segmentation fails, but the
+    // messages already built hold this many packets each
+    const int segments = d_segments;
+    int npackets = std::min(noutput_items / d_items_per_packet, max_batch * segments);
+
+    // One message per segments packets; each packet is its header followed
+    // by its items, read in place.
+    int nmsgs = 0;
+    for (int first = 0; first < npackets; first += segments) {
+        int last = std::min(first + segments, npackets);
+        iovec* iov = &d_iovecs[first * iov_per_packet];
+        for (int pkt = first; pkt < last; pkt++) {
+            iovec* pkt_iov = &d_iovecs[pkt * iov_per_packet];
+            if (d_header_size > 0) {
+                char* header = &d_headers[pkt * d_header_size];
+                build_header(header);
+                pkt_iov->iov_base = header;
+                pkt_iov->iov_len = d_header_size;
+                pkt_iov++;
+            }
+            pkt_iov->iov_base = (void*)(in + (size_t)pkt * d_precomp_datasize);
+            pkt_iov->iov_len = d_precomp_datasize;
+        }
+
+        msghdr& hdr = d_msgs[nmsgs++].msg_hdr;
+        hdr.msg_iov = iov;
+        hdr.msg_iovlen = (last - first) * iov_per_packet;
+    }
+
+    int nsent = send_messages(nmsgs);
+    int packets_sent = std::min(nsent * segments, npackets);
+    if (packets_sent < npackets && d_header_type != HEADERTYPE_NONE) {
+        // The rest goes out again with the next call; number it again then.
+        d_seq_num -= npackets - packets_sent;
     }
 
+    d_packets_sent += packets_sent;
+
+    return packets_sent * d_items_per_packet;
+}
+#endif
+
+int udp_sink_impl::work_queued(int noutput_items, const char* in)
+{
+    long num_bytes_to_transmit = noutput_items * d_block_size;
+
+    // Build a long local queue to pull from so we can break it up easier
+    d_localqueue->insert(d_localqueue->end(), in, in + num_bytes_to_transmit);
+
     // Local boost buffer for transmitting
     std::vector<boost::asio::const_buffer> transmitbuffer;
 
@@ -242,17 +458,17 @@ int udp_sink_impl::work(int noutput_items,
 
         // build our next header if we need it
         if (d_header_type != HEADERTYPE_NONE) {
-            build_header();
+            build_header(d_tmpheaderbuff);
 
             transmitbuffer.push_back(
                 boost::asio::buffer((const void*)d_tmpheaderbuff, d_header_size));
         }
 
         // Fill the data buffer
-        for (int i = 0; i < d_precomp_datasize; i++) {
-            d_localbuffer[i] = d_localqueue->at(0);
-            d_localqueue->pop_front();
-        }
+        std::copy(d_localqueue->begin(),
+                  d_localqueue->begin() + d_precomp_datasize,
+                  d_localbuffer);
+        d_localqueue->erase_begin(d_precomp_datasize);
 
         // Set up for transmit
         transmitbuffer.push_back(
@@ -262,10 +478,42 @@ int udp_sink_impl::work(int noutput_items,
         d_udpsocket->send_to(transmitbuffer, d_endpoint);
     }
 
+    d_packets_sent += blocks_available;
+    d_send_calls += blocks_available;
+
     int itemsreturned = blocks_available * d_precomp_data_overitemsize;
 
     return itemsreturned;
 }
 
+void udp_sink_impl::setup_rpc()
+{
+#ifdef GR_CTRLPORT
+    d_rpc_vars.emplace_back(
+        new rpcbasic_register_get<udp_sink, double>(alias(),
+                                                    "packet_rate",
+                                                    &udp_sink::packet_rate,
+                                                    pmt::mp(0.0),
+                                                    pmt::mp(10.0e6),
+                                                    pmt::mp(0.0),
+                                                    "packets/s",
+                                                    "Packets sent",
+                                                    RPC_PRIVLVL_MIN,
+                                                    DISPTIME | DISPOPTSTRIP));
+
+    d_rpc_vars.emplace_back(
+        new rpcbasic_register_get<udp_sink, double>(alias(),
+                                                    "send_call_rate",
+                                                    &udp_sink::send_call_rate,
+                                                    pmt::mp(0.0),
+                                                    pmt::mp(10.0e6),
+                                                    pmt::mp(0.0),
+                                                    "calls/s",
+                                                    "Send system calls",
+                                                    RPC_PRIVLVL_MIN,
+                                                    DISPTIME | DISPOPTSTRIP));
+#endif /* GR_CTRLPORT */
+}
+
 } /* namespace network */
 } /* namespace gr */
@@ -17,6 +17,13 @@
 #include <boost/circular_buffer.hpp>
 
 #include <gnuradio/network/packet_headers.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#ifdef HAVE_SENDMMSG
+#include <sys/socket.h>
+#endif
 
 namespace gr {
 namespace network {
@@ -39,7 +46,7 @@ protected:
     int d_precomp_datasize;
     int d_precomp_data_overitemsize;
 
-    char d_tmpheaderbuff[12]; // Largest header is 10 bytes
+    char d_tmpheaderbuff[sizeof(header_seq_plus_size)]; // Largest header
 
     // A queue is required because we have 2 different timing
     // domains: The network packets and the GR work()/scheduler
@@ -54,8 +61,34 @@ protected:
 
     boost::mutex d_mutex;
 
-    virtual void
-    build_header(); // returns header size.  Header is stored in tmpHeaderBuff
+    std::atomic<uint64_t> d_packets_sent;
+    std::atomic<uint64_t> d_send_calls;
+    std::atomic<double> d_packet_rate;
+    std::atomic<double> d_send_call_rate;
+    std::chrono::steady_clock::time_point d_rate_start;
+    uint64_t d_rate_packets;
+    uint64_t d_rate_send_calls;
+
+    // Items per packet when sending straight from the input buffer, 0 when
+    // going through d_localqueue
+    int d_items_per_packet;
+
+#ifdef HAVE_SENDMMSG
+    // Batched transmit: every iovec points at a header in d_headers or straight
+    // into the input buffer.  With UDP GSO each message carries d_segments
+    // packets, which the kernel splits again.
+    int d_segments;
+    std::vector<mmsghdr> d_msgs;
+    std::vector<iovec> d_iovecs;
+    std::vector<char> d_headers;
+
+    int work_batched(int noutput_items, const char* in);
+    int send_messages(int nmsgs);
+#endif
+    int work_queued(int noutput_items, const char* in);
+    void update_rates();
+
+    virtual void build_header(char* header); // Writes d_header_size bytes
 
 public:
     udp_sink_impl(size_t itemsize,
@@ -69,6 +102,13 @@ public:
 
     bool stop() override;
 
+    uint64_t packets_sent() const override { return d_packets_sent; }
+    uint64_t send_calls() const override { return d_send_calls; }
+    double packet_rate() const override { return d_packet_rate; }
+    double send_call_rate() const override { return d_send_call_rate; }
+
+    void setup_rpc() override;
+
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items) override;
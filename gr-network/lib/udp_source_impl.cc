@@ -14,12 +14,40 @@
 
 #include "udp_source_impl.h"
 #include <gnuradio/io_signature.h>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
+#ifdef HAVE_RECVMMSG
+#include <cerrno>
+#include <cstring>
+#endif
+
 namespace gr {
 namespace network {
 
+namespace {
+// Datagrams pulled per recvmmsg() call at most
+constexpr size_t max_batch = 64;
+// A sequence number further behind than this is taken as a sender restart
+// rather than a late packet.
+constexpr uint64_t max_reorder_distance = 1024;
+// Asked for in high rate mode; the kernel clamps it to net.core.rmem_max
+constexpr int receive_buffer_bytes = 8 * 1024 * 1024;
+
+const pmt::pmt_t& lost_key()
+{
+    static const pmt::pmt_t key = pmt::mp("udp_lost");
+    return key;
+}
+
+const pmt::pmt_t& reordered_key()
+{
+    static const pmt::pmt_t key = pmt::mp("udp_reordered");
+    return key;
+}
+} // namespace
+
 udp_source::sptr udp_source::make(size_t itemsize,
                                   size_t veclen,
                                   int port,
@@ -27,7 +55,8 @@ udp_source::sptr udp_source::make(size_t itemsize,
                                   int payloadsize,
                                   bool notify_missed,
                                   bool source_zeros,
-                                  bool ipv6)
+                                  bool ipv6,
+                                  bool high_rate)
 {
     return gnuradio::make_block_sptr<udp_source_impl>(itemsize,
                                                       veclen,
@@ -36,7 +65,8 @@ udp_source::sptr udp_source::make(size_t itemsize,
                                                       payloadsize,
                                                       notify_missed,
                                                       source_zeros,
-                                                      ipv6);
+                                                      ipv6,
+                                                      high_rate);
 }
 
 /*
@@ -49,7 +79,8 @@ udp_source_impl::udp_source_impl(size_t itemsize,
                                  int payloadsize,
                                  bool notify_missed,
                                  bool source_zeros,
-                                 bool ipv6)
+                                 bool ipv6,
+                                 bool high_rate)
     : gr::sync_block("udp_source",
                      gr::io_signature::make(0, 0, 0),
                      gr::io_signature::make(1, 1, itemsize * veclen)),
@@ -59,11 +90,16 @@ udp_source_impl::udp_source_impl(size_t itemsize,
       d_port(port),
       d_notify_missed(notify_missed),
       d_source_zeros(source_zeros),
+      d_high_rate(high_rate),
       d_header_type(header_type),
       d_payloadsize(payloadsize),
       d_seq_num(0),
       d_header_size(0),
-      d_partial_frame_counter(0)
+      d_partial_frame_counter(0),
+      d_local_buffer(nullptr),
+      d_localqueue(nullptr),
+      d_lost_packets(0),
+      d_reordered_packets(0)
 {
     d_block_size = d_itemsize * d_veclen;
 
@@ -103,20 +139,46 @@ udp_source_impl::udp_source_impl(size_t itemsize,
     d_precomp_data_size = d_payloadsize - d_header_size;
     d_precomp_data_over_item_size = d_precomp_data_size / d_itemsize;
 
-    d_local_buffer = new char[d_payloadsize];
-    long max_circ_buffer;
-
-    // Let's keep it from getting too big
-    if (d_payloadsize < 2000) {
-        max_circ_buffer = d_payloadsize * 4000;
-    } else {
-        if (d_payloadsize < 5000)
-            max_circ_buffer = d_payloadsize * 2000;
-        else
-            max_circ_buffer = d_payloadsize * 1500;
+#ifndef HAVE_RECVMMSG
+    if (d_high_rate) {
+        GR_LOG_WARN(d_logger, "High rate mode needs recvmmsg(), turning it off.");
+        d_high_rate = false;
+    }
+#else
+    if (d_high_rate) {
+        d_msgs.resize(max_batch);
+        d_iovecs.resize(2 * max_batch);
+        d_headers.resize(max_batch * d_header_size);
+        for (size_t i = 0; i < max_batch; i++) {
+            iovec* iov = &d_iovecs[2 * i];
+            // The payload iovec is pointed into the output buffer by work()
+            iov[0].iov_base = d_headers.data() + i * d_header_size;
+            iov[0].iov_len = d_header_size;
+            iov[1].iov_len = d_precomp_data_size;
+
+            memset(&d_msgs[i], 0, sizeof(mmsghdr));
+            d_msgs[i].msg_hdr.msg_iov = d_header_size > 0 ? iov : iov + 1;
+            d_msgs[i].msg_hdr.msg_iovlen = d_header_size > 0 ? 2 : 1;
+        }
     }
+#endif
+
+    if (!d_high_rate) {
+        d_local_buffer = new char[d_payloadsize];
+        long max_circ_buffer;
 
-    d_localqueue = new boost::circular_buffer<char>(max_circ_buffer);
+        // Let's keep it from getting too big
+        if (d_payloadsize < 2000) {
+            max_circ_buffer = d_payloadsize * 4000;
+        } else {
+            if (d_payloadsize < 5000)
+                max_circ_buffer = d_payloadsize * 2000;
+            else
+                max_circ_buffer = d_payloadsize * 1500;
+        }
+
+        d_localqueue = new boost::circular_buffer<char>(max_circ_buffer);
+    }
 
     if (is_ipv6)
         d_endpoint = boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v6(), port);
@@ -130,6 +192,10 @@ udp_source_impl::udp_source_impl(size_t itemsize,
                                  ex.what());
     }
 
+    if (d_high_rate)
+        d_udpsocket->set_option(
+            boost::asio::socket_base::receive_buffer_size(receive_buffer_bytes), ec);
+
     int out_multiple = (d_payloadsize - d_header_size) / d_block_size;
 
     if (out_multiple == 1)
@@ -177,7 +243,7 @@ size_t udp_source_impl::data_available()
     d_udpsocket->io_control(command);
     size_t bytes_readable = command.get();
 
-    return (bytes_readable + d_localqueue->size());
+    return (bytes_readable + (d_localqueue ? d_localqueue->size() : 0));
 }
 
 size_t udp_source_impl::netdata_available()
@@ -190,63 +256,192 @@ size_t udp_source_impl::netdata_available()
     return bytes_readable;
 }
 
-uint64_t udp_source_impl::get_header_seqnum()
+uint64_t udp_source_impl::get_header_seqnum(const char* header)
 {
     uint64_t retVal = 0;
 
     switch (d_header_type) {
     case HEADERTYPE_SEQNUM: {
-        retVal = ((header_seq_num*)d_local_buffer)->seqnum;
+        retVal = ((const header_seq_num*)header)->seqnum;
     } break;
 
     case HEADERTYPE_SEQPLUSSIZE: {
-        retVal = ((header_seq_plus_size*)d_local_buffer)->seqnum;
+        retVal = ((const header_seq_plus_size*)header)->seqnum;
     } break;
 
     case HEADERTYPE_OLDATA: {
-        retVal = ((ata_header*)d_local_buffer)->seq;
+        retVal = ((const ata_header*)header)->seq;
     } break;
     }
 
     return retVal;
 }
 
+uint64_t udp_source_impl::check_seqnum(const char* header, uint64_t out_item)
+{
+    uint64_t pkt_seq_num = get_header_seqnum(header);
+    uint64_t skipped = 0;
+
+    // d_seq_num will be 0 when this block starts
+    if (d_seq_num > 0) {
+        if (pkt_seq_num <= d_seq_num &&
+            d_seq_num - pkt_seq_num < max_reorder_distance) {
+            // A late packet.  Its data is still passed on, but it must not pull
+            // the sequence back or everything after it would count as lost.
+            d_reordered_packets++;
+            if (d_notify_missed) {
+                add_item_tag(
+                    0, out_item, reordered_key(), pmt::from_uint64(pkt_seq_num));
+            }
+            return 0;
+        }
+
+        if (pkt_seq_num > d_seq_num) {
+            // Ideally pkt_seq_num = d_seq_num + 1.  Therefore this should do += 0
+            // when no packets are dropped.
+            skipped = pkt_seq_num - d_seq_num - 1;
+        }
+    }
+
+    if (skipped > 0) {
+        d_lost_packets += skipped;
+        if (d_notify_missed)
+            add_item_tag(0, out_item, lost_key(), pmt::from_uint64(skipped));
+    }
+
+    // Store as current for next pass.
+    d_seq_num = pkt_seq_num;
+
+    return skipped;
+}
+
+int udp_source_impl::underrun(int noutput_items, char* out)
+{
+    d_partial_frame_counter = 0;
+
+    if (d_source_zeros) {
+        // Just return 0's
+        memset((void*)out, 0x00, noutput_items * d_block_size);
+        return noutput_items;
+    }
+
+    return 0;
+}
+
+void udp_source_impl::partial_frame()
+{
+    // since we should be getting these in UDP packet blocks matched on the
+    // sender/receiver, this should be a fringe case, or a case where another
+    // app is sourcing the packets.
+    d_partial_frame_counter++;
+
+    if (d_partial_frame_counter >= 100) {
+        std::stringstream msg_stream;
+        msg_stream << "Insufficient block data.  Check your sending "
+                      "app is using "
+                   << d_payloadsize << " send blocks.";
+        GR_LOG_WARN(d_logger, msg_stream.str());
+
+        // This is just a safety to clear in the case there's a hanging partial
+        // packet. If we've lingered through a number of calls and we still don't
+        // have any data, clear the stale data.
+        if (d_localqueue)
+            d_localqueue->clear();
+
+        d_partial_frame_counter = 0;
+    }
+}
+
 int udp_source_impl::work(int noutput_items,
                           gr_vector_const_void_star& input_items,
                           gr_vector_void_star& output_items)
 {
     gr::thread::scoped_lock guard(d_setlock);
 
-    static bool first_time = true;
-    static int underrun_counter = 0;
-
-    int bytes_available = netdata_available();
     char* out = (char*)output_items[0];
-    unsigned int num_requested = noutput_items * d_block_size;
 
-    // quick exit if nothing to do
-    if ((bytes_available == 0) && (d_localqueue->empty())) {
-        underrun_counter++;
-        d_partial_frame_counter = 0;
-        if (d_source_zeros) {
-            // Just return 0's
-            memset((void*)out, 0x00, num_requested); // num_requested will be in bytes
-            return noutput_items;
-        } else {
-            if (underrun_counter == 0) {
-                if (!first_time) {
-                    std::cout << "nU";
-                } else
-                    first_time = false;
-            } else {
-                if (underrun_counter > 100)
-                    underrun_counter = 0;
-            }
+#ifdef HAVE_RECVMMSG
+    if (d_high_rate)
+        return work_batched(noutput_items, out);
+#endif
+    return work_queued(noutput_items, out);
+}
 
-            return 0;
+#ifdef HAVE_RECVMMSG
+int udp_source_impl::work_batched(int noutput_items, char* out)
+{
+    // Number of data-only blocks requested (set_output_multiple() should make
+    // sure this is an integer multiple)
+    size_t blocks_requested =
+        std::min<size_t>(noutput_items / d_precomp_data_over_item_size, max_batch);
+
+    if (blocks_requested == 0)
+        return 0;
+
+    for (size_t i = 0; i < blocks_requested; i++)
+        d_iovecs[2 * i + 1].iov_base = out + i * d_precomp_data_size;
+
+    int received = recvmmsg(
+        d_udpsocket->native_handle(), d_msgs.data(), blocks_requested, MSG_DONTWAIT, NULL);
+
+    if (received <= 0) {
+        if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            std::stringstream msg_stream;
+            msg_stream << "[UDP source:" << d_port
+                       << "] receive error: " << strerror(errno);
+            GR_LOG_WARN(d_logger, msg_stream.str());
+        }
+        return underrun(noutput_items, out);
+    }
+
+    // Payloads landed in place; only a short or truncated datagram forces the
+    // ones after it to be moved down over its slot.
+    int blocks_retrieved = 0;
+    uint64_t skipped_packets = 0;
+    for (int i = 0; i < received; i++) {
+        const msghdr& hdr = d_msgs[i].msg_hdr;
+        if (d_msgs[i].msg_len != d_payloadsize || (hdr.msg_flags & MSG_TRUNC)) {
+            partial_frame();
+            continue;
+        }
+
+        char* data_ptr = out + blocks_retrieved * d_precomp_data_size;
+        if (blocks_retrieved != i)
+            memmove(data_ptr, out + i * d_precomp_data_size, d_precomp_data_size);
+
+        // Interpret the header if present
+        if (d_header_type != HEADERTYPE_NONE) {
+            skipped_packets +=
+                check_seqnum(&d_headers[i * d_header_size],
+                             nitems_written(0) +
+                                 blocks_retrieved * d_precomp_data_over_item_size);
         }
+
+        blocks_retrieved++;
+    }
+
+    if (blocks_retrieved > 0)
+        d_partial_frame_counter = 0;
+
+    if (skipped_packets > 0 && d_notify_missed) {
+        std::stringstream msg_stream;
+        msg_stream << "[UDP source:" << d_port
+                   << "] missed  packets: " << skipped_packets;
+        GR_LOG_WARN(d_logger, msg_stream.str());
     }
 
+    return blocks_retrieved * d_precomp_data_over_item_size;
+}
+#endif
+
+int udp_source_impl::work_queued(int noutput_items, char* out)
+{
+    int bytes_available = netdata_available();
+
+    // quick exit if nothing to do
+    if ((bytes_available == 0) && (d_localqueue->empty()))
+        return underrun(noutput_items, out);
+
     int bytes_read;
 
     // we could get here even if no data was received but there's still data in
@@ -266,34 +461,13 @@ int udp_source_impl::work(int noutput_items,
             // for.  In that case we'll only return noutput_items bytes
             const char* read_data =
                 boost::asio::buffer_cast<const char*>(d_read_buffer.data());
-            for (int i = 0; i < bytes_read; i++) {
-                d_localqueue->push_back(read_data[i]);
-            }
+            d_localqueue->insert(d_localqueue->end(), read_data, read_data + bytes_read);
             d_read_buffer.consume(bytes_read);
         }
     }
 
     if (d_localqueue->size() < d_payloadsize) {
-        // since we should be getting these in UDP packet blocks matched on the
-        // sender/receiver, this should be a fringe case, or a case where another
-        // app is sourcing the packets.
-        d_partial_frame_counter++;
-
-        if (d_partial_frame_counter >= 100) {
-            std::stringstream msg_stream;
-            msg_stream << "Insufficient block data.  Check your sending "
-                          "app is using "
-                       << d_payloadsize << " send blocks.";
-            GR_LOG_WARN(d_logger, msg_stream.str());
-
-            // This is just a safety to clear in the case there's a hanging partial
-            // packet. If we've lingered through a number of calls and we still don't
-            // have any data, clear the stale data.
-            while (!d_localqueue->empty())
-                d_localqueue->pop_front();
-
-            d_partial_frame_counter = 0;
-        }
+        partial_frame();
         return 0; // Don't memset 0x00 since we're starting to get data.  In this
                   // case we'll hold for the rest.
     }
@@ -329,32 +503,20 @@ int udp_source_impl::work(int noutput_items,
     char* data_ptr;
     data_ptr = &d_local_buffer[d_header_size];
     int out_index = 0;
-    int skipped_packets = 0;
+    uint64_t skipped_packets = 0;
 
     for (int cur_pkt = 0; cur_pkt < blocks_retrieved; cur_pkt++) {
         // Move a packet to our local buffer
-        for (int cur_byte = 0; cur_byte < d_payloadsize; cur_byte++) {
-            d_local_buffer[cur_byte] = d_localqueue->at(0);
-            d_localqueue->pop_front();
-        }
+        std::copy(d_localqueue->begin(),
+                  d_localqueue->begin() + d_payloadsize,
+                  d_local_buffer);
+        d_localqueue->erase_begin(d_payloadsize);
 
         // Interpret the header if present
         if (d_header_type != HEADERTYPE_NONE) {
-            uint64_t pkt_seq_num = get_header_seqnum();
-
-            if (d_seq_num > 0) { // d_seq_num will be 0 when this block starts
-                if (pkt_seq_num > d_seq_num) {
-                    // Ideally pkt_seq_num = d_seq_num + 1.  Therefore this should do += 0
-                    // when no packets are dropped.
-                    skipped_packets += pkt_seq_num - d_seq_num - 1;
-                }
-
-                // Store as current for next pass.
-                d_seq_num = pkt_seq_num;
-            } else {
-                // just starting.  Prime it for no loss on the first packet.
-                d_seq_num = pkt_seq_num;
-            }
+            skipped_packets += check_seqnum(
+                d_local_buffer,
+                nitems_written(0) + cur_pkt * d_precomp_data_over_item_size);
         }
 
         // Move the data to the output buffer and increment the out index
@@ -17,6 +17,12 @@
 #include <boost/circular_buffer.hpp>
 
 #include <gnuradio/network/packet_headers.h>
+#include <atomic>
+#include <vector>
+
+#ifdef HAVE_RECVMMSG
+#include <sys/socket.h>
+#endif
 
 namespace gr {
 namespace network {
@@ -31,6 +37,7 @@ protected:
 
     bool d_notify_missed;
     bool d_source_zeros;
+    bool d_high_rate;
     int d_header_type;
     uint16_t d_payloadsize;
 
@@ -56,7 +63,24 @@ protected:
     // domains: The network packets and the GR work()/scheduler
     boost::circular_buffer<char>* d_localqueue;
 
-    uint64_t get_header_seqnum();
+    std::atomic<uint64_t> d_lost_packets;
+    std::atomic<uint64_t> d_reordered_packets;
+
+#ifdef HAVE_RECVMMSG
+    // Batched reception: one mmsghdr per datagram, each scattering the
+    // header into d_headers and the payload straight into the output buffer.
+    std::vector<mmsghdr> d_msgs;
+    std::vector<iovec> d_iovecs;
+    std::vector<char> d_headers;
+
+    int work_batched(int noutput_items, char* out);
+#endif
+    int work_queued(int noutput_items, char* out);
+    int underrun(int noutput_items, char* out);
+    void partial_frame();
+
+    uint64_t get_header_seqnum(const char* header);
+    uint64_t check_seqnum(const char* header, uint64_t out_item);
 
 public:
     udp_source_impl(size_t itemsize,
@@ -66,11 +90,15 @@ public:
                     int payloadsize,
                     bool notify_missed,
                     bool source_zeros,
-                    bool ipv6);
+                    bool ipv6,
+                    bool high_rate);
     ~udp_source_impl() override;
 
     bool stop() override;
 
+    uint64_t lost_packets() const override { return d_lost_packets; }
+    uint64_t reordered_packets() const override { return d_reordered_packets; }
+
     size_t data_available();
     inline size_t netdata_available();
 
@@ -22,3 +22,15 @@ static const char* __doc_gr_network_udp_sink_udp_sink = R"doc()doc";
 
 
 static const char* __doc_gr_network_udp_sink_make = R"doc()doc";
+
+
+static const char* __doc_gr_network_udp_sink_packets_sent = R"doc()doc";
+
+
+static const char* __doc_gr_network_udp_sink_send_calls = R"doc()doc";
+
+
+static const char* __doc_gr_network_udp_sink_packet_rate = R"doc()doc";
+
+
+static const char* __doc_gr_network_udp_sink_send_call_rate = R"doc()doc";
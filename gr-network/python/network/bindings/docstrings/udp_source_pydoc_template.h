@@ -22,3 +22,9 @@ static const char* __doc_gr_network_udp_source_udp_source = R"doc()doc";
 
 
 static const char* __doc_gr_network_udp_source_make = R"doc()doc";
+
+
+static const char* __doc_gr_network_udp_source_lost_packets = R"doc()doc";
+
+
+static const char* __doc_gr_network_udp_source_reordered_packets = R"doc()doc";
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(udp_sink.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(c998bf2a9132f90dc5c3dd252d9477cb)                     */
+/* BINDTOOL_HEADER_FILE_HASH(ce5bfddc1b2f13348c611b61e93a9440)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -50,5 +50,16 @@ void bind_udp_sink(py::module& m)
              D(udp_sink, make))
 
 
+        .def("packets_sent", &udp_sink::packets_sent, D(udp_sink, packets_sent))
+
+
+        .def("send_calls", &udp_sink::send_calls, D(udp_sink, send_calls))
+
+
+        .def("packet_rate", &udp_sink::packet_rate, D(udp_sink, packet_rate))
+
+
+        .def("send_call_rate", &udp_sink::send_call_rate, D(udp_sink, send_call_rate))
+
         ;
 }
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(udp_source.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(e8dceb0f73955c17260a5277ff77a7bc)                     */
+/* BINDTOOL_HEADER_FILE_HASH(f7a9c5e8ccf91de90e34d4d105854f5d)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -48,8 +48,16 @@ void bind_udp_source(py::module& m)
              py::arg("notify_missed"),
              py::arg("source_zeros"),
              py::arg("ipv6"),
+             py::arg("high_rate") = false,
              D(udp_source, make))
 
 
+        .def("lost_packets", &udp_source::lost_packets, D(udp_source, lost_packets))
+
+
+        .def("reordered_packets",
+             &udp_source::reordered_packets,
+             D(udp_source, reordered_packets))
+
         ;
 }
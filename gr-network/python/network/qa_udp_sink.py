@@ -0,0 +1,98 @@
+#!/usr/bin/env python
+#
+# Copyright 2024 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+
+from gnuradio import gr, gr_unittest, blocks
+from gnuradio import network
+import random
+import socket
+import sys
+import time
+
+# Linux socket option for the path MTU of a connected socket
+IP_MTU = getattr(socket, 'IP_MTU', 14)
+
+
+def route_mtu(host):
+    # Path MTU towards host, or None if there is no route to it
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    try:
+        s.connect((host, 9))
+        return s.getsockopt(socket.IPPROTO_IP, IP_MTU)
+    except OSError:
+        return None
+    finally:
+        s.close()
+
+
+class qa_udp_sink (gr_unittest.TestCase):
+
+    def setUp(self):
+        random.seed(0)
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_until_sent(self, sink, npackets, timeout=5.0):
+        self.tb.start()
+        deadline = time.time() + timeout
+        while sink.packets_sent() < npackets and time.time() < deadline:
+            time.sleep(0.05)
+        self.tb.stop()
+        self.tb.wait()
+
+    def test_001_loopback(self):
+        # Packets with sequence numbers arrive whole and in order
+        port = random.Random().randint(0, 30000) + 10000
+        payload = 8972
+        npackets = 20
+        rx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        rx.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 * 1024 * 1024)
+        rx.bind(('127.0.0.1', port))
+        rx.settimeout(2.0)
+
+        data = [random.randint(0, 255) for i in range(payload * npackets)]
+        src = blocks.vector_source_b(data, False)
+        sink = network.udp_sink(1, 1, '127.0.0.1', port, 1, payload + 8, False)
+        self.tb.connect(src, sink)
+        self.run_until_sent(sink, npackets)
+        self.assertEqual(sink.packets_sent(), npackets)
+
+        received = []
+        for i in range(npackets):
+            pkt = rx.recv(65536)
+            self.assertEqual(len(pkt), payload + 8)
+            self.assertEqual(int.from_bytes(pkt[:8], 'little'), i + 1)
+            received.extend(pkt[8:])
+        rx.close()
+        self.assertEqual(data, received)
+
+    def test_002_larger_than_mtu(self):
+        # Packets bigger than the path MTU must still go out (fragmented)
+        if not sys.platform.startswith('linux'):
+            self.skipTest('needs IP_MTU')
+        host = '192.0.2.1'  # TEST-NET-1, nothing listens there
+        mtu = route_mtu(host)
+        if mtu is None or mtu >= 65535:
+            self.skipTest('no non-loopback route')
+        port = random.Random().randint(0, 30000) + 10000
+        payload = min(mtu - 28 + 100, 65507)
+        npackets = 100
+
+        src = blocks.vector_source_b([0] * (payload * npackets), False)
+        sink = network.udp_sink(1, 1, host, port, 0, payload, False)
+        self.tb.connect(src, sink)
+        self.run_until_sent(sink, npackets)
+        self.assertEqual(sink.packets_sent(), npackets)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_udp_sink)
@@ -0,0 +1,71 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Transmit rate of network::udp_sink to a loopback port nobody listens
+ * on, and how many packets it gets out per system call.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/network/packet_headers.h>
+#include <gnuradio/network/udp_sink.h>
+#include <gnuradio/top_block.h>
+#include <chrono>
+#include <cstdio>
+
+#define NPACKETS (1000 * 1000)
+#define PORT 52002
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void run(int payloadsize)
+{
+    const int items_per_packet = payloadsize - sizeof(header_seq_num);
+
+    gr::top_block_sptr tb = gr::make_top_block("benchmark_udp_sink");
+    gr::basic_block_sptr src = gr::blocks::null_source::make(sizeof(char));
+    gr::basic_block_sptr head =
+        gr::blocks::head::make(sizeof(char), (uint64_t)NPACKETS * items_per_packet);
+    gr::network::udp_sink::sptr sink = gr::network::udp_sink::make(
+        sizeof(char), 1, "127.0.0.1", PORT, HEADERTYPE_SEQNUM, payloadsize, false);
+    tb->connect(src, 0, head, 0);
+    tb->connect(head, 0, sink, 0);
+
+    double start = now();
+    tb->run();
+    double elapsed = now() - start;
+
+    printf("%5d byte payload %10.1f kpackets/s %8.1f MB/s %6.1f packets/call\n",
+           payloadsize,
+           sink->packets_sent() / elapsed * 1e-3,
+           (double)sink->packets_sent() * payloadsize / elapsed * 1e-6,
+           (double)sink->packets_sent() / sink->send_calls());
+}
+
+int main(int argc, char** argv)
+{
+    const int payloadsizes[] = { 1472, 8972 };
+
+    printf("udp_sink on loopback, %d packets:\n", NPACKETS);
+    for (int size : payloadsizes)
+        run(size);
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Receive rate of network::udp_source on loopback.  A thread sends
+ * sequence numbered datagrams as fast as it can while the flowgraph
+ * takes a fixed number of packets; the sender is usually the limit on
+ * a single core, so compare the lost count as well as the rate.  Runs
+ * with and without high rate mode.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/network/packet_headers.h>
+#include <gnuradio/network/udp_source.h>
+#include <gnuradio/top_block.h>
+#include <boost/asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#define NPACKETS (1000 * 1000)
+#define PORT 52001
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void send_packets(int payloadsize, const std::atomic<bool>& done)
+{
+    boost::asio::io_service io_service;
+    boost::asio::ip::udp::socket sock(io_service, boost::asio::ip::udp::v4());
+    boost::asio::ip::udp::endpoint dest(boost::asio::ip::address_v4::loopback(), PORT);
+
+    std::vector<char> packet(payloadsize, 0);
+    header_seq_num header;
+    boost::system::error_code ec;
+    while (!done) {
+        header.seqnum++;
+        memcpy(packet.data(), &header, sizeof(header));
+        sock.send_to(boost::asio::buffer(packet), dest, 0, ec);
+    }
+}
+
+static void run(int payloadsize, bool high_rate)
+{
+    const int items_per_packet = payloadsize - sizeof(header_seq_num);
+
+    gr::top_block_sptr tb = gr::make_top_block("benchmark_udp_source");
+    gr::network::udp_source::sptr src = gr::network::udp_source::make(sizeof(char),
+                                                                      1,
+                                                                      PORT,
+                                                                      HEADERTYPE_SEQNUM,
+                                                                      payloadsize,
+                                                                      false,
+                                                                      false,
+                                                                      false,
+                                                                      high_rate);
+    gr::basic_block_sptr head =
+        gr::blocks::head::make(sizeof(char), (uint64_t)NPACKETS * items_per_packet);
+    tb->connect(src, 0, head, 0);
+    tb->connect(head, 0, gr::blocks::null_sink::make(sizeof(char)), 0);
+
+    std::atomic<bool> done(false);
+    std::thread sender(send_packets, payloadsize, std::cref(done));
+
+    double start = now();
+    tb->run();
+    double elapsed = now() - start;
+
+    done = true;
+    sender.join();
+
+    printf("%5d byte payload %-9s %10.1f kpackets/s %8.1f MB/s  lost %llu\n",
+           payloadsize,
+           high_rate ? "high rate" : "",
+           NPACKETS / elapsed * 1e-3,
+           (double)NPACKETS * payloadsize / elapsed * 1e-6,
+           (unsigned long long)src->lost_packets());
+}
+
+int main(int argc, char** argv)
+{
+    const int payloadsizes[] = { 1472, 8972 };
+
+    printf("udp_source on loopback, %d packets:\n", NPACKETS);
+    for (int size : payloadsizes) {
+        run(size, false);
+        run(size, true);
+    }
+
+    return 0;
+}
@@ -38,8 +38,9 @@ add_system_time_impl::add_system_time_impl(const pmt::pmt_t key)
     // d_epoch = epoch;
 
     message_port_register_in(msgport_names::pdu());
-    set_msg_handler(msgport_names::pdu(),
-                    [this](const pmt::pmt_t& msg) { this->handle_pdu(msg); });
+    set_msg_handler_batch(
+        msgport_names::pdu(),
+        [this](const std::vector<pmt::pmt_t>& pdus) { this->handle_pdus(pdus); });
     message_port_register_out(msgport_names::pdu());
 }
 
@@ -48,20 +49,26 @@ add_system_time_impl::add_system_time_impl(const pmt::pmt_t key)
  */
 add_system_time_impl::~add_system_time_impl() {}
 
-void add_system_time_impl::handle_pdu(const pmt::pmt_t& pdu)
+void add_system_time_impl::handle_pdus(const std::vector<pmt::pmt_t>& pdus)
 {
-    // make sure the message is a PDU
-    if (!(pmt::is_pdu(pdu))) {
-        GR_LOG_WARN(d_logger, "Message received is not a PDU, dropping");
-        return;
-    }
+    std::vector<pmt::pmt_t> out;
+    out.reserve(pdus.size());
+    for (const auto& pdu : pdus) {
+        // make sure the message is a PDU
+        if (!(pmt::is_pdu(pdu))) {
+            GR_LOG_WARN(d_logger, "Message received is not a PDU, dropping");
+            continue;
+        }
 
-    pmt::pmt_t meta = pmt::car(pdu);
+        pmt::pmt_t meta = pmt::car(pdu);
 
-    // append time and publish
-    double t_now((boost::get_system_time() - d_epoch).total_microseconds() / 1000000.0);
-    meta = pmt::dict_add(meta, d_key, pmt::from_double(t_now));
-    message_port_pub(msgport_names::pdu(), pmt::cons(meta, pmt::cdr(pdu)));
+        // append time, each PDU still gets the time it was handled at
+        double t_now((boost::get_system_time() - d_epoch).total_microseconds() /
+                     1000000.0);
+        meta = pmt::dict_add(meta, d_key, pmt::from_double(t_now));
+        out.push_back(pmt::cons(meta, pmt::cdr(pdu)));
+    }
+    message_port_pub_batch(msgport_names::pdu(), out);
 }
 
 } /* namespace pdu */
@@ -11,6 +11,7 @@
 #define INCLUDED_PDU_ADD_SYSTEM_TIME_IMPL_H
 
 #include <gnuradio/pdu/add_system_time.h>
+#include <vector>
 
 namespace gr {
 namespace pdu {
@@ -22,7 +23,7 @@ private:
     const boost::posix_time::ptime d_epoch;
     pmt::pmt_t d_key;
 
-    void handle_pdu(const pmt::pmt_t& pdu);
+    void handle_pdus(const std::vector<pmt::pmt_t>& pdus);
 
 public:
     add_system_time_impl(const pmt::pmt_t key);
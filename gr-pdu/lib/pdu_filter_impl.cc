@@ -32,27 +32,33 @@ pdu_filter_impl::pdu_filter_impl(pmt::pmt_t k, pmt::pmt_t v, bool invert)
 {
     message_port_register_out(msgport_names::pdus());
     message_port_register_in(msgport_names::pdus());
-    set_msg_handler(msgport_names::pdus(),
-                    [this](pmt::pmt_t msg) { this->handle_msg(msg); });
+    set_msg_handler_batch(
+        msgport_names::pdus(),
+        [this](const std::vector<pmt::pmt_t>& pdus) { this->handle_msgs(pdus); });
 }
 
-void pdu_filter_impl::handle_msg(pmt::pmt_t pdu)
+void pdu_filter_impl::handle_msgs(const std::vector<pmt::pmt_t>& pdus)
 {
-    pmt::pmt_t meta = pmt::car(pdu);
-    bool output = d_invert;
-
-    // check base type
-    // key exists
-    // value matches
-    if (pmt::is_dict(meta) && dict_has_key(meta, d_k) &&
-        pmt::eqv(pmt::dict_ref(meta, d_k, pmt::PMT_NIL), d_v)) {
-        output = !d_invert;
-    }
+    std::vector<pmt::pmt_t> out;
+    out.reserve(pdus.size());
+    for (const auto& pdu : pdus) {
+        pmt::pmt_t meta = pmt::car(pdu);
+        bool output = d_invert;
+
+        // check base type
+        // key exists
+        // value matches
+        if (pmt::is_dict(meta) && dict_has_key(meta, d_k) &&
+            pmt::eqv(pmt::dict_ref(meta, d_k, pmt::PMT_NIL), d_v)) {
+            output = !d_invert;
+        }
 
-    // if all tests pass, propagate the pdu
-    if (output) {
-        message_port_pub(msgport_names::pdus(), pdu);
+        // if all tests pass, propagate the pdu
+        if (output) {
+            out.push_back(pdu);
+        }
     }
+    message_port_pub_batch(msgport_names::pdus(), out);
 }
 
 } /* namespace pdu */
@@ -12,6 +12,7 @@
 #define INCLUDED_PDU_PDU_FILTER_IMPL_H
 
 #include <gnuradio/pdu/pdu_filter.h>
+#include <vector>
 
 namespace gr {
 namespace pdu {
@@ -23,9 +24,10 @@ private:
     pmt::pmt_t d_v;
     bool d_invert;
 
+    void handle_msgs(const std::vector<pmt::pmt_t>& pdus);
+
 public:
     pdu_filter_impl(pmt::pmt_t k, pmt::pmt_t v, bool invert);
-    void handle_msg(pmt::pmt_t msg);
     void set_key(pmt::pmt_t key) override { d_k = key; };
     void set_val(pmt::pmt_t val) override { d_v = val; };
     void set_inversion(bool invert) override { d_invert = invert; };
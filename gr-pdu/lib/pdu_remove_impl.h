@@ -12,6 +12,7 @@
 #define INCLUDED_PDU_PDU_REMOVE_IMPL_H
 
 #include <gnuradio/pdu/pdu_remove.h>
+#include <vector>
 
 namespace gr {
 namespace pdu {
@@ -21,9 +22,10 @@ class pdu_remove_impl : public pdu_remove
 private:
     pmt::pmt_t d_k;
 
+    void handle_msgs(const std::vector<pmt::pmt_t>& pdus);
+
 public:
     pdu_remove_impl(pmt::pmt_t k);
-    void handle_msg(pmt::pmt_t msg);
     void set_key(pmt::pmt_t key) override { d_k = key; };
 };
 
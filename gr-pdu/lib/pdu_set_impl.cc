@@ -31,21 +31,32 @@ pdu_set_impl::pdu_set_impl(pmt::pmt_t k, pmt::pmt_t v)
 {
     message_port_register_out(msgport_names::pdus());
     message_port_register_in(msgport_names::pdus());
-    set_msg_handler(msgport_names::pdus(),
-                    [this](pmt::pmt_t msg) { this->handle_msg(msg); });
+    set_msg_handler_batch(
+        msgport_names::pdus(),
+        [this](const std::vector<pmt::pmt_t>& pdus) { this->handle_msgs(pdus); });
 }
 
-void pdu_set_impl::handle_msg(pmt::pmt_t pdu)
+void pdu_set_impl::handle_msgs(const std::vector<pmt::pmt_t>& pdus)
 {
-    // add the field and publish
-    pmt::pmt_t meta = pmt::car(pdu);
-    if (pmt::is_null(meta)) {
-        meta = pmt::make_dict();
-    } else if (!pmt::is_dict(meta)) {
-        throw std::runtime_error("pdu_set received non PDU input");
+    // check the whole batch first, so a bad message doesn't leave part
+    // of it published
+    for (const auto& pdu : pdus) {
+        if (!pmt::is_pair(pdu) ||
+            !(pmt::is_null(pmt::car(pdu)) || pmt::is_dict(pmt::car(pdu))))
+            throw std::runtime_error("pdu_set received non PDU input");
     }
-    meta = pmt::dict_add(meta, d_k, d_v);
-    message_port_pub(msgport_names::pdus(), pmt::cons(meta, pmt::cdr(pdu)));
+
+    // add the field to each PDU, then publish them together
+    std::vector<pmt::pmt_t> out;
+    out.reserve(pdus.size());
+    for (const auto& pdu : pdus) {
+        pmt::pmt_t meta = pmt::car(pdu);
+        if (pmt::is_null(meta))
+            meta = pmt::make_dict();
+        meta = pmt::dict_add(meta, d_k, d_v);
+        out.push_back(pmt::cons(meta, pmt::cdr(pdu)));
+    }
+    message_port_pub_batch(msgport_names::pdus(), out);
 }
 
 } /* namespace pdu */
@@ -12,6 +12,7 @@
 #define INCLUDED_PDU_PDU_SET_IMPL_H
 
 #include <gnuradio/pdu/pdu_set.h>
+#include <vector>
 
 namespace gr {
 namespace pdu {
@@ -22,9 +23,10 @@ private:
     pmt::pmt_t d_k;
     pmt::pmt_t d_v;
 
+    void handle_msgs(const std::vector<pmt::pmt_t>& pdus);
+
 public:
     pdu_set_impl(pmt::pmt_t k, pmt::pmt_t v);
-    void handle_msg(pmt::pmt_t msg);
     void set_key(pmt::pmt_t key) override { d_k = key; };
     void set_val(pmt::pmt_t val) override { d_v = val; };
 };
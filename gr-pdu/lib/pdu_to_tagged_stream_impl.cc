@@ -78,13 +78,13 @@ int pdu_to_tagged_stream_impl::work(int noutput_items,
     const uint8_t* ptr = (const uint8_t*)uniform_vector_elements(d_curr_vect, io);
     memcpy(out, ptr, d_curr_len * d_itemsize);
 
-    // Copy tags
+    // Copy tags, walking the entries once
     if (!pmt::eq(d_curr_meta, pmt::PMT_NIL)) {
-        pmt::pmt_t klist(pmt::dict_keys(d_curr_meta));
-        for (size_t i = 0; i < pmt::length(klist); i++) {
-            pmt::pmt_t k(pmt::nth(i, klist));
-            pmt::pmt_t v(pmt::dict_ref(d_curr_meta, k, pmt::PMT_NIL));
-            add_item_tag(0, nitems_written(0), k, v, alias_pmt());
+        for (pmt::pmt_t items = pmt::dict_items(d_curr_meta); pmt::is_pair(items);
+             items = pmt::cdr(items)) {
+            const pmt::pmt_t item = pmt::car(items);
+            add_item_tag(
+                0, nitems_written(0), pmt::car(item), pmt::cdr(item), alias_pmt());
         }
     }
 
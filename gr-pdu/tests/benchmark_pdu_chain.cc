@@ -0,0 +1,129 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/*
+ * Messages per second through a running chain of PDU blocks
+ * (pdu_set -> pdu_set -> pdu_remove -> pdu_filter -> counter), with
+ * one and with several threads posting into the head of the chain at
+ * the same time. The PDU blocks take their messages in batches
+ * (set_msg_handler_batch), as many as are queued when they wake up.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/pdu.h>
+#include <gnuradio/pdu/pdu_filter.h>
+#include <gnuradio/pdu/pdu_remove.h>
+#include <gnuradio/pdu/pdu_set.h>
+#include <gnuradio/top_block.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define NMSGS 1000000
+
+static double now()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Counts the PDUs that make it through and wakes main() after the last
+class pdu_counter : public gr::block
+{
+public:
+    pdu_counter(long target)
+        : gr::block("pdu_counter",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0)),
+          d_target(target),
+          d_count(0)
+    {
+        message_port_register_in(gr::msgport_names::pdus());
+        set_msg_handler(gr::msgport_names::pdus(), [this](const pmt::pmt_t&) {
+            if (++d_count == d_target) {
+                std::lock_guard<std::mutex> guard(d_mutex);
+                d_cond.notify_all();
+            }
+        });
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> guard(d_mutex);
+        d_cond.wait(guard, [this]() { return d_count.load() >= d_target; });
+    }
+
+private:
+    const long d_target;
+    std::atomic<long> d_count;
+    std::mutex d_mutex;
+    std::condition_variable d_cond;
+};
+
+static void run(int nproducers)
+{
+    const pmt::pmt_t pdus = gr::msgport_names::pdus();
+    const pmt::pmt_t k1 = pmt::intern("k1");
+    const pmt::pmt_t k2 = pmt::intern("k2");
+    const pmt::pmt_t v = pmt::from_long(1);
+
+    auto tb = gr::make_top_block("benchmark_pdu_chain");
+    auto set1 = gr::pdu::pdu_set::make(k1, v);
+    auto set2 = gr::pdu::pdu_set::make(k2, v);
+    auto remove = gr::pdu::pdu_remove::make(k1);
+    auto filter = gr::pdu::pdu_filter::make(k2, v);
+    auto counter = std::make_shared<pdu_counter>(NMSGS);
+
+    tb->msg_connect(set1, pdus, set2, pdus);
+    tb->msg_connect(set2, pdus, remove, pdus);
+    tb->msg_connect(remove, pdus, filter, pdus);
+    tb->msg_connect(filter, pdus, counter, pdus);
+    tb->start();
+
+    const pmt::pmt_t pdu =
+        pmt::cons(pmt::make_dict(), pmt::init_u8vector(64, std::vector<uint8_t>(64)));
+
+    double start = now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < nproducers; p++) {
+        producers.emplace_back([&, p]() {
+            for (int i = p; i < NMSGS; i += nproducers)
+                set1->post(pdus, pdu);
+        });
+    }
+    for (auto& t : producers)
+        t.join();
+    counter->wait();
+    double elapsed = now() - start;
+
+    tb->stop();
+    tb->wait();
+
+    printf("%d producer(s): %8.3f Mmsgs/s\n", nproducers, NMSGS / elapsed * 1e-6);
+}
+
+int main(int argc, char** argv)
+{
+    printf("%d PDUs through a chain of 4 PDU blocks:\n", NMSGS);
+    run(1);
+    run(4);
+
+    return 0;
+}
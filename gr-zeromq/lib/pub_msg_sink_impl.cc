@@ -56,12 +56,8 @@ pub_msg_sink_impl::~pub_msg_sink_impl() {}
 
 void pub_msg_sink_impl::handler(pmt::pmt_t msg)
 {
-    std::stringbuf sb("");
-    pmt::serialize(msg, sb);
-    std::string s = sb.str();
-    zmq::message_t zmsg(s.size());
-
-    memcpy(zmsg.data(), s.c_str(), s.size());
+    zmq::message_t zmsg(pmt::serialized_size(msg));
+    pmt::serialize_to_buffer(msg, zmsg.data(), zmsg.size());
 #if USE_NEW_CPPZMQ_SEND_RECV
     d_socket.send(zmsg, zmq::send_flags::none);
 #else
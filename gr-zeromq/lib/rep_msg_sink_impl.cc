@@ -105,11 +105,8 @@ void rep_msg_sink_impl::readloop()
 
                 // create message copy and send
                 pmt::pmt_t msg = delete_head_nowait(d_port);
-                std::stringbuf sb("");
-                pmt::serialize(msg, sb);
-                std::string s = sb.str();
-                zmq::message_t zmsg(s.size());
-                memcpy(zmsg.data(), s.c_str(), s.size());
+                zmq::message_t zmsg(pmt::serialized_size(msg));
+                pmt::serialize_to_buffer(msg, zmsg.data(), zmsg.size());
 #if USE_NEW_CPPZMQ_SEND_RECV
                 d_socket.send(zmsg, zmq::send_flags::none);
 #else
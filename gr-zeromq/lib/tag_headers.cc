@@ -12,7 +12,6 @@
 #include <gnuradio/block.h>
 #include <gnuradio/io_signature.h>
 #include <cstring>
-#include <sstream>
 
 #define GR_HEADER_MAGIC 0x5FF0
 #define GR_HEADER_VERSION 0x01
@@ -20,44 +19,47 @@
 namespace gr {
 namespace zeromq {
 
-struct membuf : std::streambuf {
-    membuf(void* b, size_t len)
-    {
-        char* bc = static_cast<char*>(b);
-        this->setg(bc, bc, bc + len);
-    }
-};
-
 std::string gen_tag_header(uint64_t offset, std::vector<gr::tag_t>& tags)
 {
-    std::stringbuf sb("");
-    std::ostream ss(&sb);
-
     uint16_t header_magic = GR_HEADER_MAGIC;
     uint8_t header_version = GR_HEADER_VERSION;
     uint64_t ntags = (uint64_t)tags.size();
 
-    ss.write((const char*)&header_magic, sizeof(uint16_t));
-    ss.write((const char*)&header_version, sizeof(uint8_t));
-    ss.write((const char*)&offset, sizeof(uint64_t));
-    ss.write((const char*)&ntags, sizeof(uint64_t));
-
-    for (size_t i = 0; i < tags.size(); i++) {
-        ss.write((const char*)&tags[i].offset, sizeof(uint64_t));
-        pmt::serialize(tags[i].key, sb);
-        pmt::serialize(tags[i].value, sb);
-        pmt::serialize(tags[i].srcid, sb);
+    size_t len = sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint64_t);
+    for (const auto& tag : tags)
+        len += sizeof(uint64_t) + pmt::serialized_size(tag.key) +
+               pmt::serialized_size(tag.value) + pmt::serialized_size(tag.srcid);
+
+    std::string header(len, '\0');
+    char* p = &header[0];
+    char* end = p + len;
+
+    memcpy(p, &header_magic, sizeof(uint16_t));
+    p += sizeof(uint16_t);
+    memcpy(p, &header_version, sizeof(uint8_t));
+    p += sizeof(uint8_t);
+    memcpy(p, &offset, sizeof(uint64_t));
+    p += sizeof(uint64_t);
+    memcpy(p, &ntags, sizeof(uint64_t));
+    p += sizeof(uint64_t);
+
+    for (const auto& tag : tags) {
+        memcpy(p, &tag.offset, sizeof(uint64_t));
+        p += sizeof(uint64_t);
+        p += pmt::serialize_to_buffer(tag.key, p, end - p);
+        p += pmt::serialize_to_buffer(tag.value, p, end - p);
+        p += pmt::serialize_to_buffer(tag.srcid, p, end - p);
     }
 
-    return sb.str();
+    return header;
 }
 
 size_t parse_tag_header(zmq::message_t& msg,
                         uint64_t& offset_out,
                         std::vector<gr::tag_t>& tags_out)
 {
-    membuf sb(msg.data(), msg.size());
-    std::istream iss(&sb);
+    const char* p = static_cast<const char*>(msg.data());
+    const char* end = p + msg.size();
 
     size_t min_len =
         sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint64_t);
@@ -68,8 +70,10 @@ size_t parse_tag_header(zmq::message_t& msg,
     uint8_t header_version;
     uint64_t rcv_ntags;
 
-    iss.read((char*)&header_magic, sizeof(uint16_t));
-    iss.read((char*)&header_version, sizeof(uint8_t));
+    memcpy(&header_magic, p, sizeof(uint16_t));
+    p += sizeof(uint16_t);
+    memcpy(&header_version, p, sizeof(uint8_t));
+    p += sizeof(uint8_t);
 
     if (header_magic != GR_HEADER_MAGIC)
         throw std::runtime_error("gr header magic does not match!");
@@ -77,19 +81,29 @@ size_t parse_tag_header(zmq::message_t& msg,
     if (header_version != 1)
         throw std::runtime_error("gr header version too high!");
 
-    iss.read((char*)&offset_out, sizeof(uint64_t));
-    iss.read((char*)&rcv_ntags, sizeof(uint64_t));
+    memcpy(&offset_out, p, sizeof(uint64_t));
+    p += sizeof(uint64_t);
+    memcpy(&rcv_ntags, p, sizeof(uint64_t));
+    p += sizeof(uint64_t);
 
     for (size_t i = 0; i < rcv_ntags; i++) {
         gr::tag_t newtag;
-        sb.sgetn((char*)&(newtag.offset), sizeof(uint64_t));
-        newtag.key = pmt::deserialize(sb);
-        newtag.value = pmt::deserialize(sb);
-        newtag.srcid = pmt::deserialize(sb);
+        if (size_t(end - p) < sizeof(uint64_t))
+            throw std::runtime_error("incoming zmq msg too small to hold gr tag header!");
+        memcpy(&newtag.offset, p, sizeof(uint64_t));
+        p += sizeof(uint64_t);
+
+        size_t used;
+        newtag.key = pmt::deserialize_from_buffer(p, end - p, used);
+        p += used;
+        newtag.value = pmt::deserialize_from_buffer(p, end - p, used);
+        p += used;
+        newtag.srcid = pmt::deserialize_from_buffer(p, end - p, used);
+        p += used;
         tags_out.push_back(newtag);
     }
 
-    return msg.size() - sb.in_avail();
+    return p - static_cast<const char*>(msg.data());
 }
 } /* namespace zeromq */
 } /* namespace gr */